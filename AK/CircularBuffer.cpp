@@ -255,6 +255,36 @@ ErrorOr<size_t> CircularBuffer::copy_from_seekback(size_t distance, size_t lengt
     if (distance > m_seekback_limit)
         return Error::from_string_literal("Tried a seekback copy beyond the seekback limit");
 
+    // Fast path: Most back-references are short and neither their source nor their destination wraps around the end of
+    // the buffer, so they can be copied directly without going through spans.
+    if (distance > 0 && length <= empty_space()) {
+        auto write_offset = m_reading_head + m_used_space;
+        if (write_offset >= capacity())
+            write_offset -= capacity();
+        auto read_offset = write_offset >= distance ? write_offset - distance : write_offset + capacity() - distance;
+
+        if (write_offset + length <= capacity() && read_offset + length <= capacity()) {
+            auto* destination = m_buffer.data() + write_offset;
+            auto const* source = m_buffer.data() + read_offset;
+
+            if (distance >= length) {
+                // NOTE: The source can still overlap with the destination if it's ahead of it, but then it only holds
+                //       older data, so a plain memmove gives the right result.
+                __builtin_memmove(destination, source, length);
+            } else if (distance == 1) {
+                __builtin_memset(destination, *source, length);
+            } else {
+                // The source overlaps with what we are writing, so the copy has to repeat the last `distance` bytes.
+                for (size_t i = 0; i < length; ++i)
+                    destination[i] = source[i];
+            }
+
+            m_used_space += length;
+            m_seekback_limit = min(m_seekback_limit + length, capacity());
+            return length;
+        }
+    }
+
     auto remaining_length = length;
     while (remaining_length > 0) {
         if (empty_space() == 0)
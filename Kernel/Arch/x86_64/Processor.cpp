@@ -948,6 +948,22 @@ u32 ProcessorBase<T>::smp_wake_n_idle_processors(u32 wake_count)
     return did_wake_count;
 }
 
+template<typename T>
+bool ProcessorBase<T>::smp_wake_idle_processor(u32 cpu)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    if (!s_smp_enabled || cpu == Processor::current_id())
+        return false;
+
+    // Flip it to busy first, so that it only gets one IPI when others try to wake it up as well.
+    u32 cpu_mask = 1u << cpu;
+    if (!(Processor::s_idle_cpu_mask.fetch_and(~cpu_mask, AK::MemoryOrder::memory_order_acq_rel) & cpu_mask))
+        return false;
+
+    APIC::the().send_ipi(cpu);
+    return true;
+}
+
 template<typename T>
 UNMAP_AFTER_INIT void ProcessorBase<T>::smp_enable()
 {
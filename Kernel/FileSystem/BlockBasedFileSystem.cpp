@@ -4,9 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/FixedArray.h>
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
@@ -16,101 +19,290 @@ struct CacheEntry {
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_dirty { false };
+    bool is_in_hash { false };
 };
 
-class DiskCache {
+struct CacheChunk {
+    NonnullOwnPtr<KBuffer> block_data;
+    FixedArray<CacheEntry> entries;
+};
+
+class DiskCacheShard {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
-    {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * fs.logical_block_size();
-            m_clean_list.append(entries()[i]);
-        }
-    }
+    // Entries are allocated (and freed again) in chunks of this many blocks.
+    static constexpr size_t EntriesPerChunk = 256;
+    static constexpr size_t MaxChunks = 32;
+
+    // Looking at the system memory state takes the memory manager lock, so we only
+    // reconsider the size of a shard every so many misses.
+    static constexpr size_t MissesPerCapacityCheck = 64;
 
-    ~DiskCache() = default;
+    // The longest run of contiguous dirty blocks that is written back with a single write.
+    static constexpr size_t MaxWriteBackRunLength = 32;
 
-    bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
+    DiskCacheShard() = default;
 
-    void mark_all_clean()
+    ~DiskCacheShard()
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+        // NOTE: The entries live in m_chunks, so make sure the lists let go of them first.
+        m_dirty_list.clear();
+        m_clean_list.clear();
     }
 
+    size_t capacity() const { return m_chunks.size() * EntriesPerChunk; }
+    size_t dirty_count() const { return m_dirty_count; }
+    bool is_dirty() const { return m_dirty_count > 0; }
+
     void mark_dirty(CacheEntry& entry)
     {
+        if (!entry.is_dirty)
+            ++m_dirty_count;
+        entry.is_dirty = true;
         m_dirty_list.prepend(entry);
     }
 
     void mark_clean(CacheEntry& entry)
     {
+        if (entry.is_dirty)
+            --m_dirty_count;
+        entry.is_dirty = false;
         m_clean_list.prepend(entry);
     }
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+    ErrorOr<void> grow(size_t block_size)
+    {
+        auto block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, EntriesPerChunk * block_size));
+        auto entries = TRY(FixedArray<CacheEntry>::create(EntriesPerChunk));
+        for (size_t i = 0; i < EntriesPerChunk; ++i)
+            entries[i].data = block_data->data() + i * block_size;
+        TRY(m_chunks.try_append({ move(block_data), move(entries) }));
+
+        // Fresh entries go to the back of the clean list, so they are used before anything gets evicted.
+        for (auto& entry : m_chunks.last().entries)
+            m_clean_list.append(entry);
+        return {};
+    }
+
+    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index)
     {
         auto it = m_hash.find(block_index);
         if (it == m_hash.end())
             return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
+        auto& entry = *it->value;
         VERIFY(entry.block_index == block_index);
-        if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
+        if (!entry.is_dirty && (m_clean_list.first() != &entry)) {
             // Cache hit! Promote the entry to the front of the list.
             m_clean_list.prepend(entry);
         }
         return &entry;
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index, BlockBasedFileSystem& fs) const
+    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index, BlockBasedFileSystem& fs)
     {
-        if (auto* entry = get(block_index))
+        if (auto* entry = get(block_index)) {
+            ++m_hits;
             return entry;
+        }
+        ++m_misses;
+
+        adjust_capacity_if_needed(fs);
 
         if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            fs.flush_writes_impl();
-            return ensure(block_index, fs);
+            // Not a single clean entry! Write back our dirty blocks and try again.
+            write_back_dirty_entries(fs);
         }
 
         VERIFY(m_clean_list.last());
         auto& new_entry = *m_clean_list.last();
         m_clean_list.prepend(new_entry);
 
-        m_hash.remove(new_entry.block_index);
+        if (new_entry.is_in_hash) {
+            m_hash.remove(new_entry.block_index);
+            new_entry.is_in_hash = false;
+            ++m_evictions;
+        }
         TRY(m_hash.try_set(block_index, &new_entry));
 
         new_entry.block_index = block_index;
         new_entry.has_data = false;
+        new_entry.is_in_hash = true;
 
         return &new_entry;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    void write_back_entry(BlockBasedFileSystem& fs, CacheEntry& entry)
+    {
+        auto base_offset = entry.block_index.value() * fs.logical_block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        [[maybe_unused]] auto rc = fs.file_description().write(base_offset, entry_data_buffer, fs.logical_block_size());
+    }
+
+    size_t write_back_dirty_entries(BlockBasedFileSystem& fs)
+    {
+        if (!is_dirty())
+            return 0;
+
+        size_t count = m_dirty_count;
+        Vector<CacheEntry*> dirty_entries;
+        if (dirty_entries.try_ensure_capacity(count).is_error()) {
+            // Not enough memory to sort the dirty blocks, write them back one by one instead.
+            for (auto& entry : m_dirty_list)
+                write_back_entry(fs, entry);
+        } else {
+            for (auto& entry : m_dirty_list)
+                dirty_entries.unchecked_append(&entry);
+            quick_sort(dirty_entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+
+            for (size_t run_start = 0; run_start < dirty_entries.size();) {
+                auto first_block = dirty_entries[run_start]->block_index.value();
+                size_t run_length = 1;
+                while (run_start + run_length < dirty_entries.size()
+                    && run_length < MaxWriteBackRunLength
+                    && dirty_entries[run_start + run_length]->block_index.value() == first_block + run_length)
+                    ++run_length;
+                write_back_run(fs, dirty_entries.span().slice(run_start, run_length));
+                run_start += run_length;
+            }
+        }
+
+        while (auto* entry = m_dirty_list.first())
+            mark_clean(*entry);
+        m_written_back += count;
+        return count;
+    }
+
+    DiskCacheStatistics statistics() const
+    {
+        return {
+            .hits = m_hits,
+            .misses = m_misses,
+            .evictions = m_evictions,
+            .written_back = m_written_back,
+            .capacity = capacity(),
+            .dirty = m_dirty_count,
+        };
+    }
+
+private:
+    void write_back_run(BlockBasedFileSystem& fs, Span<CacheEntry*> run)
+    {
+        auto block_size = fs.logical_block_size();
+        if (run.size() > 1 && !m_write_back_buffer) {
+            auto buffer_or_error = KBuffer::try_create_with_size("BlockBasedFS: Cache write-back"sv, MaxWriteBackRunLength * block_size);
+            if (!buffer_or_error.is_error())
+                m_write_back_buffer = buffer_or_error.release_value();
+        }
+
+        if (run.size() == 1 || !m_write_back_buffer) {
+            for (auto* entry : run)
+                write_back_entry(fs, *entry);
+            return;
+        }
+
+        for (size_t i = 0; i < run.size(); ++i)
+            memcpy(m_write_back_buffer->data() + i * block_size, run[i]->data, block_size);
+        auto base_offset = run[0]->block_index.value() * block_size;
+        auto data_buffer = m_write_back_buffer->as_kernel_buffer();
+        [[maybe_unused]] auto rc = fs.file_description().write(base_offset, data_buffer, run.size() * block_size);
+    }
+
+    void adjust_capacity_if_needed(BlockBasedFileSystem& fs)
+    {
+        if (++m_misses_since_capacity_check < MissesPerCapacityCheck)
+            return;
+        m_misses_since_capacity_check = 0;
+
+        // Grow while at least a quarter of physical memory is uncommitted, and give
+        // memory back once less than an eighth is left.
+        auto memory_info = MM.get_system_memory_info();
+        auto available_pages = memory_info.physical_pages_uncommitted;
+
+        if (available_pages < memory_info.physical_pages / 8) {
+            if (m_chunks.size() <= 1)
+                return;
+            write_back_dirty_entries(fs);
+            shrink();
+            return;
+        }
+
+        if (available_pages >= memory_info.physical_pages / 4 && m_chunks.size() < MaxChunks) {
+            // If this fails we'll simply keep evicting entries from the chunks we have.
+            (void)grow(fs.logical_block_size());
+        }
+    }
+
+    void shrink()
+    {
+        VERIFY(m_chunks.size() > 1);
+        auto chunk = m_chunks.take_last();
+        for (auto& entry : chunk.entries) {
+            VERIFY(!entry.is_dirty);
+            if (entry.is_in_hash) {
+                m_hash.remove(entry.block_index);
+                ++m_evictions;
+            }
+            m_clean_list.remove(entry);
+        }
+    }
+
+    // NOTE: m_chunks must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
+    Vector<CacheChunk> m_chunks;
+    IntrusiveList<&CacheEntry::list_node> m_dirty_list;
+    IntrusiveList<&CacheEntry::list_node> m_clean_list;
+    HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    OwnPtr<KBuffer> m_write_back_buffer;
+    size_t m_dirty_count { 0 };
+    size_t m_misses_since_capacity_check { 0 };
+
+    u64 m_hits { 0 };
+    u64 m_misses { 0 };
+    u64 m_evictions { 0 };
+    u64 m_written_back { 0 };
+};
+
+class DiskCache {
+public:
+    static constexpr size_t ShardCount = 16;
+
+    // Runs of consecutive blocks map to the same shard, so that contiguous dirty
+    // blocks can be written back together.
+    static constexpr size_t BlocksPerStripe = 64;
+
+    // The cache starts out with room for at least as many blocks as the unsharded cache had.
+    static constexpr size_t InitialEntryCount = 10000;
+    static constexpr size_t InitialChunksPerShard = ceil_div(InitialEntryCount, ShardCount * DiskCacheShard::EntriesPerChunk);
+    static_assert(InitialChunksPerShard <= DiskCacheShard::MaxChunks);
+
+    static ErrorOr<NonnullOwnPtr<DiskCache>> try_create(size_t block_size)
+    {
+        auto cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache));
+        for (auto& protected_shard : cache->m_shards) {
+            TRY(protected_shard.with_exclusive([&](auto& shard) -> ErrorOr<void> {
+                for (size_t i = 0; i < InitialChunksPerShard; ++i)
+                    TRY(shard.grow(block_size));
+                return {};
+            }));
+        }
+        return cache;
+    }
+
+    MutexProtected<DiskCacheShard>& shard_for(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        return m_shards[(block_index.value() / BlocksPerStripe) % ShardCount];
+    }
 
     template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    void for_each_shard(Callback callback)
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        for (auto& protected_shard : m_shards)
+            protected_shard.with_exclusive([&](auto& shard) { callback(shard); });
     }
 
 private:
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
-    NonnullOwnPtr<KBuffer> m_entries;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    DiskCache() = default;
+
+    Array<MutexProtected<DiskCacheShard>, ShardCount> m_shards;
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -126,13 +318,7 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(logical_block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
-
-    m_cache.with_exclusive([&](auto& cache) {
-        cache = move(disk_cache);
-    });
+    m_cache = TRY(DiskCache::try_create(logical_block_size()));
     return {};
 }
 
@@ -149,7 +335,7 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache->shard_for(index).with_exclusive([&](auto& shard) -> ErrorOr<void> {
         if (!allow_cache) {
             flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * logical_block_size() + offset;
@@ -158,14 +344,14 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
             return {};
         }
 
-        auto entry = TRY(cache->ensure(index, *this));
+        auto entry = TRY(shard.ensure(index, *this));
         if (count < logical_block_size()) {
             // Fill the cache first.
             TRY(read_block(index, nullptr, logical_block_size()));
         }
         memcpy(entry->data + offset, buffered_data.data(), count);
 
-        cache->mark_dirty(*entry);
+        shard.mark_dirty(*entry);
         entry->has_data = true;
         return {};
     });
@@ -223,7 +409,7 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= logical_block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache->shard_for(index).with_exclusive([&](auto& shard) -> ErrorOr<void> {
         if (!allow_cache) {
             const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * logical_block_size() + offset;
@@ -232,7 +418,7 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
             return {};
         }
 
-        auto* entry = TRY(cache->ensure(index, const_cast<BlockBasedFileSystem&>(*this)));
+        auto* entry = TRY(shard.ensure(index, const_cast<BlockBasedFileSystem&>(*this)));
         if (!entry->has_data) {
             auto base_offset = index.value() * logical_block_size();
             auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
@@ -264,35 +450,26 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
 
 void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 {
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
+    m_cache->shard_for(index).with_exclusive([&](auto& shard) {
+        if (!shard.is_dirty())
             return;
-        auto* entry = cache->get(index);
+        auto* entry = shard.get(index);
         if (!entry)
             return;
-        if (!cache->entry_is_dirty(*entry))
+        if (!entry->is_dirty)
             return;
-        size_t base_offset = entry->block_index.value() * logical_block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-        (void)file_description().write(base_offset, entry_data_buffer, logical_block_size());
+        shard.write_back_entry(*this, *entry);
     });
 }
 
 void BlockBasedFileSystem::flush_writes_impl()
 {
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
-            ++count;
-        });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+    m_cache->for_each_shard([&](auto& shard) {
+        count += shard.write_back_dirty_entries(*this);
     });
+    if (count > 0)
+        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
 }
 
 ErrorOr<void> BlockBasedFileSystem::flush_writes()
@@ -301,4 +478,19 @@ ErrorOr<void> BlockBasedFileSystem::flush_writes()
     return {};
 }
 
+DiskCacheStatistics BlockBasedFileSystem::cache_statistics() const
+{
+    DiskCacheStatistics statistics;
+    m_cache->for_each_shard([&](auto& shard) {
+        auto shard_statistics = shard.statistics();
+        statistics.hits += shard_statistics.hits;
+        statistics.misses += shard_statistics.misses;
+        statistics.evictions += shard_statistics.evictions;
+        statistics.written_back += shard_statistics.written_back;
+        statistics.capacity += shard_statistics.capacity;
+        statistics.dirty += shard_statistics.dirty;
+    });
+    return statistics;
+}
+
 }
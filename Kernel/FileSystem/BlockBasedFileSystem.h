@@ -11,6 +11,15 @@
 
 namespace Kernel {
 
+struct DiskCacheStatistics {
+    u64 hits { 0 };
+    u64 misses { 0 };
+    u64 evictions { 0 };
+    u64 written_back { 0 };
+    size_t capacity { 0 };
+    size_t dirty { 0 };
+};
+
 class BlockBasedFileSystem : public FileBackedFileSystem {
 public:
     AK_TYPEDEF_DISTINCT_ORDERED_ID(u64, BlockIndex);
@@ -22,6 +31,8 @@ public:
     virtual ErrorOr<void> flush_writes() override;
     void flush_writes_impl();
 
+    DiskCacheStatistics cache_statistics() const;
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -42,9 +53,11 @@ protected:
     u64 m_device_block_size { 512 };
 
 private:
+    virtual bool is_block_based() const override { return true; }
+
     void flush_specific_block_if_needed(BlockIndex index);
 
-    mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+    OwnPtr<DiskCache> m_cache;
 };
 
 }
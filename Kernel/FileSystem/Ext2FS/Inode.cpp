@@ -543,6 +543,35 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     return nread;
 }
 
+ErrorOr<void> Ext2FSInode::read_ahead_locked(off_t offset, size_t count)
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+    if (static_cast<u64>(offset) >= size() || count == 0)
+        return {};
+
+    // Inline symlinks have no blocks to read ahead.
+    if (is_symlink() && size() < max_inline_symlink_length)
+        return {};
+
+    auto const block_size = fs().logical_block_size();
+    auto end_offset = min(static_cast<u64>(offset) + count, size());
+    BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
+    BlockBasedFileSystem::BlockIndex last_block_logical_index = (end_offset - 1) / block_size;
+
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_ahead(): Reading logical blocks {} through {}", identifier(), first_block_logical_index, last_block_logical_index);
+
+    for (auto logical_index = first_block_logical_index; logical_index <= last_block_logical_index; logical_index = logical_index.value() + 1) {
+        auto block_index = TRY(m_block_view.get_block(logical_index));
+        // Holes read as zeroes without touching the disk.
+        if (block_index.value() == 0)
+            continue;
+        // NOTE: Passing no buffer only pulls the block into the disk cache.
+        TRY(fs().read_block(block_index, nullptr, block_size));
+    }
+    return {};
+}
+
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
     VERIFY(m_inode_lock.is_locked());
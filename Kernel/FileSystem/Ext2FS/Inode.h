@@ -45,6 +45,8 @@ private:
     virtual ErrorOr<void> chown(UserID, GroupID) override;
     virtual ErrorOr<void> truncate_locked(u64) override;
     virtual ErrorOr<int> get_block_address(int) override;
+    virtual bool supports_read_ahead() const override { return true; }
+    virtual ErrorOr<void> read_ahead_locked(off_t, size_t) override;
 
     bool is_within_inode_bounds(FlatPtr base, FlatPtr value_offset, size_t value_size) const;
 
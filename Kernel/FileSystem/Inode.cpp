@@ -19,6 +19,7 @@
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
@@ -114,6 +115,18 @@ ErrorOr<size_t> Inode::read_bytes(off_t offset, size_t length, UserOrKernelBuffe
     return read_bytes_locked(offset, length, buffer, open_description);
 }
 
+void Inode::schedule_read_ahead(off_t offset, size_t length)
+{
+    if (!supports_read_ahead())
+        return;
+
+    // NOTE: Read-ahead is best effort. If we can't queue it up, the reader will simply wait for the disk later.
+    [[maybe_unused]] auto result = g_read_ahead_work->try_queue([inode = NonnullRefPtr<Inode> { *this }, offset, length] {
+        MutexLocker locker(inode->m_inode_lock, Mutex::Mode::Shared);
+        [[maybe_unused]] auto result = inode->read_ahead_locked(offset, length);
+    });
+}
+
 ErrorOr<size_t> Inode::read_until_filled_or_end(off_t offset, size_t length, UserOrKernelBuffer buffer, OpenFileDescription* open_description) const
 {
     auto remaining_length = length;
@@ -55,6 +55,9 @@ public:
 
     ErrorOr<size_t> write_bytes(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*);
     ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const;
+
+    // Asynchronously pulls the given range into the file system's caches, if the file system supports it.
+    void schedule_read_ahead(off_t, size_t);
     ErrorOr<size_t> read_until_filled_or_end(off_t, size_t, UserOrKernelBuffer buffer, OpenFileDescription*) const;
     ErrorOr<void> truncate(u64);
 
@@ -124,6 +127,9 @@ protected:
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const = 0;
     virtual ErrorOr<void> truncate_locked(u64) { return {}; }
 
+    virtual bool supports_read_ahead() const { return false; }
+    virtual ErrorOr<void> read_ahead_locked(off_t, size_t) { return {}; }
+
 private:
     ErrorOr<bool> try_apply_flock(Process const&, OpenFileDescription const&, flock const&);
 
@@ -34,6 +34,10 @@ ErrorOr<size_t> InodeFile::read(OpenFileDescription& description, u64 offset, Us
     if (nread > 0) {
         Thread::current()->did_file_read(nread);
         evaluate_block_conditions();
+        if (!description.is_direct()) {
+            if (auto read_ahead = description.did_read(offset, nread, m_inode->size()); read_ahead.has_value())
+                m_inode->schedule_read_ahead(read_ahead->offset, read_ahead->length);
+        }
     }
     return nread;
 }
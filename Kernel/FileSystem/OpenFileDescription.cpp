@@ -498,6 +498,11 @@ bool OpenFileDescription::is_direct() const
     return m_state.with([](auto& state) { return state.direct; });
 }
 
+Optional<ReadAheadRange> OpenFileDescription::did_read(u64 offset, size_t count, u64 file_size)
+{
+    return m_state.with([&](auto& state) { return state.read_ahead.did_access(offset, count, file_size); });
+}
+
 bool OpenFileDescription::is_directory() const
 {
     return m_state.with([](auto& state) { return state.is_directory; });
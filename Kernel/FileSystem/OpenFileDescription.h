@@ -13,6 +13,7 @@
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/ReadAheadState.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/KBuffer.h>
 #include <Kernel/Memory/VirtualAddress.h>
@@ -63,6 +64,9 @@ public:
 
     bool is_direct() const;
 
+    // Records a read of [offset, offset + count) and returns the range to read ahead, if any.
+    Optional<ReadAheadRange> did_read(u64 offset, size_t count, u64 file_size);
+
     bool is_directory() const;
 
     File& file() { return *m_file; }
@@ -157,6 +161,7 @@ private:
         bool should_append : 1 { false };
         bool direct : 1 { false };
         FIFO::Direction fifo_direction : 2 { FIFO::Direction::Neither };
+        ReadAheadState read_ahead { 32 * KiB, 1 * MiB };
     };
 
     RecursiveSpinlockProtected<State, LockRank::None> m_state {};
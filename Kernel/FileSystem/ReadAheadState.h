@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+struct ReadAheadRange {
+    u64 offset { 0 };
+    u64 length { 0 };
+};
+
+// Detects sequential access to a file (or any other linear space) and decides how
+// much to fetch ahead of the reader. The window starts out small and doubles with
+// every read-ahead that gets issued, up to the given maximum. Any non-sequential
+// access resets it. The units are up to the user, they only need to be consistent.
+class ReadAheadState {
+public:
+    constexpr ReadAheadState(u64 minimum_window, u64 maximum_window)
+        : m_minimum_window(minimum_window)
+        , m_maximum_window(maximum_window)
+    {
+    }
+
+    // Call this after every access of [offset, offset + length). If the access pattern
+    // looks sequential, returns the range that should be fetched ahead of time.
+    Optional<ReadAheadRange> did_access(u64 offset, u64 length, u64 end)
+    {
+        auto access_end = offset + length;
+        // NOTE: An access at the very start is treated as the beginning of a new sequential scan.
+        bool is_restart = offset == 0 && m_next_offset != 0;
+        bool is_sequential = offset == m_next_offset || offset == 0;
+        m_next_offset = access_end;
+
+        if (!is_sequential || is_restart) {
+            m_window = 0;
+            m_read_ahead_end = 0;
+            m_last_read_ahead_length = 0;
+            if (!is_sequential)
+                return {};
+        }
+
+        if (m_window == 0)
+            m_window = m_minimum_window;
+
+        // Don't issue more read-ahead until the reader has consumed at least half of what
+        // we fetched last time, so the next chunk still arrives before it's needed.
+        if (m_read_ahead_end > access_end && m_read_ahead_end - access_end > m_last_read_ahead_length / 2)
+            return {};
+
+        auto start = max(access_end, m_read_ahead_end);
+        if (start >= end)
+            return {};
+
+        ReadAheadRange range { start, min(m_window, end - start) };
+        m_read_ahead_end = start + range.length;
+        m_last_read_ahead_length = range.length;
+        m_window = min(m_window * 2, m_maximum_window);
+        return range;
+    }
+
+private:
+    u64 m_minimum_window { 0 };
+    u64 m_maximum_window { 0 };
+    u64 m_next_offset { 0 };
+    u64 m_window { 0 };
+    u64 m_read_ahead_end { 0 };
+    u64 m_last_read_ahead_length { 0 };
+};
+
+}
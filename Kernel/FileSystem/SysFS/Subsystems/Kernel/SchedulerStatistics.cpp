@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/SchedulerStatistics.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Scheduler.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSSchedulerStatistics::SysFSSchedulerStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSSchedulerStatistics> SysFSSchedulerStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSSchedulerStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSSchedulerStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    ErrorOr<void> result; // FIXME: Make this nicer
+    Processor::for_each([&array, &result](Processor& processor) {
+        if (result.is_error())
+            return;
+        result = ([&]() -> ErrorOr<void> {
+            auto statistics = Scheduler::ready_queue_statistics(processor.id());
+            auto obj = TRY(array.add_object());
+            TRY(obj.add("processor"sv, processor.id()));
+            TRY(obj.add("queue_length"sv, statistics.queue_length));
+            TRY(obj.add("enqueued"sv, statistics.enqueued));
+            TRY(obj.add("stolen"sv, statistics.stolen));
+            TRY(obj.add("migrations"sv, statistics.migrations));
+            TRY(obj.finish());
+            return {};
+        })();
+    });
+    TRY(result);
+    TRY(array.finish());
+    return {};
+}
+
+}
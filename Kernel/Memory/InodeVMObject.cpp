@@ -5,7 +5,10 @@
  */
 
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Memory/InodeVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel::Memory {
 
@@ -91,4 +94,60 @@ u32 InodeVMObject::writable_mappings() const
     return count;
 }
 
+void InodeVMObject::did_fault_in_page(size_t page_index)
+{
+    Optional<ReadAheadRange> read_ahead;
+    {
+        SpinlockLocker locker(m_lock);
+        read_ahead = m_page_read_ahead.did_access(page_index, 1, page_count());
+    }
+    if (!read_ahead.has_value())
+        return;
+
+    // NOTE: Read-ahead is best effort. If we can't queue it up, the pages will simply be faulted in one by one.
+    [[maybe_unused]] auto result = g_read_ahead_work->try_queue([vmobject = NonnullRefPtr<InodeVMObject> { *this }, read_ahead = *read_ahead] {
+        vmobject->populate_pages(read_ahead.offset, read_ahead.length);
+    });
+}
+
+void InodeVMObject::populate_pages(size_t first_page_index, size_t count)
+{
+    u8 page_buffer[PAGE_SIZE];
+    auto last_page_index = min(first_page_index + count, page_count());
+
+    for (auto page_index = first_page_index; page_index < last_page_index; ++page_index) {
+        {
+            SpinlockLocker locker(m_lock);
+            if (!m_physical_pages[page_index].is_null())
+                continue;
+        }
+
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
+        auto nread_or_error = inode().read_bytes(page_index * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
+        if (nread_or_error.is_error() || nread_or_error.value() == 0)
+            return;
+        auto nread = nread_or_error.release_value();
+        if (nread < PAGE_SIZE)
+            memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+
+        auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+        if (new_physical_page_or_error.is_error())
+            return;
+        auto new_physical_page = new_physical_page_or_error.release_value();
+        {
+            InterruptDisabler disabler;
+            u8* dest_ptr = MM.quickmap_page(*new_physical_page);
+            memcpy(dest_ptr, page_buffer, PAGE_SIZE);
+            // We don't know whether this page will end up being mapped executable, so synchronize just in case.
+            Processor::flush_instruction_cache(VirtualAddress { dest_ptr }, PAGE_SIZE);
+            MM.unquickmap_page();
+        }
+
+        // The page is not mapped anywhere yet. The next fault on it will find it and simply remap.
+        SpinlockLocker locker(m_lock);
+        if (m_physical_pages[page_index].is_null())
+            m_physical_pages[page_index] = move(new_physical_page);
+    }
+}
+
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Bitmap.h>
+#include <Kernel/FileSystem/ReadAheadState.h>
 #include <Kernel/Memory/VMObject.h>
 #include <Kernel/UnixTypes.h>
 
@@ -30,6 +31,9 @@ public:
 
     u32 writable_mappings() const;
 
+    // Called after a page fault read in the given page. Sequential faults cause upcoming pages to be read in ahead of time.
+    void did_fault_in_page(size_t page_index);
+
 protected:
     explicit InodeVMObject(Inode&, FixedArray<RefPtr<PhysicalRAMPage>>&&, Bitmap dirty_pages);
     explicit InodeVMObject(InodeVMObject const&, FixedArray<RefPtr<PhysicalRAMPage>>&&, Bitmap dirty_pages);
@@ -40,8 +44,11 @@ protected:
 
     virtual bool is_inode() const final { return true; }
 
+    void populate_pages(size_t first_page_index, size_t count);
+
     NonnullRefPtr<Inode> const m_inode;
     Bitmap m_dirty_pages;
+    ReadAheadState m_page_read_ahead { 4, 64 };
 };
 
 }
@@ -573,6 +573,7 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
     auto& physical_page_slot = inode_vmobject.physical_pages()[page_index_in_vmobject];
 
+    bool page_was_already_present = false;
     {
         // NOTE: The VMObject lock is required when manipulating the VMObject's physical page slot.
         SpinlockLocker locker(inode_vmobject.m_lock);
@@ -583,10 +584,16 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
                 inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
             if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot))
                 return PageFaultResponse::OutOfMemory;
-            return PageFaultResponse::Continue;
+            page_was_already_present = true;
         }
     }
 
+    if (page_was_already_present) {
+        // NOTE: This may well be a page that was read ahead, so keep the sequential access detection in the loop.
+        inode_vmobject.did_fault_in_page(page_index_in_vmobject);
+        return PageFaultResponse::Continue;
+    }
+
     dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}", name(), page_index_in_region);
 
     auto current_thread = Thread::current();
@@ -653,8 +660,10 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
             inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
         if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot))
             return PageFaultResponse::OutOfMemory;
-        return PageFaultResponse::Continue;
     }
+
+    inode_vmobject.did_fault_in_page(page_index_in_vmobject);
+    return PageFaultResponse::Continue;
 }
 
 PageFaultResponse Region::handle_dirty_on_write_fault(size_t page_index_in_region)
@@ -46,7 +46,25 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<RecursiveSpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// Each processor owns a set of ready queues, so that picking the next thread and
+// queueing up a woken thread only contend with processors touching the same queues.
+// Processors that run out of work steal runnable threads from their peers.
+struct ProcessorReadyQueues {
+    RecursiveSpinlockProtected<ThreadReadyQueues, LockRank::None> ready_queues {};
+
+    // These are only updated while holding the ready queues lock, but may be read
+    // without it (e.g. when looking for the least loaded processor).
+    Atomic<u32> length { 0 };
+    Atomic<u64> enqueued { 0 };
+    Atomic<u64> stolen { 0 };
+    Atomic<u64> migrations { 0 };
+};
+
+static Singleton<Array<ProcessorReadyQueues, MAX_CPU_COUNT>> g_ready_queues;
+
+// A thread only gets moved away from the processor it last ran on (and whose caches
+// are probably still warm) if another eligible processor has this many fewer threads queued.
+static constexpr u32 migration_imbalance_threshold = 2;
 
 static RecursiveSpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -55,7 +73,7 @@ static void dump_thread_list(bool = false);
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into ThreadReadyQueues::queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -64,73 +82,145 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static u32 ready_queue_count()
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
+    // NOTE: Processor::count() is not maintained on every architecture, but those
+    //       only bring up a single processor anyway.
+    return clamp(Processor::count(), 1u, static_cast<u32>(MAX_CPU_COUNT));
+}
+
+Thread* Scheduler::first_runnable_thread(ThreadReadyQueues& ready_queues, u32 affinity_mask)
+{
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            VERIFY(thread.m_runnable_priority == (int)priority);
+            if (thread.is_active())
+                continue;
+            if (!(thread.affinity() & affinity_mask))
+                continue;
+            return &thread;
         }
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
+}
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
+void Scheduler::remove_runnable_thread(ProcessorReadyQueues& processor_queues, ThreadReadyQueues& ready_queues, Thread& thread)
+{
+    auto priority = thread.m_runnable_priority;
+    VERIFY(priority >= 0);
+    VERIFY(ready_queues.mask & (1u << priority));
+    auto& ready_queue = ready_queues.queues[priority];
+    thread.m_runnable_priority = -1;
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty())
+        ready_queues.mask &= ~(1u << priority);
+    processor_queues.length.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+Thread* Scheduler::take_runnable_thread_from(ProcessorReadyQueues& processor_queues, u32 affinity_mask)
+{
+    return processor_queues.ready_queues.with([&](auto& ready_queues) -> Thread* {
+        auto* thread = first_runnable_thread(ready_queues, affinity_mask);
+        if (!thread)
+            return nullptr;
+        remove_runnable_thread(processor_queues, ready_queues, *thread);
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread->set_active(true);
+        return thread;
     });
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+Thread* Scheduler::steal_runnable_thread(u32 processor_id)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
+    // Start looking at the processor after us, so that processors going idle at
+    // the same time don't all descend on the same victim.
+    auto affinity_mask = 1u << processor_id;
+    auto queue_count = ready_queue_count();
+    for (u32 i = 1; i < queue_count; ++i) {
+        auto victim_id = (processor_id + i) % queue_count;
+        auto& victim_queues = g_ready_queues->at(victim_id);
+        if (victim_queues.length.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+            continue;
+        if (auto* thread = take_runnable_thread_from(victim_queues, affinity_mask)) {
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", processor_id, *thread, victim_id);
+            g_ready_queues->at(processor_id).stolen.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            return thread;
         }
+    }
+    return nullptr;
+}
+
+u32 Scheduler::select_processor_for(Thread const& thread)
+{
+    auto affinity = thread.affinity();
+    auto queue_count = ready_queue_count();
+    auto queue_length = [&](u32 processor_id) {
+        return g_ready_queues->at(processor_id).length.load(AK::MemoryOrder::memory_order_relaxed);
+    };
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
-        return nullptr;
+    Optional<u32> selected_processor;
+    auto last_processor = thread.cpu();
+    if (last_processor < queue_count && (affinity & (1u << last_processor)))
+        selected_processor = last_processor;
+
+    for (u32 processor_id = 0; processor_id < queue_count; ++processor_id) {
+        if (!(affinity & (1u << processor_id)))
+            continue;
+        if (!selected_processor.has_value()) {
+            selected_processor = processor_id;
+            continue;
+        }
+        if (queue_length(processor_id) + migration_imbalance_threshold <= queue_length(*selected_processor))
+            selected_processor = processor_id;
+    }
+
+    // If the affinity mask doesn't contain any processor that is up (yet), fall
+    // back to the current processor. Nobody will be able to steal the thread, so
+    // it will only run once it is allowed to.
+    return selected_processor.value_or(Processor::current_id());
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto processor_id = Processor::current_id();
+    auto affinity_mask = 1u << processor_id;
+
+    auto* thread = take_runnable_thread_from(g_ready_queues->at(processor_id), affinity_mask);
+    if (!thread)
+        thread = steal_runnable_thread(processor_id);
+    if (thread)
+        return *thread;
+
+    auto* idle_thread = Processor::idle_thread();
+    idle_thread->set_active(true);
+    return *idle_thread;
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    auto processor_id = Processor::current_id();
+    auto affinity_mask = 1u << processor_id;
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled. Threads queued on other processors are left to their
+    // owners (or to idle processors stealing them).
+    return g_ready_queues->at(processor_id).ready_queues.with([&](auto& ready_queues) {
+        return first_runnable_thread(ready_queues, affinity_mask);
     });
 }
 
@@ -139,43 +229,58 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
-            VERIFY(!thread.m_ready_queue_node.is_in_list());
-            return false;
-        }
-
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
+    if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
+        return false;
 
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
-        return true;
-    });
+    // The thread's queue position is only stable while holding the lock of the queues it was put on, as
+    // another processor may be taking it off them right now.
+    for (;;) {
+        auto processor_id = thread.m_runnable_processor.load(AK::MemoryOrder::memory_order_acquire);
+        auto& processor_queues = g_ready_queues->at(processor_id);
+        auto dequeued = processor_queues.ready_queues.with([&](auto& ready_queues) -> Optional<bool> {
+            if (thread.m_runnable_processor.load(AK::MemoryOrder::memory_order_relaxed) != processor_id)
+                return {};
+            if (thread.m_runnable_priority < 0) {
+                VERIFY(!thread.m_ready_queue_node.is_in_list());
+                return false;
+            }
+            remove_runnable_thread(processor_queues, ready_queues, thread);
+            return true;
+        });
+        if (dequeued.has_value())
+            return *dequeued;
+    }
 }
 
 void Scheduler::enqueue_runnable_thread(Thread& thread)
 {
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    auto processor_id = select_processor_for(thread);
+    auto& processor_queues = g_ready_queues->at(processor_id);
 
-    g_ready_queues->with([&](auto& ready_queues) {
+    processor_queues.ready_queues.with([&](auto& ready_queues) {
         VERIFY(thread.m_runnable_priority < 0);
         thread.m_runnable_priority = (int)priority;
+        thread.m_runnable_processor.store(processor_id, AK::MemoryOrder::memory_order_release);
         VERIFY(!thread.m_ready_queue_node.is_in_list());
         auto& ready_queue = ready_queues.queues[priority];
         bool was_empty = ready_queue.thread_list.is_empty();
         ready_queue.thread_list.append(thread);
         if (was_empty)
             ready_queues.mask |= (1u << priority);
+        processor_queues.length.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
     });
+
+    processor_queues.enqueued.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    if (thread.times_scheduled() > 0 && thread.cpu() != processor_id)
+        processor_queues.migrations.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+
+    // If the processor we picked is idle, make sure it notices the new thread right away. Otherwise it may be
+    // a while until it looks at its queues again, so let an idle peer steal the thread instead.
+    if (!Processor::smp_wake_idle_processor(processor_id))
+        Processor::smp_wake_n_idle_processors(1);
 }
 
 UNMAP_AFTER_INIT void Scheduler::start()
@@ -217,26 +322,36 @@ void Scheduler::pick_next()
             Processor::set_current_in_scheduler(false);
         });
 
-    SpinlockLocker lock(g_scheduler_lock);
-
     if constexpr (SCHEDULER_RUNNABLE_DEBUG) {
+        SpinlockLocker lock(g_scheduler_lock);
         dump_thread_list();
     }
 
-    auto& thread_to_schedule = pull_next_runnable_thread();
+    // Taking a thread off the ready queues only needs their own locks, but switching to it needs the scheduler lock.
+    // The thread may have been stopped, blocked or killed in between, in which case we have to pick another one. It
+    // is queued up again once it becomes runnable.
+    auto* thread_to_schedule = &pull_next_runnable_thread();
+    SpinlockLocker lock(g_scheduler_lock);
+    while (!thread_to_schedule->is_idle_thread() && thread_to_schedule->state() != Thread::State::Runnable) {
+        thread_to_schedule->set_active(false);
+        lock.unlock();
+        thread_to_schedule = &pull_next_runnable_thread();
+        lock.lock();
+    }
+
     if constexpr (SCHEDULER_DEBUG) {
         dbgln("Scheduler[{}]: Switch to {} @ {:p}",
             Processor::current_id(),
-            thread_to_schedule,
-            thread_to_schedule.regs().ip());
+            *thread_to_schedule,
+            thread_to_schedule->regs().ip());
     }
 
     // We need to leave our first critical section before switching context,
     // but since we're still holding the scheduler lock we're still in a critical section
     critical.leave();
 
-    thread_to_schedule.set_ticks_left(time_slice_for(thread_to_schedule));
-    context_switch(&thread_to_schedule);
+    thread_to_schedule->set_ticks_left(time_slice_for(*thread_to_schedule));
+    context_switch(thread_to_schedule);
 }
 
 void Scheduler::yield()
@@ -507,6 +622,18 @@ TotalTimeScheduled Scheduler::get_total_time_scheduled()
     return g_total_time_scheduled.with([&](auto& total_time_scheduled) { return total_time_scheduled; });
 }
 
+ReadyQueueStatistics Scheduler::ready_queue_statistics(u32 processor_id)
+{
+    VERIFY(processor_id < MAX_CPU_COUNT);
+    auto& processor_queues = g_ready_queues->at(processor_id);
+    return {
+        .queue_length = processor_queues.length.load(AK::MemoryOrder::memory_order_relaxed),
+        .enqueued = processor_queues.enqueued.load(AK::MemoryOrder::memory_order_relaxed),
+        .stolen = processor_queues.stolen.load(AK::MemoryOrder::memory_order_relaxed),
+        .migrations = processor_queues.migrations.load(AK::MemoryOrder::memory_order_relaxed),
+    };
+}
+
 void dump_thread_list(bool with_stack_traces)
 {
     dbgln("Scheduler thread list for processor {}:", Processor::current_id());
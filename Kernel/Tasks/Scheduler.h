@@ -18,6 +18,8 @@
 namespace Kernel {
 
 struct RegisterState;
+struct ThreadReadyQueues;
+struct ProcessorReadyQueues;
 
 extern Thread* g_finalizer;
 extern WaitQueue* g_finalizer_wait_queue;
@@ -29,6 +31,13 @@ struct TotalTimeScheduled {
     u64 total_kernel { 0 };
 };
 
+struct ReadyQueueStatistics {
+    u32 queue_length { 0 };
+    u64 enqueued { 0 };
+    u64 stolen { 0 };
+    u64 migrations { 0 };
+};
+
 class Scheduler {
 public:
     static void initialize();
@@ -55,6 +64,14 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+    static ReadyQueueStatistics ready_queue_statistics(u32 processor_id);
+
+private:
+    static Thread* first_runnable_thread(ThreadReadyQueues&, u32 affinity_mask);
+    static void remove_runnable_thread(ProcessorReadyQueues&, ThreadReadyQueues&, Thread&);
+    static Thread* take_runnable_thread_from(ProcessorReadyQueues&, u32 affinity_mask);
+    static Thread* steal_runnable_thread(u32 processor_id);
+    static u32 select_processor_for(Thread const&);
 };
 
 }
@@ -1094,6 +1094,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    Atomic<u32> m_runnable_processor { 0 };
 
     friend class WaitQueue;
 
@@ -427,6 +427,29 @@ TEST_CASE(find_copy_in_seekback)
     }
 }
 
+TEST_CASE(copy_from_seekback_overlapping)
+{
+    auto circular_buffer = MUST(CircularBuffer::create_empty(16));
+    EXPECT_EQ(circular_buffer.write("abc"sv.bytes()), 3ul);
+
+    // A distance shorter than the length repeats the last `distance` bytes.
+    EXPECT_EQ(TRY_OR_FAIL(circular_buffer.copy_from_seekback(3, 7)), 7ul);
+    // A distance of one repeats a single byte.
+    EXPECT_EQ(TRY_OR_FAIL(circular_buffer.copy_from_seekback(1, 2)), 2ul);
+
+    Array<u8, 12> result {};
+    EXPECT_EQ(circular_buffer.read(result).size(), 12ul);
+    EXPECT_EQ(StringView { result.span() }, "abcabcabcaaa"sv);
+
+    // Now the same again, but with the copies wrapping around the end of the buffer.
+    EXPECT_EQ(circular_buffer.write("xyz"sv.bytes()), 3ul);
+    EXPECT_EQ(TRY_OR_FAIL(circular_buffer.copy_from_seekback(2, 5)), 5ul);
+    EXPECT_EQ(TRY_OR_FAIL(circular_buffer.copy_from_seekback(8, 4)), 4ul);
+
+    EXPECT_EQ(circular_buffer.read(result).size(), 12ul);
+    EXPECT_EQ(StringView { result.span() }, "xyzyzyzyxyzy"sv);
+}
+
 BENCHMARK_CASE(looping_copy_from_seekback)
 {
     auto circular_buffer = MUST(CircularBuffer::create_empty(16 * MiB));
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr auto TEST_FILE_PATH = "/home/anon/.read_ahead_test";
+static constexpr size_t TEST_FILE_SIZE = 16 * MiB;
+static constexpr size_t CHUNK_SIZE = 4 * KiB;
+
+static u8 expected_byte_at(size_t offset)
+{
+    return static_cast<u8>((offset * 31) ^ (offset >> 12));
+}
+
+static int create_test_file()
+{
+    int fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd != -1);
+
+    u8 buffer[CHUNK_SIZE];
+    for (size_t offset = 0; offset < TEST_FILE_SIZE; offset += CHUNK_SIZE) {
+        for (size_t i = 0; i < CHUNK_SIZE; ++i)
+            buffer[i] = expected_byte_at(offset + i);
+        VERIFY(write(fd, buffer, CHUNK_SIZE) == CHUNK_SIZE);
+    }
+    VERIFY(fsync(fd) == 0);
+    VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+    return fd;
+}
+
+static bool chunk_matches(u8 const* buffer, size_t offset, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        if (buffer[i] != expected_byte_at(offset + i))
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE(sequential_and_random_reads_return_file_contents)
+{
+    int fd = create_test_file();
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    u8 buffer[CHUNK_SIZE];
+    for (size_t offset = 0; offset < TEST_FILE_SIZE; offset += CHUNK_SIZE) {
+        EXPECT_EQ(read(fd, buffer, CHUNK_SIZE), static_cast<ssize_t>(CHUNK_SIZE));
+        EXPECT(chunk_matches(buffer, offset, CHUNK_SIZE));
+    }
+    EXPECT_EQ(read(fd, buffer, CHUNK_SIZE), 0);
+
+    // Jump around to make sure a broken sequential streak never hands back stale data.
+    for (size_t i = 0; i < 64; ++i) {
+        size_t offset = ((i * 7919) % (TEST_FILE_SIZE / CHUNK_SIZE)) * CHUNK_SIZE + (i % 17);
+        size_t length = min(CHUNK_SIZE, TEST_FILE_SIZE - offset);
+        EXPECT_EQ(pread(fd, buffer, length, offset), static_cast<ssize_t>(length));
+        EXPECT(chunk_matches(buffer, offset, length));
+    }
+}
+
+TEST_CASE(sequential_mmap_faults_return_file_contents)
+{
+    int fd = create_test_file();
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    auto* mapping = static_cast<u8*>(mmap(nullptr, TEST_FILE_SIZE, PROT_READ, MAP_SHARED, fd, 0));
+    VERIFY(mapping != MAP_FAILED);
+    auto unmap_guard = ScopeGuard([&] {
+        munmap(mapping, TEST_FILE_SIZE);
+    });
+
+    for (size_t offset = 0; offset < TEST_FILE_SIZE; offset += PAGE_SIZE)
+        EXPECT(chunk_matches(mapping + offset, offset, PAGE_SIZE));
+}
+
+BENCHMARK_CASE(sequential_read_throughput)
+{
+    int fd = create_test_file();
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    u8 buffer[CHUNK_SIZE];
+    for (size_t pass = 0; pass < 4; ++pass) {
+        VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+        size_t total = 0;
+        while (auto nread = read(fd, buffer, CHUNK_SIZE)) {
+            VERIFY(nread > 0);
+            total += nread;
+        }
+        EXPECT_EQ(total, TEST_FILE_SIZE);
+    }
+}
+
+BENCHMARK_CASE(sequential_mmap_throughput)
+{
+    int fd = create_test_file();
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    for (size_t pass = 0; pass < 4; ++pass) {
+        auto* mapping = static_cast<u8 volatile*>(mmap(nullptr, TEST_FILE_SIZE, PROT_READ, MAP_PRIVATE, fd, 0));
+        VERIFY(mapping != MAP_FAILED);
+        u32 checksum = 0;
+        for (size_t offset = 0; offset < TEST_FILE_SIZE; offset += PAGE_SIZE)
+            checksum += mapping[offset];
+        (void)checksum;
+        munmap(const_cast<u8*>(mapping), TEST_FILE_SIZE);
+    }
+}
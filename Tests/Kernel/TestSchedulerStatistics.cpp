@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/Vector.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+#include <sched.h>
+
+struct SchedulerTotals {
+    u64 enqueued { 0 };
+    u64 stolen { 0 };
+    u64 migrations { 0 };
+};
+
+static JsonArray read_scheduler_statistics()
+{
+    auto file = MUST(Core::File::open("/sys/kernel/scheduler"sv, Core::File::OpenMode::Read));
+    auto contents = MUST(file->read_until_eof());
+    auto json = MUST(JsonValue::from_string(contents));
+    VERIFY(json.is_array());
+    return json.as_array();
+}
+
+static SchedulerTotals read_scheduler_totals()
+{
+    SchedulerTotals totals;
+    read_scheduler_statistics().for_each([&](JsonValue const& value) {
+        auto const& processor = value.as_object();
+        totals.enqueued += processor.get_u64("enqueued"sv).value_or(0);
+        totals.stolen += processor.get_u64("stolen"sv).value_or(0);
+        totals.migrations += processor.get_u64("migrations"sv).value_or(0);
+    });
+    return totals;
+}
+
+TEST_CASE(scheduler_statistics_cover_every_processor)
+{
+    auto statistics = read_scheduler_statistics();
+    EXPECT(statistics.size() > 0);
+
+    for (size_t i = 0; i < statistics.size(); ++i) {
+        auto const& processor = statistics.at(i).as_object();
+        EXPECT_EQ(processor.get_u32("processor"sv), static_cast<u32>(i));
+        EXPECT(processor.get_u32("queue_length"sv).has_value());
+        EXPECT(processor.get_u64("enqueued"sv).has_value());
+        EXPECT(processor.get_u64("stolen"sv).has_value());
+        EXPECT(processor.get_u64("migrations"sv).has_value());
+    }
+}
+
+static void* yield_repeatedly(void*)
+{
+    for (size_t i = 0; i < 10'000; ++i)
+        sched_yield();
+    return nullptr;
+}
+
+BENCHMARK_CASE(many_threads_yielding)
+{
+    static constexpr size_t thread_count = 64;
+
+    auto before = read_scheduler_totals();
+
+    Vector<pthread_t, thread_count> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+        pthread_t thread;
+        EXPECT_EQ(pthread_create(&thread, nullptr, yield_repeatedly, nullptr), 0);
+        threads.append(thread);
+    }
+    for (auto thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    auto after = read_scheduler_totals();
+    EXPECT(after.enqueued >= before.enqueued);
+
+    warnln("Scheduler: {} threads enqueued, {} stolen by idle processors, {} migrated",
+        after.enqueued - before.enqueued,
+        after.stolen - before.stolen,
+        after.migrations - before.migrations);
+}
@@ -156,6 +156,64 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed == original);
 }
 
+static ByteBuffer generate_text_corpus(size_t size)
+{
+    // Something that looks like natural language text: a small vocabulary with a skewed distribution, so that we get
+    // plenty of short literal codes as well as back-references of all kinds of lengths and distances.
+    static constexpr Array words { "the"sv, "of"sv, "and"sv, "a"sv, "to"sv, "in"sv, "is"sv, "you"sv, "that"sv, "it"sv,
+        "compression"sv, "huffman"sv, "literal"sv, "distance"sv, "window"sv, "buffer"sv, "symbol"sv, "serenity"sv };
+
+    auto corpus = ByteBuffer::create_uninitialized(size).release_value();
+    size_t offset = 0;
+    while (offset < size) {
+        // Squaring a uniform value favors the first (shorter) words.
+        auto pick = get_random_uniform(words.size());
+        auto word = words[(pick * pick) / words.size()];
+        auto length = min(word.length(), size - offset);
+        memcpy(corpus.data() + offset, word.characters_without_null_termination(), length);
+        offset += length;
+        if (offset < size)
+            corpus[offset++] = get_random_uniform(12) == 0 ? '\n' : ' ';
+    }
+    return corpus;
+}
+
+TEST_CASE(deflate_round_trip_text)
+{
+    auto original = generate_text_corpus(256 * KiB);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST));
+    EXPECT(compressed.size() < original.size() / 2);
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
+TEST_CASE(deflate_round_trip_long_codes)
+{
+    // A very skewed distribution of byte values gives the rare ones codes that are longer than what fits into the
+    // decoder's lookup table.
+    auto original = ByteBuffer::create_uninitialized(64 * KiB).release_value();
+    for (auto& byte : original.bytes()) {
+        u8 value = 0;
+        while (value < 255 && get_random_uniform(2) == 0)
+            ++value;
+        byte = value;
+    }
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST));
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
+BENCHMARK_CASE(deflate_decompress_text)
+{
+    auto original = generate_text_corpus(4 * MiB);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::GOOD));
+
+    for (size_t i = 0; i < 10; ++i) {
+        auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+        EXPECT_EQ(uncompressed.size(), original.size());
+    }
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
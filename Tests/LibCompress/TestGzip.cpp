@@ -94,6 +94,50 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed == original);
 }
 
+static ByteBuffer make_compressible_input(size_t size)
+{
+    auto input = ByteBuffer::create_uninitialized(size).release_value();
+    for (size_t i = 0; i < size; ++i)
+        input[i] = "the quick brown fox jumps over the lazy dog "sv[i % 44] ^ (get_random_uniform(64) == 0 ? 0x20 : 0);
+    return input;
+}
+
+TEST_CASE(gzip_round_trip_parallel)
+{
+    // One byte more than a multiple of the chunk size, so the last chunk is tiny.
+    auto original = make_compressible_input(5 * Compress::GzipCompressor::parallel_chunk_size + 1);
+
+    auto compressed = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original, 4));
+    auto uncompressed = TRY_OR_FAIL(Compress::GzipDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+
+    // Apart from the sync flush markers between the chunks, the output should be the same as with a single thread.
+    auto compressed_on_one_thread = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original));
+    EXPECT(compressed.size() <= compressed_on_one_thread.size() + 5 * 5);
+}
+
+TEST_CASE(gzip_round_trip_parallel_small_input)
+{
+    auto original = make_compressible_input(1000);
+    auto compressed = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original, 4));
+    auto uncompressed = TRY_OR_FAIL(Compress::GzipDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
+BENCHMARK_CASE(gzip_compress_single_thread)
+{
+    auto original = make_compressible_input(16 * MiB);
+    auto compressed = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original));
+    EXPECT(compressed.size() < original.size());
+}
+
+BENCHMARK_CASE(gzip_compress_parallel)
+{
+    auto original = make_compressible_input(16 * MiB);
+    auto compressed = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original, 8));
+    EXPECT(compressed.size() < original.size());
+}
+
 TEST_CASE(gzip_truncated_uncompressed_block)
 {
     Array<u8, 38> const compressed {
@@ -412,6 +412,38 @@ TEST_CASE(test_AES_GCM_128bit_encrypt_with_aad)
     EXPECT(memcmp(result_tag, tag.data(), tag.size()) == 0);
 }
 
+TEST_CASE(test_AES_GCM_round_trip_long_messages)
+{
+    Crypto::Cipher::AESCipher::GCMMode cipher("\xfe\xff\xe9\x92\x86\x65\x73\x1c\x6d\x6a\x8f\x94\x67\x30\x83\x08"_b, 128, Crypto::Cipher::Intent::Encryption);
+    auto iv = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad\xde\xca\xf8\x88\x00\x00\x00\x00"_b;
+    auto aad = "additional authenticated data"_b;
+
+    // Sizes around the multiples of the block size, of the number of blocks encrypted and hashed at once, and of the
+    // chunks that GCM processes at a time.
+    for (size_t size : { 1ul, 15ul, 16ul, 17ul, 127ul, 128ul, 129ul, 1023ul, 1024ul, 1025ul, 5000ul }) {
+        auto plaintext = MUST(ByteBuffer::create_uninitialized(size));
+        fill_with_random(plaintext);
+
+        auto ciphertext = MUST(ByteBuffer::create_uninitialized(size));
+        auto tag = MUST(ByteBuffer::create_uninitialized(16));
+        cipher.encrypt(plaintext, ciphertext.bytes(), iv, aad, tag);
+
+        // Encrypting in place has to give the same result.
+        auto in_place = MUST(ByteBuffer::copy(plaintext));
+        auto in_place_tag = MUST(ByteBuffer::create_uninitialized(16));
+        cipher.encrypt(in_place, in_place.bytes(), iv, aad, in_place_tag);
+        EXPECT_EQ(in_place, ciphertext);
+        EXPECT_EQ(in_place_tag, tag);
+
+        auto decrypted = MUST(ByteBuffer::create_uninitialized(size));
+        EXPECT_EQ(cipher.decrypt(ciphertext, decrypted.bytes(), iv, aad, tag), Crypto::VerificationConsistency::Consistent);
+        EXPECT_EQ(decrypted, plaintext);
+
+        ciphertext[size - 1] ^= 1;
+        EXPECT_EQ(cipher.decrypt(ciphertext, decrypted.bytes(), iv, aad, tag), Crypto::VerificationConsistency::Inconsistent);
+    }
+}
+
 TEST_CASE(test_AES_GCM_128bit_decrypt_empty)
 {
     Crypto::Cipher::AESCipher::GCMMode cipher("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"_b, 128, Crypto::Cipher::Intent::Encryption);
@@ -201,6 +201,26 @@ TEST_CASE(test_unsigned_bigint_multiplication_with_big_numbers2)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_unsigned_bigint_multiplication_with_huge_numbers)
+{
+    // Large enough to be split up a few times.
+    Crypto::UnsignedBigInteger num1 = bigint_fibonacci(9000);
+    Crypto::UnsignedBigInteger num2 = bigint_fibonacci(4000);
+    Crypto::UnsignedBigInteger num3 = bigint_fibonacci(700);
+
+    for (auto const* other : { &num2, &num3 }) {
+        auto product = num1.multiplied_by(*other);
+        auto division_result = product.divided_by(*other);
+        EXPECT_EQ(division_result.quotient, num1);
+        EXPECT_EQ(division_result.remainder, 0u);
+    }
+
+    // Squares take their own path.
+    auto copy_of_num1 = num1;
+    EXPECT_EQ(num1.multiplied_by(num1), num1.multiplied_by(copy_of_num1));
+    EXPECT_EQ(num1.multiplied_by(num1).divided_by(num1).quotient, num1);
+}
+
 TEST_CASE(test_unsigned_bigint_simple_division)
 {
     Crypto::UnsignedBigInteger num1(27194);
@@ -335,6 +355,24 @@ TEST_CASE(test_bigint_modular_power_extra_tests)
     }
 }
 
+TEST_CASE(test_bigint_modular_power_with_large_odd_modulo)
+{
+    // Moduli on both sides of the 4096-bit limit of the fixed-size implementation.
+    for (size_t modulo_index : { 3001, 5900, 6001 }) {
+        Crypto::UnsignedBigInteger modulo = bigint_fibonacci(modulo_index);
+        EXPECT(modulo.is_odd());
+        Crypto::UnsignedBigInteger base = bigint_fibonacci(modulo_index - 3);
+        Crypto::UnsignedBigInteger exponent1 = bigint_fibonacci(100);
+        Crypto::UnsignedBigInteger exponent2 = bigint_fibonacci(90);
+
+        // b^(e1 + e2) == b^e1 * b^e2 (mod m)
+        auto power1 = Crypto::NumberTheory::ModularPower(base, exponent1, modulo);
+        auto power2 = Crypto::NumberTheory::ModularPower(base, exponent2, modulo);
+        auto expected = Crypto::NumberTheory::Mod(power1.multiplied_by(power2), modulo);
+        EXPECT_EQ(Crypto::NumberTheory::ModularPower(base, exponent1.plus(exponent2), modulo), expected);
+    }
+}
+
 TEST_CASE(test_bigint_primality_test)
 {
     struct {
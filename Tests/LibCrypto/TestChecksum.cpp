@@ -9,6 +9,15 @@
 #include <LibCrypto/Checksum/cksum.h>
 #include <LibTest/TestCase.h>
 
+// Long enough for the vectorized implementations, and to need several modulo reductions in Adler-32.
+static ByteBuffer generate_long_input(u8 fill = 0)
+{
+    auto input = MUST(ByteBuffer::create_uninitialized(20000));
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = fill != 0 ? fill : static_cast<u8>((i * i * 31 + i * 7 + 3) >> 3);
+    return input;
+}
+
 TEST_CASE(test_adler32)
 {
     auto do_test = [](ReadonlyBytes input, u32 expected_result) {
@@ -21,6 +30,24 @@ TEST_CASE(test_adler32)
     do_test("abc"sv.bytes(), 0x024d0127);
     do_test("message digest"sv.bytes(), 0x29750586);
     do_test("abcdefghijklmnopqrstuvwxyz"sv.bytes(), 0x90860b20);
+
+    auto long_input = generate_long_input();
+    do_test(long_input, 0xac42e913);
+    do_test(long_input.bytes().slice(3, 19987), 0xf40fe38a);
+    do_test(generate_long_input(0xff), 0x9f51d664);
+}
+
+TEST_CASE(test_adler32_split_input)
+{
+    auto input = generate_long_input();
+    auto expected = Crypto::Checksum::Adler32(input).digest();
+
+    for (size_t split = 0; split < 200; split += 7) {
+        Crypto::Checksum::Adler32 adler32;
+        adler32.update(input.bytes().trim(split));
+        adler32.update(input.bytes().slice(split));
+        EXPECT_EQ(adler32.digest(), expected);
+    }
 }
 
 TEST_CASE(test_cksum)
@@ -62,4 +89,34 @@ TEST_CASE(test_crc32)
     do_test(""sv.bytes(), 0x0);
     do_test("The quick brown fox jumps over the lazy dog"sv.bytes(), 0x414FA339);
     do_test("various CRC algorithms input data"sv.bytes(), 0x9BD366AE);
+
+    auto long_input = generate_long_input();
+    do_test(long_input, 0x9f510fbe);
+    do_test(long_input.bytes().slice(3, 19987), 0x90582554);
+    do_test(generate_long_input(0xff), 0xc16d1f09);
+}
+
+TEST_CASE(test_crc32_split_input)
+{
+    auto input = generate_long_input();
+    auto expected = Crypto::Checksum::CRC32(input).digest();
+
+    for (size_t split = 0; split < 200; split += 7) {
+        Crypto::Checksum::CRC32 crc32;
+        crc32.update(input.bytes().trim(split));
+        crc32.update(input.bytes().slice(split));
+        EXPECT_EQ(crc32.digest(), expected);
+    }
+}
+
+TEST_CASE(test_crc32_combine)
+{
+    auto input = "The quick brown fox jumps over the lazy dog"sv.bytes();
+    auto expected = Crypto::Checksum::CRC32(input).digest();
+
+    for (size_t split = 0; split <= input.size(); ++split) {
+        auto first = Crypto::Checksum::CRC32(input.trim(split)).digest();
+        auto second = Crypto::Checksum::CRC32(input.slice(split)).digest();
+        EXPECT_EQ(Crypto::Checksum::CRC32::combine(first, second, input.size() - split), expected);
+    }
 }
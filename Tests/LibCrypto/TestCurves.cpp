@@ -8,6 +8,7 @@
 #include <LibCrypto/Curves/SECPxxxr1.h>
 #include <LibCrypto/Curves/X25519.h>
 #include <LibCrypto/Curves/X448.h>
+#include <LibCrypto/Hash/SHA2.h>
 #include <LibTest/TestCase.h>
 
 TEST_CASE(test_x25519)
@@ -306,3 +307,69 @@ TEST_CASE(test_secp384r1)
     auto generated_public = MUST(curve.generate_public_key(private_key));
     EXPECT_EQ(expected_public_key.span(), generated_public);
 }
+
+TEST_CASE(test_secp256r1_verify)
+{
+    // clang-format off
+    Array<u8, 65> public_key {
+        0x04, 0xb0, 0xa1, 0xf5, 0x8f, 0xe3, 0xe9, 0x91, 0xc5, 0x6f, 0xb5, 0x40, 0x53, 0xde, 0xd0, 0x0c,
+        0xba, 0x1f, 0x1c, 0xae, 0xf9, 0x1b, 0x10, 0x09, 0xf2, 0xb3, 0x7d, 0xcf, 0x58, 0xbc, 0xa5, 0x19,
+        0x35, 0x9d, 0x24, 0x09, 0x05, 0xa3, 0xe6, 0xeb, 0x0b, 0x75, 0xbb, 0x66, 0x9c, 0x3a, 0x22, 0x38,
+        0xd2, 0x44, 0x87, 0x25, 0x8e, 0x4d, 0xca, 0x01, 0x96, 0xca, 0x19, 0x17, 0xa6, 0x0a, 0xb6, 0x03,
+        0xfc,
+    };
+    Array<u8, 70> signature {
+        0x30, 0x44, 0x02, 0x20, 0x46, 0xec, 0xcb, 0xe9, 0xfa, 0x9b, 0x95, 0x7f, 0x1a, 0x33, 0x8c, 0x34,
+        0x1e, 0x52, 0x94, 0x80, 0x45, 0x3f, 0x04, 0xf7, 0x42, 0xbf, 0x4a, 0xf2, 0x71, 0xc2, 0x81, 0x97,
+        0x31, 0x38, 0x9a, 0x78, 0x02, 0x20, 0x2d, 0x80, 0x5a, 0x36, 0x30, 0x5b, 0xab, 0x02, 0xc5, 0x2d,
+        0x21, 0xf0, 0x7e, 0x18, 0x3e, 0x8d, 0x50, 0x59, 0x74, 0xfb, 0x27, 0x1d, 0x01, 0x0f, 0xe6, 0x16,
+        0x2d, 0x6a, 0xc0, 0x66, 0xea, 0xf5,
+    };
+    // clang-format on
+
+    auto hash = Crypto::Hash::SHA256::hash("Well hello friends"sv);
+
+    Crypto::Curves::SECP256r1 curve;
+    EXPECT_EQ(MUST(curve.verify(hash.bytes(), public_key, signature)), true);
+
+    auto other_hash = Crypto::Hash::SHA256::hash("Well hello fiends"sv);
+    EXPECT_EQ(MUST(curve.verify(other_hash.bytes(), public_key, signature)), false);
+
+    signature.last() ^= 1;
+    EXPECT_EQ(MUST(curve.verify(hash.bytes(), public_key, signature)), false);
+}
+
+TEST_CASE(test_secp384r1_verify)
+{
+    // clang-format off
+    Array<u8, 97> public_key {
+        0x04, 0x69, 0xa1, 0x4b, 0x30, 0x48, 0x0e, 0xff, 0xdd, 0x62, 0xb8, 0xe2, 0xef, 0xbe, 0x04, 0xb9,
+        0x0c, 0xd3, 0xd6, 0x54, 0xc2, 0x83, 0xc6, 0x17, 0x7b, 0xe5, 0x53, 0xc3, 0x5e, 0x4c, 0xdd, 0x63,
+        0xb9, 0x0a, 0xed, 0x13, 0xe8, 0xbc, 0x8c, 0xb8, 0x31, 0x97, 0x66, 0xd9, 0xeb, 0x44, 0x86, 0xe3,
+        0x73, 0x74, 0xf0, 0x0d, 0x01, 0x24, 0xcc, 0x84, 0xfb, 0x66, 0x8b, 0xb6, 0x9a, 0xa0, 0xf6, 0xd0,
+        0xe6, 0xed, 0x7d, 0xd3, 0xdb, 0xb2, 0x53, 0xdf, 0x10, 0x11, 0xea, 0xb8, 0x20, 0xa7, 0x64, 0x36,
+        0x4d, 0x4c, 0xb5, 0x96, 0x43, 0x1a, 0xee, 0xf4, 0xa3, 0x68, 0x11, 0xac, 0x19, 0xad, 0xf9, 0x61,
+        0x46,
+    };
+    Array<u8, 102> signature {
+        0x30, 0x64, 0x02, 0x30, 0x1b, 0xa9, 0xa5, 0x6d, 0x7c, 0xb0, 0x5f, 0x19, 0x64, 0x34, 0x93, 0xc5,
+        0x7e, 0xcd, 0x63, 0xfd, 0x80, 0x6c, 0x63, 0x25, 0x00, 0x65, 0x88, 0x15, 0xae, 0x5e, 0x70, 0xc7,
+        0x95, 0x70, 0x09, 0xc1, 0xf5, 0xe7, 0x91, 0xa9, 0xd2, 0xc5, 0xcc, 0x3b, 0x0b, 0x24, 0x8d, 0x2d,
+        0xd8, 0xba, 0xa4, 0xf2, 0x02, 0x30, 0x2d, 0x0f, 0x5a, 0x84, 0x10, 0x7b, 0x52, 0x9d, 0x64, 0x46,
+        0xd9, 0x2d, 0x12, 0x6f, 0x62, 0xb6, 0xbd, 0x63, 0xa7, 0xea, 0xbb, 0x3b, 0x41, 0xf7, 0xf4, 0x95,
+        0xa4, 0x4a, 0x8a, 0xf1, 0xe7, 0xac, 0x7f, 0xc3, 0xb9, 0xa0, 0x7f, 0xc2, 0xbe, 0xf9, 0x10, 0x48,
+        0x2f, 0x39, 0x61, 0xf5, 0xbd, 0x83,
+    };
+    // clang-format on
+
+    auto hash = Crypto::Hash::SHA384::hash("Well hello friends"sv);
+
+    Crypto::Curves::SECP384r1 curve;
+    EXPECT_EQ(MUST(curve.verify(hash.bytes(), public_key, signature)), true);
+
+    auto other_hash = Crypto::Hash::SHA384::hash("Well hello fiends"sv);
+    EXPECT_EQ(MUST(curve.verify(other_hash.bytes(), public_key, signature)), false);
+
+    signature.last() ^= 1;
+    EXPECT_EQ(MUST(curve.verify(hash.bytes(), public_key, signature)), false);
+}
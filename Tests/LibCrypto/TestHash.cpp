@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Random.h>
 #include <LibCrypto/Authentication/GHash.h>
 #include <LibCrypto/Authentication/HMAC.h>
 #include <LibCrypto/Hash/BLAKE2b.h>
@@ -69,6 +70,18 @@ TEST_CASE(test_BLAKE2b_consecutive_updates_reuse)
     EXPECT(memcmp(digest0.data, digest1.data, Crypto::Hash::BLAKE2b::digest_size()) == 0);
 }
 
+TEST_CASE(test_BLAKE2b_hash_multiple_blocks)
+{
+    u8 result[] {
+        0xc1, 0x1e, 0x1c, 0x03, 0x40, 0xbd, 0x7e, 0x5a, 0x1b, 0x27, 0x5f, 0x12, 0x30, 0xc9, 0x62, 0xfa, 0xd2, 0x15, 0xec, 0xb1, 0x39, 0x14, 0x86, 0xe7, 0x4e, 0x31, 0xb9, 0x60, 0xa2, 0xf2, 0x99, 0x63, 0x81, 0xa5, 0xfa, 0xd0, 0x92, 0xda, 0x06, 0x84, 0x1d, 0x5f, 0x26, 0xe3, 0x8f, 0x6e, 0xcf, 0xea, 0xf4, 0x41, 0xac, 0xbc, 0xd1, 0xc2, 0xde, 0x61, 0xae, 0xf1, 0x21, 0xe7, 0x92, 0x71, 0x75, 0xf5
+    };
+    auto input = MUST(ByteBuffer::create_uninitialized(1000));
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = i % 251;
+    auto digest = Crypto::Hash::BLAKE2b::hash(input);
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::BLAKE2b::digest_size()) == 0);
+}
+
 TEST_CASE(test_MD5_name)
 {
     Crypto::Hash::MD5 md5;
@@ -241,6 +254,36 @@ TEST_CASE(test_SHA256_hash_split_into_blocks)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+template<typename Hash>
+static void test_hash_many()
+{
+    // Messages of all lengths around the block boundaries, so that the lanes finish at different times.
+    auto input = MUST(ByteBuffer::create_uninitialized(3 * Hash::block_size() + 1));
+    fill_with_random(input);
+
+    Vector<ReadonlyBytes> messages;
+    for (size_t length = 0; length <= input.size(); ++length)
+        messages.append(input.bytes().slice(input.size() - length));
+    messages.append(input.bytes());
+
+    Vector<typename Hash::DigestType> digests;
+    digests.resize(messages.size());
+    Hash::hash_many(messages, digests);
+
+    for (size_t i = 0; i < messages.size(); ++i)
+        EXPECT_EQ(digests[i].bytes(), Hash::hash(messages[i].data(), messages[i].size()).bytes());
+}
+
+TEST_CASE(test_SHA256_hash_many)
+{
+    test_hash_many<Crypto::Hash::SHA256>();
+
+    Crypto::Hash::SHA256::DigestType digest;
+    auto message = "Well hello friends"sv.bytes();
+    Crypto::Hash::SHA256::hash_many({ &message, 1 }, { &digest, 1 });
+    EXPECT_EQ(digest.bytes(), Crypto::Hash::SHA256::hash("Well hello friends"sv).bytes());
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
@@ -300,12 +343,37 @@ TEST_CASE(test_SHA512_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA512::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA512_hash_many)
+{
+    test_hash_many<Crypto::Hash::SHA512>();
+}
+
 TEST_CASE(test_ghash_test_name)
 {
     Crypto::Authentication::GHash ghash("WellHelloFriends");
     EXPECT_EQ(ghash.class_name(), "GHash");
 }
 
+TEST_CASE(test_ghash_incremental)
+{
+    auto aad = MUST(ByteBuffer::create_uninitialized(37));
+    auto data = MUST(ByteBuffer::create_uninitialized(1000));
+    fill_with_random(aad);
+    fill_with_random(data);
+
+    Crypto::Authentication::GHash ghash("WellHelloFriends");
+    auto expected = ghash.process(aad, data);
+
+    // Feeding the same input in whole blocks has to give the same result, no matter how many blocks are hashed at once.
+    for (size_t piece_size : { 16ul, 48ul, 128ul, 256ul }) {
+        ghash.update(aad);
+        for (size_t offset = 0; offset < data.size(); offset += piece_size)
+            ghash.update(data.bytes().slice(offset, min(piece_size, data.size() - offset)));
+        auto digest = ghash.finish(aad.size(), data.size());
+        EXPECT(memcmp(expected.data, digest.data, Crypto::Authentication::GHash::digest_size()) == 0);
+    }
+}
+
 TEST_CASE(test_ghash_galois_field_multiply)
 {
     u32 x[4] { 0x42831ec2, 0x21777424, 0x4b7221b7, 0x84d0d49c },
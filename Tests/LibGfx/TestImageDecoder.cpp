@@ -457,6 +457,21 @@ TEST_CASE(test_jpeg_odd_mcu_restart_interval)
     TRY_OR_FAIL(expect_single_frame_of_size(*plugin_decoder, { 102, 77 }));
 }
 
+TEST_CASE(test_jpeg_restart_intervals_decoded_in_parallel)
+{
+    auto file = TRY_OR_FAIL(Core::MappedFile::map(TEST_INPUT("jpg/odd-restart.jpg"sv)));
+    auto plugin_decoder = TRY_OR_FAIL(Gfx::JPEGImageDecoderPlugin::create(file->bytes()));
+    auto expected_frame = TRY_OR_FAIL(expect_single_frame_of_size(*plugin_decoder, { 102, 77 }));
+
+    auto parallel_plugin_decoder = TRY_OR_FAIL(Gfx::JPEGImageDecoderPlugin::create_with_options(file->bytes(), { .thread_count = 4 }));
+    auto frame = TRY_OR_FAIL(expect_single_frame_of_size(*parallel_plugin_decoder, { 102, 77 }));
+
+    for (int y = 0; y < frame.image->height(); ++y) {
+        for (int x = 0; x < frame.image->width(); ++x)
+            EXPECT_EQ(frame.image->get_pixel(x, y), expected_frame.image->get_pixel(x, y));
+    }
+}
+
 TEST_CASE(test_jpeg_rgb_components)
 {
     auto file = TRY_OR_FAIL(Core::MappedFile::map(TEST_INPUT("jpg/rgb_components.jpg"sv)));
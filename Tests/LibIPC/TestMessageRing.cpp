@@ -0,0 +1,482 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/MemoryStream.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Socket.h>
+#include <LibCore/System.h>
+#include <LibIPC/Connection.h>
+#include <LibIPC/Decoder.h>
+#include <LibIPC/Encoder.h>
+#include <LibIPC/File.h>
+#include <LibIPC/MessageRing.h>
+#include <LibIPC/Stub.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/Thread.h>
+#include <sched.h>
+#include <sys/socket.h>
+
+static ByteBuffer make_message(size_t size, u8 seed)
+{
+    auto message = MUST(ByteBuffer::create_uninitialized(size));
+    for (size_t i = 0; i < size; ++i)
+        message[i] = static_cast<u8>(seed + i);
+    return message;
+}
+
+static NonnullOwnPtr<IPC::MessageRing> attach_to(IPC::MessageRing const& ring)
+{
+    return MUST(IPC::MessageRing::attach(MUST(IPC::File::clone_fd(ring.fd())), ring.capacity()));
+}
+
+TEST_CASE(invalid_capacity)
+{
+    EXPECT(IPC::MessageRing::create(1000).is_error());
+    EXPECT(IPC::MessageRing::create(IPC::MessageRing::MINIMUM_CAPACITY / 2).is_error());
+    EXPECT(IPC::MessageRing::create(IPC::MessageRing::MAXIMUM_CAPACITY * 2).is_error());
+
+    auto ring = MUST(IPC::MessageRing::create(IPC::MessageRing::MINIMUM_CAPACITY));
+    EXPECT(IPC::MessageRing::attach(MUST(IPC::File::clone_fd(ring->fd())), ring->capacity() * 2).is_error());
+}
+
+TEST_CASE(write_and_read_messages)
+{
+    auto producer = MUST(IPC::MessageRing::create(IPC::MessageRing::MINIMUM_CAPACITY));
+    auto consumer = attach_to(*producer);
+
+    EXPECT(!MUST(consumer->read_next()).has_value());
+
+    for (u8 i = 1; i <= 10; ++i)
+        EXPECT(producer->try_write(make_message(i * 3, i)));
+
+    for (u8 i = 1; i <= 10; ++i) {
+        auto message = MUST(consumer->read_next());
+        EXPECT(message.has_value());
+        EXPECT(*message == make_message(i * 3, i).bytes());
+    }
+
+    EXPECT(!MUST(consumer->read_next()).has_value());
+    EXPECT_EQ(consumer->read_position(), producer->write_position());
+}
+
+TEST_CASE(messages_wrap_around_the_end_of_the_ring)
+{
+    auto producer = MUST(IPC::MessageRing::create(IPC::MessageRing::MINIMUM_CAPACITY));
+    auto consumer = attach_to(*producer);
+
+    // 1000 is not a divisor of the capacity, so messages end up split at every possible offset.
+    for (size_t i = 0; i < 100; ++i) {
+        auto message = make_message(1000, static_cast<u8>(i));
+        EXPECT(producer->try_write(message));
+
+        auto read_message = MUST(consumer->read_next());
+        EXPECT(read_message.has_value());
+        EXPECT(*read_message == message.bytes());
+    }
+}
+
+TEST_CASE(full_ring)
+{
+    auto producer = MUST(IPC::MessageRing::create(IPC::MessageRing::MINIMUM_CAPACITY));
+    auto consumer = attach_to(*producer);
+
+    EXPECT(!producer->try_write(make_message(producer->capacity(), 0)));
+
+    // Each entry is the message and its 4-byte size.
+    auto message = make_message(IPC::MessageRing::MINIMUM_CAPACITY / 4 - 4, 0);
+    for (size_t i = 0; i < 4; ++i)
+        EXPECT(producer->try_write(message));
+    EXPECT(!producer->try_write(make_message(1, 0)));
+
+    EXPECT(MUST(consumer->read_next()).has_value());
+    EXPECT(!producer->try_write(make_message(IPC::MessageRing::MINIMUM_CAPACITY / 4, 0)));
+    EXPECT(producer->try_write(message));
+}
+
+TEST_CASE(corrupted_ring)
+{
+    auto producer = MUST(IPC::MessageRing::create(IPC::MessageRing::MINIMUM_CAPACITY));
+    auto consumer = attach_to(*producer);
+
+    // A misbehaving peer overwrites the first message with a larger one, and then the producer moves the write
+    // position back to before the end of that message.
+    auto rogue_producer = attach_to(*producer);
+    EXPECT(producer->try_write(make_message(16, 0)));
+    EXPECT(rogue_producer->try_write(make_message(100, 0)));
+    EXPECT(producer->try_write(make_message(16, 0)));
+
+    EXPECT(consumer->read_next().is_error());
+}
+
+TEST_CASE(wake_up_waiting_consumer)
+{
+    auto producer = MUST(IPC::MessageRing::create(IPC::MessageRing::MINIMUM_CAPACITY));
+    auto consumer = attach_to(*producer);
+
+    // A new consumer hasn't read anything yet, so it has to be woken up for the first message.
+    EXPECT(producer->try_write(make_message(8, 0)));
+    EXPECT(producer->take_consumer_wakeup());
+
+    EXPECT(producer->try_write(make_message(8, 0)));
+    EXPECT(!producer->take_consumer_wakeup());
+
+    EXPECT(!consumer->prepare_to_wait());
+    while (MUST(consumer->read_next()).has_value())
+        ;
+    EXPECT(consumer->prepare_to_wait());
+
+    EXPECT(producer->try_write(make_message(8, 0)));
+    EXPECT(producer->take_consumer_wakeup());
+}
+
+TEST_CASE(producer_consumer_multithread)
+{
+    IGNORE_USE_IN_ESCAPING_LAMBDA auto producer = MUST(IPC::MessageRing::create(IPC::MessageRing::MINIMUM_CAPACITY));
+    IGNORE_USE_IN_ESCAPING_LAMBDA auto consumer = attach_to(*producer);
+
+    // Ensure that the ring is filled up many times over.
+    static constexpr size_t test_count = 10000;
+
+    auto consumer_thread = Threading::Thread::construct([&consumer]() {
+        for (size_t i = 0; i < test_count; ++i) {
+            Optional<ReadonlyBytes> message;
+            while (!message.has_value())
+                message = MUST(consumer->read_next());
+
+            EXPECT(*message == make_message(i % 200, static_cast<u8>(i)).bytes());
+        }
+        return 0;
+    });
+    consumer_thread->start();
+
+    for (size_t i = 0; i < test_count; ++i) {
+        auto message = make_message(i % 200, static_cast<u8>(i));
+        while (!producer->try_write(message))
+            sched_yield();
+    }
+
+    (void)consumer_thread->join();
+    EXPECT_EQ(consumer->read_position(), producer->write_position());
+}
+
+// The tests and benchmarks below send messages through a pair of IPC connections, which is what the endpoints that
+// the IPC compiler generates would do as well.
+enum class MessageID : i32 {
+    Ping = 1,
+    Echo,
+    EchoResponse,
+};
+
+class TestMessage final : public IPC::Message {
+public:
+    TestMessage(u32 endpoint_magic, MessageID id, u32 sequence, ByteBuffer payload = {}, Optional<IPC::File> file = {})
+        : m_endpoint_magic(endpoint_magic)
+        , m_id(id)
+        , m_sequence(sequence)
+        , m_payload(move(payload))
+        , m_file(move(file))
+    {
+    }
+
+    virtual u32 endpoint_magic() const override { return m_endpoint_magic; }
+    virtual int message_id() const override { return to_underlying(m_id); }
+    virtual char const* message_name() const override { return "TestMessage"; }
+    virtual bool valid() const override { return true; }
+
+    u32 sequence() const { return m_sequence; }
+    ByteBuffer const& payload() const { return m_payload; }
+    Optional<IPC::File> const& file() const { return m_file; }
+
+    static ErrorOr<NonnullOwnPtr<IPC::Message>> decode(u32 endpoint_magic, ReadonlyBytes bytes, Queue<IPC::File>& files)
+    {
+        FixedMemoryStream stream { bytes };
+        if (TRY(stream.read_value<u32>()) != endpoint_magic)
+            return Error::from_string_literal("Endpoint magic number mismatch, not my message!");
+
+        IPC::Decoder decoder { stream, files };
+        auto id = TRY(decoder.decode<i32>());
+        if (id < to_underlying(MessageID::Ping) || id > to_underlying(MessageID::EchoResponse))
+            return Error::from_string_literal("Failed to decode test message");
+
+        auto sequence = TRY(decoder.decode<u32>());
+        auto payload = TRY(decoder.decode<ByteBuffer>());
+        auto file = TRY(decoder.decode<Optional<IPC::File>>());
+        return make<TestMessage>(endpoint_magic, static_cast<MessageID>(id), sequence, move(payload), move(file));
+    }
+
+    virtual ErrorOr<IPC::MessageBuffer> encode() const override
+    {
+        IPC::MessageBuffer buffer;
+        IPC::Encoder stream(buffer);
+        TRY(stream.encode(m_endpoint_magic));
+        TRY(stream.encode(to_underlying(m_id)));
+        TRY(stream.encode(m_sequence));
+        TRY(stream.encode(m_payload));
+        TRY(stream.encode(m_file));
+        return buffer;
+    }
+
+private:
+    u32 m_endpoint_magic { 0 };
+    MessageID m_id { MessageID::Ping };
+    u32 m_sequence { 0 };
+    ByteBuffer m_payload;
+    Optional<IPC::File> m_file;
+};
+
+template<u32 magic>
+struct TestEndpoint {
+    static u32 static_magic() { return magic; }
+
+    static ErrorOr<NonnullOwnPtr<IPC::Message>> decode_message(ReadonlyBytes bytes, Queue<IPC::File>& files)
+    {
+        return TestMessage::decode(magic, bytes, files);
+    }
+};
+
+// Like the response of a generated synchronous message, EchoResponse belongs to the server's endpoint.
+using ServerEndpoint = TestEndpoint<0x53525652>;
+using ClientEndpoint = TestEndpoint<0x434c4e54>;
+
+class ServerStub final : public IPC::Stub {
+public:
+    struct ReceivedMessage {
+        u32 sequence { 0 };
+        size_t payload_size { 0 };
+        Optional<ino_t> file_inode;
+    };
+
+    virtual u32 magic() const override { return ServerEndpoint::static_magic(); }
+    virtual ByteString name() const override { return "ServerStub"; }
+
+    virtual ErrorOr<OwnPtr<IPC::MessageBuffer>> handle(IPC::Message const& message) override
+    {
+        auto const& test_message = static_cast<TestMessage const&>(message);
+
+        Optional<ino_t> file_inode;
+        if (test_message.file().has_value())
+            file_inode = TRY(Core::System::fstat(test_message.file()->fd())).st_ino;
+        TRY(received_messages.try_append({ test_message.sequence(), test_message.payload().size(), file_inode }));
+
+        if (message.message_id() != to_underlying(MessageID::Echo))
+            return nullptr;
+
+        TestMessage response { ServerEndpoint::static_magic(), MessageID::EchoResponse, test_message.sequence() };
+        return make<IPC::MessageBuffer>(TRY(response.encode()));
+    }
+
+    Vector<ReceivedMessage> received_messages;
+};
+
+class ClientStub final : public IPC::Stub {
+public:
+    virtual u32 magic() const override { return ClientEndpoint::static_magic(); }
+    virtual ByteString name() const override { return "ClientStub"; }
+    virtual ErrorOr<OwnPtr<IPC::MessageBuffer>> handle(IPC::Message const&) override { return nullptr; }
+};
+
+// Both connections live on the same thread, so instead of waiting for the event loop to handle the received messages,
+// the test handles them as soon as it is done receiving.
+class QueuedInvoker final : public IPC::DeferredInvoker {
+public:
+    virtual void schedule(Function<void()> callback) override { m_callbacks.append(move(callback)); }
+
+    void run_pending()
+    {
+        auto callbacks = move(m_callbacks);
+        for (auto& callback : callbacks)
+            callback();
+    }
+
+private:
+    Vector<Function<void()>> m_callbacks;
+};
+
+template<typename LocalEndpoint, typename PeerEndpoint>
+class TestConnection final : public IPC::Connection<LocalEndpoint, PeerEndpoint> {
+    C_OBJECT(TestConnection);
+
+public:
+    void receive_messages()
+    {
+        this->wait_for_socket_to_become_readable();
+        MUST(this->drain_messages_from_peer());
+        m_invoker->run_pending();
+    }
+
+    OwnPtr<TestMessage> wait_for_echo_response()
+    {
+        auto response = this->wait_for_specific_endpoint_message_impl(PeerEndpoint::static_magic(), to_underlying(MessageID::EchoResponse));
+        m_invoker->run_pending();
+        if (!response)
+            return {};
+        return response.template release_nonnull<TestMessage>();
+    }
+
+private:
+    TestConnection(IPC::Stub& stub, NonnullOwnPtr<Core::LocalSocket> socket)
+        : IPC::Connection<LocalEndpoint, PeerEndpoint>(stub, move(socket))
+    {
+        auto invoker = make<QueuedInvoker>();
+        m_invoker = invoker.ptr();
+        this->set_deferred_invoker(move(invoker));
+    }
+
+    QueuedInvoker* m_invoker { nullptr };
+};
+
+using ServerConnection = TestConnection<ServerEndpoint, ClientEndpoint>;
+using ClientConnection = TestConnection<ClientEndpoint, ServerEndpoint>;
+
+enum class UseMessageRings {
+    No,
+    Yes,
+};
+
+class ConnectionPair {
+public:
+    explicit ConnectionPair(UseMessageRings use_message_rings, size_t ring_capacity = IPC::MessageRing::DEFAULT_CAPACITY)
+    {
+        int fds[2];
+        MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds));
+        client = ClientConnection::construct(client_stub, MUST(Core::LocalSocket::adopt_fd(fds[0])));
+        server = ServerConnection::construct(server_stub, MUST(Core::LocalSocket::adopt_fd(fds[1])));
+
+        if (use_message_rings == UseMessageRings::Yes) {
+            MUST(client->enable_shared_memory_ring(ring_capacity));
+            MUST(server->enable_shared_memory_ring(ring_capacity));
+        }
+    }
+
+    Core::EventLoop event_loop;
+    ServerStub server_stub;
+    ClientStub client_stub;
+    RefPtr<ClientConnection> client;
+    RefPtr<ServerConnection> server;
+};
+
+static TestMessage make_ping(u32 sequence, ByteBuffer payload = {}, Optional<IPC::File> file = {})
+{
+    return { ServerEndpoint::static_magic(), MessageID::Ping, sequence, move(payload), move(file) };
+}
+
+// Returns the read end of a new pipe, which is any file that can be told apart from others by its inode.
+static IPC::File make_file(ino_t& inode)
+{
+    auto fds = MUST(Core::System::pipe2(0));
+    MUST(Core::System::close(fds[1]));
+    inode = MUST(Core::System::fstat(fds[0])).st_ino;
+    return IPC::File::adopt_fd(fds[0]);
+}
+
+TEST_CASE(connection_keeps_message_order)
+{
+    ConnectionPair connections { UseMessageRings::No };
+    auto& client = *connections.client;
+    auto& server = *connections.server;
+    auto const& received = connections.server_stub.received_messages;
+
+    // This file's fd arrives in front of the one of the ring, and has to stay there.
+    ino_t first_inode = 0;
+    MUST(client.post_message(make_ping(0, {}, make_file(first_inode))));
+
+    MUST(client.enable_shared_memory_ring(IPC::MessageRing::MINIMUM_CAPACITY));
+    MUST(server.enable_shared_memory_ring(IPC::MessageRing::MINIMUM_CAPACITY));
+    EXPECT(client.has_shared_memory_ring());
+
+    // Messages with file descriptors and messages that don't fit in the ring are sent over the socket, and have to be
+    // handled in between the ones from the ring.
+    ino_t second_inode = 0;
+    MUST(client.post_message(make_ping(1)));
+    MUST(client.post_message(make_ping(2, {}, make_file(second_inode))));
+    MUST(client.post_message(make_ping(3)));
+    MUST(client.post_message(make_ping(4, make_message(IPC::MessageRing::MINIMUM_CAPACITY * 2, 0))));
+    MUST(client.post_message(make_ping(5)));
+    MUST(client.post_message(TestMessage { ServerEndpoint::static_magic(), MessageID::Echo, 6 }, IPC::ConnectionBase::MessageKind::Sync));
+
+    server.receive_messages();
+
+    EXPECT_EQ(received.size(), 7u);
+    for (size_t i = 0; i < min(received.size(), 7u); ++i)
+        EXPECT_EQ(received[i].sequence, i);
+
+    if (received.size() == 7) {
+        EXPECT_EQ(received[0].file_inode, first_inode);
+        EXPECT_EQ(received[2].file_inode, second_inode);
+        EXPECT_EQ(received[4].payload_size, IPC::MessageRing::MINIMUM_CAPACITY * 2);
+        EXPECT(!received[5].file_inode.has_value());
+    }
+
+    // The response is written to the server's ring, and the client has to be woken up for it over the socket.
+    auto response = client.wait_for_echo_response();
+    EXPECT(response);
+    if (response)
+        EXPECT_EQ(response->sequence(), 6u);
+
+    // After both sides have drained their rings and gone back to waiting, they have to be woken up again.
+    for (u32 sequence = 7; sequence < 10; ++sequence) {
+        MUST(client.post_message(TestMessage { ServerEndpoint::static_magic(), MessageID::Echo, sequence }, IPC::ConnectionBase::MessageKind::Sync));
+        server.receive_messages();
+
+        auto response = client.wait_for_echo_response();
+        EXPECT(response);
+        if (response)
+            EXPECT_EQ(response->sequence(), sequence);
+    }
+    EXPECT_EQ(received.size(), 10u);
+}
+
+// The benchmarks compare sending messages over the socket of a connection with sending them through message rings.
+static constexpr size_t benchmark_message_size = 64;
+static constexpr size_t benchmark_message_count = 100000;
+static constexpr size_t benchmark_batch_size = 100;
+
+static void run_round_trips(ConnectionPair& connections)
+{
+    for (u32 i = 0; i < benchmark_message_count; ++i) {
+        TestMessage request { ServerEndpoint::static_magic(), MessageID::Echo, i, make_message(benchmark_message_size, 0) };
+        MUST(connections.client->post_message(request, IPC::ConnectionBase::MessageKind::Sync));
+        connections.server->receive_messages();
+
+        auto response = connections.client->wait_for_echo_response();
+        EXPECT(response && response->sequence() == i);
+    }
+}
+
+// The server only starts receiving once a whole batch was sent, which lets a ring carry the batch with a single wakeup.
+static void run_one_way_messages(ConnectionPair& connections)
+{
+    for (u32 i = 0; i < benchmark_message_count; i += benchmark_batch_size) {
+        for (u32 j = 0; j < benchmark_batch_size; ++j)
+            MUST(connections.client->post_message(make_ping(i + j, make_message(benchmark_message_size, 0))));
+        connections.server->receive_messages();
+    }
+    EXPECT_EQ(connections.server_stub.received_messages.size(), benchmark_message_count);
+}
+
+BENCHMARK_CASE(round_trips_over_socket)
+{
+    ConnectionPair connections { UseMessageRings::No };
+    run_round_trips(connections);
+}
+
+BENCHMARK_CASE(round_trips_over_message_ring)
+{
+    ConnectionPair connections { UseMessageRings::Yes };
+    run_round_trips(connections);
+}
+
+BENCHMARK_CASE(one_way_messages_over_socket)
+{
+    ConnectionPair connections { UseMessageRings::No };
+    run_one_way_messages(connections);
+}
+
+BENCHMARK_CASE(one_way_messages_over_message_ring)
+{
+    ConnectionPair connections { UseMessageRings::Yes };
+    run_one_way_messages(connections);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "TestLibJSCommon.h"
+
+// Each of these scripts hammers a small set of bytecode instructions in a tight loop,
+// so a slowdown in a single handler (or in dispatch itself) stands out.
+
+static void expect_number(StringView source, double expected)
+{
+    auto completion = run_script(source);
+    VERIFY(!completion.is_error());
+    auto result = completion.release_value();
+    EXPECT(result.is_number());
+    EXPECT_EQ(result.as_double(), expected);
+}
+
+BENCHMARK_CASE(local_arithmetic)
+{
+    expect_number(R"~~~(
+        (function () {
+            let sum = 0;
+            for (let i = 0; i < 10000000; i = i + 1)
+                sum = (sum + i) & 0xffff;
+            return sum;
+        })();
+    )~~~"sv,
+        54464);
+}
+
+BENCHMARK_CASE(compare_and_jump)
+{
+    expect_number(R"~~~(
+        (function () {
+            let count = 0;
+            for (let i = 0; i < 10000000; ++i) {
+                if (i % 3 === 0)
+                    ++count;
+                else if (i > 5000000)
+                    --count;
+            }
+            return count;
+        })();
+    )~~~"sv,
+        2);
+}
+
+BENCHMARK_CASE(property_get_and_call)
+{
+    expect_number(R"~~~(
+        (function () {
+            const counter = {
+                value: 0,
+                increment(amount) { this.value += amount; },
+            };
+            for (let i = 0; i < 2000000; ++i)
+                counter.increment(2);
+            return counter.value;
+        })();
+    )~~~"sv,
+        4000000);
+}
+
+BENCHMARK_CASE(array_element_access)
+{
+    expect_number(R"~~~(
+        (function () {
+            const values = [];
+            for (let i = 0; i < 1000; ++i)
+                values.push(i);
+            let sum = 0;
+            for (let round = 0; round < 5000; ++round) {
+                for (let i = 0; i < values.length; ++i)
+                    sum = sum + values[i];
+            }
+            return sum;
+        })();
+    )~~~"sv,
+        2497500000);
+}
+
+BENCHMARK_CASE(function_calls)
+{
+    expect_number(R"~~~(
+        (function () {
+            function fib(n) {
+                return n < 2 ? n : fib(n - 1) + fib(n - 2);
+            }
+            return fib(27);
+        })();
+    )~~~"sv,
+        196418);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "TestLibJSCommon.h"
+
+// Builds a large graph and keeps moving existing objects between already visited ones while producing garbage,
+// which is exactly what an incremental collector has to get right.
+static constexpr auto graph_shuffling_script = R"~~~(
+    (function (rounds) {
+        const count = 100000;
+        const nodes = [];
+        for (let i = 0; i < count; ++i)
+            nodes.push({ id: i, next: null, payload: [i, i + 1] });
+        for (let i = 0; i < count; ++i)
+            nodes[i].next = nodes[(i * 7919) % count];
+
+        for (let round = 0; round < rounds; ++round) {
+            for (let i = 0; i < count; ++i) {
+                const j = (i * 31 + round) % count;
+                const next = nodes[i].next;
+                nodes[i].next = nodes[j].next;
+                nodes[j].next = next;
+
+                const old = nodes[j];
+                nodes[j] = { id: old.id, next: old.next, payload: [old.id, old.id + 1] };
+            }
+        }
+
+        let sum = 0;
+        for (const node of nodes)
+            sum += node.id + node.payload[0] + node.payload[1] + node.next.id;
+        return sum;
+    })
+)~~~"sv;
+
+// Every node contributes 3i + 1, and the next pointers are a permutation of all ids.
+static constexpr double graph_shuffling_result = 19999900000;
+
+struct ShuffleResult {
+    JS::Value value;
+    Duration longest_pause;
+};
+
+static ShuffleResult shuffle_graph(bool incremental_marking, bool generational_collection, int rounds)
+{
+    auto vm = MUST(JS::VM::create());
+    vm->heap().set_uses_incremental_marking(incremental_marking);
+    vm->heap().set_incremental_marking_slice_budget(Duration::from_milliseconds(1));
+    vm->heap().set_uses_generational_collection(generational_collection);
+
+    auto result = run_script(*vm, ByteString::formatted("{}({});", graph_shuffling_script, rounds));
+    VERIFY(!result.is_error());
+    return { result.release_value(), vm->heap().longest_garbage_collection_pause() };
+}
+
+static void expect_correct_graph(ShuffleResult const& result)
+{
+    EXPECT(result.value.is_number());
+    EXPECT_EQ(result.value.as_double(), graph_shuffling_result);
+}
+
+TEST_CASE(incremental_marking_keeps_moved_objects_alive)
+{
+    expect_correct_graph(shuffle_graph(true, false, 3));
+}
+
+TEST_CASE(incremental_marking_with_generational_collection)
+{
+    expect_correct_graph(shuffle_graph(true, true, 3));
+}
+
+BENCHMARK_CASE(longest_pause_stop_the_world)
+{
+    auto result = shuffle_graph(false, false, 20);
+    expect_correct_graph(result);
+    outln("Longest pause with stop-the-world marking: {} ms", result.longest_pause.to_milliseconds());
+}
+
+BENCHMARK_CASE(longest_pause_incremental_marking)
+{
+    auto result = shuffle_graph(true, false, 20);
+    expect_correct_graph(result);
+    outln("Longest pause with incremental marking: {} ms", result.longest_pause.to_milliseconds());
+}
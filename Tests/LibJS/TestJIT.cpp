@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <math.h>
+
+#include "TestLibJSCommon.h"
+
+// Runs the script with every executable compiled on its first run, so the results can be compared to the interpreter's.
+static JS::ThrowCompletionOr<JS::Value> run_script_with_jit(StringView source, bool jit_enabled)
+{
+    JS::Bytecode::g_jit_enabled = jit_enabled;
+    JS::Bytecode::g_jit_compilation_threshold = 1;
+    auto restore_jit_settings = ScopeGuard([] {
+        JS::Bytecode::g_jit_enabled = false;
+        JS::Bytecode::g_jit_compilation_threshold = 16;
+    });
+
+    return run_script(source);
+}
+
+static void expect_same_number(StringView source, double expected)
+{
+    for (bool jit_enabled : { false, true }) {
+        auto result = run_script_with_jit(source, jit_enabled);
+        EXPECT(!result.is_error());
+        if (result.is_error())
+            continue;
+        EXPECT(result.value().is_number());
+        EXPECT_EQ(result.value().as_double(), expected);
+    }
+}
+
+TEST_CASE(int32_arithmetic_overflows_into_doubles)
+{
+    expect_same_number(R"~~~(
+        (function () {
+            let a = 2147483647;
+            a = a + 1;
+            let b = -2147483648;
+            b = b - 1;
+            let c = 65536;
+            c = c * 65536;
+            let d = 2147483647;
+            ++d;
+            return a + b + c + d;
+        })();
+    )~~~"sv,
+        2147483648.0 - 2147483649.0 + 4294967296.0 + 2147483648.0);
+}
+
+TEST_CASE(multiplication_produces_negative_zero)
+{
+    expect_same_number(R"~~~(
+        (function () {
+            let zero = 0;
+            let minus_one = -1;
+            return 1 / (zero * minus_one);
+        })();
+    )~~~"sv,
+        -INFINITY);
+}
+
+TEST_CASE(comparisons_and_bitwise_operations)
+{
+    expect_same_number(R"~~~(
+        (function () {
+            let result = 0;
+            for (let i = -50; i < 50; ++i) {
+                if (i <= -10 || i >= 10)
+                    result = result ^ (i & 0x7f);
+                if (i > 0.5)
+                    result = result | 0x100;
+                if (i == "3")
+                    result = result + 1000;
+            }
+            return result;
+        })();
+    )~~~"sv,
+        1374);
+}
+
+TEST_CASE(cached_property_accesses_follow_shape_changes)
+{
+    expect_same_number(R"~~~(
+        (function () {
+            function get_x(o) { return o.x; }
+            const objects = [{ x: 1 }, { y: 2, x: 3 }, Object.create({ x: 5 }), { get x() { return 7; } }];
+            let sum = 0;
+            for (let round = 0; round < 10; ++round) {
+                for (const o of objects)
+                    sum += get_x(o);
+                objects[0].x = round;
+            }
+            return sum;
+        })();
+    )~~~"sv,
+        (0 + 1 + 2 + 3 + 4 + 5 + 6 + 7 + 8) + 1 + 10 * (3 + 5 + 7));
+}
+
+TEST_CASE(exceptions_leave_native_code)
+{
+    for (bool jit_enabled : { false, true }) {
+        auto result = run_script_with_jit(R"~~~(
+            (function () {
+                const o = null;
+                return o.property;
+            })();
+        )~~~"sv,
+            jit_enabled);
+        EXPECT(result.is_error());
+    }
+}
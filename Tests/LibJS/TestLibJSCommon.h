@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibTest/TestCase.h>
+
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <LibJS/Script.h>
+
+// Runs the source as a script in a new realm of the VM, so the VM can be set up before and inspected after.
+static inline JS::ThrowCompletionOr<JS::Value> run_script(JS::VM& vm, StringView source)
+{
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(vm);
+
+    auto script = JS::Script::parse(source, *root_execution_context->realm);
+    VERIFY(!script.is_error());
+    return vm.bytecode_interpreter().run(script.value());
+}
+
+static inline JS::ThrowCompletionOr<JS::Value> run_script(StringView source)
+{
+    auto vm = MUST(JS::VM::create());
+    return run_script(*vm, source);
+}
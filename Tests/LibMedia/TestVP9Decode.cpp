@@ -23,6 +23,86 @@ TEST_CASE(vp9_oob_blocks)
     decode_video("./vp9_oob_blocks.webm"sv, 240, make_decoder);
 }
 
+static Vector<NonnullOwnPtr<Media::VideoFrame>> decode_all_frames(StringView path, Media::Video::VP9::Decoder::FrameThreading frame_threading)
+{
+    auto matroska_reader = MUST(Media::Matroska::Reader::from_file(path));
+    u64 video_track = 0;
+    MUST(matroska_reader.for_each_track_of_type(Media::Matroska::TrackEntry::TrackType::Video, [&](Media::Matroska::TrackEntry const& track_entry) -> Media::DecoderErrorOr<IterationDecision> {
+        video_track = track_entry.track_number();
+        return IterationDecision::Break;
+    }));
+    VERIFY(video_track != 0);
+
+    auto iterator = MUST(matroska_reader.create_sample_iterator(video_track));
+    Media::Video::VP9::Decoder decoder { frame_threading };
+    Vector<NonnullOwnPtr<Media::VideoFrame>> frames;
+
+    auto take_decoded_frames = [&] {
+        while (true) {
+            auto frame_result = decoder.get_decoded_frame();
+            if (frame_result.is_error()) {
+                VERIFY(frame_result.error().category() == Media::DecoderErrorCategory::NeedsMoreInput);
+                return;
+            }
+            frames.append(frame_result.release_value());
+        }
+    };
+
+    while (true) {
+        auto block_result = iterator.next_block();
+        if (block_result.is_error()) {
+            VERIFY(block_result.error().category() == Media::DecoderErrorCategory::EndOfStream);
+            break;
+        }
+
+        auto block = block_result.release_value();
+        for (auto const& frame : block.frames()) {
+            MUST(decoder.receive_sample(block.timestamp(), frame));
+            take_decoded_frames();
+        }
+    }
+
+    MUST(decoder.signal_end_of_stream());
+    take_decoded_frames();
+    return frames;
+}
+
+static void expect_same_output_with_frame_threading(StringView path)
+{
+    auto expected_frames = decode_all_frames(path, Media::Video::VP9::Decoder::FrameThreading::No);
+    auto frames = decode_all_frames(path, Media::Video::VP9::Decoder::FrameThreading::Yes);
+    EXPECT(!expected_frames.is_empty());
+    EXPECT_EQ(frames.size(), expected_frames.size());
+
+    for (size_t i = 0; i < min(frames.size(), expected_frames.size()); i++) {
+        auto& expected_frame = static_cast<Media::SubsampledYUVFrame&>(*expected_frames[i]);
+        auto& frame = static_cast<Media::SubsampledYUVFrame&>(*frames[i]);
+        EXPECT_EQ(frame.timestamp(), expected_frame.timestamp());
+        EXPECT_EQ(frame.size(), expected_frame.size());
+        EXPECT_EQ(frame.bit_depth(), expected_frame.bit_depth());
+        if (frame.size() != expected_frame.size() || frame.bit_depth() != expected_frame.bit_depth())
+            continue;
+
+        size_t bytes_per_sample = frame.bit_depth() > 8 ? sizeof(u16) : sizeof(u8);
+        for (u32 plane = 0; plane < 3; plane++) {
+            auto plane_size = plane == 0 ? frame.size() : frame.subsampling().subsampled_size(frame.size());
+            auto plane_bytes = plane_size.width() * plane_size.height() * bytes_per_sample;
+            ReadonlyBytes expected_samples { expected_frame.get_raw_plane_data(plane), plane_bytes };
+            ReadonlyBytes samples { frame.get_raw_plane_data(plane), plane_bytes };
+            if (samples != expected_samples) {
+                FAIL(ByteString::formatted("Plane {} of frame {} differs with frame threading", plane, i));
+                return;
+            }
+        }
+    }
+}
+
+TEST_CASE(vp9_frame_threading)
+{
+    expect_same_output_with_frame_threading("./vp9_in_webm.webm"sv);
+    expect_same_output_with_frame_threading("./vp9_4k.webm"sv);
+}
+
 TEST_CASE(vp9_malformed_frame)
 {
     Array test_inputs = {
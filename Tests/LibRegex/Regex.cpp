@@ -1218,3 +1218,256 @@ TEST_CASE(mismatching_brackets)
         EXPECT_EQ(re.parser_result.error, regex::Error::MismatchingBracket);
     }
 }
+
+TEST_CASE(nfa_is_used_for_ambiguous_loops)
+{
+    auto const uses_nfa = [](StringView pattern) {
+        Regex<ECMA262> re(pattern);
+        return re.parser_result.optimization_data.nfa.has_value();
+    };
+
+    EXPECT(uses_nfa("(a|aa)*b"sv));
+    EXPECT(uses_nfa("(a+)+b"sv));
+    EXPECT(uses_nfa("^(\\w+\\s?)*$"sv));
+
+    // Nothing to gain from simple loops.
+    EXPECT(!uses_nfa("a*b"sv));
+    EXPECT(!uses_nfa("foo|bar"sv));
+
+    // Nor from loops where the next character decides which branch to take.
+    EXPECT(!uses_nfa("(foo|bar)*x"sv));
+    EXPECT(!uses_nfa("(\\d+,)*x"sv));
+
+    // Backreferences, lookaround and counted repetitions need the backtracking VM.
+    EXPECT(!uses_nfa("(a|aa)*\\1"sv));
+    EXPECT(!uses_nfa("(a|aa)*(?=b)"sv));
+    EXPECT(!uses_nfa("(a|aa){2,5}b"sv));
+}
+
+TEST_CASE(nfa_matches_like_backtracking)
+{
+    Array patterns {
+        "(a|aa)*b"sv,
+        "(a+)+c"sv,
+        "(x+x+)+y"sv,
+        "^(\\w+\\s?)*$"sv,
+        "(?:a|b)*?c"sv,
+        "(a|ab)(c|bcd)(d*)"sv,
+        "([a-z]+)@([a-z]+)\\.com"sv,
+        "(?<word>\\w+)(\\s+\\w+)*"sv,
+        "\\b(foo|foobar)\\b"sv,
+        "hello (world|there)+!"sv,
+    };
+    Array subjects {
+        ""sv,
+        "aaaab"sv,
+        "aaaa"sv,
+        "aaac"sv,
+        "xxxxy"sv,
+        "abcd"sv,
+        "abababc"sv,
+        "foo foobar"sv,
+        "mail john@example.com and jane@test.com"sv,
+        "hello worldthereworld!"sv,
+        "b"sv,
+    };
+
+    for (auto pattern : patterns) {
+        Regex<ECMA262> backtracking(pattern, ECMAScriptFlags::Global);
+        backtracking.parser_result.optimization_data.nfa.clear();
+
+        Regex<ECMA262> nfa(pattern, ECMAScriptFlags::Global);
+        nfa.parser_result.optimization_data.nfa = regex::NFAProgram::compile(nfa.parser_result.bytecode);
+        EXPECT(nfa.parser_result.optimization_data.nfa.has_value());
+
+        for (auto subject : subjects) {
+            auto expected = backtracking.match(subject);
+            auto result = nfa.match(subject);
+
+            EXPECT_EQ(result.success, expected.success);
+            EXPECT_EQ(result.matches.size(), expected.matches.size());
+            if (result.matches.size() != expected.matches.size())
+                continue;
+
+            for (size_t i = 0; i < expected.matches.size(); ++i) {
+                EXPECT_EQ(result.matches[i].view.to_byte_string(), expected.matches[i].view.to_byte_string());
+                EXPECT_EQ(result.matches[i].global_offset, expected.matches[i].global_offset);
+
+                auto const& groups = result.capture_group_matches[i];
+                auto const& expected_groups = expected.capture_group_matches[i];
+                EXPECT_EQ(groups.size(), expected_groups.size());
+                for (size_t j = 0; j < min(groups.size(), expected_groups.size()); ++j)
+                    EXPECT_EQ(groups[j].view.to_byte_string(), expected_groups[j].view.to_byte_string());
+            }
+        }
+    }
+}
+
+TEST_CASE(nfa_search_continues_after_all_threads_died)
+{
+    struct TestCase {
+        StringView pattern;
+        ECMAScriptFlags flags;
+        StringView subject;
+        StringView expected_match;
+    };
+    Array tests {
+        TestCase { "^(a|aa)*b"sv, ECMAScriptFlags::Multiline, "x\naab"sv, "aab"sv },
+        TestCase { "\\b(a|aa)*c"sv, {}, "xy aac"sv, "aac"sv },
+    };
+
+    for (auto& test : tests) {
+        Regex<ECMA262> backtracking(test.pattern, test.flags);
+        backtracking.parser_result.optimization_data.nfa.clear();
+
+        Regex<ECMA262> nfa(test.pattern, test.flags);
+        nfa.parser_result.optimization_data.nfa = regex::NFAProgram::compile(nfa.parser_result.bytecode);
+        EXPECT(nfa.parser_result.optimization_data.nfa.has_value());
+
+        auto expected = backtracking.search(test.subject);
+        EXPECT(expected.success);
+        EXPECT_EQ(expected.matches.first().view.to_byte_string(), test.expected_match);
+
+        auto result = nfa.search(test.subject);
+        EXPECT(result.success);
+        if (!result.success)
+            continue;
+        EXPECT_EQ(result.matches.first().view.to_byte_string(), test.expected_match);
+        EXPECT_EQ(result.matches.first().global_offset, expected.matches.first().global_offset);
+    }
+}
+
+// "(a|aa)*b" has to try every way of splitting a run of a's into a's and aa's before giving up, which is
+// exponential in the length of the run for the backtracking VM.
+static ByteString pathological_subject(size_t run_length, size_t runs)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < runs; ++i) {
+        builder.append(ByteString::repeated('a', run_length));
+        builder.append(' ');
+    }
+    return builder.to_byte_string();
+}
+
+BENCHMARK_CASE(pathological_pattern_backtracking)
+{
+    Regex<ECMA262> re("(a|aa)*b"sv);
+    re.parser_result.optimization_data.nfa.clear();
+
+    auto subject = pathological_subject(22, 4);
+    auto result = re.search(subject);
+    EXPECT_EQ(result.success, false);
+    outln("Backtracking: {} operations", result.n_operations);
+}
+
+BENCHMARK_CASE(pathological_pattern_nfa)
+{
+    Regex<ECMA262> re("(a|aa)*b"sv);
+    EXPECT(re.parser_result.optimization_data.nfa.has_value());
+
+    auto subject = pathological_subject(22, 4);
+    auto result = re.search(subject);
+    EXPECT_EQ(result.success, false);
+    outln("NFA: {} operations", result.n_operations);
+
+    // The NFA stays linear even on inputs the backtracking VM would never finish.
+    auto long_subject = pathological_subject(10'000, 100);
+    EXPECT_EQ(re.search(long_subject).success, false);
+}
+
+TEST_CASE(prefilter_extraction)
+{
+    auto const has_prefilter = [](StringView pattern) {
+        Regex<ECMA262> re(pattern);
+        return re.parser_result.optimization_data.prefilter.has_value();
+    };
+
+    EXPECT(has_prefilter("foo\\d+"sv));
+    EXPECT(has_prefilter("[0-9a-f]+x"sv));
+    EXPECT(has_prefilter("(cat|dog)s?"sv));
+    EXPECT(has_prefilter("\\w+@example\\.com"sv));
+    EXPECT(has_prefilter("^\\s*#include"sv));
+
+    // These can match the empty string, or start with anything.
+    EXPECT(!has_prefilter("a*"sv));
+    EXPECT(!has_prefilter(".+"sv));
+    EXPECT(!has_prefilter("[^a]+"sv));
+}
+
+TEST_CASE(prefilter_matches_like_vm)
+{
+    Array patterns {
+        "foo\\d+"sv,
+        "foobar"sv,
+        "[0-9a-f]+x"sv,
+        "(cat|dog)s?"sv,
+        "\\w+@example\\.com"sv,
+        "\\bword\\b"sv,
+        "a(?!bc)b"sv,
+        "x(?:ab)+y"sv,
+        "\\s+end"sv,
+    };
+    Array subjects {
+        ""sv,
+        "foo foo1 foo22 bar"sv,
+        "foofoobarfoobar"sv,
+        "deadbeefx 12 abx cafex"sv,
+        "cats and dogs and a cat"sv,
+        "mail john@example.com or jane@example.org"sv,
+        "words word sword word"sv,
+        "abc abd ab"sv,
+        "xaby xababy xy xabab"sv,
+        "the end\tend  end"sv,
+        "0123456789abcdefghijklmnopqrstuvwxyz, the quick brown fox jumps over the lazy dog"sv,
+    };
+
+    for (auto pattern : patterns) {
+        Regex<ECMA262> filtered(pattern, ECMAScriptFlags::Global);
+        EXPECT(filtered.parser_result.optimization_data.prefilter.has_value());
+
+        Regex<ECMA262> unfiltered(pattern, ECMAScriptFlags::Global);
+        unfiltered.parser_result.optimization_data.prefilter.clear();
+
+        for (auto subject : subjects) {
+            auto expected = unfiltered.match(subject);
+            auto result = filtered.match(subject);
+
+            EXPECT_EQ(result.success, expected.success);
+            EXPECT_EQ(result.matches.size(), expected.matches.size());
+            for (size_t i = 0; i < min(result.matches.size(), expected.matches.size()); ++i) {
+                EXPECT_EQ(result.matches[i].view.to_byte_string(), expected.matches[i].view.to_byte_string());
+                EXPECT_EQ(result.matches[i].global_offset, expected.matches[i].global_offset);
+            }
+        }
+    }
+}
+
+static ByteString log_file_subject()
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 20'000; ++i)
+        builder.appendff("2026-01-01 12:00:{:02} [info] request {} served in {}ms\n", i % 60, i, i % 100);
+    builder.append("2026-01-01 12:00:00 [error] disk full\n"sv);
+    return builder.to_byte_string();
+}
+
+BENCHMARK_CASE(prefilter_literal_prefix)
+{
+    Regex<ECMA262> re("\\[error\\] (\\w+)"sv);
+    auto subject = log_file_subject();
+    for (size_t i = 0; i < 10; ++i) {
+        auto result = re.search(subject);
+        EXPECT_EQ(result.success, true);
+    }
+}
+
+BENCHMARK_CASE(prefilter_literal_prefix_disabled)
+{
+    Regex<ECMA262> re("\\[error\\] (\\w+)"sv);
+    re.parser_result.optimization_data.prefilter.clear();
+    auto subject = log_file_subject();
+    for (size_t i = 0; i < 10; ++i) {
+        auto result = re.search(subject);
+        EXPECT_EQ(result.success, true);
+    }
+}
@@ -235,3 +235,32 @@ TEST_CASE(reuse_row_storage)
     auto size_in_bytes_after_reinsertion = MUST(db->file_size_in_bytes());
     EXPECT(size_in_bytes_after_reinsertion <= original_size_in_bytes);
 }
+
+TEST_CASE(group_commit)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    {
+        auto db = MUST(SQL::Database::create("/tmp/test.db"));
+        MUST(db->open());
+        db->set_uses_group_commit(true);
+        (void)setup_table(db);
+        commit(db);
+
+        // Every insert is committed as a transaction of its own, but they're only synced once.
+        auto table = MUST(db->get_table("TestSchema", "TestTable"));
+        for (int ix = 0; ix < 10; ix++) {
+            SQL::Row row(*table);
+            row["TextColumn"] = ByteString::formatted("Test{}", ix);
+            row["IntColumn"] = ix;
+            TRY_OR_FAIL(db->insert(row));
+            commit(db);
+        }
+        TRY_OR_FAIL(db->sync());
+    }
+    {
+        auto db = MUST(SQL::Database::create("/tmp/test.db"));
+        MUST(db->open());
+        verify_table_contents(db, 10);
+    }
+}
+
@@ -6,19 +6,49 @@
 
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
+#include <LibCore/File.h>
 #include <LibCore/System.h>
 #include <LibSQL/Heap.h>
+#include <LibSQL/PageCache.h>
 #include <LibTest/TestCase.h>
 
 static constexpr auto db_path = "/tmp/test.db"sv;
 
-static NonnullRefPtr<SQL::Heap> create_heap()
+static constexpr auto wal_path = "/tmp/test.db-wal"sv;
+static constexpr auto crashed_db_path = "/tmp/test-crashed.db"sv;
+static constexpr auto crashed_wal_path = "/tmp/test-crashed.db-wal"sv;
+
+static constexpr auto block_data_size = SQL::Block::DEFAULT_SIZE - SQL::Block::HEADER_SIZE;
+
+static NonnullRefPtr<SQL::Heap> create_heap(StringView path = db_path, u32 block_size = SQL::Block::DEFAULT_SIZE)
 {
-    auto heap = MUST(SQL::Heap::create(db_path));
+    auto heap = MUST(SQL::Heap::create(path, block_size));
     MUST(heap->open());
     return heap;
 }
 
+static void unlink_crashed_heap()
+{
+    (void)Core::System::unlink(db_path);
+    (void)Core::System::unlink(wal_path);
+    (void)Core::System::unlink(crashed_db_path);
+    (void)Core::System::unlink(crashed_wal_path);
+}
+
+// Copies the files of an open heap, which is what would be left on disk if the process crashed right now.
+static void simulate_crash()
+{
+    auto copy_file = [](StringView from, StringView to) {
+        auto source = MUST(Core::File::open(from, Core::File::OpenMode::Read));
+        auto contents = MUST(source->read_until_eof());
+        auto destination = MUST(Core::File::open(to, Core::File::OpenMode::Write));
+        MUST(destination->write_until_depleted(contents));
+    };
+
+    copy_file(db_path, crashed_db_path);
+    copy_file(wal_path, crashed_wal_path);
+}
+
 TEST_CASE(heap_write_large_storage_without_flush)
 {
     ScopeGuard guard([]() { MUST(Core::System::unlink(db_path)); });
@@ -27,7 +57,7 @@ TEST_CASE(heap_write_large_storage_without_flush)
 
     // Write large storage spanning multiple blocks
     StringBuilder builder;
-    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 4));
+    MUST(builder.try_append_repeated('x', block_data_size * 4));
     auto long_string = builder.string_view();
     TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
 
@@ -44,7 +74,7 @@ TEST_CASE(heap_write_large_storage_with_flush)
 
     // Write large storage spanning multiple blocks
     StringBuilder builder;
-    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 4));
+    MUST(builder.try_append_repeated('x', block_data_size * 4));
     auto long_string = builder.string_view();
     TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
     MUST(heap->flush());
@@ -62,7 +92,7 @@ TEST_CASE(heap_overwrite_large_storage)
 
     // Write large storage spanning multiple blocks
     StringBuilder builder;
-    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 4));
+    MUST(builder.try_append_repeated('x', block_data_size * 4));
     auto long_string = builder.string_view();
     TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
     MUST(heap->flush());
@@ -76,7 +106,7 @@ TEST_CASE(heap_overwrite_large_storage)
 
     // Write a smaller string and read back - heap size should be at most the previous size
     builder.clear();
-    MUST(builder.try_append_repeated('y', SQL::Block::DATA_SIZE * 2));
+    MUST(builder.try_append_repeated('y', block_data_size * 2));
     auto shorter_string = builder.string_view();
     TRY_OR_FAIL(heap->write_storage(storage_block_id, shorter_string.bytes()));
     MUST(heap->flush());
@@ -87,7 +117,7 @@ TEST_CASE(heap_overwrite_large_storage)
 
     // Write a longer string and read back - heap size is expected to grow
     builder.clear();
-    MUST(builder.try_append_repeated('z', SQL::Block::DATA_SIZE * 6));
+    MUST(builder.try_append_repeated('z', block_data_size * 6));
     auto longest_string = builder.string_view();
     TRY_OR_FAIL(heap->write_storage(storage_block_id, longest_string.bytes()));
     MUST(heap->flush());
@@ -105,7 +135,7 @@ TEST_CASE(heap_reuse_freed_blocks_after_storage_trim)
     // First, write storage spanning 4 blocks
     auto first_index = heap->request_new_block_index();
     StringBuilder builder;
-    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 4));
+    MUST(builder.try_append_repeated('x', block_data_size * 4));
     auto long_string = builder.string_view();
     TRY_OR_FAIL(heap->write_storage(first_index, long_string.bytes()));
     MUST(heap->flush());
@@ -113,7 +143,7 @@ TEST_CASE(heap_reuse_freed_blocks_after_storage_trim)
 
     // Then, overwrite the first storage and reduce it to 2 blocks
     builder.clear();
-    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 2));
+    MUST(builder.try_append_repeated('x', block_data_size * 2));
     long_string = builder.string_view();
     TRY_OR_FAIL(heap->write_storage(first_index, long_string.bytes()));
     MUST(heap->flush());
@@ -134,7 +164,7 @@ TEST_CASE(heap_reuse_freed_blocks_after_reopening_file)
 
     size_t original_heap_size = 0;
     StringBuilder builder;
-    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 4));
+    MUST(builder.try_append_repeated('x', block_data_size * 4));
     auto long_string = builder.string_view();
 
     {
@@ -148,7 +178,7 @@ TEST_CASE(heap_reuse_freed_blocks_after_reopening_file)
 
         // Then, overwrite the first storage and reduce it to 2 blocks
         builder.clear();
-        MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 2));
+        MUST(builder.try_append_repeated('x', block_data_size * 2));
         long_string = builder.string_view();
         TRY_OR_FAIL(heap->write_storage(first_index, long_string.bytes()));
         MUST(heap->flush());
@@ -176,7 +206,7 @@ TEST_CASE(heap_free_storage)
 
     // Write large storage spanning multiple blocks
     StringBuilder builder;
-    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 4));
+    MUST(builder.try_append_repeated('x', block_data_size * 4));
     auto long_string = builder.string_view();
     TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
     MUST(heap->flush());
@@ -192,3 +222,213 @@ TEST_CASE(heap_free_storage)
     auto new_heap_size = MUST(heap->file_size_in_bytes());
     EXPECT(new_heap_size <= heap_size);
 }
+
+TEST_CASE(heap_recover_committed_transactions)
+{
+    ScopeGuard guard([]() { unlink_crashed_heap(); });
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', block_data_size * 4));
+    auto committed_string = builder.string_view();
+
+    auto heap = create_heap();
+    auto committed_index = heap->request_new_block_index();
+    TRY_OR_FAIL(heap->write_storage(committed_index, committed_string.bytes()));
+    MUST(heap->flush());
+
+    // Blocks that have not been committed are lost in a crash
+    auto uncommitted_index = heap->request_new_block_index();
+    TRY_OR_FAIL(heap->write_storage(uncommitted_index, "uncommitted"sv.bytes()));
+    simulate_crash();
+
+    auto recovered_heap = create_heap(crashed_db_path);
+    auto stored_string = TRY_OR_FAIL(recovered_heap->read_storage(committed_index));
+    EXPECT_EQ(committed_string.bytes(), stored_string.bytes());
+    EXPECT(!recovered_heap->has_block(uncommitted_index));
+}
+
+TEST_CASE(heap_discard_incomplete_transaction)
+{
+    ScopeGuard guard([]() { unlink_crashed_heap(); });
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', block_data_size * 2));
+    auto first_string = builder.to_byte_string();
+    builder.clear();
+    MUST(builder.try_append_repeated('y', block_data_size * 2));
+    auto second_string = builder.to_byte_string();
+
+    auto heap = create_heap();
+    auto storage_block_id = heap->request_new_block_index();
+    TRY_OR_FAIL(heap->write_storage(storage_block_id, first_string.bytes()));
+    MUST(heap->flush());
+    TRY_OR_FAIL(heap->write_storage(storage_block_id, second_string.bytes()));
+    MUST(heap->flush());
+    simulate_crash();
+
+    // Cut off the end of the last transaction, as if the process crashed while it was being written
+    auto crashed_wal = MUST(Core::File::open(crashed_wal_path, Core::File::OpenMode::ReadWrite));
+    MUST(crashed_wal->truncate(MUST(Core::System::stat(crashed_wal_path)).st_size - 1));
+
+    auto recovered_heap = create_heap(crashed_db_path);
+    auto stored_string = TRY_OR_FAIL(recovered_heap->read_storage(storage_block_id));
+    EXPECT_EQ(first_string.bytes(), stored_string.bytes());
+}
+
+TEST_CASE(heap_checkpoint_on_close)
+{
+    ScopeGuard guard([]() { unlink_crashed_heap(); });
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', block_data_size * 4));
+    auto long_string = builder.string_view();
+
+    SQL::Block::Index storage_block_id = 0;
+    {
+        auto heap = create_heap();
+        storage_block_id = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
+        MUST(heap->flush());
+        EXPECT(MUST(Core::System::stat(wal_path)).st_size > static_cast<off_t>(SQL::Block::DEFAULT_SIZE * 4));
+    }
+
+    // All blocks have been copied to the heap file, so the log is empty
+    EXPECT(MUST(Core::System::stat(wal_path)).st_size < static_cast<off_t>(SQL::Block::DEFAULT_SIZE));
+    EXPECT(MUST(Core::System::stat(db_path)).st_size >= static_cast<off_t>(SQL::Block::DEFAULT_SIZE * 5));
+
+    auto heap = create_heap();
+    auto stored_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(long_string.bytes(), stored_string.bytes());
+}
+
+TEST_CASE(heap_invalid_block_size)
+{
+    EXPECT(SQL::Heap::create(db_path, 1024).is_error());
+    EXPECT(SQL::Heap::create(db_path, 6 * KiB).is_error());
+    EXPECT(SQL::Heap::create(db_path, 32 * KiB).is_error());
+}
+
+TEST_CASE(heap_keep_block_size_after_reopening_file)
+{
+    ScopeGuard guard([]() { unlink_crashed_heap(); });
+
+    auto large_block_size = static_cast<u32>(16 * KiB);
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', (large_block_size - SQL::Block::HEADER_SIZE) * 3));
+    auto long_string = builder.string_view();
+
+    SQL::Block::Index storage_block_id = 0;
+    {
+        auto heap = create_heap(db_path, large_block_size);
+        EXPECT_EQ(heap->block_size(), large_block_size);
+        storage_block_id = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
+    }
+    EXPECT_EQ(MUST(Core::System::stat(db_path)).st_size, static_cast<off_t>(large_block_size * 4));
+
+    // The block size the heap file was created with wins over the one that is asked for when opening it
+    auto heap = create_heap(db_path, SQL::Block::DEFAULT_SIZE);
+    EXPECT_EQ(heap->block_size(), large_block_size);
+    auto stored_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(long_string.bytes(), stored_string.bytes());
+}
+
+TEST_CASE(heap_recover_block_size_from_log)
+{
+    ScopeGuard guard([]() { unlink_crashed_heap(); });
+
+    auto large_block_size = static_cast<u32>(16 * KiB);
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', (large_block_size - SQL::Block::HEADER_SIZE) * 3));
+    auto long_string = builder.string_view();
+
+    auto heap = create_heap(db_path, large_block_size);
+    auto storage_block_id = heap->request_new_block_index();
+    TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
+    MUST(heap->flush());
+    simulate_crash();
+
+    // Nothing has been checkpointed yet, so the log is the only place that knows the block size
+    EXPECT_EQ(MUST(Core::System::stat(crashed_db_path)).st_size, 0);
+
+    auto recovered_heap = create_heap(crashed_db_path, SQL::Block::DEFAULT_SIZE);
+    EXPECT_EQ(recovered_heap->block_size(), large_block_size);
+    auto stored_string = TRY_OR_FAIL(recovered_heap->read_storage(storage_block_id));
+    EXPECT_EQ(long_string.bytes(), stored_string.bytes());
+}
+
+TEST_CASE(heap_page_cache)
+{
+    ScopeGuard guard([]() { unlink_crashed_heap(); });
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', block_data_size * 2));
+    auto first_string = builder.to_byte_string();
+    builder.clear();
+    MUST(builder.try_append_repeated('y', block_data_size * 2));
+    auto second_string = builder.to_byte_string();
+
+    SQL::Block::Index storage_block_id = 0;
+    {
+        auto heap = create_heap();
+        storage_block_id = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(storage_block_id, first_string.bytes()));
+    }
+
+    auto heap = create_heap();
+    auto misses = heap->page_cache().misses();
+    auto stored_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(first_string.bytes(), stored_string.bytes());
+    EXPECT_EQ(heap->page_cache().misses(), misses + 2);
+
+    // Reading the storage again doesn't read any block from the heap file
+    auto hits = heap->page_cache().hits();
+    stored_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(first_string.bytes(), stored_string.bytes());
+    EXPECT_EQ(heap->page_cache().hits(), hits + 2);
+    EXPECT_EQ(heap->page_cache().misses(), misses + 2);
+
+    // Cached blocks are replaced when they are written
+    TRY_OR_FAIL(heap->write_storage(storage_block_id, second_string.bytes()));
+    stored_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(second_string.bytes(), stored_string.bytes());
+}
+
+TEST_CASE(heap_mapped_reads)
+{
+    ScopeGuard guard([]() { unlink_crashed_heap(); });
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', block_data_size * 4));
+    auto first_string = builder.to_byte_string();
+    builder.clear();
+    MUST(builder.try_append_repeated('y', block_data_size * 2));
+    auto second_string = builder.to_byte_string();
+
+    SQL::Block::Index first_index = 0;
+    {
+        auto heap = create_heap();
+        first_index = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(first_index, first_string.bytes()));
+    }
+
+    SQL::Block::Index second_index = 0;
+    {
+        auto heap = MUST(SQL::Heap::create(db_path));
+        MUST(heap->set_uses_mapped_reads(true));
+        MUST(heap->open());
+        auto stored_string = TRY_OR_FAIL(heap->read_storage(first_index));
+        EXPECT_EQ(first_string.bytes(), stored_string.bytes());
+
+        second_index = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(second_index, second_string.bytes()));
+    }
+
+    // The blocks that were added to the heap file while it was mapped are read from a new mapping
+    auto heap = create_heap();
+    MUST(heap->set_uses_mapped_reads(true));
+    auto stored_string = TRY_OR_FAIL(heap->read_storage(second_index));
+    EXPECT_EQ(second_string.bytes(), stored_string.bytes());
+    stored_string = TRY_OR_FAIL(heap->read_storage(first_index));
+    EXPECT_EQ(first_string.bytes(), stored_string.bytes());
+}
@@ -9,6 +9,7 @@
 
 #include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
+#include <LibSQL/AST/Cursor.h>
 #include <LibSQL/AST/Parser.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Result.h>
@@ -41,6 +42,30 @@ SQL::ResultSet execute(NonnullRefPtr<SQL::Database> database, ByteString const&
     return result.release_value();
 }
 
+NonnullOwnPtr<SQL::AST::Cursor> open_cursor(NonnullRefPtr<SQL::Database> database, ByteString const& sql, Vector<SQL::Value> placeholder_values = {})
+{
+    auto parser = SQL::AST::Parser(SQL::AST::Lexer(sql));
+    auto statement = parser.next_statement();
+    EXPECT(!parser.has_errors());
+
+    auto cursor = statement->open_cursor(move(database), placeholder_values);
+    if (cursor.is_error()) {
+        outln("{}", cursor.release_error().error_string());
+        VERIFY_NOT_REACHED();
+    }
+    return cursor.release_value();
+}
+
+Vector<Vector<SQL::Value>> fetch(SQL::AST::Cursor& cursor, size_t max_row_count)
+{
+    auto rows = cursor.fetch(max_row_count);
+    if (rows.is_error()) {
+        outln("{}", rows.release_error().error_string());
+        VERIFY_NOT_REACHED();
+    }
+    return rows.release_value();
+}
+
 template<typename... Args>
 Vector<SQL::Value> placeholders(Args&&... args)
 {
@@ -1061,3 +1086,382 @@ TEST_CASE(update_all_rows)
 }
 
 }
+
+TEST_CASE(create_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+
+    auto result = execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+
+    auto error = try_execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( TextColumn );");
+    EXPECT(error.is_error());
+    EXPECT(error.release_error().error() == SQL::SQLErrorCode::IndexExists);
+
+    result = execute(database, "CREATE INDEX IF NOT EXISTS TestSchema.IntIndex ON TestTable ( TextColumn );");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+
+    error = try_execute(database, "CREATE INDEX TestSchema.BadIndex ON TestTable ( NoColumn );");
+    EXPECT(error.is_error());
+    EXPECT(error.release_error().error() == SQL::SQLErrorCode::ColumnDoesNotExist);
+}
+
+TEST_CASE(select_with_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+
+    // Insert the rows out of order, so that ordered results must come from the index.
+    for (auto count = 0; count < 20; ++count) {
+        auto value = (count * 7) % 20;
+        auto result = execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", value, value));
+        EXPECT_EQ(result.size(), 1u);
+    }
+    execute(database, "INSERT INTO TestSchema.TestTable ( TextColumn ) VALUES ( 'TNull' );");
+    execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+
+    auto result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 7;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "T7"sv);
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = ?;", placeholders(7));
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "T7"sv);
+
+    result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn > 5 AND IntColumn <= 15 ORDER BY IntColumn;");
+    EXPECT_EQ(result.size(), 10u);
+    for (auto i = 0u; i < result.size(); ++i)
+        EXPECT_EQ(result[i].row[0], i + 6);
+
+    result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE 10 <= IntColumn AND TextColumn <> 'T12' ORDER BY IntColumn;");
+    EXPECT_EQ(result.size(), 9u);
+    EXPECT_EQ(result[0].row[0], 10);
+    EXPECT_EQ(result[1].row[0], 11);
+    EXPECT_EQ(result[2].row[0], 13);
+
+    result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 18 ORDER BY IntColumn DESC;");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].row[0], 19);
+    EXPECT_EQ(result[1].row[0], 18);
+
+    result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn = 20;");
+    EXPECT(result.is_empty());
+
+    // NULL compares less than any other value, so rows that aren't in the index can match an upper bound.
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn < 2;");
+    EXPECT_EQ(result.size(), 3u);
+}
+
+TEST_CASE(select_with_index_on_large_integers)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+
+    // These values are only one apart, but are the same when they are converted to doubles.
+    execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T1', 9007199254740992 );");
+    execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T2', 9007199254740993 );");
+    execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T3', 9007199254740994 );");
+    execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+
+    auto result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 9007199254740993;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "T2"sv);
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn > 9007199254740992 ORDER BY IntColumn;");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].row[0], "T2"sv);
+    EXPECT_EQ(result[1].row[0], "T3"sv);
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn < 9007199254740993.5;");
+    EXPECT_EQ(result.size(), 2u);
+}
+
+TEST_CASE(explain_query_plan)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+    execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+
+    auto validate = [&](ByteString const& sql, Vector<StringView> expected_steps) {
+        auto result = execute(database, sql);
+        EXPECT_EQ(result.command(), SQL::SQLCommand::Explain);
+        EXPECT_EQ(result.size(), expected_steps.size());
+
+        for (size_t i = 0; i < min(result.size(), expected_steps.size()); ++i)
+            EXPECT_EQ(result[i].row[0], expected_steps[i]);
+    };
+
+    validate("EXPLAIN SELECT * FROM TestSchema.TestTable;", { "SCAN TESTTABLE"sv });
+    validate("EXPLAIN SELECT * FROM TestSchema.TestTable ORDER BY IntColumn;", { "SCAN TESTTABLE"sv, "SORT ROWS FOR ORDER BY"sv });
+    validate("EXPLAIN SELECT * FROM TestSchema.TestTable WHERE TextColumn = 'T1';", { "SCAN TESTTABLE"sv });
+    validate("EXPLAIN SELECT * FROM TestSchema.TestTable WHERE IntColumn < 1;", { "SCAN TESTTABLE"sv });
+    validate("EXPLAIN SELECT * FROM TestSchema.TestTable WHERE IntColumn = 1;", { "SEARCH TESTTABLE USING INDEX INTINDEX (INTCOLUMN=?)"sv });
+    validate("EXPLAIN QUERY PLAN SELECT * FROM TestSchema.TestTable WHERE IntColumn > 1 AND IntColumn <= 5 ORDER BY IntColumn;", { "SEARCH TESTTABLE USING INDEX INTINDEX (INTCOLUMN>? AND INTCOLUMN<=?)"sv });
+    validate("EXPLAIN SELECT * FROM TestSchema.TestTable WHERE IntColumn > 1 ORDER BY TextColumn;", { "SEARCH TESTTABLE USING INDEX INTINDEX (INTCOLUMN>?)"sv, "SORT ROWS FOR ORDER BY"sv });
+    validate("EXPLAIN UPDATE TestSchema.TestTable SET TextColumn = 'T' WHERE IntColumn = 1;", { "SEARCH TESTTABLE USING INDEX INTINDEX (INTCOLUMN=?)"sv });
+    validate("EXPLAIN DELETE FROM TestSchema.TestTable WHERE IntColumn >= 1;", { "SEARCH TESTTABLE USING INDEX INTINDEX (INTCOLUMN>=?)"sv });
+
+    auto error = try_execute(database, "EXPLAIN CREATE SCHEMA OtherSchema;");
+    EXPECT(error.is_error());
+    EXPECT(error.release_error().error() == SQL::SQLErrorCode::NotYetImplemented);
+}
+
+TEST_CASE(update_and_delete_with_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    {
+        auto database = MUST(SQL::Database::create(db_name));
+        MUST(database->open());
+        create_table(database);
+        execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+
+        for (auto count = 0; count < 10; ++count) {
+            auto result = execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+            EXPECT_EQ(result.size(), 1u);
+        }
+
+        execute(database, "UPDATE TestSchema.TestTable SET IntColumn=100 WHERE IntColumn = 3;");
+        execute(database, "DELETE FROM TestSchema.TestTable WHERE IntColumn >= 5 AND IntColumn < 8;");
+
+        // A deleted value is added to the index again when a row with that value is inserted.
+        execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T6', 6 );");
+    }
+    {
+        auto database = MUST(SQL::Database::create(db_name));
+        MUST(database->open());
+
+        auto result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 0 ORDER BY IntColumn;");
+        Vector<int> expected { 0, 1, 2, 4, 6, 8, 9, 100 };
+        EXPECT_EQ(result.size(), expected.size());
+        for (auto i = 0u; i < min(result.size(), expected.size()); ++i)
+            EXPECT_EQ(result[i].row[0], expected[i]);
+
+        result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 100;");
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].row[0], "T3"sv);
+
+        result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 3;");
+        EXPECT(result.is_empty());
+
+        result = execute(database, "SELECT * FROM TestSchema.TestTable;");
+        EXPECT_EQ(result.size(), 8u);
+    }
+}
+
+TEST_CASE(fetch_from_cursor_in_batches)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+
+    for (auto count = 0; count < 25; ++count)
+        execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+
+    auto cursor = open_cursor(database, "SELECT IntColumn, TextColumn FROM TestSchema.TestTable;");
+    EXPECT_EQ(cursor->column_names().size(), 2u);
+    EXPECT_EQ(cursor->column_names()[0], "INTCOLUMN"sv);
+
+    Vector<int> values;
+    auto collect = [&](auto const& rows) {
+        for (auto const& row : rows) {
+            EXPECT_EQ(row.size(), 2u);
+            values.append(row[0].template to_int<int>().value());
+            EXPECT_EQ(row[1], ByteString::formatted("T{}", values.last()));
+        }
+    };
+
+    auto rows = fetch(*cursor, 10);
+    EXPECT_EQ(rows.size(), 10u);
+    collect(rows);
+    EXPECT(MUST(cursor->has_next_row()));
+
+    rows = fetch(*cursor, 10);
+    EXPECT_EQ(rows.size(), 10u);
+    collect(rows);
+
+    rows = fetch(*cursor, 10);
+    EXPECT_EQ(rows.size(), 5u);
+    collect(rows);
+    EXPECT(!MUST(cursor->has_next_row()));
+    EXPECT(fetch(*cursor, 10).is_empty());
+    EXPECT_EQ(cursor->fetched_row_count(), 25u);
+
+    quick_sort(values);
+    for (auto i = 0; i < 25; ++i)
+        EXPECT_EQ(values[i], i);
+}
+
+TEST_CASE(fetch_from_cursor_with_where_limit_and_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+
+    for (auto count = 0; count < 20; ++count) {
+        auto value = (count * 7) % 20;
+        execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", value, value));
+    }
+    execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+
+    auto cursor = open_cursor(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn >= ? AND TextColumn <> 'T13' ORDER BY IntColumn LIMIT 4 OFFSET 2;", placeholders(10));
+    auto rows = fetch(*cursor, 3);
+    EXPECT_EQ(rows.size(), 3u);
+    EXPECT_EQ(rows[0][0], 12);
+    EXPECT_EQ(rows[1][0], 14);
+    EXPECT_EQ(rows[2][0], 15);
+
+    rows = fetch(*cursor, 3);
+    EXPECT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0][0], 16);
+    EXPECT_EQ(cursor->fetched_row_count(), 4u);
+
+    cursor = open_cursor(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn = 20;");
+    EXPECT(!MUST(cursor->has_next_row()));
+}
+
+TEST_CASE(fetch_from_cursor_with_sorted_result)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+
+    for (auto count = 0; count < 10; ++count)
+        execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+
+    // Rows that must be sorted are all read before the first one is returned.
+    auto cursor = open_cursor(database, "SELECT IntColumn FROM TestSchema.TestTable ORDER BY IntColumn DESC;");
+    auto rows = fetch(*cursor, 100);
+    EXPECT_EQ(rows.size(), 10u);
+    for (auto i = 0u; i < rows.size(); ++i)
+        EXPECT_EQ(rows[i][0], static_cast<int>(9 - i));
+}
+
+TEST_CASE(modify_table_while_cursor_is_open)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+
+    for (auto count = 0; count < 10; ++count)
+        execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+
+    auto cursor = open_cursor(database, "SELECT IntColumn FROM TestSchema.TestTable;");
+    auto rows = fetch(*cursor, 4);
+    EXPECT_EQ(rows.size(), 4u);
+
+    // The cursor returns the rows the table had when the cursor was opened.
+    execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T10', 10 );");
+    execute(database, "DELETE FROM TestSchema.TestTable WHERE IntColumn < 5;");
+    execute(database, "UPDATE TestSchema.TestTable SET IntColumn = 100 WHERE IntColumn = 9;");
+
+    auto remaining_rows = fetch(*cursor, 100);
+    EXPECT_EQ(remaining_rows.size(), 6u);
+    rows.extend(move(remaining_rows));
+
+    Vector<int> values;
+    for (auto const& row : rows)
+        values.append(row[0].to_int<int>().value());
+    quick_sort(values);
+    for (auto i = 0; i < 10; ++i)
+        EXPECT_EQ(values[i], i);
+
+    auto result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable;");
+    EXPECT_EQ(result.size(), 6u);
+}
+
+TEST_CASE(modify_index_while_cursor_is_open)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+    execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+
+    for (auto count = 0; count < 10; ++count)
+        execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+
+    auto cursor = open_cursor(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 0;");
+    auto rows = fetch(*cursor, 3);
+    EXPECT_EQ(rows.size(), 3u);
+
+    // Rows that move further along the index are not returned twice, and new rows are not returned at all.
+    execute(database, "UPDATE TestSchema.TestTable SET IntColumn = IntColumn + 100 WHERE IntColumn >= 5;");
+    execute(database, "DELETE FROM TestSchema.TestTable WHERE IntColumn = 4;");
+    for (auto count = 10; count < 40; ++count)
+        execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+
+    rows.extend(fetch(*cursor, 100));
+    EXPECT_EQ(rows.size(), 10u);
+    for (auto i = 0u; i < min(rows.size(), 10u); ++i)
+        EXPECT_EQ(rows[i][0], static_cast<int>(i));
+
+    // The same goes for a statement that modifies the rows of its own scan.
+    execute(database, "UPDATE TestSchema.TestTable SET IntColumn = IntColumn + 1 WHERE IntColumn >= 0;");
+    auto result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 100;");
+    EXPECT_EQ(result.size(), 5u);
+    for (auto const& row : result) {
+        auto value = row.row[0].to_int<int>().value();
+        EXPECT(value >= 106 && value <= 110);
+    }
+}
+
+TEST_CASE(abandoned_cursor_is_released)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+
+    for (auto count = 0; count < 10; ++count)
+        execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+
+    {
+        auto cursor = open_cursor(database, "SELECT IntColumn FROM TestSchema.TestTable;");
+        EXPECT_EQ(fetch(*cursor, 3).size(), 3u);
+        EXPECT_EQ(database->open_scan_count(), 1u);
+    }
+
+    // Once the cursor is gone, its scan doesn't preserve the rows that are written anymore.
+    EXPECT_EQ(database->open_scan_count(), 0u);
+    execute(database, "UPDATE TestSchema.TestTable SET IntColumn = IntColumn + 100;");
+    EXPECT_EQ(execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 100;").size(), 10u);
+}
+
+TEST_CASE(cursor_is_invalidated_once_too_many_rows_are_preserved)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    database->set_maximum_preserved_row_count(5);
+    create_table(database);
+
+    for (auto count = 0; count < 10; ++count)
+        execute(database, ByteString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+
+    auto cursor = open_cursor(database, "SELECT IntColumn FROM TestSchema.TestTable;");
+    EXPECT_EQ(fetch(*cursor, 3).size(), 3u);
+
+    // Writing fewer rows than the limit leaves the cursor usable.
+    execute(database, "UPDATE TestSchema.TestTable SET IntColumn = IntColumn + 100 WHERE IntColumn < 3;");
+    auto other_cursor = open_cursor(database, "SELECT IntColumn FROM TestSchema.TestTable;");
+    EXPECT_EQ(fetch(*other_cursor, 1).size(), 1u);
+
+    // Writing more rows than the limit makes the next fetch fail, while the writes themselves succeed.
+    execute(database, "UPDATE TestSchema.TestTable SET IntColumn = IntColumn + 100;");
+    EXPECT(cursor->fetch(10).is_error());
+    EXPECT(other_cursor->fetch(10).is_error());
+    EXPECT_EQ(execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 100;").size(), 10u);
+}
@@ -277,6 +277,46 @@ TEST_CASE(drop_table)
     validate("DROP TABLE IF EXISTS test;"sv, {}, "TEST"sv, false);
 }
 
+TEST_CASE(create_index)
+{
+    EXPECT(parse("CREATE INDEX"sv).is_error());
+    EXPECT(parse("CREATE INDEX test"sv).is_error());
+    EXPECT(parse("CREATE INDEX test ON"sv).is_error());
+    EXPECT(parse("CREATE INDEX test ON table_name"sv).is_error());
+    EXPECT(parse("CREATE INDEX test ON table_name ()"sv).is_error());
+    EXPECT(parse("CREATE INDEX test ON table_name (column_name"sv).is_error());
+    EXPECT(parse("CREATE INDEX test ON table_name (column_name)"sv).is_error());
+    EXPECT(parse("CREATE INDEX IF test ON table_name (column_name);"sv).is_error());
+
+    struct IndexedColumn {
+        StringView name;
+        SQL::Order order { SQL::Order::Ascending };
+    };
+
+    auto validate = [](StringView sql, StringView expected_schema, StringView expected_index, StringView expected_table, Vector<IndexedColumn> expected_columns, bool expected_is_error_if_index_exists = true) {
+        auto statement = TRY_OR_FAIL(parse(sql));
+        EXPECT(is<SQL::AST::CreateIndex>(*statement));
+
+        auto const& index = static_cast<const SQL::AST::CreateIndex&>(*statement);
+        EXPECT_EQ(index.schema_name(), expected_schema);
+        EXPECT_EQ(index.index_name(), expected_index);
+        EXPECT_EQ(index.table_name(), expected_table);
+        EXPECT_EQ(index.is_error_if_index_exists(), expected_is_error_if_index_exists);
+
+        auto const& columns = index.indexed_columns();
+        EXPECT_EQ(columns.size(), expected_columns.size());
+        for (size_t i = 0; i < columns.size(); ++i) {
+            EXPECT_EQ(columns[i].column_name, expected_columns[i].name);
+            EXPECT_EQ(columns[i].order, expected_columns[i].order);
+        }
+    };
+
+    validate("CREATE INDEX test ON table_name (column_name);"sv, {}, "TEST"sv, "TABLE_NAME"sv, { { "COLUMN_NAME"sv } });
+    validate("CREATE INDEX schema_name.test ON table_name (column_name);"sv, "SCHEMA_NAME"sv, "TEST"sv, "TABLE_NAME"sv, { { "COLUMN_NAME"sv } });
+    validate("CREATE INDEX IF NOT EXISTS test ON table_name (column_name);"sv, {}, "TEST"sv, "TABLE_NAME"sv, { { "COLUMN_NAME"sv } }, false);
+    validate("CREATE INDEX test ON table_name (column1, column2 ASC, column3 DESC);"sv, {}, "TEST"sv, "TABLE_NAME"sv, { { "COLUMN1"sv }, { "COLUMN2"sv }, { "COLUMN3"sv, SQL::Order::Descending } });
+}
+
 TEST_CASE(insert)
 {
     EXPECT(parse("INSERT"sv).is_error());
@@ -783,3 +823,25 @@ TEST_CASE(describe_table)
     validate("DESCRIBE TABLE TableName;"sv, {}, "TABLENAME"sv);
     validate("DESCRIBE TABLE SchemaName.TableName;"sv, "SCHEMANAME"sv, "TABLENAME"sv);
 }
+
+TEST_CASE(explain)
+{
+    EXPECT(parse("EXPLAIN"sv).is_error());
+    EXPECT(parse("EXPLAIN;"sv).is_error());
+    EXPECT(parse("EXPLAIN QUERY;"sv).is_error());
+    EXPECT(parse("EXPLAIN QUERY PLAN;"sv).is_error());
+    EXPECT(parse("EXPLAIN SELECT * FROM table_name"sv).is_error());
+
+    auto validate = [](StringView sql, auto is_expected_statement) {
+        auto statement = TRY_OR_FAIL(parse(sql));
+        EXPECT(is<SQL::AST::Explain>(*statement));
+
+        auto const& explain_statement = static_cast<const SQL::AST::Explain&>(*statement);
+        EXPECT(is_expected_statement(*explain_statement.statement()));
+    };
+
+    validate("EXPLAIN SELECT * FROM table_name;"sv, [](auto const& statement) { return is<SQL::AST::Select>(statement); });
+    validate("EXPLAIN QUERY PLAN SELECT * FROM table_name WHERE column_name = 1;"sv, [](auto const& statement) { return is<SQL::AST::Select>(statement); });
+    validate("EXPLAIN UPDATE table_name SET column_name = 1;"sv, [](auto const& statement) { return is<SQL::AST::Update>(statement); });
+    validate("EXPLAIN DELETE FROM table_name WHERE column_name = 1;"sv, [](auto const& statement) { return is<SQL::AST::Delete>(statement); });
+}
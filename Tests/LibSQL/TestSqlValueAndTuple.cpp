@@ -633,6 +633,26 @@ TEST_CASE(order_int_values)
     EXPECT(v2 > v1);
 }
 
+TEST_CASE(order_int_and_float_values)
+{
+    // 2^53 + 1 can't be represented as a double, so it must not be rounded to compare with one.
+    SQL::Value large_int(static_cast<i64>(9007199254740993));
+    SQL::Value large_float(9007199254740992.0);
+    EXPECT(large_int > large_float);
+    EXPECT(large_float < large_int);
+    EXPECT(large_int != large_float);
+
+    SQL::Value two(2);
+    EXPECT(two < SQL::Value(2.5));
+    EXPECT(SQL::Value(2.5) > two);
+    EXPECT(two > SQL::Value(1.5));
+    EXPECT(two == SQL::Value(2.0));
+    EXPECT(SQL::Value(-2) > SQL::Value(-2.5));
+
+    EXPECT(SQL::Value(NumericLimits<u64>::max()) > SQL::Value(-1));
+    EXPECT(SQL::Value(-1) < SQL::Value(NumericLimits<u64>::max()));
+}
+
 TEST_CASE(tuple)
 {
     NonnullRefPtr<SQL::TupleDescriptor> descriptor = adopt_ref(*new SQL::TupleDescriptor);
@@ -82,3 +82,28 @@ TEST_CASE(test_TLS_hello_handshake)
 
     loop.exec();
 }
+
+TEST_CASE(test_TLS_session_resumption)
+{
+    Core::EventLoop loop;
+    auto root_certificates = TRY_OR_FAIL(load_certificates());
+    auto session_cache = TLS::SessionCache::create();
+
+    auto connect = [&] {
+        TLS::Options options;
+        options.set_root_certificates(root_certificates);
+        options.set_session_cache(session_cache);
+        return TLS::TLSv12::connect(DEFAULT_SERVER, port, move(options));
+    };
+
+    auto first_connection = TRY_OR_FAIL(connect());
+    EXPECT(!first_connection->is_resumed_session());
+    EXPECT(session_cache->find(DEFAULT_SERVER).has_value());
+    first_connection->close();
+
+    // The second connection should pick up where the first one left off, without a full handshake.
+    auto second_connection = TRY_OR_FAIL(connect());
+    EXPECT(second_connection->is_resumed_session());
+    EXPECT(second_connection->is_established());
+    second_connection->close();
+}
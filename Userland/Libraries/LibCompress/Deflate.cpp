@@ -62,7 +62,8 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
     }
 
     if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_prefix_table[0] = PrefixTableEntry { static_cast<u16>(last_non_zero), 1u };
+        TRY(code.m_prefix_table.try_resize(2));
+        code.m_prefix_table[0] = PrefixTableEntry { .symbol_value = static_cast<u16>(last_non_zero), .code_length = 1 };
         code.m_prefix_table[1] = code.m_prefix_table[0];
         code.m_max_prefixed_code_length = 1;
 
@@ -139,6 +140,7 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
     if (next_code != (1 << 15))
         return Error::from_string_literal("Failed to decode code lengths");
 
+    TRY(code.m_prefix_table.try_resize(1u << code.m_max_prefixed_code_length));
     for (auto [symbol_code, symbol_value, code_length] : prefix_codes) {
         if (code_length == 0 || code_length > CanonicalCode::max_allowed_prefixed_code_length)
             break;
@@ -148,36 +150,95 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
 
         for (size_t j = 0; j < (1u << shift); ++j) {
             auto index = fast_reverse16(symbol_code + j, code.m_max_prefixed_code_length);
-            code.m_prefix_table[index] = PrefixTableEntry { symbol_value, code_length };
+            code.m_prefix_table[index] = PrefixTableEntry { .symbol_value = symbol_value, .code_length = static_cast<u8>(code_length) };
         }
     }
 
+    // Runs of literals are common, so if the bits after a literal's code are enough to decode another literal, remember
+    // that one as well. The bits above the first code are the low bits of the index of the second one.
+    for (size_t index = 0; index < code.m_prefix_table.size(); ++index) {
+        auto& entry = code.m_prefix_table[index];
+        if (entry.code_length == 0 || entry.symbol_value >= EndOfBlock)
+            continue;
+
+        auto const& next_entry = code.m_prefix_table[index >> entry.code_length];
+        if (next_entry.code_length == 0 || next_entry.code_length > code.m_max_prefixed_code_length - entry.code_length || next_entry.symbol_value >= EndOfBlock)
+            continue;
+
+        entry.next_literal_code_length = next_entry.code_length;
+        entry.next_literal = next_entry.symbol_value;
+    }
+
     return code;
 }
 
-ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream) const
+ALWAYS_INLINE ErrorOr<u32> CanonicalCode::read_symbol_impl(LittleEndianInputBitStream& stream, Optional<u8>* next_literal) const
 {
-    auto prefix = TRY(stream.peek_bits<size_t>(m_max_prefixed_code_length));
+    // Near the end of the input there might not be enough bits left to peek at, even though the symbol is shorter.
+    auto prefix_or_error = stream.peek_bits<size_t>(m_max_prefixed_code_length);
+    if (prefix_or_error.is_error()) [[unlikely]]
+        return read_symbol_bit_by_bit(stream);
+
+    auto const& entry = m_prefix_table[prefix_or_error.value()];
+    if (entry.code_length != 0) {
+        if (next_literal && entry.next_literal_code_length != 0) {
+            stream.discard_previously_peeked_bits(entry.code_length + entry.next_literal_code_length);
+            *next_literal = entry.next_literal;
+        } else {
+            stream.discard_previously_peeked_bits(entry.code_length);
+        }
+        return entry.symbol_value;
+    }
 
-    if (auto [symbol_value, code_length] = m_prefix_table[prefix]; code_length != 0) {
-        stream.discard_previously_peeked_bits(code_length);
-        return symbol_value;
+    // The code is longer than what the prefix table covers. Codes of the same length are consecutive numbers, so we
+    // can find the length by comparing against the first code after each length.
+    auto code_bits_or_error = stream.peek_bits<u16>(max_code_length);
+    if (code_bits_or_error.is_error()) [[unlikely]]
+        return read_symbol_bit_by_bit(stream);
+
+    auto code_bits = fast_reverse16(code_bits_or_error.value(), max_code_length);
+    for (size_t code_length = m_max_prefixed_code_length + 1; code_length <= max_code_length; ++code_length) {
+        auto code = code_bits >> (max_code_length - code_length);
+        if (code < m_first_symbol_of_length_after[code_length]) {
+            stream.discard_previously_peeked_bits(code_length);
+            auto symbol_index = (uint16_t)(m_offset_to_first_symbol_index[code_length] + code);
+            return m_symbol_values[symbol_index];
+        }
     }
 
-    auto code_bits = TRY(stream.read_bits<u16>(m_max_prefixed_code_length + 1));
-    code_bits = fast_reverse16(code_bits, m_max_prefixed_code_length + 1);
+    return Error::from_string_literal("Symbol exceeds maximum symbol number");
+}
+
+ErrorOr<u32> CanonicalCode::read_symbol_bit_by_bit(LittleEndianInputBitStream& stream) const
+{
+    // A code with a single symbol doesn't have any of the tables below, but uses a single bit.
+    if (m_first_symbol_of_length_after.is_empty()) {
+        TRY(stream.read_bit());
+        return m_prefix_table[0].symbol_value;
+    }
 
-    for (size_t i = m_max_prefixed_code_length + 1; i <= 15; ++i) {
-        if (code_bits < m_first_symbol_of_length_after[i]) {
-            auto symbol_index = (uint16_t)(m_offset_to_first_symbol_index[i] + code_bits);
+    u32 code_bits = 0;
+    for (size_t code_length = 1; code_length <= max_code_length; ++code_length) {
+        code_bits = code_bits << 1 | TRY(stream.read_bit());
+        if (code_bits < m_first_symbol_of_length_after[code_length]) {
+            auto symbol_index = (uint16_t)(m_offset_to_first_symbol_index[code_length] + code_bits);
             return m_symbol_values[symbol_index];
         }
-        code_bits = code_bits << 1 | TRY(stream.read_bit());
     }
 
     return Error::from_string_literal("Symbol exceeds maximum symbol number");
 }
 
+ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream) const
+{
+    return read_symbol_impl(stream, nullptr);
+}
+
+ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream, Optional<u8>& next_literal) const
+{
+    return read_symbol_impl(stream, &next_literal);
+}
+
 DeflateDecompressor::CompressedBlock::CompressedBlock(DeflateDecompressor& decompressor, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes)
     : m_decompressor(decompressor)
     , m_literal_codes(literal_codes)
@@ -190,37 +251,61 @@ ErrorOr<bool> DeflateDecompressor::CompressedBlock::try_read_more()
     if (m_eof == true)
         return false;
 
-    auto const symbol = TRY(m_literal_codes.read_symbol(*m_decompressor.m_input_stream));
+    auto& input_stream = *m_decompressor.m_input_stream;
+    auto& output_buffer = m_decompressor.m_output_buffer;
 
-    if (symbol >= 286)
-        return Error::from_string_literal("Invalid deflate literal/length symbol");
+    // Literals are collected here and written to the output buffer in bulk.
+    Array<u8, 64> literals;
+    size_t literal_count = 0;
+    auto flush_literals = [&] {
+        auto written = output_buffer.write(literals.span().trim(literal_count));
+        VERIFY(written == literal_count);
+        literal_count = 0;
+    };
 
-    if (symbol < EndOfBlock) {
-        u8 byte_symbol = symbol;
-        m_decompressor.m_output_buffer.write({ &byte_symbol, sizeof(byte_symbol) });
-        return true;
-    }
+    // Decode for as long as the largest possible back-reference still fits into the output buffer, rather than a single
+    // symbol per call.
+    while (output_buffer.empty_space() >= literal_count + max_back_reference_length) {
+        Optional<u8> next_literal;
+        auto const symbol = TRY(m_literal_codes.read_symbol(input_stream, next_literal));
+
+        if (symbol < EndOfBlock) {
+            literals[literal_count++] = symbol;
+            if (next_literal.has_value())
+                literals[literal_count++] = *next_literal;
+            if (literal_count >= literals.size() - 1)
+                flush_literals();
+            continue;
+        }
 
-    if (symbol == EndOfBlock) {
-        m_eof = true;
-        return false;
-    }
+        flush_literals();
 
-    if (!m_distance_codes.has_value())
-        return Error::from_string_literal("Distance codes have not been initialized");
+        if (symbol == EndOfBlock) {
+            // Let the caller pick up what we have decoded so far, the next call will report the end of the block.
+            m_eof = true;
+            return true;
+        }
+
+        if (symbol >= 286)
+            return Error::from_string_literal("Invalid deflate literal/length symbol");
 
-    auto const length = TRY(m_decompressor.decode_length(symbol));
-    auto const distance_symbol = TRY(m_distance_codes.value().read_symbol(*m_decompressor.m_input_stream));
-    if (distance_symbol >= 30)
-        return Error::from_string_literal("Invalid deflate distance symbol");
+        if (!m_distance_codes.has_value())
+            return Error::from_string_literal("Distance codes have not been initialized");
 
-    auto const distance = TRY(m_decompressor.decode_distance(distance_symbol));
+        auto const length = TRY(m_decompressor.decode_length(symbol));
+        auto const distance_symbol = TRY(m_distance_codes.value().read_symbol(input_stream));
+        if (distance_symbol >= 30)
+            return Error::from_string_literal("Invalid deflate distance symbol");
 
-    auto copied_length = TRY(m_decompressor.m_output_buffer.copy_from_seekback(distance, length));
+        auto const distance = TRY(m_decompressor.decode_distance(distance_symbol));
 
-    // TODO: What should we do if the output buffer is full?
-    VERIFY(copied_length == length);
+        auto copied_length = TRY(output_buffer.copy_from_seekback(distance, length));
 
+        // The loop condition makes sure that there is enough space for this.
+        VERIFY(copied_length == length);
+    }
+
+    flush_literals();
     return true;
 }
 
@@ -493,7 +578,8 @@ DeflateCompressor::DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>
 
 DeflateCompressor::~DeflateCompressor()
 {
-    VERIFY(m_finished);
+    // Anything still pending would be lost, so a final_flush() or sync_flush() has to have happened.
+    VERIFY(m_finished || (m_synced && m_pending_block_size == 0));
 }
 
 ErrorOr<Bytes> DeflateCompressor::read_some(Bytes)
@@ -504,6 +590,7 @@ ErrorOr<Bytes> DeflateCompressor::read_some(Bytes)
 ErrorOr<size_t> DeflateCompressor::write_some(ReadonlyBytes bytes)
 {
     VERIFY(!m_finished);
+    m_synced = false;
 
     size_t total_written = 0;
     while (!bytes.is_empty()) {
@@ -970,6 +1057,22 @@ ErrorOr<void> DeflateCompressor::final_flush()
     return {};
 }
 
+ErrorOr<void> DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        TRY(flush());
+
+    TRY(m_output_stream->write_bits(0b0u, 1));  // not the final block
+    TRY(m_output_stream->write_bits(0b00u, 2)); // no compression
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0));
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0xffff));
+    TRY(m_output_stream->flush_buffer_to_stream());
+    m_synced = true;
+    return {};
+}
+
 ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
@@ -25,26 +25,39 @@ public:
     ErrorOr<u32> read_symbol(LittleEndianInputBitStream&) const;
     ErrorOr<void> write_symbol(LittleEndianOutputBitStream&, u32) const;
 
+    // Like read_symbol(), but if a literal byte is directly followed by the code of another literal, both are read at
+    // once and the second one is stored in `next_literal`. This only makes sense for the literal/length code of DEFLATE.
+    ErrorOr<u32> read_symbol(LittleEndianInputBitStream&, Optional<u8>& next_literal) const;
+
     static CanonicalCode const& fixed_literal_codes();
     static CanonicalCode const& fixed_distance_codes();
 
     static ErrorOr<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
-    static constexpr size_t max_allowed_prefixed_code_length = 8;
+    static constexpr size_t max_allowed_prefixed_code_length = 11;
+    static constexpr size_t max_code_length = 15;
 
     struct PrefixTableEntry {
         u16 symbol_value { 0 };
-        u16 code_length { 0 };
+        u8 code_length { 0 };
+
+        // If this is a literal and the remaining bits of the index hold the code of another literal.
+        u8 next_literal_code_length { 0 };
+        u8 next_literal { 0 };
     };
 
+    ErrorOr<u32> read_symbol_impl(LittleEndianInputBitStream&, Optional<u8>* next_literal) const;
+    ErrorOr<u32> read_symbol_bit_by_bit(LittleEndianInputBitStream&) const;
+
     // Decompression - indexed by code
     Vector<u16, 286> m_symbol_values;
 
     Vector<u32, 16> m_first_symbol_of_length_after;
     Vector<u16, 16> m_offset_to_first_symbol_index;
 
-    Array<PrefixTableEntry, 1 << max_allowed_prefixed_code_length> m_prefix_table {};
+    // Indexed by the next m_max_prefixed_code_length bits of the input, so it is only as large as it has to be.
+    Vector<PrefixTableEntry> m_prefix_table;
     size_t m_max_prefixed_code_length { 0 };
 
     // Compression - indexed by symbol
@@ -176,6 +189,10 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Ends the current block without ending the stream, and pads the output to a byte boundary with an empty stored
+    // block. Independently compressed streams ended this way can be concatenated into a single deflate stream.
+    ErrorOr<void> sync_flush();
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
 private:
@@ -207,6 +224,7 @@ private:
     ErrorOr<void> flush();
 
     bool m_finished { false };
+    bool m_synced { false };
     CompressionLevel m_compression_level;
     CompressionConstants m_compression_constants;
     NonnullOwnPtr<LittleEndianOutputBitStream> m_output_stream;
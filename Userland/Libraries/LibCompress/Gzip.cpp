@@ -7,10 +7,12 @@
 
 #include <LibCompress/Gzip.h>
 
+#include <AK/Atomic.h>
 #include <AK/BitStream.h>
 #include <AK/MemoryStream.h>
 #include <AK/String.h>
 #include <LibCore/DateTime.h>
+#include <LibThreading/Thread.h>
 
 namespace Compress {
 
@@ -184,8 +186,9 @@ ErrorOr<size_t> GzipDecompressor::write_some(ReadonlyBytes)
     return Error::from_errno(EBADF);
 }
 
-GzipCompressor::GzipCompressor(MaybeOwned<Stream> stream)
+GzipCompressor::GzipCompressor(MaybeOwned<Stream> stream, size_t thread_count)
     : m_output_stream(move(stream))
+    , m_thread_count(max(thread_count, 1uz))
 {
 }
 
@@ -205,16 +208,84 @@ ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
     TRY(m_output_stream->write_until_depleted({ &header, sizeof(header) }));
-    auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
-    TRY(compressed_stream->write_until_depleted(bytes));
-    TRY(compressed_stream->final_flush());
-    Crypto::Checksum::CRC32 crc32;
-    crc32.update(bytes);
-    TRY(m_output_stream->write_value<LittleEndian<u32>>(crc32.digest()));
+
+    u32 crc32;
+    if (m_thread_count > 1 && bytes.size() > parallel_chunk_size) {
+        crc32 = TRY(write_deflate_data_in_parallel(bytes));
+    } else {
+        auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
+        TRY(compressed_stream->write_until_depleted(bytes));
+        TRY(compressed_stream->final_flush());
+        crc32 = Crypto::Checksum::CRC32 { bytes }.digest();
+    }
+
+    TRY(m_output_stream->write_value<LittleEndian<u32>>(crc32));
     TRY(m_output_stream->write_value<LittleEndian<u32>>(bytes.size()));
     return bytes.size();
 }
 
+ErrorOr<u32> GzipCompressor::write_deflate_data_in_parallel(ReadonlyBytes bytes)
+{
+    struct Chunk {
+        ReadonlyBytes input;
+        ByteBuffer output {};
+        u32 crc32 { 0 };
+        Optional<Error> error {};
+    };
+
+    Vector<Chunk> chunks;
+    TRY(chunks.try_ensure_capacity(ceil_div(bytes.size(), parallel_chunk_size)));
+    for (size_t offset = 0; offset < bytes.size(); offset += parallel_chunk_size)
+        chunks.unchecked_append({ .input = bytes.slice(offset, min(parallel_chunk_size, bytes.size() - offset)) });
+
+    // Every chunk becomes a piece of one deflate stream: all but the last one end with a sync flush, so that they can
+    // simply be concatenated.
+    auto compress_chunk = [&](Chunk& chunk, bool is_last_chunk) -> ErrorOr<void> {
+        AllocatingMemoryStream output_stream;
+        auto compressor = TRY(DeflateCompressor::construct(MaybeOwned<Stream>(output_stream)));
+        TRY(compressor->write_until_depleted(chunk.input));
+        if (is_last_chunk)
+            TRY(compressor->final_flush());
+        else
+            TRY(compressor->sync_flush());
+
+        chunk.output = TRY(output_stream.read_until_eof());
+        chunk.crc32 = Crypto::Checksum::CRC32 { chunk.input }.digest();
+        return {};
+    };
+
+    Atomic<size_t> next_chunk_index { 0 };
+    auto compress_chunks = [&]() -> intptr_t {
+        for (;;) {
+            auto index = next_chunk_index.fetch_add(1);
+            if (index >= chunks.size())
+                return 0;
+            if (auto result = compress_chunk(chunks[index], index == chunks.size() - 1); result.is_error())
+                chunks[index].error = result.release_error();
+        }
+    };
+
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    auto thread_count = min(m_thread_count, chunks.size());
+    TRY(threads.try_ensure_capacity(thread_count));
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto thread = Threading::Thread::construct([&] { return compress_chunks(); }, "GzipCompressor"sv);
+        thread->start();
+        threads.unchecked_append(move(thread));
+    }
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    u32 crc32 = 0;
+    for (auto& chunk : chunks) {
+        if (chunk.error.has_value())
+            return chunk.error.release_value();
+        TRY(m_output_stream->write_until_depleted(chunk.output));
+        crc32 = Crypto::Checksum::CRC32::combine(crc32, chunk.crc32, chunk.input.size());
+    }
+    return crc32;
+}
+
 bool GzipCompressor::is_eof() const
 {
     return true;
@@ -229,10 +300,10 @@ void GzipCompressor::close()
 {
 }
 
-ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
+ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes, size_t thread_count)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
-    GzipCompressor gzip_stream { MaybeOwned<Stream>(*output_stream) };
+    GzipCompressor gzip_stream { MaybeOwned<Stream>(*output_stream), thread_count };
 
     TRY(gzip_stream.write_until_depleted(bytes));
 
@@ -83,7 +83,8 @@ private:
 
 class GzipCompressor final : public Stream {
 public:
-    GzipCompressor(MaybeOwned<Stream>);
+    // With more than one thread, large writes are split into chunks that are compressed in parallel, like pigz does.
+    GzipCompressor(MaybeOwned<Stream>, size_t thread_count = 1);
 
     virtual ErrorOr<Bytes> read_some(Bytes) override;
     virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
@@ -91,10 +92,17 @@ public:
     virtual bool is_open() const override;
     virtual void close() override;
 
-    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes);
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, size_t thread_count = 1);
+
+    // DeflateCompressor doesn't look for matches across its own blocks, so chunks that are a multiple of its block
+    // size compress just as well on their own.
+    static constexpr size_t parallel_chunk_size = 4 * DeflateCompressor::block_size;
 
 private:
+    ErrorOr<u32> write_deflate_data_in_parallel(ReadonlyBytes);
+
     MaybeOwned<Stream> m_output_stream;
+    size_t m_thread_count { 1 };
 };
 
 }
@@ -5,7 +5,10 @@
  */
 
 #include <AK/ByteReader.h>
+#include <AK/CPUFeatures.h>
 #include <AK/Debug.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Types.h>
 #include <LibCrypto/Authentication/GHash.h>
 
@@ -27,38 +30,150 @@ static void to_u8s(u8* b, u32 const* w)
 
 namespace Crypto::Authentication {
 
-GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
+template<CPUFeatures>
+static void update_blocks_impl(u32 (&tag)[4], u32 const (&key)[4], u32 const (&key_powers)[GHash::aggregated_block_count][4], ReadonlyBytes blocks);
+
+template<>
+void update_blocks_impl<CPUFeatures::None>(u32 (&tag)[4], u32 const (&key)[4], u32 const (&)[GHash::aggregated_block_count][4], ReadonlyBytes blocks)
 {
-    u32 tag[4] { 0, 0, 0, 0 };
-
-    auto transform_one = [&](auto& buf) {
-        size_t i = 0;
-        for (; i < buf.size(); i += 16) {
-            if (i + 16 <= buf.size()) {
-                for (auto j = 0; j < 4; ++j) {
-                    tag[j] ^= to_u32(buf.offset(i + j * 4));
-                }
-                galois_multiply(tag, m_key, tag);
-            }
+    for (size_t i = 0; i < blocks.size(); i += 16) {
+        for (auto j = 0; j < 4; ++j) {
+            tag[j] ^= to_u32(blocks.offset(i + j * 4));
         }
+        galois_multiply(tag, key, tag);
+    }
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_PCLMUL
+// This follows Intel's "Intel Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode".
+// Blocks are kept as 128-bit little-endian integers, i.e. with their bytes reversed. Because GHASH numbers the bits of
+// each byte the other way around, the carry-less product of two such values comes out shifted right by one bit.
+using AK::SIMD::u32x4, AK::SIMD::u64x2, AK::SIMD::u8x16;
+using illx2 = signed long long int __attribute__((vector_size(16)));
+
+struct WideProduct {
+    u64x2 low;
+    u64x2 high;
+};
+
+template<int selector>
+[[gnu::target("pclmul"), gnu::always_inline]] static inline u64x2 carryless_multiply(u64x2 a, u64x2 b)
+{
+    return bit_cast<u64x2>(__builtin_ia32_pclmulqdq128(bit_cast<illx2>(a), bit_cast<illx2>(b), selector));
+}
+
+[[gnu::target("pclmul"), gnu::always_inline]] static inline WideProduct multiply(u64x2 a, u64x2 b)
+{
+    auto middle = carryless_multiply<0x01>(a, b) ^ carryless_multiply<0x10>(a, b);
+    return {
+        carryless_multiply<0x00>(a, b) ^ u64x2 { 0, middle[0] },
+        carryless_multiply<0x11>(a, b) ^ u64x2 { middle[1], 0 },
+    };
+}
+
+[[gnu::target("pclmul"), gnu::always_inline]] static inline u64x2 reduce(WideProduct product)
+{
+    auto low = bit_cast<u32x4>(product.low);
+    auto high = bit_cast<u32x4>(product.high);
+
+    // Undo the bit shift by shifting the whole 256-bit product left by one.
+    auto low_carry = low >> 31;
+    auto high_carry = high >> 31;
+    low = (low << 1) | u32x4 { 0, low_carry[0], low_carry[1], low_carry[2] };
+    high = (high << 1) | u32x4 { low_carry[3], high_carry[0], high_carry[1], high_carry[2] };
+
+    // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+    auto folded = (low << 31) ^ (low << 30) ^ (low << 25);
+    low ^= u32x4 { 0, 0, 0, folded[0] };
+    auto remainder = (low >> 1) ^ (low >> 2) ^ (low >> 7) ^ u32x4 { folded[1], folded[2], folded[3], 0 };
+    return bit_cast<u64x2>(high ^ low ^ remainder);
+}
 
-        if (i > buf.size()) {
-            u8 buffer[16] = {};
-            Bytes buffer_bytes { buffer, 16 };
-            buf.slice(i - 16).copy_to(buffer_bytes);
+[[gnu::target("pclmul"), gnu::always_inline]] static inline u64x2 from_words(u32 const (&words)[4])
+{
+    return bit_cast<u64x2>(u32x4 { words[3], words[2], words[1], words[0] });
+}
+
+[[gnu::target("pclmul"), gnu::always_inline]] static inline u64x2 load_block(u8 const* block)
+{
+    return bit_cast<u64x2>(AK::SIMD::item_reverse(AK::SIMD::load_unaligned<u8x16>(block)));
+}
 
-            for (auto j = 0; j < 4; ++j) {
-                tag[j] ^= to_u32(buffer_bytes.offset(j * 4));
+template<>
+[[gnu::target("pclmul")]] void update_blocks_impl<CPUFeatures::X86_PCLMUL>(u32 (&tag)[4], u32 const (&key)[4], u32 const (&key_powers)[GHash::aggregated_block_count][4], ReadonlyBytes blocks)
+{
+    constexpr auto block_count = GHash::aggregated_block_count;
+
+    auto value = from_words(tag);
+    auto const* data = blocks.data();
+    auto remaining = blocks.size();
+
+    if (remaining >= block_count * 16) {
+        u64x2 powers[block_count];
+        for (size_t i = 0; i < block_count; ++i)
+            powers[i] = from_words(key_powers[i]);
+
+        // ((((tag ^ X1) * H ^ X2) * H ...) ^ X8) * H = (tag ^ X1) * H^8 ^ X2 * H^7 ^ ... ^ X8 * H, which only needs a
+        // single reduction at the end.
+        while (remaining >= block_count * 16) {
+            auto product = multiply(value ^ load_block(data), powers[block_count - 1]);
+            for (size_t i = 1; i < block_count; ++i) {
+                auto next = multiply(load_block(data + i * 16), powers[block_count - 1 - i]);
+                product.low ^= next.low;
+                product.high ^= next.high;
             }
-            galois_multiply(tag, m_key, tag);
+            value = reduce(product);
+            data += block_count * 16;
+            remaining -= block_count * 16;
         }
-    };
+    }
+
+    auto h = from_words(key);
+    for (; remaining >= 16; data += 16, remaining -= 16)
+        value = reduce(multiply(value ^ load_block(data), h));
+
+    auto words = bit_cast<u32x4>(value);
+    tag[0] = words[3];
+    tag[1] = words[2];
+    tag[2] = words[1];
+    tag[3] = words[0];
+}
+#endif
+
+static void (*const update_blocks_dispatched)(u32 (&)[4], u32 const (&)[4], u32 const (&)[GHash::aggregated_block_count][4], ReadonlyBytes) = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_PCLMUL)) {
+        if (has_flag(features, CPUFeatures::X86_PCLMUL))
+            return &update_blocks_impl<CPUFeatures::X86_PCLMUL>;
+    }
+
+    return &update_blocks_impl<CPUFeatures::None>;
+}();
+
+void GHash::compute_key_powers()
+{
+    __builtin_memcpy(m_key_powers[0], m_key, sizeof(m_key));
+    for (size_t i = 1; i < aggregated_block_count; ++i)
+        galois_multiply(m_key_powers[i], m_key_powers[i - 1], m_key);
+}
 
-    transform_one(aad);
-    transform_one(cipher);
+void GHash::update(ReadonlyBytes data)
+{
+    auto whole_blocks = data.trim(data.size() - data.size() % 16);
+    update_blocks_dispatched(m_tag, m_key, m_key_powers, whole_blocks);
 
-    auto aad_bits = 8 * (u64)aad.size();
-    auto cipher_bits = 8 * (u64)cipher.size();
+    if (whole_blocks.size() < data.size()) {
+        u8 buffer[16] = {};
+        data.slice(whole_blocks.size()).copy_to(buffer);
+        update_blocks_dispatched(m_tag, m_key, m_key_powers, { buffer, 16 });
+    }
+}
+
+GHash::TagType GHash::finish(u64 aad_length, u64 cipher_length)
+{
+    auto aad_bits = 8 * aad_length;
+    auto cipher_bits = 8 * cipher_length;
 
     auto high = [](u64 value) -> u32 { return value >> 32; };
     auto low = [](u64 value) -> u32 { return value & 0xffffffff; };
@@ -66,24 +181,32 @@ GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
     if constexpr (GHASH_PROCESS_DEBUG) {
         dbgln("AAD bits: {} : {}", high(aad_bits), low(aad_bits));
         dbgln("Cipher bits: {} : {}", high(cipher_bits), low(cipher_bits));
-        dbgln("Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
+        dbgln("Tag bits: {} : {} : {} : {}", m_tag[0], m_tag[1], m_tag[2], m_tag[3]);
     }
 
-    tag[0] ^= high(aad_bits);
-    tag[1] ^= low(aad_bits);
-    tag[2] ^= high(cipher_bits);
-    tag[3] ^= low(cipher_bits);
+    m_tag[0] ^= high(aad_bits);
+    m_tag[1] ^= low(aad_bits);
+    m_tag[2] ^= high(cipher_bits);
+    m_tag[3] ^= low(cipher_bits);
 
-    dbgln_if(GHASH_PROCESS_DEBUG, "Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
+    dbgln_if(GHASH_PROCESS_DEBUG, "Tag bits: {} : {} : {} : {}", m_tag[0], m_tag[1], m_tag[2], m_tag[3]);
 
-    galois_multiply(tag, m_key, tag);
+    galois_multiply(m_tag, m_key, m_tag);
 
     TagType digest;
-    to_u8s(digest.data, tag);
+    to_u8s(digest.data, m_tag);
 
+    __builtin_memset(m_tag, 0, sizeof(m_tag));
     return digest;
 }
 
+GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
+{
+    update(aad);
+    update(cipher);
+    return finish(aad.size(), cipher.size());
+}
+
 /// Galois Field multiplication using <x^127 + x^7 + x^2 + x + 1>.
 /// Note that x, y, and z are strictly BE.
 void galois_multiply(u32 (&_z)[4], u32 const (&_x)[4], u32 const (&_y)[4])
@@ -43,6 +43,7 @@ public:
         for (size_t i = 0; i < 16; i += 4) {
             m_key[i / 4] = AK::convert_between_host_and_big_endian(ByteReader::load32(key.offset(i)));
         }
+        compute_key_powers();
     }
 
     constexpr static size_t digest_size() { return TagType::Size; }
@@ -56,8 +57,24 @@ public:
 
     TagType process(ReadonlyBytes aad, ReadonlyBytes cipher);
 
+    // The same as process(), but with the input fed in pieces, so that it can be interleaved with the encryption.
+    // Each piece is padded with zeroes to a whole number of blocks, so only the last piece of the AAD and the last
+    // piece of the ciphertext may end in a partial block.
+    void update(ReadonlyBytes);
+    TagType finish(u64 aad_length, u64 cipher_length);
+
+    // How many blocks the vectorized implementation hashes at once.
+    static constexpr size_t aggregated_block_count = 8;
+
 private:
+    void compute_key_powers();
+
     u32 m_key[4];
+
+    // H, H^2, ..., H^8, which allow hashing several blocks with a single reduction.
+    u32 m_key_powers[aggregated_block_count][4];
+
+    u32 m_tag[4] { 0, 0, 0, 0 };
 };
 
 }
@@ -6,6 +6,7 @@
  */
 
 #include "UnsignedBigIntegerAlgorithms.h"
+#include <AK/BigIntBase.h>
 
 namespace Crypto {
 
@@ -13,9 +14,7 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
     UnsignedBigInteger& ep,
     UnsignedBigInteger& base,
     UnsignedBigInteger const& m,
-    UnsignedBigInteger& temp_1,
-    UnsignedBigInteger& temp_2,
-    UnsignedBigInteger& temp_3,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& temp_multiply,
     UnsignedBigInteger& temp_quotient,
     UnsignedBigInteger& temp_remainder,
@@ -25,7 +24,7 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
     while (!(ep < 1)) {
         if (ep.words()[0] % 2 == 1) {
             // exp = (exp * base) % m;
-            multiply_without_allocation(exp, base, temp_1, temp_2, temp_3, temp_multiply);
+            multiply_without_allocation(exp, base, temp_scratch, temp_multiply);
             divide_without_allocation(temp_multiply, m, temp_quotient, temp_remainder);
             exp.set_to(temp_remainder);
         }
@@ -34,7 +33,7 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
         ep.set_to(ep.shift_right(1));
 
         // base = (base * base) % m;
-        multiply_without_allocation(base, base, temp_1, temp_2, temp_3, temp_multiply);
+        multiply_without_allocation(base, base, temp_scratch, temp_multiply);
         divide_without_allocation(temp_multiply, m, temp_quotient, temp_remainder);
         base.set_to(temp_remainder);
 
@@ -181,6 +180,241 @@ void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allo
     result.resize_with_leading_zeros(num_words);
 }
 
+using AK::Detail::native_word_size;
+using AK::Detail::NativeDoubleWord;
+using AK::Detail::NativeWord;
+using AK::Detail::wide_multiply;
+
+// Moduli of up to this many bits (which covers RSA keys up to 4096 bits) are exponentiated on fixed-size arrays of
+// native words on the stack, rather than on UnsignedBigIntegers.
+static constexpr size_t fixed_montgomery_max_bits = 4096;
+static constexpr size_t fixed_montgomery_max_words = fixed_montgomery_max_bits / native_word_size;
+static constexpr size_t words_per_native_word = sizeof(NativeWord) / sizeof(UnsignedBigInteger::Word);
+
+using FixedMontgomeryNumber = NativeWord[fixed_montgomery_max_words];
+
+/**
+ * Compute -(1/value) % 2^native_word_size, for an odd value.
+ * Every step of Newton's iteration doubles the number of correct low bits, and value * value == 1 (mod 8).
+ */
+static NativeWord negated_inverse_wrapped(NativeWord value)
+{
+    VERIFY(value & 1);
+
+    NativeWord inverse = value;
+    for (size_t correct_bits = 3; correct_bits < native_word_size; correct_bits *= 2)
+        inverse *= 2 - value * inverse;
+    return -inverse;
+}
+
+static void load_native_words(UnsignedBigInteger const& number, size_t num_words, NativeWord* output)
+{
+    auto const& words = number.words();
+    for (size_t i = 0; i < num_words; ++i) {
+        output[i] = 0;
+        for (size_t j = 0; j < words_per_native_word; ++j) {
+            size_t index = i * words_per_native_word + j;
+            if (index < words.size())
+                output[i] |= static_cast<NativeWord>(words[index]) << (j * UnsignedBigInteger::BITS_IN_WORD);
+        }
+    }
+}
+
+/**
+ * z = t - modulo if there is a carry out of t's num_words words, and z = t otherwise.
+ */
+static void fixed_montgomery_reduce_once(NativeWord const* t, NativeWord carry, NativeWord const* modulo, size_t num_words, NativeWord* z)
+{
+    if (carry == 0) {
+        __builtin_memcpy(z, t, num_words * sizeof(NativeWord));
+        return;
+    }
+    bool borrow = false;
+    for (size_t i = 0; i < num_words; ++i)
+        z[i] = AK::Detail::sub_words(t[i], modulo[i], borrow);
+}
+
+/**
+ * Computes the "almost montgomery" product like almost_montgomery_multiplication_without_allocation(), on native words:
+ * z = x * y * 2 ^ (-num_words * native_word_size) % modulo, where z is only guaranteed to be below 2 ^ (num_words * native_word_size).
+ * This is the "Coarsely Integrated Operand Scanning" method, which interleaves the multiplication and the reduction word by word.
+ * Algorithm from: Koç, Acar, Kaliski, "Analyzing and Comparing Montgomery Multiplication Algorithms".
+ */
+static void fixed_montgomery_multiply(NativeWord const* x, NativeWord const* y, NativeWord const* modulo, NativeWord k, size_t num_words, NativeWord* z)
+{
+    NativeWord t[fixed_montgomery_max_words + 2];
+    __builtin_memset(t, 0, (num_words + 2) * sizeof(NativeWord));
+
+    for (size_t i = 0; i < num_words; ++i) {
+        // t += x * y_i
+        NativeDoubleWord carry = 0;
+        for (size_t j = 0; j < num_words; ++j) {
+            carry += wide_multiply(x[j], y[i]) + t[j];
+            t[j] = static_cast<NativeWord>(carry);
+            carry >>= native_word_size;
+        }
+        carry += t[num_words];
+        t[num_words] = static_cast<NativeWord>(carry);
+        t[num_words + 1] = static_cast<NativeWord>(carry >> native_word_size);
+
+        // t = (t + modulo * (t_0 * k)) >> native_word_size, where the addition makes the lowest word zero.
+        NativeWord factor = t[0] * k;
+        carry = (wide_multiply(factor, modulo[0]) + t[0]) >> native_word_size;
+        for (size_t j = 1; j < num_words; ++j) {
+            carry += wide_multiply(factor, modulo[j]) + t[j];
+            t[j - 1] = static_cast<NativeWord>(carry);
+            carry >>= native_word_size;
+        }
+        carry += t[num_words];
+        t[num_words - 1] = static_cast<NativeWord>(carry);
+        t[num_words] = t[num_words + 1] + static_cast<NativeWord>(carry >> native_word_size);
+    }
+
+    fixed_montgomery_reduce_once(t, t[num_words], modulo, num_words, z);
+}
+
+/**
+ * Like fixed_montgomery_multiply(x, x, ...), but squares first (with the products of different words computed only once)
+ * and reduces afterwards. Squarings make up four out of five multiplications of the modular power below.
+ */
+static void fixed_montgomery_square(NativeWord const* x, NativeWord const* modulo, NativeWord k, size_t num_words, NativeWord* z)
+{
+    NativeWord t[2 * fixed_montgomery_max_words];
+    __builtin_memset(t, 0, 2 * num_words * sizeof(NativeWord));
+
+    // t = x * x: the cross products, doubled, plus the squares of each word.
+    for (size_t i = 0; i < num_words; ++i) {
+        NativeDoubleWord carry = 0;
+        for (size_t j = i + 1; j < num_words; ++j) {
+            carry += wide_multiply(x[i], x[j]) + t[i + j];
+            t[i + j] = static_cast<NativeWord>(carry);
+            carry >>= native_word_size;
+        }
+        t[i + num_words] = static_cast<NativeWord>(carry);
+    }
+    NativeWord top_bit = 0;
+    for (size_t i = 0; i < 2 * num_words; ++i) {
+        NativeWord word = t[i];
+        t[i] = (word << 1) | top_bit;
+        top_bit = word >> (native_word_size - 1);
+    }
+    NativeDoubleWord carry = 0;
+    for (size_t i = 0; i < num_words; ++i) {
+        carry += wide_multiply(x[i], x[i]) + t[2 * i];
+        t[2 * i] = static_cast<NativeWord>(carry);
+        carry >>= native_word_size;
+        carry += t[2 * i + 1];
+        t[2 * i + 1] = static_cast<NativeWord>(carry);
+        carry >>= native_word_size;
+    }
+
+    // Montgomery reduction: zero out the low words one by one by adding multiples of the modulo.
+    NativeWord overflow = 0;
+    for (size_t i = 0; i < num_words; ++i) {
+        NativeWord factor = t[i] * k;
+        carry = 0;
+        for (size_t j = 0; j < num_words; ++j) {
+            carry += wide_multiply(factor, modulo[j]) + t[i + j];
+            t[i + j] = static_cast<NativeWord>(carry);
+            carry >>= native_word_size;
+        }
+        carry += static_cast<NativeDoubleWord>(t[i + num_words]) + overflow;
+        t[i + num_words] = static_cast<NativeWord>(carry);
+        overflow = static_cast<NativeWord>(carry >> native_word_size);
+    }
+
+    fixed_montgomery_reduce_once(t + num_words, overflow, modulo, num_words, z);
+}
+
+/**
+ * The same algorithm as montgomery_modular_power_with_minimal_allocations(), for moduli of up to fixed_montgomery_max_bits bits.
+ */
+void UnsignedBigIntegerAlgorithms::fixed_montgomery_modular_power(
+    UnsignedBigInteger const& base,
+    UnsignedBigInteger const& exponent,
+    UnsignedBigInteger const& modulo,
+    UnsignedBigInteger& temp_one,
+    UnsignedBigInteger& temp_x,
+    UnsignedBigInteger& temp_extra,
+    UnsignedBigInteger& temp_rr,
+    UnsignedBigInteger& result)
+{
+    constexpr size_t window_size = 4;
+
+    size_t num_words = ceil_div(modulo.trimmed_length(), words_per_native_word);
+    VERIFY(num_words <= fixed_montgomery_max_words);
+
+    FixedMontgomeryNumber m;
+    load_native_words(modulo, num_words, m);
+    NativeWord k = negated_inverse_wrapped(m[0]);
+
+    // rr = ( 2 ^ (2 * num_words * native_word_size) ) % modulo
+    temp_one.set_to(1);
+    shift_left_by_n_words(temp_one, 2 * num_words * words_per_native_word, temp_x);
+    divide_without_allocation(temp_x, modulo, temp_extra, temp_rr);
+    FixedMontgomeryNumber rr;
+    load_native_words(temp_rr, num_words, rr);
+
+    // x = base [% modulo, if x doesn't already fit in modulo's words]
+    FixedMontgomeryNumber x;
+    if (base.trimmed_length() > modulo.trimmed_length()) {
+        divide_without_allocation(base, modulo, temp_extra, temp_x);
+        load_native_words(temp_x, num_words, x);
+    } else {
+        load_native_words(base, num_words, x);
+    }
+
+    FixedMontgomeryNumber one {};
+    one[0] = 1;
+
+    // Compute the montgomery powers from 0 to 2^window_size. powers[i] = x^i
+    FixedMontgomeryNumber powers[1 << window_size];
+    fixed_montgomery_multiply(one, rr, m, k, num_words, powers[0]);
+    fixed_montgomery_multiply(x, rr, m, k, num_words, powers[1]);
+    for (size_t i = 2; i < (1 << window_size); ++i)
+        fixed_montgomery_multiply(powers[i - 1], powers[1], m, k, num_words, powers[i]);
+
+    FixedMontgomeryNumber z;
+    __builtin_memcpy(z, powers[0], num_words * sizeof(NativeWord));
+
+    ssize_t exponent_length = exponent.trimmed_length();
+    for (ssize_t word_in_exponent = exponent_length - 1; word_in_exponent >= 0; --word_in_exponent) {
+        UnsignedBigInteger::Word exponent_word = exponent.m_words[word_in_exponent];
+        size_t bit_in_word = 0;
+        while (bit_in_word < UnsignedBigInteger::BITS_IN_WORD) {
+            if (word_in_exponent != exponent_length - 1 || bit_in_word != 0) {
+                for (size_t i = 0; i < window_size; ++i)
+                    fixed_montgomery_square(z, m, k, num_words, z);
+            }
+            auto power_index = exponent_word >> (UnsignedBigInteger::BITS_IN_WORD - window_size);
+            fixed_montgomery_multiply(z, powers[power_index], m, k, num_words, z);
+
+            // Move to the next window
+            exponent_word <<= window_size;
+            bit_in_word += window_size;
+        }
+    }
+
+    fixed_montgomery_multiply(z, one, m, k, num_words, z);
+
+    // Multiplying by one leaves at most the modulo itself, which is one subtraction away from the actual result.
+    bool is_below_modulo = false;
+    for (size_t i = num_words; i-- > 0;) {
+        if (z[i] != m[i]) {
+            is_below_modulo = z[i] < m[i];
+            break;
+        }
+    }
+    if (!is_below_modulo)
+        fixed_montgomery_reduce_once(z, 1, m, num_words, z);
+
+    result.set_to_0();
+    result.resize_with_leading_zeros(num_words * words_per_native_word);
+    for (size_t i = 0; i < num_words * words_per_native_word; ++i)
+        result.m_words[i] = static_cast<UnsignedBigInteger::Word>(z[i / words_per_native_word] >> (i % words_per_native_word * UnsignedBigInteger::BITS_IN_WORD));
+    result.clamp_to_trimmed_length();
+}
+
 /**
  * Complexity: still O(N^3) with N the number of words in the largest word, but less complex than the classical mod power.
  * Note: the montgomery multiplications requires an inverse modulo over 2^32, which is only defined for odd numbers.
@@ -200,6 +434,9 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
 {
     VERIFY(modulo.is_odd());
 
+    if (modulo.trimmed_length() * UnsignedBigInteger::BITS_IN_WORD <= fixed_montgomery_max_bits)
+        return fixed_montgomery_modular_power(base, exponent, modulo, one, x, temp_extra, rr, result);
+
     // Note: While this is a constexpr variable for clarity and could be changed in theory,
     // various optimized parts of the algorithm rely on this value being exactly 4.
     constexpr size_t window_size = 4;
@@ -6,41 +6,236 @@
  */
 
 #include "UnsignedBigIntegerAlgorithms.h"
+#include <AK/BigIntBase.h>
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using AK::Detail::wide_multiply;
+
+// Below this many words, the schoolbook method beats Karatsuba's additions and bookkeeping. Schoolbook squaring only
+// does half the work, so it stays faster for longer.
+static constexpr size_t karatsuba_threshold = 32;
+static constexpr size_t karatsuba_square_threshold = 48;
+
+/**
+ * Adds b (b_length words) into a (a_length words, a_length >= b_length) and returns the carry out of a.
+ */
+static Word add_words_in_place(Word* a, size_t a_length, Word const* b, size_t b_length)
+{
+    u64 carry = 0;
+    size_t i = 0;
+    for (; i < b_length; ++i) {
+        carry += static_cast<u64>(a[i]) + b[i];
+        a[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    for (; carry != 0 && i < a_length; ++i) {
+        carry += a[i];
+        a[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    return static_cast<Word>(carry);
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Subtracts b (b_length words) from a (a_length words, a_length >= b_length), which must not underflow.
+ */
+static void subtract_words_in_place(Word* a, size_t a_length, Word const* b, size_t b_length)
+{
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < b_length; ++i) {
+        u64 difference = static_cast<u64>(a[i]) - b[i] - borrow;
+        a[i] = static_cast<Word>(difference);
+        borrow = static_cast<Word>(difference >> 63);
+    }
+    for (; borrow != 0 && i < a_length; ++i) {
+        borrow = a[i] == 0;
+        --a[i];
+    }
+    VERIFY(borrow == 0);
+}
+
+/**
+ * Complexity: O(N * M)
+ * result must have room for a_length + b_length words, and must not overlap the operands.
+ */
+static void schoolbook_multiply(Word const* a, size_t a_length, Word const* b, size_t b_length, Word* result)
+{
+    __builtin_memset(result, 0, (a_length + b_length) * sizeof(Word));
+    for (size_t i = 0; i < a_length; ++i) {
+        u64 carry = 0;
+        for (size_t j = 0; j < b_length; ++j) {
+            carry += wide_multiply(a[i], b[j]) + result[i + j];
+            result[i + j] = static_cast<Word>(carry);
+            carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        }
+        result[i + b_length] = static_cast<Word>(carry);
+    }
+}
+
+/**
+ * Complexity: O(N^2), but with about half the multiplications of schoolbook_multiply(a, a).
+ * Every product a[i] * a[j] with i != j appears twice in the square, so these are summed up once and doubled, and the
+ * squares of the single words are added on top.
+ */
+static void schoolbook_square(Word const* a, size_t length, Word* result)
+{
+    __builtin_memset(result, 0, 2 * length * sizeof(Word));
+    for (size_t i = 0; i < length; ++i) {
+        u64 carry = 0;
+        for (size_t j = i + 1; j < length; ++j) {
+            carry += wide_multiply(a[i], a[j]) + result[i + j];
+            result[i + j] = static_cast<Word>(carry);
+            carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        }
+        result[i + length] = static_cast<Word>(carry);
+    }
+
+    Word top_bit = 0;
+    for (size_t i = 0; i < 2 * length; ++i) {
+        Word word = result[i];
+        result[i] = (word << 1) | top_bit;
+        top_bit = word >> (UnsignedBigInteger::BITS_IN_WORD - 1);
+    }
+
+    u64 carry = 0;
+    for (size_t i = 0; i < length; ++i) {
+        carry += wide_multiply(a[i], a[i]) + result[2 * i];
+        result[2 * i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        carry += result[2 * i + 1];
+        result[2 * i + 1] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+}
+
+/**
+ * The number of scratch words that multiply_words() and square_words() need for operands of up to `length` words.
+ * Squaring needs less, as it stops splitting earlier and has only one sum per level.
+ */
+static size_t karatsuba_scratch_length(size_t length)
+{
+    if (length < karatsuba_threshold)
+        return 0;
+    size_t half = (length + 1) / 2;
+    return 4 * (half + 1) + karatsuba_scratch_length(half + 1);
+}
+
+/**
+ * Complexity: O(N^1.58) where N is the number of words in the larger number
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Karatsuba's method, with both numbers split into a low part (x0) and a high part (x1) at the same word:
+ *  a * b = a1 * b1 << 2m + ((a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1) << m + a0 * b0
+ * which is three multiplications of half the size instead of four. Small products are done the schoolbook way.
+ */
+static void multiply_words(Word const* a, size_t a_length, Word const* b, size_t b_length, Word* result, Word* scratch)
+{
+    if (a_length < b_length) {
+        swap(a, b);
+        swap(a_length, b_length);
+    }
+
+    if (b_length < karatsuba_threshold)
+        return schoolbook_multiply(a, a_length, b, b_length, result);
+
+    size_t half = (a_length + 1) / 2;
+    size_t result_length = a_length + b_length;
+
+    if (b_length <= half) {
+        // b doesn't reach into the high part of a, so this is just a0 * b + (a1 * b) << m.
+        multiply_words(a, half, b, b_length, result, scratch);
+        __builtin_memset(result + half + b_length, 0, (a_length - half) * sizeof(Word));
+
+        auto* high_product = scratch;
+        size_t high_product_length = a_length - half + b_length;
+        multiply_words(a + half, a_length - half, b, b_length, high_product, scratch + high_product_length);
+        add_words_in_place(result + half, result_length - half, high_product, high_product_length);
+        return;
+    }
+
+    auto* a_sum = scratch;
+    auto* b_sum = a_sum + half + 1;
+    auto* middle = b_sum + half + 1;
+    auto* rest_of_scratch = middle + 2 * (half + 1);
+
+    // The low and high products go straight into their places in the result.
+    multiply_words(a, half, b, half, result, rest_of_scratch);
+    multiply_words(a + half, a_length - half, b + half, b_length - half, result + 2 * half, rest_of_scratch);
+
+    __builtin_memcpy(a_sum, a, half * sizeof(Word));
+    a_sum[half] = add_words_in_place(a_sum, half, a + half, a_length - half);
+    __builtin_memcpy(b_sum, b, half * sizeof(Word));
+    b_sum[half] = add_words_in_place(b_sum, half, b + half, b_length - half);
+
+    multiply_words(a_sum, half + 1, b_sum, half + 1, middle, rest_of_scratch);
+    subtract_words_in_place(middle, 2 * (half + 1), result, 2 * half);
+    subtract_words_in_place(middle, 2 * (half + 1), result + 2 * half, result_length - 2 * half);
+
+    // The middle product fits into the result (together with the others), so its top words are zero from here on.
+    size_t middle_length = min(2 * (half + 1), result_length - half);
+    add_words_in_place(result + half, result_length - half, middle, middle_length);
+}
+
+/**
+ * Complexity: O(N^1.58)
+ * Like multiply_words(), but using schoolbook_square() for the small squares.
+ */
+static void square_words(Word const* a, size_t length, Word* result, Word* scratch)
+{
+    if (length < karatsuba_square_threshold)
+        return schoolbook_square(a, length, result);
+
+    size_t half = (length + 1) / 2;
+
+    auto* sum = scratch;
+    auto* middle = sum + half + 1;
+    auto* rest_of_scratch = middle + 2 * (half + 1);
+
+    square_words(a, half, result, rest_of_scratch);
+    square_words(a + half, length - half, result + 2 * half, rest_of_scratch);
+
+    __builtin_memcpy(sum, a, half * sizeof(Word));
+    sum[half] = add_words_in_place(sum, half, a + half, length - half);
+
+    square_words(sum, half + 1, middle, rest_of_scratch);
+    subtract_words_in_place(middle, 2 * (half + 1), result, 2 * half);
+    subtract_words_in_place(middle, 2 * (half + 1), result + 2 * half, 2 * (length - half));
+
+    size_t middle_length = min(2 * (half + 1), 2 * length - half);
+    add_words_in_place(result + half, 2 * length - half, middle, middle_length);
+}
+
+/**
+ * Complexity: O(N^1.58) where N is the number of words in the larger number, O(N * M) if either has fewer than
+ * karatsuba_threshold words.
+ * Squares (where left and right are the same object) take the faster square_words() path.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& output)
 {
+    size_t left_length = left.trimmed_length();
+    size_t right_length = right.trimmed_length();
+
     output.set_to_0();
+    if (left_length == 0 || right_length == 0)
+        return;
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    temp_scratch.set_to_0();
+    temp_scratch.resize_with_leading_zeros(karatsuba_scratch_length(max(left_length, right_length)));
+    output.resize_with_leading_zeros(left_length + right_length);
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    if (&left == &right)
+        square_words(left.m_words.data(), left_length, output.m_words.data(), temp_scratch.m_words.data());
+    else
+        multiply_words(left.m_words.data(), left_length, right.m_words.data(), right_length, output.m_words.data(), temp_scratch.m_words.data());
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
-    }
+    // The product may be one word shorter than the sum of the lengths.
+    output.clamp_to_trimmed_length();
 }
 
 }
@@ -4,19 +4,28 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CPUFeatures.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
 namespace Crypto::Checksum {
 
-void Adler32::update(ReadonlyBytes data)
+static constexpr u32 modulus = 65521;
+
+template<CPUFeatures>
+static void update_impl(u32& state_a, u32& state_b, ReadonlyBytes data);
+
+template<>
+void update_impl<CPUFeatures::None>(u32& state_a_out, u32& state_b_out, ReadonlyBytes data)
 {
     // See https://github.com/SerenityOS/serenity/pull/24408#discussion_r1609051678
     constexpr size_t iterations_without_overflow = 380368439;
 
-    u64 state_a = m_state_a;
-    u64 state_b = m_state_b;
+    u64 state_a = state_a_out;
+    u64 state_b = state_b_out;
     while (data.size()) {
         // You can verify that no overflow will happen here during at least
         // `iterations_without_overflow` iterations using the following Python script:
@@ -32,12 +41,144 @@ void Adler32::update(ReadonlyBytes data)
             state_a += byte;
             state_b += state_a;
         }
-        state_a %= 65521;
-        state_b %= 65521;
+        state_a %= modulus;
+        state_b %= modulus;
         data = data.slice(chunk.size());
     }
-    m_state_a = state_a;
-    m_state_b = state_b;
+    state_a_out = state_a;
+    state_b_out = state_b;
+}
+
+// The vectorized versions below work on blocks of 32 bytes. Within a block, byte i (counting from 0) is added to
+// state_b 32 - i times, which is a multiply-add with the weights 32..1. State_a before each block is added to state_b
+// 32 times per block, which we sum up separately and multiply by 32 at the end. State_b is only reduced after
+// 5536 bytes, the largest multiple of 32 for which it still fits into 32 bits (zlib calls this NMAX).
+static constexpr size_t block_size = 32;
+static constexpr size_t max_blocks_between_reductions = 5552 / block_size;
+
+template<typename Vector>
+static ALWAYS_INLINE u32 horizontal_sum(Vector vector)
+{
+    u32 sum = 0;
+    for (size_t i = 0; i < sizeof(Vector) / sizeof(u32); ++i)
+        sum += vector[i];
+    return sum;
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_SSSE3
+template<>
+[[gnu::target("ssse3")]] void update_impl<CPUFeatures::X86_SSSE3>(u32& state_a, u32& state_b, ReadonlyBytes data)
+{
+    using AK::SIMD::i16x8, AK::SIMD::u32x4;
+    using charx16 = char __attribute__((vector_size(16)));
+
+    charx16 const first_half_weights { 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17 };
+    charx16 const second_half_weights { 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+    i16x8 const ones { 1, 1, 1, 1, 1, 1, 1, 1 };
+
+    // psadbw against zero sums up the bytes, pmaddubsw and pmaddwd do the weighted sum.
+    auto sum_bytes = [] [[gnu::target("ssse3")]] (charx16 bytes) {
+        return bit_cast<u32x4>(__builtin_ia32_psadbw128(bytes, charx16 {}));
+    };
+    auto weighted_sum = [&] [[gnu::target("ssse3")]] (charx16 bytes, charx16 weights) {
+        return bit_cast<u32x4>(__builtin_ia32_pmaddwd128(__builtin_ia32_pmaddubsw128(bytes, weights), ones));
+    };
+
+    state_a %= modulus;
+    state_b %= modulus;
+
+    auto const* bytes = data.data();
+    auto block_count = data.size() / block_size;
+    while (block_count > 0) {
+        auto blocks = min(block_count, max_blocks_between_reductions);
+        block_count -= blocks;
+
+        u32x4 sum_of_previous_a { static_cast<u32>(state_a * blocks), 0, 0, 0 };
+        u32x4 a {};
+        u32x4 b { state_b, 0, 0, 0 };
+        for (size_t i = 0; i < blocks; ++i) {
+            auto first_half = AK::SIMD::load_unaligned<charx16>(bytes);
+            auto second_half = AK::SIMD::load_unaligned<charx16>(bytes + 16);
+
+            sum_of_previous_a += a;
+            a += sum_bytes(first_half) + sum_bytes(second_half);
+            b += weighted_sum(first_half, first_half_weights) + weighted_sum(second_half, second_half_weights);
+            bytes += block_size;
+        }
+        b += sum_of_previous_a << 5;
+
+        state_a = (state_a + horizontal_sum(a)) % modulus;
+        state_b = horizontal_sum(b) % modulus;
+    }
+
+    update_impl<CPUFeatures::None>(state_a, state_b, data.slice(bytes - data.data()));
+}
+#endif
+
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+template<>
+[[gnu::target("avx2")]] void update_impl<CPUFeatures::X86_AVX2>(u32& state_a, u32& state_b, ReadonlyBytes data)
+{
+    using AK::SIMD::i16x16, AK::SIMD::u32x8;
+    using charx32 = char __attribute__((vector_size(32)));
+
+    charx32 const weights {
+        32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1
+    };
+    i16x16 const ones { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+    state_a %= modulus;
+    state_b %= modulus;
+
+    auto const* bytes = data.data();
+    auto block_count = data.size() / block_size;
+    while (block_count > 0) {
+        auto blocks = min(block_count, max_blocks_between_reductions);
+        block_count -= blocks;
+
+        u32x8 sum_of_previous_a { static_cast<u32>(state_a * blocks), 0, 0, 0, 0, 0, 0, 0 };
+        u32x8 a {};
+        u32x8 b { state_b, 0, 0, 0, 0, 0, 0, 0 };
+        for (size_t i = 0; i < blocks; ++i) {
+            charx32 block;
+            __builtin_memcpy(&block, bytes, sizeof(block));
+
+            sum_of_previous_a += a;
+            // NOTE: AK::bit_cast() isn't compiled for AVX, so returning a 256-bit vector from it would change the ABI.
+            a += __builtin_bit_cast(u32x8, __builtin_ia32_psadbw256(block, charx32 {}));
+            b += __builtin_bit_cast(u32x8, __builtin_ia32_pmaddwd256(__builtin_ia32_pmaddubsw256(block, weights), ones));
+            bytes += block_size;
+        }
+        b += sum_of_previous_a << 5;
+
+        state_a = (state_a + horizontal_sum(a)) % modulus;
+        state_b = horizontal_sum(b) % modulus;
+    }
+
+    update_impl<CPUFeatures::None>(state_a, state_b, data.slice(bytes - data.data()));
+}
+#endif
+
+static void (*const update_dispatched)(u32&, u32&, ReadonlyBytes) = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &update_impl<CPUFeatures::X86_AVX2>;
+    }
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_SSSE3)) {
+        if (has_flag(features, CPUFeatures::X86_SSSE3))
+            return &update_impl<CPUFeatures::X86_SSSE3>;
+    }
+
+    return &update_impl<CPUFeatures::None>;
+}();
+
+void Adler32::update(ReadonlyBytes data)
+{
+    update_dispatched(m_state_a, m_state_b, data);
 }
 
 u32 Adler32::digest()
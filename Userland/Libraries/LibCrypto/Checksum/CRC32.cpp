@@ -5,7 +5,10 @@
  */
 
 #include <AK/Array.h>
+#include <AK/CPUFeatures.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/CRC32.h>
@@ -46,8 +49,6 @@ void CRC32::update(ReadonlyBytes span)
     }
 }
 
-// FIXME: On Intel, use _mm_crc32_u8 / _mm_crc32_u64 if available (SSE 4.2).
-
 #else
 
 static constexpr size_t ethernet_polynomial = 0xEDB88320;
@@ -104,7 +105,11 @@ static constexpr u32 single_byte_crc(u32 crc, u8 byte)
     return (crc >> 8) ^ table[0][(crc & 0xff) ^ byte];
 }
 
-void CRC32::update(ReadonlyBytes data)
+template<CPUFeatures>
+static u32 update_impl(u32 state, ReadonlyBytes data);
+
+template<>
+u32 update_impl<CPUFeatures::None>(u32 state, ReadonlyBytes data)
 {
     // The provided data may not be aligned to a 4-byte boundary, required to reinterpret its address
     // into a u32 in the loop below. So we split the bytes into two segments: the misaligned bytes
@@ -112,14 +117,14 @@ void CRC32::update(ReadonlyBytes data)
     auto [misaligned_data, aligned_data] = split_bytes_for_alignment(data, alignof(u32));
 
     for (auto byte : misaligned_data)
-        m_state = single_byte_crc(m_state, byte);
+        state = single_byte_crc(state, byte);
 
     while (aligned_data.size() >= 8) {
         auto const* segment = reinterpret_cast<u32 const*>(aligned_data.data());
-        auto low = *segment ^ m_state;
+        auto low = *segment ^ state;
         auto high = *(++segment);
 
-        m_state = table[0][(high >> 24) & 0xff]
+        state = table[0][(high >> 24) & 0xff]
             ^ table[1][(high >> 16) & 0xff]
             ^ table[2][(high >> 8) & 0xff]
             ^ table[3][high & 0xff]
@@ -132,7 +137,99 @@ void CRC32::update(ReadonlyBytes data)
     }
 
     for (auto byte : aligned_data)
-        m_state = single_byte_crc(m_state, byte);
+        state = single_byte_crc(state, byte);
+
+    return state;
+}
+
+// Note: The SSE 4.2 crc32 instruction uses the Castagnoli polynomial, so it can't be used for this CRC.
+//       Instead, we fold the input with carry-less multiplications as described in Intel's paper "Fast CRC Computation
+//       for Generic Polynomials Using PCLMULQDQ Instruction". The constants are the ones for the bit-reflected
+//       Ethernet polynomial given at the end of that paper.
+#        if AK_CAN_CODEGEN_FOR_X86_PCLMUL
+using AK::SIMD::u32x4, AK::SIMD::u64x2;
+using illx2 = signed long long int __attribute__((vector_size(16)));
+
+template<int selector>
+[[gnu::target("pclmul"), gnu::always_inline]] static inline u64x2 carryless_multiply(u64x2 a, u64x2 b)
+{
+    return bit_cast<u64x2>(__builtin_ia32_pclmulqdq128(bit_cast<illx2>(a), bit_cast<illx2>(b), selector));
+}
+
+// Multiplies both halves of `value` with the matching constant, which moves them 128 (or 512) bits further ahead,
+// where they can be added to the next block of the input.
+[[gnu::target("pclmul"), gnu::always_inline]] static inline u64x2 fold(u64x2 value, u64x2 constants, u64x2 next_block)
+{
+    return carryless_multiply<0x00>(value, constants) ^ carryless_multiply<0x11>(value, constants) ^ next_block;
+}
+
+template<>
+[[gnu::target("pclmul")]] u32 update_impl<CPUFeatures::X86_PCLMUL>(u32 state, ReadonlyBytes data)
+{
+    if (data.size() < 64)
+        return update_impl<CPUFeatures::None>(state, data);
+
+    u64x2 const fold_by_512_bits { 0x0154442bd4, 0x01c6e41596 };
+    u64x2 const fold_by_128_bits { 0x01751997d0, 0x00ccaa009e };
+    u64x2 const fold_by_32_bits { 0x0163cd6124, 0 };
+    u64x2 const polynomial_and_barrett_constant { 0x01db710641, 0x01f7011641 };
+    u64x2 const low_32_bits { 0xffffffff, 0xffffffff };
+
+    auto const* bytes = data.data();
+    auto remaining = data.size();
+    auto load = [&](size_t offset) { return AK::SIMD::load_unaligned<u64x2>(bytes + offset); };
+
+    // Fold four independent lanes of 128 bits each, so that the multiplications can overlap.
+    u64x2 lanes[4] { load(0), load(16), load(32), load(48) };
+    lanes[0] ^= u64x2 { state, 0 };
+    bytes += 64;
+    remaining -= 64;
+
+    while (remaining >= 64) {
+        for (size_t i = 0; i < 4; ++i)
+            lanes[i] = fold(lanes[i], fold_by_512_bits, load(i * 16));
+        bytes += 64;
+        remaining -= 64;
+    }
+
+    auto value = fold(lanes[0], fold_by_128_bits, lanes[1]);
+    value = fold(value, fold_by_128_bits, lanes[2]);
+    value = fold(value, fold_by_128_bits, lanes[3]);
+
+    while (remaining >= 16) {
+        value = fold(value, fold_by_128_bits, load(0));
+        bytes += 16;
+        remaining -= 16;
+    }
+
+    // Reduce the 128 bits to 64 bits, then to 32 bits + 32 zero bits.
+    value = carryless_multiply<0x10>(value, fold_by_128_bits) ^ u64x2 { value[1], 0 };
+    auto words = bit_cast<u32x4>(value);
+    value = carryless_multiply<0x00>(value & low_32_bits, fold_by_32_bits) ^ bit_cast<u64x2>(u32x4 { words[1], words[2], words[3], 0 });
+
+    // Barrett reduction to the final 32 bits.
+    auto quotient = carryless_multiply<0x10>(value & low_32_bits, polynomial_and_barrett_constant);
+    value ^= carryless_multiply<0x00>(quotient & low_32_bits, polynomial_and_barrett_constant);
+    state = bit_cast<u32x4>(value)[1];
+
+    return update_impl<CPUFeatures::None>(state, ReadonlyBytes { bytes, remaining });
+}
+#        endif
+
+static u32 (*const update_dispatched)(u32, ReadonlyBytes) = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_PCLMUL)) {
+        if (has_flag(features, CPUFeatures::X86_PCLMUL))
+            return &update_impl<CPUFeatures::X86_PCLMUL>;
+    }
+
+    return &update_impl<CPUFeatures::None>;
+}();
+
+void CRC32::update(ReadonlyBytes data)
+{
+    m_state = update_dispatched(m_state, data);
 }
 
 #    else
@@ -174,4 +271,61 @@ u32 CRC32::digest()
     return ~m_state;
 }
 
+// Appending zero bits to the input is a linear operation on the CRC, so it can be expressed as a 32x32 matrix over
+// GF(2). Squaring the matrix doubles the number of zero bits, which lets us skip over the length of the second input
+// in logarithmic time. This is the same approach as zlib's crc32_combine().
+using GF2Matrix = Array<u32, 32>;
+
+static u32 gf2_matrix_times(GF2Matrix const& matrix, u32 vector)
+{
+    u32 sum = 0;
+    for (size_t i = 0; vector != 0; ++i, vector >>= 1) {
+        if (vector & 1)
+            sum ^= matrix[i];
+    }
+    return sum;
+}
+
+static GF2Matrix gf2_matrix_square(GF2Matrix const& matrix)
+{
+    GF2Matrix square;
+    for (size_t i = 0; i < 32; ++i)
+        square[i] = gf2_matrix_times(matrix, matrix[i]);
+    return square;
+}
+
+u32 CRC32::combine(u32 first_digest, u32 second_digest, u64 second_length)
+{
+    if (second_length == 0)
+        return first_digest;
+
+    // The operator for a single zero bit.
+    GF2Matrix odd;
+    odd[0] = 0xEDB88320;
+    for (size_t i = 1; i < 32; ++i)
+        odd[i] = 1u << (i - 1);
+
+    // The operators for two and four zero bits.
+    auto even = gf2_matrix_square(odd);
+    odd = gf2_matrix_square(even);
+
+    // Apply the operator for each set bit of the length in bytes, starting with one byte (eight bits).
+    auto crc = first_digest;
+    do {
+        even = gf2_matrix_square(odd);
+        if (second_length & 1)
+            crc = gf2_matrix_times(even, crc);
+        second_length >>= 1;
+        if (second_length == 0)
+            break;
+
+        odd = gf2_matrix_square(even);
+        if (second_length & 1)
+            crc = gf2_matrix_times(odd, crc);
+        second_length >>= 1;
+    } while (second_length != 0);
+
+    return crc ^ second_digest;
+}
+
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteReader.h>
 #include <AK/CPUFeatures.h>
 #include <AK/Platform.h>
 #include <AK/SIMD.h>
@@ -746,6 +747,99 @@ decltype(AESCipher::decrypt_block_dispatched) AESCipher::decrypt_block_dispatche
     return &AESCipher::decrypt_block_impl<CPUFeatures::None>;
 }();
 
+template<>
+void AESCipher::apply_counter_key_stream_impl<CPUFeatures::None>(Bytes counter, ReadonlyBytes in, Bytes out)
+{
+    VERIFY(out.size() >= in.size());
+
+    AESCipherBlock block;
+    for (size_t offset = 0; offset + block.block_size() <= in.size(); offset += block.block_size()) {
+        block.overwrite(counter);
+        encrypt_block_impl<CPUFeatures::None>(block, block);
+        block.apply_initialization_vector(in.slice(offset, block.block_size()));
+        block.bytes().copy_to(out.slice(offset));
+        IncrementInplace {}(counter);
+    }
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AES
+template<>
+[[gnu::target("aes")]] void AESCipher::apply_counter_key_stream_impl<CPUFeatures::X86_AES>(Bytes counter, ReadonlyBytes in, Bytes out)
+{
+    using illx2 = signed long long int __attribute__((vector_size(16)));
+
+    // aesenc has a latency of several cycles, but the CPU can start a new one every cycle. Encrypting eight
+    // independent counter blocks side by side keeps it busy.
+    static constexpr size_t parallel_blocks = 8;
+
+    VERIFY(counter.size() == 16);
+    VERIFY(out.size() >= in.size());
+
+    AESCipherKey const& key = m_key;
+    auto round_keys = key.round_keys();
+    auto n_rounds = key.rounds();
+    illx2 keys[15];
+    VERIFY(n_rounds < array_size(keys));
+    for (size_t i = 0; i <= n_rounds; ++i)
+        keys[i] = AK::SIMD::load_unaligned<illx2>(&round_keys[i * 4]);
+
+    u64 counter_high = AK::convert_between_host_and_big_endian(ByteReader::load64(counter.offset(0)));
+    u64 counter_low = AK::convert_between_host_and_big_endian(ByteReader::load64(counter.offset(8)));
+    auto next_counter_block = [&] {
+        illx2 block { static_cast<i64>(AK::convert_between_host_and_big_endian(counter_high)), static_cast<i64>(AK::convert_between_host_and_big_endian(counter_low)) };
+        if (++counter_low == 0)
+            ++counter_high;
+        return block;
+    };
+
+    auto const* input = in.data();
+    auto* output = out.data();
+    auto remaining = in.size();
+
+    while (remaining >= parallel_blocks * 16) {
+        illx2 blocks[parallel_blocks];
+        for (size_t i = 0; i < parallel_blocks; ++i)
+            blocks[i] = next_counter_block() ^ keys[0];
+        for (size_t round = 1; round < n_rounds; ++round) {
+            for (size_t i = 0; i < parallel_blocks; ++i)
+                blocks[i] = __builtin_ia32_aesenc128(blocks[i], keys[round]);
+        }
+        for (size_t i = 0; i < parallel_blocks; ++i) {
+            blocks[i] = __builtin_ia32_aesenclast128(blocks[i], keys[n_rounds]);
+            AK::SIMD::store_unaligned(output + i * 16, blocks[i] ^ AK::SIMD::load_unaligned<illx2>(input + i * 16));
+        }
+        input += parallel_blocks * 16;
+        output += parallel_blocks * 16;
+        remaining -= parallel_blocks * 16;
+    }
+
+    while (remaining >= 16) {
+        auto block = next_counter_block() ^ keys[0];
+        for (size_t round = 1; round < n_rounds; ++round)
+            block = __builtin_ia32_aesenc128(block, keys[round]);
+        block = __builtin_ia32_aesenclast128(block, keys[n_rounds]);
+        AK::SIMD::store_unaligned(output, block ^ AK::SIMD::load_unaligned<illx2>(input));
+        input += 16;
+        output += 16;
+        remaining -= 16;
+    }
+
+    ByteReader::store(counter.offset(0), AK::convert_between_host_and_big_endian(counter_high));
+    ByteReader::store(counter.offset(8), AK::convert_between_host_and_big_endian(counter_low));
+}
+#endif
+
+decltype(AESCipher::apply_counter_key_stream_dispatched) AESCipher::apply_counter_key_stream_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AES)) {
+        if (has_flag(features, CPUFeatures::X86_AES))
+            return &AESCipher::apply_counter_key_stream_impl<CPUFeatures::X86_AES>;
+    }
+
+    return &AESCipher::apply_counter_key_stream_impl<CPUFeatures::None>;
+}();
+
 void AESCipherBlock::overwrite(ReadonlyBytes bytes)
 {
     auto data = bytes.data();
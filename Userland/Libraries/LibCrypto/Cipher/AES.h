@@ -128,6 +128,11 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) override { return (this->*encrypt_block_dispatched)(in, out); }
     virtual void decrypt_block(BlockType const& in, BlockType& out) override { return (this->*decrypt_block_dispatched)(in, out); }
 
+    // XORs the whole blocks of `in` with the encryption of `counter`, `counter + 1`, ... (as a 128-bit big-endian
+    // integer), and advances `counter` past the blocks it used. This is what CTR mode does one block at a time, but it
+    // lets the implementation work on several independent blocks at once.
+    void apply_counter_key_stream(Bytes counter, ReadonlyBytes in, Bytes out) { return (this->*apply_counter_key_stream_dispatched)(counter, in, out); }
+
 #ifndef KERNEL
     virtual ByteString class_name() const override
     {
@@ -146,6 +151,11 @@ private:
 
     static void (AESCipher::*const encrypt_block_dispatched)(BlockType const& in, BlockType& out);
     static void (AESCipher::*const decrypt_block_dispatched)(BlockType const& in, BlockType& out);
+
+    template<CPUFeatures>
+    void apply_counter_key_stream_impl(Bytes counter, ReadonlyBytes in, Bytes out);
+
+    static void (AESCipher::*const apply_counter_key_stream_dispatched)(Bytes counter, ReadonlyBytes in, Bytes out);
 };
 
 }
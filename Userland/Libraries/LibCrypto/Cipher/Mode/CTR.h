@@ -170,6 +170,15 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        // Ciphers that can produce the key stream for several blocks at once get all the whole blocks in one go.
+        if constexpr (requires { cipher.apply_counter_key_stream(iv, *in, out); } && IsSame<IncrementFunctionType, IncrementInplace>) {
+            if (in && length >= block_size) {
+                offset = length - length % block_size;
+                cipher.apply_counter_key_stream(iv, in->trim(offset), out);
+                length -= offset;
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
@@ -95,12 +95,19 @@ public:
         // Skip past block 0
         CTR<T>::increment(iv);
 
-        if (in.is_empty())
+        m_ghash->update(aad);
+        if (in.is_empty()) {
             CTR<T>::key_stream(out, iv);
-        else
-            CTR<T>::encrypt(in, out, iv);
+            m_ghash->update(out);
+        } else {
+            // Hash each chunk of the ciphertext right after encrypting it, while it's still in the cache.
+            for_each_chunk(in, out, [&](ReadonlyBytes in_chunk, Bytes& out_chunk) {
+                CTR<T>::encrypt(in_chunk, out_chunk, iv, &iv);
+                m_ghash->update(out_chunk);
+            });
+        }
 
-        auto auth_tag = m_ghash->process(aad, out);
+        auto auth_tag = m_ghash->finish(aad.size(), in.is_empty() ? out.size() : in.size());
         block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
         block0.bytes().copy_to(tag);
     }
@@ -123,27 +130,42 @@ public:
         // Skip past block 0
         CTR<T>::increment(iv);
 
-        auto auth_tag = m_ghash->process(aad, in);
-        block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
-
-        auto test_consistency = [&] {
-            if (block0.block_size() != tag.size() || !timing_safe_compare(block0.bytes().data(), tag.data(), tag.size()))
-                return VerificationConsistency::Inconsistent;
-
-            return VerificationConsistency::Consistent;
-        };
-
+        m_ghash->update(aad);
         if (in.is_empty()) {
             out = {};
-            return test_consistency();
+        } else {
+            // Hash each chunk of the ciphertext right before decrypting it, so that it's only read from memory once.
+            for_each_chunk(in, out, [&](ReadonlyBytes in_chunk, Bytes& out_chunk) {
+                m_ghash->update(in_chunk);
+                CTR<T>::encrypt(in_chunk, out_chunk, iv, &iv);
+            });
         }
 
-        CTR<T>::encrypt(in, out, iv);
-        return test_consistency();
+        auto auth_tag = m_ghash->finish(aad.size(), in.size());
+        block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
+
+        if (block0.block_size() != tag.size() || !timing_safe_compare(block0.bytes().data(), tag.data(), tag.size()))
+            return VerificationConsistency::Inconsistent;
+
+        return VerificationConsistency::Consistent;
     }
 
 private:
     static constexpr auto block_size = T::BlockType::BlockSizeInBits / 8;
+
+    // Small enough to stay in the L1 cache between the encryption and the hash, and a whole number of blocks, so that
+    // the counter carries over from one chunk to the next.
+    static constexpr size_t chunk_size = 64 * block_size;
+
+    template<typename Callback>
+    static void for_each_chunk(ReadonlyBytes in, Bytes out, Callback callback)
+    {
+        for (size_t offset = 0; offset < in.size(); offset += chunk_size) {
+            auto in_chunk = in.slice(offset, min(chunk_size, in.size() - offset));
+            auto out_chunk = out.slice(offset, in_chunk.size());
+            callback(in_chunk, out_chunk);
+        }
+    }
     u8 m_auth_key_storage[block_size];
     Bytes m_auth_key { m_auth_key_storage, block_size };
     Optional<Authentication::GHash> m_ghash;
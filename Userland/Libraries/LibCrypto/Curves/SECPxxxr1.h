@@ -31,7 +31,7 @@ template<size_t bit_size, SECPxxxr1CurveParameters const& CURVE_PARAMETERS>
 class SECPxxxr1 : public EllipticCurve {
 private:
     using StorageType = AK::UFixedBigInt<bit_size>;
-    using StorageTypeX2 = AK::UFixedBigInt<bit_size * 2>;
+    using NativeWord = AK::Detail::NativeWord;
 
     struct JacobianPoint {
         StorageType x;
@@ -92,27 +92,25 @@ private:
     // Check that the generator point starts with 0x04
     static_assert(GENERATOR_POINT[0] == 0x04);
 
-    static constexpr StorageType calculate_modular_inverse_mod_r(StorageType value)
+    static constexpr NativeWord calculate_negated_inverse_mod_word(StorageType const& modulus)
     {
-        // Calculate the modular multiplicative inverse of value mod 2^bit_size using the extended euclidean algorithm
-        using StorageTypeP1 = AK::UFixedBigInt<bit_size + 1>;
-
-        StorageTypeP1 old_r = value;
-        StorageTypeP1 r = static_cast<StorageTypeP1>(1u) << KEY_BIT_SIZE;
-        StorageTypeP1 old_s = 1u;
-        StorageTypeP1 s = 0u;
+        // Calculate -modulus^-1 mod 2^native_word_size using Newton's method, where every step doubles the number of correct
+        // low bits. Any odd number is its own inverse mod 8, so the first guess already has 3 correct bits.
+        NativeWord low_word = static_cast<NativeWord>(modulus);
+        NativeWord inverse = low_word;
+        for (size_t i = 0; i < 5; i++)
+            inverse *= 2 - low_word * inverse;
 
-        while (!r.is_zero_constant_time()) {
-            StorageTypeP1 r_save = r;
-            StorageTypeP1 quotient = old_r.div_mod(r, r);
-            old_r = r_save;
+        return 0 - inverse;
+    }
 
-            StorageTypeP1 s_save = s;
-            s = old_s - quotient * s;
-            old_s = s_save;
-        }
+    static constexpr StorageType calculate_r_mod(StorageType modulus)
+    {
+        // Calculate the value of R mod modulus, where R = 2^bit_size, which is 1 in Montgomery form
+        using StorageTypeP1 = AK::UFixedBigInt<bit_size + 1>;
 
-        return static_cast<StorageType>(old_s);
+        StorageTypeP1 r = static_cast<StorageTypeP1>(1u) << KEY_BIT_SIZE;
+        return r % modulus;
     }
 
     static constexpr StorageType calculate_r2_mod(StorageType modulus)
@@ -128,13 +126,20 @@ private:
     static_assert(A == PRIME - 3);
 
     // Precomputed helper values for reduction and Montgomery multiplication
-    static constexpr StorageType REDUCE_PRIME = StorageType { 0 } - PRIME;
     static constexpr StorageType REDUCE_ORDER = StorageType { 0 } - ORDER;
-    static constexpr StorageType PRIME_INVERSE_MOD_R = StorageType { 0 } - calculate_modular_inverse_mod_r(PRIME);
-    static constexpr StorageType ORDER_INVERSE_MOD_R = StorageType { 0 } - calculate_modular_inverse_mod_r(ORDER);
+    static constexpr NativeWord PRIME_INVERSE_MOD_WORD = calculate_negated_inverse_mod_word(PRIME);
+    static constexpr NativeWord ORDER_INVERSE_MOD_WORD = calculate_negated_inverse_mod_word(ORDER);
+    static constexpr StorageType R_MOD_PRIME = calculate_r_mod(PRIME);
+    static constexpr StorageType R_MOD_ORDER = calculate_r_mod(ORDER);
     static constexpr StorageType R2_MOD_PRIME = calculate_r2_mod(PRIME);
     static constexpr StorageType R2_MOD_ORDER = calculate_r2_mod(ORDER);
 
+    // Scalar multiplication works on windows of 4 bits of the scalar at a time
+    static constexpr size_t WINDOW_BIT_SIZE = 4;
+    static constexpr size_t WINDOW_COUNT = KEY_BIT_SIZE / WINDOW_BIT_SIZE;
+    static constexpr size_t WINDOW_TABLE_SIZE = 1 << WINDOW_BIT_SIZE;
+    static_assert(AK::Detail::native_word_size % WINDOW_BIT_SIZE == 0);
+
 public:
     size_t key_size() override { return POINT_BYTE_SIZE; }
 
@@ -147,7 +152,11 @@ public:
 
     ErrorOr<ByteBuffer> generate_public_key(ReadonlyBytes a) override
     {
-        return compute_coordinate(a, GENERATOR_POINT);
+        AK::FixedMemoryStream scalar_stream { a };
+
+        StorageType scalar = TRY(scalar_stream.read_value<BigEndian<StorageType>>());
+        JacobianPoint result = TRY(generate_public_key_internal(scalar));
+        return write_uncompressed_point(result);
     }
 
     ErrorOr<ByteBuffer> compute_coordinate(ReadonlyBytes scalar_bytes, ReadonlyBytes point_bytes) override
@@ -158,14 +167,7 @@ public:
         StorageType scalar = TRY(scalar_stream.read_value<BigEndian<StorageType>>());
         JacobianPoint point = TRY(read_uncompressed_point(point_stream));
         JacobianPoint result = TRY(compute_coordinate_internal(scalar, point));
-
-        // Export the values into an output buffer
-        auto buf = TRY(ByteBuffer::create_uninitialized(POINT_BYTE_SIZE));
-        AK::FixedMemoryStream buf_stream { buf.bytes() };
-        TRY(buf_stream.write_value<u8>(0x04));
-        TRY(buf_stream.write_value<BigEndian<StorageType>>(result.x));
-        TRY(buf_stream.write_value<BigEndian<StorageType>>(result.y));
-        return buf;
+        return write_uncompressed_point(result);
     }
 
     ErrorOr<ByteBuffer> derive_premaster_key(ReadonlyBytes shared_point) override
@@ -200,6 +202,10 @@ public:
             s |= (ss << (i * 32));
         }
 
+        // Both r and s have to be in [1, n - 1]
+        if (r.is_zero_constant_time() || s.is_zero_constant_time() || r >= ORDER || s >= ORDER)
+            return false;
+
         // z is the hash
         StorageType z = 0u;
         for (uint8_t byte : hash) {
@@ -210,6 +216,14 @@ public:
         AK::FixedMemoryStream pubkey_stream { pubkey };
         JacobianPoint pubkey_point = TRY(read_uncompressed_point(pubkey_stream));
 
+        // Convert the input point into Montgomery form
+        pubkey_point.x = to_montgomery(pubkey_point.x);
+        pubkey_point.y = to_montgomery(pubkey_point.y);
+        pubkey_point.z = to_montgomery(pubkey_point.z);
+
+        if (!is_point_on_curve(pubkey_point))
+            return Error::from_string_literal("SECPxxxr1: point is not on the curve");
+
         StorageType r_mo = to_montgomery_order(r);
         StorageType s_mo = to_montgomery_order(s);
         StorageType z_mo = to_montgomery_order(z);
@@ -222,47 +236,39 @@ public:
         u1 = from_montgomery_order(u1);
         u2 = from_montgomery_order(u2);
 
-        JacobianPoint point1 = TRY(generate_public_key_internal(u1));
-        JacobianPoint point2 = TRY(compute_coordinate_internal(u2, pubkey_point));
-
-        // Convert the input point into Montgomery form
-        point1.x = to_montgomery(point1.x);
-        point1.y = to_montgomery(point1.y);
-        point1.z = to_montgomery(point1.z);
-
-        VERIFY(is_point_on_curve(point1));
-
-        // Convert the input point into Montgomery form
-        point2.x = to_montgomery(point2.x);
-        point2.y = to_montgomery(point2.y);
-        point2.z = to_montgomery(point2.z);
-
-        VERIFY(is_point_on_curve(point2));
-
+        JacobianPoint point1 = multiply_generator(u1);
+        JacobianPoint point2 = multiply_point(u2, pubkey_point);
         JacobianPoint result = point_add(point1, point2);
 
+        if (result.z.is_zero_constant_time())
+            return false;
+
         // Convert from Jacobian coordinates back to Affine coordinates
         convert_jacobian_to_affine(result);
 
         // Make sure the resulting point is on the curve
         VERIFY(is_point_on_curve(result));
 
-        // Convert the result back from Montgomery form
-        result.x = from_montgomery(result.x);
-        result.y = from_montgomery(result.y);
-        // Final modular reduction on the coordinates
-        result.x = modular_reduce(result.x);
-        result.y = modular_reduce(result.y);
+        // Convert the result back from Montgomery form, and reduce it modulo the order
+        StorageType x = modular_reduce_order(from_montgomery(result.x));
 
-        return r.is_equal_to_constant_time(result.x);
+        return r.is_equal_to_constant_time(x);
     }
 
 private:
-    ErrorOr<JacobianPoint> generate_public_key_internal(StorageType a)
+    struct AffinePoint {
+        StorageType x;
+        StorageType y;
+    };
+
+    ErrorOr<JacobianPoint> generate_public_key_internal(StorageType scalar)
     {
-        AK::FixedMemoryStream generator_point_stream { GENERATOR_POINT };
-        JacobianPoint point = TRY(read_uncompressed_point(generator_point_stream));
-        return compute_coordinate_internal(a, point);
+        // FIXME: This will slightly bias the distribution of client secrets
+        scalar = modular_reduce_order(scalar);
+        if (scalar.is_zero_constant_time())
+            return Error::from_string_literal("SECPxxxr1: scalar is zero");
+
+        return convert_result_point(multiply_generator(scalar));
     }
 
     ErrorOr<JacobianPoint> compute_coordinate_internal(StorageType scalar, JacobianPoint point)
@@ -281,22 +287,11 @@ private:
         if (!is_point_on_curve(point))
             return Error::from_string_literal("SECPxxxr1: point is not on the curve");
 
-        JacobianPoint result { 0, 0, 0 };
-        JacobianPoint temp_result { 0, 0, 0 };
-
-        // Calculate the scalar times point multiplication in constant time
-        for (size_t i = 0; i < KEY_BIT_SIZE; i++) {
-            temp_result = point_add(result, point);
-
-            auto condition = (scalar & 1u) == 1u;
-            result.x = select(result.x, temp_result.x, condition);
-            result.y = select(result.y, temp_result.y, condition);
-            result.z = select(result.z, temp_result.z, condition);
-
-            point = point_double(point);
-            scalar >>= 1u;
-        }
+        return convert_result_point(multiply_point(scalar, point));
+    }
 
+    static JacobianPoint convert_result_point(JacobianPoint result)
+    {
         // Convert from Jacobian coordinates back to Affine coordinates
         convert_jacobian_to_affine(result);
 
@@ -307,10 +302,6 @@ private:
         result.x = from_montgomery(result.x);
         result.y = from_montgomery(result.y);
         result.z = from_montgomery(result.z);
-        // Final modular reduction on the coordinates
-        result.x = modular_reduce(result.x);
-        result.y = modular_reduce(result.y);
-        result.z = modular_reduce(result.z);
 
         return result;
     }
@@ -330,26 +321,62 @@ private:
         return point;
     }
 
-    constexpr StorageType select(StorageType const& left, StorageType const& right, bool condition)
+    static ErrorOr<ByteBuffer> write_uncompressed_point(JacobianPoint const& point)
+    {
+        // Export the values into an output buffer
+        auto buf = TRY(ByteBuffer::create_uninitialized(POINT_BYTE_SIZE));
+        AK::FixedMemoryStream buf_stream { buf.bytes() };
+        TRY(buf_stream.write_value<u8>(0x04));
+        TRY(buf_stream.write_value<BigEndian<StorageType>>(point.x));
+        TRY(buf_stream.write_value<BigEndian<StorageType>>(point.y));
+        return buf;
+    }
+
+    static constexpr StorageType select(StorageType const& left, StorageType const& right, bool condition)
     {
         // If condition = 0 return left else right
-        StorageType mask = static_cast<StorageType>(condition) - 1;
+        // The mask is a single word, so that hiding it from the optimizer doesn't force the values out of registers.
+        NativeWord mask = static_cast<NativeWord>(condition) - 1;
         AK::taint_for_optimizer(mask);
 
-        return (left & mask) | (right & ~mask);
+        StorageType result;
+        auto& left_words = AK::Detail::get_storage_of(left);
+        auto& right_words = AK::Detail::get_storage_of(right);
+        auto& result_words = AK::Detail::get_storage_of(result);
+        for (size_t i = 0; i < result_words.size(); i++)
+            result_words[i] = (left_words[i] & mask) | (right_words[i] & ~mask);
+        return result;
     }
 
-    constexpr StorageType modular_reduce(StorageType const& value)
+    static constexpr JacobianPoint select(JacobianPoint const& left, JacobianPoint const& right, bool condition)
     {
-        // Add -prime % 2^KEY_BIT_SIZE
-        bool carry = false;
-        StorageType other = value.addc(REDUCE_PRIME, carry);
+        return JacobianPoint {
+            select(left.x, right.x, condition),
+            select(left.y, right.y, condition),
+            select(left.z, right.z, condition),
+        };
+    }
 
-        // Check for overflow
-        return select(value, other, carry);
+    static constexpr AffinePoint select(AffinePoint const& left, AffinePoint const& right, bool condition)
+    {
+        return AffinePoint {
+            select(left.x, right.x, condition),
+            select(left.y, right.y, condition),
+        };
+    }
+
+    template<typename Point, size_t table_size>
+    static constexpr Point select_from_table(Array<Point, table_size> const& table, size_t index)
+    {
+        // Read every entry of the table, so that the memory access pattern doesn't depend on the index.
+        // An index past the end of the table leaves the first entry selected.
+        Point result = table[0];
+        for (size_t i = 1; i < table_size; i++)
+            result = select(result, table[i], i == index);
+        return result;
     }
 
-    constexpr StorageType modular_reduce_order(StorageType const& value)
+    static constexpr StorageType modular_reduce_order(StorageType const& value)
     {
         // Add -order % 2^KEY_BIT_SIZE
         bool carry = false;
@@ -359,82 +386,120 @@ private:
         return select(value, other, carry);
     }
 
-    constexpr StorageType modular_add(StorageType const& left, StorageType const& right, bool carry_in = false)
-    {
-        bool carry = carry_in;
-        StorageType output = left.addc(right, carry);
+    // All of the arithmetic below keeps values fully reduced, i.e. in [0, modulus), as long as the inputs are.
 
-        // If there is a carry, subtract p by adding 2^KEY_BIT_SIZE - p
-        StorageType addend = select(0u, REDUCE_PRIME, carry);
-        carry = false;
-        output = output.addc(addend, carry);
+    static constexpr StorageType add_mod(StorageType const& left, StorageType const& right, StorageType const& modulus)
+    {
+        bool carry = false;
+        StorageType sum = left.addc(right, carry);
 
-        // If there is still a carry, subtract p by adding 2^KEY_BIT_SIZE - p
-        addend = select(0u, REDUCE_PRIME, carry);
-        return output + addend;
+        // The sum is below 2 * modulus, so subtracting the modulus once is enough. Keep the sum if the subtraction
+        // underflows without the addition having overflowed.
+        bool borrow = false;
+        StorageType difference = sum.subc(modulus, borrow);
+        return select(difference, sum, borrow & !carry);
     }
 
-    constexpr StorageType modular_sub(StorageType const& left, StorageType const& right)
+    static constexpr StorageType sub_mod(StorageType const& left, StorageType const& right, StorageType const& modulus)
     {
         bool borrow = false;
-        StorageType output = left.subc(right, borrow);
-
-        // If there is a borrow, add p by subtracting 2^KEY_BIT_SIZE - p
-        StorageType sub = select(0u, REDUCE_PRIME, borrow);
-        borrow = false;
-        output = output.subc(sub, borrow);
+        StorageType difference = left.subc(right, borrow);
 
-        // If there is still a borrow, add p by subtracting 2^KEY_BIT_SIZE - p
-        sub = select(0u, REDUCE_PRIME, borrow);
-        return output - sub;
+        // If there is a borrow, add the modulus back
+        return difference + select(0u, modulus, borrow);
     }
 
-    constexpr StorageType modular_multiply(StorageType const& left, StorageType const& right)
+    static constexpr StorageType montgomery_multiply(StorageType const& left, StorageType const& right, StorageType const& modulus, NativeWord modulus_inverse)
     {
         // Modular multiplication using the Montgomery method: https://en.wikipedia.org/wiki/Montgomery_modular_multiplication
         // This requires that the inputs to this function are in Montgomery form.
+        //
+        // The multiplication and the reduction are interleaved word by word ("CIOS" in Koç et al., "Analyzing and
+        // Comparing Montgomery Multiplication Algorithms"), so this never needs more than KEY_BIT_SIZE plus two words.
+        using AK::Detail::NativeDoubleWord;
+        using AK::Detail::native_word_size;
+        using AK::Detail::wide_multiply;
+
+        constexpr size_t word_count = KEY_BIT_SIZE / native_word_size;
+        auto& left_words = AK::Detail::get_storage_of(left);
+        auto& right_words = AK::Detail::get_storage_of(right);
+        auto& modulus_words = AK::Detail::get_storage_of(modulus);
+
+        NativeWord t[word_count + 2] {};
+        for (size_t i = 0; i < word_count; i++) {
+            // t += left * right[i]
+            NativeWord carry = 0;
+            for (size_t j = 0; j < word_count; j++) {
+                NativeDoubleWord product = wide_multiply(left_words[j], right_words[i]) + t[j] + carry;
+                t[j] = static_cast<NativeWord>(product);
+                carry = static_cast<NativeWord>(product >> native_word_size);
+            }
+            NativeDoubleWord top = static_cast<NativeDoubleWord>(t[word_count]) + carry;
+            t[word_count] = static_cast<NativeWord>(top);
+            t[word_count + 1] = static_cast<NativeWord>(top >> native_word_size);
+
+            // t = (t + m * modulus) / 2^native_word_size, where m makes the lowest word of the sum zero
+            NativeWord m = t[0] * modulus_inverse;
+            NativeDoubleWord product = wide_multiply(m, modulus_words[0]) + t[0];
+            carry = static_cast<NativeWord>(product >> native_word_size);
+            for (size_t j = 1; j < word_count; j++) {
+                product = wide_multiply(m, modulus_words[j]) + t[j] + carry;
+                t[j - 1] = static_cast<NativeWord>(product);
+                carry = static_cast<NativeWord>(product >> native_word_size);
+            }
+            top = static_cast<NativeDoubleWord>(t[word_count]) + carry;
+            t[word_count - 1] = static_cast<NativeWord>(top);
+            t[word_count] = t[word_count + 1] + static_cast<NativeWord>(top >> native_word_size);
+        }
 
-        // T = left * right
-        StorageTypeX2 mult = left.wide_multiply(right);
-        StorageType mult_mod_r = static_cast<StorageType>(mult);
+        StorageType output;
+        auto& output_words = AK::Detail::get_storage_of(output);
+        for (size_t i = 0; i < word_count; i++)
+            output_words[i] = t[i];
 
-        // m = ((T mod R) * curve_p')
-        StorageType m = mult_mod_r * PRIME_INVERSE_MOD_R;
+        // The result is below 2 * modulus, so subtracting the modulus once is enough
+        bool borrow = false;
+        StorageType difference = output.subc(modulus, borrow);
+        return select(difference, output, borrow & !t[word_count]);
+    }
 
-        // mp = (m mod R) * curve_p
-        StorageTypeX2 mp = m.wide_multiply(PRIME);
+    static constexpr StorageType modular_add(StorageType const& left, StorageType const& right)
+    {
+        return add_mod(left, right, PRIME);
+    }
 
-        // t = (T + mp)
-        bool carry = false;
-        mult_mod_r.addc(static_cast<StorageType>(mp), carry);
+    static constexpr StorageType modular_sub(StorageType const& left, StorageType const& right)
+    {
+        return sub_mod(left, right, PRIME);
+    }
 
-        // output = t / R
-        StorageType mult_high = static_cast<StorageType>(mult >> KEY_BIT_SIZE);
-        StorageType mp_high = static_cast<StorageType>(mp >> KEY_BIT_SIZE);
-        return modular_add(mult_high, mp_high, carry);
+    static constexpr StorageType modular_multiply(StorageType const& left, StorageType const& right)
+    {
+        return montgomery_multiply(left, right, PRIME, PRIME_INVERSE_MOD_WORD);
     }
 
-    constexpr StorageType modular_square(StorageType const& value)
+    static constexpr StorageType modular_square(StorageType const& value)
     {
         return modular_multiply(value, value);
     }
 
-    constexpr StorageType to_montgomery(StorageType const& value)
+    static constexpr StorageType to_montgomery(StorageType const& value)
     {
+        // This also reduces values in [p, 2^KEY_BIT_SIZE), as value * R^2 < R * p
         return modular_multiply(value, R2_MOD_PRIME);
     }
 
-    constexpr StorageType from_montgomery(StorageType const& value)
+    static constexpr StorageType from_montgomery(StorageType const& value)
     {
         return modular_multiply(value, 1u);
     }
 
-    constexpr StorageType modular_inverse(StorageType const& value)
+    static constexpr StorageType modular_inverse(StorageType const& value)
     {
         // Modular inverse modulo the curve prime can be computed using Fermat's little theorem: a^(p-2) mod p = a^-1 mod p.
         // Calculating a^(p-2) mod p can be done using the square-and-multiply exponentiation method, as p-2 is constant.
         StorageType base = value;
-        StorageType result = to_montgomery(1u);
+        StorageType result = R_MOD_PRIME;
         StorageType prime_minus_2 = PRIME - 2u;
 
         for (size_t i = 0; i < KEY_BIT_SIZE; i++) {
@@ -448,67 +513,33 @@ private:
         return result;
     }
 
-    constexpr StorageType modular_add_order(StorageType const& left, StorageType const& right, bool carry_in = false)
+    static constexpr StorageType modular_multiply_order(StorageType const& left, StorageType const& right)
     {
-        bool carry = carry_in;
-        StorageType output = left.addc(right, carry);
-
-        // If there is a carry, subtract n by adding 2^KEY_BIT_SIZE - n
-        StorageType addend = select(0u, REDUCE_ORDER, carry);
-        carry = false;
-        output = output.addc(addend, carry);
-
-        // If there is still a carry, subtract n by adding 2^KEY_BIT_SIZE - n
-        addend = select(0u, REDUCE_ORDER, carry);
-        return output + addend;
+        return montgomery_multiply(left, right, ORDER, ORDER_INVERSE_MOD_WORD);
     }
 
-    constexpr StorageType modular_multiply_order(StorageType const& left, StorageType const& right)
-    {
-        // Modular multiplication using the Montgomery method: https://en.wikipedia.org/wiki/Montgomery_modular_multiplication
-        // This requires that the inputs to this function are in Montgomery form.
-
-        // T = left * right
-        StorageTypeX2 mult = left.wide_multiply(right);
-        StorageType mult_mod_r = static_cast<StorageType>(mult);
-
-        // m = ((T mod R) * curve_n')
-        StorageType m = mult_mod_r * ORDER_INVERSE_MOD_R;
-
-        // mp = (m mod R) * curve_n
-        StorageTypeX2 mp = m.wide_multiply(ORDER);
-
-        // t = (T + mp)
-        bool carry = false;
-        mult_mod_r.addc(static_cast<StorageType>(mp), carry);
-
-        // output = t / R
-        StorageType mult_high = static_cast<StorageType>(mult >> KEY_BIT_SIZE);
-        StorageType mp_high = static_cast<StorageType>(mp >> KEY_BIT_SIZE);
-        return modular_add_order(mult_high, mp_high, carry);
-    }
-
-    constexpr StorageType modular_square_order(StorageType const& value)
+    static constexpr StorageType modular_square_order(StorageType const& value)
     {
         return modular_multiply_order(value, value);
     }
 
-    constexpr StorageType to_montgomery_order(StorageType const& value)
+    static constexpr StorageType to_montgomery_order(StorageType const& value)
     {
+        // This also reduces values in [n, 2^KEY_BIT_SIZE), as value * R^2 < R * n
         return modular_multiply_order(value, R2_MOD_ORDER);
     }
 
-    constexpr StorageType from_montgomery_order(StorageType const& value)
+    static constexpr StorageType from_montgomery_order(StorageType const& value)
     {
         return modular_multiply_order(value, 1u);
     }
 
-    constexpr StorageType modular_inverse_order(StorageType const& value)
+    static constexpr StorageType modular_inverse_order(StorageType const& value)
     {
         // Modular inverse modulo the curve order can be computed using Fermat's little theorem: a^(n-2) mod n = a^-1 mod n.
         // Calculating a^(n-2) mod n can be done using the square-and-multiply exponentiation method, as n-2 is constant.
         StorageType base = value;
-        StorageType result = to_montgomery_order(1u);
+        StorageType result = R_MOD_ORDER;
         StorageType order_minus_2 = ORDER - 2u;
 
         for (size_t i = 0; i < KEY_BIT_SIZE; i++) {
@@ -522,15 +553,11 @@ private:
         return result;
     }
 
-    JacobianPoint point_double(JacobianPoint const& point)
+    static JacobianPoint point_double(JacobianPoint const& point)
     {
         // Based on "Point Doubling" from http://point-at-infinity.org/ecc/Prime_Curve_Jacobian_Coordinates.html
-
-        // if (Y == 0)
-        //   return POINT_AT_INFINITY
-        if (point.y.is_zero_constant_time()) {
-            VERIFY_NOT_REACHED();
-        }
+        // There are no points with Y = 0 on these curves, as their order is odd. The point at infinity (Z = 0) is mapped
+        // onto itself by these formulas, as Z' = 2*Y*Z.
 
         StorageType temp;
 
@@ -574,13 +601,9 @@ private:
         return JacobianPoint { xp, yp, zp };
     }
 
-    JacobianPoint point_add(JacobianPoint const& point_a, JacobianPoint const& point_b)
+    static JacobianPoint point_add(JacobianPoint const& point_a, JacobianPoint const& point_b)
     {
         // Based on "Point Addition" from  http://point-at-infinity.org/ecc/Prime_Curve_Jacobian_Coordinates.html
-        if (point_a.x.is_zero_constant_time() && point_a.y.is_zero_constant_time() && point_a.z.is_zero_constant_time()) {
-            return point_b;
-        }
-
         StorageType temp;
 
         temp = modular_square(point_b.z);
@@ -597,61 +620,189 @@ private:
         StorageType s2 = modular_multiply(point_b.y, temp);
         s2 = modular_multiply(s2, point_a.z);
 
-        // if (U1 == U2)
-        //   if (S1 != S2)
-        //     return POINT_AT_INFINITY
-        //   else
-        //     return POINT_DOUBLE(X1, Y1, Z1)
-        if (u1.is_equal_to_constant_time(u2)) {
-            if (s1.is_equal_to_constant_time(s2)) {
-                return point_double(point_a);
-            } else {
-                VERIFY_NOT_REACHED();
-            }
-        }
-
         // H = U2 - U1
         StorageType h = modular_sub(u2, u1);
-        StorageType h2 = modular_square(h);
-        StorageType h3 = modular_multiply(h2, h);
         // R = S2 - S1
         StorageType r = modular_sub(s2, s1);
+
+        bool point_a_is_infinity = point_a.z.is_zero_constant_time();
+        bool point_b_is_infinity = point_b.z.is_zero_constant_time();
+
+        // if (U1 == U2 && S1 == S2)
+        //   return POINT_DOUBLE(X1, Y1, Z1)
+        // The scalar multiplications never add a point to itself, so this only depends on public values in verify().
+        if (h.is_zero_constant_time() & r.is_zero_constant_time() & !point_a_is_infinity & !point_b_is_infinity)
+            return point_double(point_a);
+
+        StorageType h2 = modular_square(h);
+        StorageType h3 = modular_multiply(h2, h);
         // X3 = R^2 - H^3 - 2*U1*H^2
         StorageType x3 = modular_square(r);
         x3 = modular_sub(x3, h3);
-        temp = modular_multiply(u1, h2);
-        temp = modular_add(temp, temp);
+        StorageType u1h2 = modular_multiply(u1, h2);
+        temp = modular_add(u1h2, u1h2);
         x3 = modular_sub(x3, temp);
         // Y3 = R*(U1*H^2 - X3) - S1*H^3
-        StorageType y3 = modular_multiply(u1, h2);
-        y3 = modular_sub(y3, x3);
+        StorageType y3 = modular_sub(u1h2, x3);
         y3 = modular_multiply(y3, r);
         temp = modular_multiply(s1, h3);
         y3 = modular_sub(y3, temp);
         // Z3 = H*Z1*Z2
+        // If U1 == U2 and S1 != S2, the points are each other's inverse, and Z3 = 0 is the point at infinity
         StorageType z3 = modular_multiply(h, point_a.z);
         z3 = modular_multiply(z3, point_b.z);
-        // return (X3, Y3, Z3)
-        return JacobianPoint { x3, y3, z3 };
+
+        // return (X3, Y3, Z3), or the other point if either of them is the point at infinity
+        JacobianPoint result { x3, y3, z3 };
+        result = select(result, point_b, point_a_is_infinity);
+        return select(result, point_a, point_b_is_infinity);
     }
 
-    void convert_jacobian_to_affine(JacobianPoint& point)
+    static JacobianPoint point_add_affine(JacobianPoint const& point_a, AffinePoint const& point_b)
     {
+        // Same as point_add() with Z2 = 1, which saves four multiplications and a squaring
         StorageType temp;
+
+        temp = modular_square(point_a.z);
+        // U2 = X2*Z1^2
+        StorageType u2 = modular_multiply(point_b.x, temp);
+        // S2 = Y2*Z1^3
+        StorageType s2 = modular_multiply(point_b.y, temp);
+        s2 = modular_multiply(s2, point_a.z);
+
+        // H = U2 - X1
+        StorageType h = modular_sub(u2, point_a.x);
+        // R = S2 - Y1
+        StorageType r = modular_sub(s2, point_a.y);
+
+        bool point_a_is_infinity = point_a.z.is_zero_constant_time();
+
+        // See point_add()
+        if (h.is_zero_constant_time() & r.is_zero_constant_time() & !point_a_is_infinity)
+            return point_double(point_a);
+
+        StorageType h2 = modular_square(h);
+        StorageType h3 = modular_multiply(h2, h);
+        // X3 = R^2 - H^3 - 2*X1*H^2
+        StorageType x3 = modular_square(r);
+        x3 = modular_sub(x3, h3);
+        StorageType x1h2 = modular_multiply(point_a.x, h2);
+        temp = modular_add(x1h2, x1h2);
+        x3 = modular_sub(x3, temp);
+        // Y3 = R*(X1*H^2 - X3) - Y1*H^3
+        StorageType y3 = modular_sub(x1h2, x3);
+        y3 = modular_multiply(y3, r);
+        temp = modular_multiply(point_a.y, h3);
+        y3 = modular_sub(y3, temp);
+        // Z3 = H*Z1
+        StorageType z3 = modular_multiply(h, point_a.z);
+
+        JacobianPoint result { x3, y3, z3 };
+        return select(result, JacobianPoint { point_b.x, point_b.y, R_MOD_PRIME }, point_a_is_infinity);
+    }
+
+    static constexpr size_t scalar_window(StorageType const& scalar, size_t window)
+    {
+        size_t bit = window * WINDOW_BIT_SIZE;
+        auto word = AK::Detail::get_storage_of(scalar)[bit / AK::Detail::native_word_size];
+        return (word >> (bit % AK::Detail::native_word_size)) & (WINDOW_TABLE_SIZE - 1);
+    }
+
+    static JacobianPoint multiply_point(StorageType const& scalar, JacobianPoint const& point)
+    {
+        // Fixed-window scalar multiplication: precompute 0*P to 15*P, then go over the scalar 4 bits at a time from the top,
+        // doubling 4 times and adding the multiple selected by those bits. This does the same operations and reads the
+        // whole table for every window, so neither the timing nor the memory access pattern depend on the scalar.
+        // The scalar has to be below the order, so that this never adds a point to itself.
+        Array<JacobianPoint, WINDOW_TABLE_SIZE> table;
+        table[0] = JacobianPoint { R_MOD_PRIME, R_MOD_PRIME, 0u };
+        table[1] = point;
+        for (size_t i = 2; i < WINDOW_TABLE_SIZE; i++)
+            table[i] = i % 2 == 0 ? point_double(table[i / 2]) : point_add(table[i - 1], point);
+
+        JacobianPoint result = table[0];
+        for (size_t window = WINDOW_COUNT; window-- > 0;) {
+            for (size_t i = 0; i < WINDOW_BIT_SIZE; i++)
+                result = point_double(result);
+            result = point_add(result, select_from_table(table, scalar_window(scalar, window)));
+        }
+
+        return result;
+    }
+
+    struct GeneratorTable {
+        // Every window of the scalar has its own table of 1*G to 15*G, shifted up to the position of that window, in
+        // affine coordinates. Multiplying the generator then takes one mixed addition per window, and no doublings.
+        Array<Array<AffinePoint, WINDOW_TABLE_SIZE - 1>, WINDOW_COUNT> windows;
+
+        GeneratorTable()
+        {
+            AK::FixedMemoryStream generator_point_stream { GENERATOR_POINT.span() };
+            JacobianPoint window_generator = MUST(read_uncompressed_point(generator_point_stream));
+            window_generator.x = to_montgomery(window_generator.x);
+            window_generator.y = to_montgomery(window_generator.y);
+            window_generator.z = to_montgomery(window_generator.z);
+
+            for (auto& window : windows) {
+                // multiples[i] = (i + 1) * window_generator
+                Array<JacobianPoint, WINDOW_TABLE_SIZE - 1> multiples;
+                multiples[0] = window_generator;
+                for (size_t i = 1; i < multiples.size(); i++)
+                    multiples[i] = i % 2 == 1 ? point_double(multiples[i / 2]) : point_add(multiples[i - 1], window_generator);
+                window_generator = point_double(multiples[WINDOW_TABLE_SIZE / 2 - 1]);
+
+                // Invert all Z coordinates with a single inversion (Montgomery's trick): invert their product, and
+                // multiply the inverse with all the other Zs to get the inverse of each one of them.
+                Array<StorageType, WINDOW_TABLE_SIZE - 1> z_products;
+                z_products[0] = multiples[0].z;
+                for (size_t i = 1; i < multiples.size(); i++)
+                    z_products[i] = modular_multiply(z_products[i - 1], multiples[i].z);
+
+                StorageType z_inverse_product = modular_inverse(z_products.last());
+                for (size_t i = multiples.size(); i-- > 0;) {
+                    StorageType z_inverse = i > 0 ? modular_multiply(z_inverse_product, z_products[i - 1]) : z_inverse_product;
+                    z_inverse_product = modular_multiply(z_inverse_product, multiples[i].z);
+
+                    // X' = X/Z^2, Y' = Y/Z^3
+                    StorageType z_inverse_squared = modular_square(z_inverse);
+                    window[i].x = modular_multiply(multiples[i].x, z_inverse_squared);
+                    window[i].y = modular_multiply(multiples[i].y, modular_multiply(z_inverse_squared, z_inverse));
+                }
+            }
+        }
+    };
+
+    static JacobianPoint multiply_generator(StorageType const& scalar)
+    {
+        // The table is computed on first use, and shared between all instances of the curve.
+        static GeneratorTable const generator_table;
+
+        // Windows of zero bits still add an entry from the table, which is then thrown away, so that every window does
+        // the same work. As the windows don't overlap, this never adds a point to itself for a scalar below the order.
+        JacobianPoint result { R_MOD_PRIME, R_MOD_PRIME, 0u };
+        for (size_t window = 0; window < WINDOW_COUNT; window++) {
+            size_t bits = scalar_window(scalar, window);
+            // Zero bits wrap around to an index past the end of the table, which selects the first entry
+            AffinePoint multiple = select_from_table(generator_table.windows[window], bits - 1);
+            result = select(result, point_add_affine(result, multiple), bits != 0);
+        }
+
+        return result;
+    }
+
+    static void convert_jacobian_to_affine(JacobianPoint& point)
+    {
         // X' = X/Z^2
-        temp = modular_square(point.z);
-        temp = modular_inverse(temp);
-        point.x = modular_multiply(point.x, temp);
         // Y' = Y/Z^3
-        temp = modular_square(point.z);
-        temp = modular_multiply(temp, point.z);
-        temp = modular_inverse(temp);
-        point.y = modular_multiply(point.y, temp);
+        StorageType z_inverse = modular_inverse(point.z);
+        StorageType z_inverse_squared = modular_square(z_inverse);
+        point.x = modular_multiply(point.x, z_inverse_squared);
+        point.y = modular_multiply(point.y, modular_multiply(z_inverse_squared, z_inverse));
         // Z' = 1
-        point.z = to_montgomery(1u);
+        point.z = R_MOD_PRIME;
     }
 
-    bool is_point_on_curve(JacobianPoint const& point)
+    static bool is_point_on_curve(JacobianPoint const& point)
     {
         // This check requires the point to be in Montgomery form, with Z=1
         StorageType temp, temp2;
@@ -665,9 +816,8 @@ private:
         temp = modular_add(temp, point.x);
         temp = modular_add(temp, point.x);
         temp = modular_sub(temp, to_montgomery(B));
-        temp = modular_reduce(temp);
 
-        return temp.is_zero_constant_time() && point.z.is_equal_to_constant_time(to_montgomery(1u));
+        return temp.is_zero_constant_time() && point.z.is_equal_to_constant_time(R_MOD_PRIME);
     }
 };
 
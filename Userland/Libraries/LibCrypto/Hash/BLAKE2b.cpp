@@ -5,6 +5,8 @@
  */
 
 #include <AK/ByteReader.h>
+#include <AK/CPUFeatures.h>
+#include <AK/SIMD.h>
 #include <LibCrypto/Hash/BLAKE2b.h>
 
 namespace Crypto::Hash {
@@ -84,7 +86,8 @@ void BLAKE2b::mix(u64* work_array, u64 a, u64 b, u64 c, u64 d, u64 x, u64 y)
     work_array[b] = ROTRIGHT(work_array[b] ^ work_array[c], rotation_constant_4);
 }
 
-void BLAKE2b::transform(u8 const* block)
+template<>
+void BLAKE2b::transform_impl<CPUFeatures::None>(u8 const* block)
 {
     u64 m[16];
     u64 v[16];
@@ -123,4 +126,97 @@ void BLAKE2b::transform(u8 const* block)
         m_internal_state.hash_state[i] = m_internal_state.hash_state[i] ^ v[i] ^ v[i + 8];
 }
 
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+// NOTE: These must only be used from functions compiled for AVX2, as passing 256-bit vectors around changes the ABI.
+using AK::SIMD::u64x4;
+
+[[gnu::target("avx2")]] ALWAYS_INLINE static u64x4 rotate_right_lanes(u64x4 x, int bits)
+{
+    return (x >> bits) | (x << (64 - bits));
+}
+
+// Rotations by whole bytes are a single byte shuffle.
+template<int bytes>
+[[gnu::target("avx2")]] ALWAYS_INLINE static u64x4 rotate_right_lanes_by_bytes(u64x4 x)
+{
+    using charx32 = char __attribute__((vector_size(32)));
+#    define BYTE_INDEX(i) ((i) & ~7) + (((i) + bytes) & 7)
+#    define WORD_INDICES(i) BYTE_INDEX(i), BYTE_INDEX(i + 1), BYTE_INDEX(i + 2), BYTE_INDEX(i + 3), BYTE_INDEX(i + 4), BYTE_INDEX(i + 5), BYTE_INDEX(i + 6), BYTE_INDEX(i + 7)
+    auto bytes_of_x = __builtin_bit_cast(charx32, x);
+    return __builtin_bit_cast(u64x4, __builtin_shufflevector(bytes_of_x, bytes_of_x, WORD_INDICES(0), WORD_INDICES(8), WORD_INDICES(16), WORD_INDICES(24)));
+#    undef WORD_INDICES
+#    undef BYTE_INDEX
+}
+
+// The mix function applied to all four columns (or diagonals) at once.
+[[gnu::target("avx2")]] ALWAYS_INLINE static void mix_lanes(u64x4& a, u64x4& b, u64x4& c, u64x4& d, u64x4 x, u64x4 y)
+{
+    a = a + b + x;
+    d = rotate_right_lanes_by_bytes<4>(d ^ a);
+    c = c + d;
+    b = rotate_right_lanes_by_bytes<3>(b ^ c);
+    a = a + b + y;
+    d = rotate_right_lanes_by_bytes<2>(d ^ a);
+    c = c + d;
+    b = rotate_right_lanes(b ^ c, 63);
+}
+
+// Each row of the 4x4 work matrix lives in one vector, so the column step mixes the four lanes in parallel. For the
+// diagonal step the rows are rotated such that the diagonals line up as columns, and rotated back afterwards.
+template<>
+[[gnu::target("avx2")]] void BLAKE2b::transform_impl<CPUFeatures::X86_AVX2>(u8 const* block)
+{
+    u64 m[16];
+    for (size_t i = 0; i < 16; ++i)
+        m[i] = ByteReader::load64(block + i * sizeof(m[i]));
+
+    auto& state = m_internal_state;
+    u64x4 row_a, row_b, row_c, row_d;
+    __builtin_memcpy(&row_a, &state.hash_state[0], sizeof(row_a));
+    __builtin_memcpy(&row_b, &state.hash_state[4], sizeof(row_b));
+    __builtin_memcpy(&row_c, &SHA512Constants::InitializationHashes[0], sizeof(row_c));
+    __builtin_memcpy(&row_d, &SHA512Constants::InitializationHashes[4], sizeof(row_d));
+    row_d ^= u64x4 { state.message_byte_offset[0], state.message_byte_offset[1], state.is_at_last_block, 0 };
+
+    auto const original_a = row_a;
+    auto const original_b = row_b;
+
+    for (size_t i = 0; i < 12; ++i) {
+        auto const* sigma = BLAKE2bSigma[i % 10];
+
+        mix_lanes(row_a, row_b, row_c, row_d,
+            u64x4 { m[sigma[0]], m[sigma[2]], m[sigma[4]], m[sigma[6]] },
+            u64x4 { m[sigma[1]], m[sigma[3]], m[sigma[5]], m[sigma[7]] });
+
+        row_b = __builtin_shufflevector(row_b, row_b, 1, 2, 3, 0);
+        row_c = __builtin_shufflevector(row_c, row_c, 2, 3, 0, 1);
+        row_d = __builtin_shufflevector(row_d, row_d, 3, 0, 1, 2);
+
+        mix_lanes(row_a, row_b, row_c, row_d,
+            u64x4 { m[sigma[8]], m[sigma[10]], m[sigma[12]], m[sigma[14]] },
+            u64x4 { m[sigma[9]], m[sigma[11]], m[sigma[13]], m[sigma[15]] });
+
+        row_b = __builtin_shufflevector(row_b, row_b, 3, 0, 1, 2);
+        row_c = __builtin_shufflevector(row_c, row_c, 2, 3, 0, 1);
+        row_d = __builtin_shufflevector(row_d, row_d, 1, 2, 3, 0);
+    }
+
+    row_a ^= original_a ^ row_c;
+    row_b ^= original_b ^ row_d;
+    __builtin_memcpy(&state.hash_state[0], &row_a, sizeof(row_a));
+    __builtin_memcpy(&state.hash_state[4], &row_b, sizeof(row_b));
+}
+#endif
+
+decltype(BLAKE2b::transform_dispatched) BLAKE2b::transform_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &BLAKE2b::transform_impl<CPUFeatures::X86_AVX2>;
+    }
+
+    return &BLAKE2b::transform_impl<CPUFeatures::None>;
+}();
+
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/CPUFeatures.h>
 #include <LibCrypto/Hash/HashFunction.h>
 #include <LibCrypto/Hash/SHA2.h>
 
@@ -87,7 +88,12 @@ private:
 
     void mix(u64* work_vector, u64 a, u64 b, u64 c, u64 d, u64 x, u64 y);
     void increment_counter_by(u64 const amount);
-    void transform(u8 const*);
+
+    template<CPUFeatures>
+    void transform_impl(u8 const*);
+
+    static void (BLAKE2b::*const transform_dispatched)(u8 const*);
+    void transform(u8 const* block) { return (this->*transform_dispatched)(block); }
 };
 
 };
@@ -6,6 +6,7 @@
  */
 
 #include <AK/CPUFeatures.h>
+#include <AK/Endian.h>
 #include <AK/Platform.h>
 #include <AK/SIMD.h>
 #include <AK/SIMDExtras.h>
@@ -440,4 +441,271 @@ SHA512::DigestType SHA512::peek()
     }
     return digest;
 }
+
+// Multi-buffer hashing: each lane of the vector registers works on a different message. Messages are handed out to the
+// lanes as they become free, so that a lane doesn't sit idle while a longer message is still being hashed in another.
+template<size_t BlockSize>
+class PaddedMessage {
+public:
+    PaddedMessage() = default;
+
+    explicit PaddedMessage(ReadonlyBytes message)
+        : m_message(message)
+        , m_full_block_count(message.size() / BlockSize)
+    {
+        // The padding is a single 1 bit, then zeros up to the message length in bits, which fills the last
+        // BlockSize / 8 bytes of the final block.
+        auto remainder = message.slice(m_full_block_count * BlockSize);
+        remainder.copy_to({ m_padding, sizeof(m_padding) });
+        m_padding[remainder.size()] = 0x80;
+        m_padding_block_count = remainder.size() + 1 + BlockSize / 8 <= BlockSize ? 1 : 2;
+
+        u64 bit_length = message.size() * 8;
+        u8* padding_end = m_padding + m_padding_block_count * BlockSize;
+        for (size_t i = 0; i < sizeof(bit_length); ++i)
+            padding_end[-1 - i] = bit_length >> (i * 8);
+    }
+
+    size_t block_count() const { return m_full_block_count + m_padding_block_count; }
+
+    u8 const* block(size_t index) const
+    {
+        if (index < m_full_block_count)
+            return m_message.offset(index * BlockSize);
+        return m_padding + (index - m_full_block_count) * BlockSize;
+    }
+
+private:
+    ReadonlyBytes m_message;
+    size_t m_full_block_count { 0 };
+    size_t m_padding_block_count { 0 };
+    u8 m_padding[2 * BlockSize] {};
+};
+
+template<typename Word, size_t LaneCount, size_t BlockSize, typename DigestType, typename TransformLanes>
+ALWAYS_INLINE static void hash_in_lanes(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests, Word const (&initialization_hashes)[8], TransformLanes transform_lanes)
+{
+    struct Lane {
+        PaddedMessage<BlockSize> message;
+        size_t message_index { 0 };
+        size_t block_index { 0 };
+        bool is_busy { false };
+    };
+
+    Lane lanes[LaneCount];
+    // The state is stored word-major, so that the same word of all lanes can be loaded into one vector.
+    Word state[8][LaneCount];
+    // Lanes without a message hash this block, and the result is thrown away.
+    u8 const idle_block[BlockSize] {};
+
+    size_t next_message = 0;
+    size_t busy_lane_count = 0;
+    auto start_next_message = [&](size_t lane_index) {
+        auto& lane = lanes[lane_index];
+        lane.is_busy = next_message < messages.size();
+        if (!lane.is_busy)
+            return;
+        lane.message = PaddedMessage<BlockSize> { messages[next_message] };
+        lane.message_index = next_message++;
+        lane.block_index = 0;
+        for (size_t i = 0; i < 8; ++i)
+            state[i][lane_index] = initialization_hashes[i];
+        ++busy_lane_count;
+    };
+
+    for (size_t lane_index = 0; lane_index < LaneCount; ++lane_index)
+        start_next_message(lane_index);
+
+    while (busy_lane_count > 0) {
+        u8 const* blocks[LaneCount];
+        for (size_t lane_index = 0; lane_index < LaneCount; ++lane_index) {
+            auto& lane = lanes[lane_index];
+            blocks[lane_index] = lane.is_busy ? lane.message.block(lane.block_index) : idle_block;
+        }
+
+        transform_lanes(state, blocks);
+
+        for (size_t lane_index = 0; lane_index < LaneCount; ++lane_index) {
+            auto& lane = lanes[lane_index];
+            if (!lane.is_busy || ++lane.block_index < lane.message.block_count())
+                continue;
+
+            auto& digest = digests[lane.message_index];
+            for (size_t i = 0; i < DigestType::Size; ++i)
+                digest.data[i] = state[i / sizeof(Word)][lane_index] >> ((sizeof(Word) - 1 - i % sizeof(Word)) * 8);
+
+            --busy_lane_count;
+            start_next_message(lane_index);
+        }
+    }
+}
+
+template<typename Word, size_t LaneCount>
+ALWAYS_INLINE static void load_big_endian_words(Word (&words)[16][LaneCount], u8 const* const (&blocks)[LaneCount])
+{
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t lane = 0; lane < LaneCount; ++lane) {
+            Word word;
+            __builtin_memcpy(&word, blocks[lane] + i * sizeof(Word), sizeof(Word));
+            words[i][lane] = AK::convert_between_host_and_big_endian(word);
+        }
+    }
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+// NOTE: These must only be used from functions compiled for AVX2, as passing 256-bit vectors around changes the ABI.
+template<typename Vector>
+[[gnu::target("avx2")]] ALWAYS_INLINE static Vector rotate_right_lanes(Vector x, int bits)
+{
+    constexpr int word_bits = sizeof(x[0]) * 8;
+    return (x >> bits) | (x << (word_bits - bits));
+}
+
+[[gnu::target("avx2")]] static void sha256_transform_lanes(u32 (&state)[8][8], u8 const* const (&blocks)[8])
+{
+    using AK::SIMD::u32x8;
+
+    u32 words[16][8];
+    load_big_endian_words(words, blocks);
+    u32x8 m[16];
+    for (size_t i = 0; i < 16; ++i)
+        __builtin_memcpy(&m[i], words[i], sizeof(u32x8));
+
+    u32x8 v[8];
+    for (size_t i = 0; i < 8; ++i)
+        __builtin_memcpy(&v[i], state[i], sizeof(u32x8));
+    auto a = v[0], b = v[1], c = v[2], d = v[3], e = v[4], f = v[5], g = v[6], h = v[7];
+
+    for (size_t i = 0; i < 64; ++i) {
+        if (i >= 16) {
+            auto w2 = m[(i - 2) % 16];
+            auto w15 = m[(i - 15) % 16];
+            auto sign1 = rotate_right_lanes(w2, 17) ^ rotate_right_lanes(w2, 19) ^ (w2 >> 10);
+            auto sign0 = rotate_right_lanes(w15, 7) ^ rotate_right_lanes(w15, 18) ^ (w15 >> 3);
+            m[i % 16] = sign1 + m[(i - 7) % 16] + sign0 + m[(i - 16) % 16];
+        }
+
+        auto ep1 = rotate_right_lanes(e, 6) ^ rotate_right_lanes(e, 11) ^ rotate_right_lanes(e, 25);
+        auto ch = (e & f) ^ (g & ~e);
+        auto temp0 = h + ep1 + ch + SHA256Constants::RoundConstants[i] + m[i % 16];
+        auto ep0 = rotate_right_lanes(a, 2) ^ rotate_right_lanes(a, 13) ^ rotate_right_lanes(a, 22);
+        auto maj = (a & b) ^ (a & c) ^ (b & c);
+        auto temp1 = ep0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp0;
+        d = c;
+        c = b;
+        b = a;
+        a = temp0 + temp1;
+    }
+
+    v[0] += a, v[1] += b, v[2] += c, v[3] += d, v[4] += e, v[5] += f, v[6] += g, v[7] += h;
+    for (size_t i = 0; i < 8; ++i)
+        __builtin_memcpy(state[i], &v[i], sizeof(u32x8));
+}
+
+[[gnu::target("avx2")]] static void sha512_transform_lanes(u64 (&state)[8][4], u8 const* const (&blocks)[4])
+{
+    using AK::SIMD::u64x4;
+
+    u64 words[16][4];
+    load_big_endian_words(words, blocks);
+    u64x4 m[16];
+    for (size_t i = 0; i < 16; ++i)
+        __builtin_memcpy(&m[i], words[i], sizeof(u64x4));
+
+    u64x4 v[8];
+    for (size_t i = 0; i < 8; ++i)
+        __builtin_memcpy(&v[i], state[i], sizeof(u64x4));
+    auto a = v[0], b = v[1], c = v[2], d = v[3], e = v[4], f = v[5], g = v[6], h = v[7];
+
+    for (size_t i = 0; i < 80; ++i) {
+        if (i >= 16) {
+            auto w2 = m[(i - 2) % 16];
+            auto w15 = m[(i - 15) % 16];
+            auto sign1 = rotate_right_lanes(w2, 19) ^ rotate_right_lanes(w2, 61) ^ (w2 >> 6);
+            auto sign0 = rotate_right_lanes(w15, 1) ^ rotate_right_lanes(w15, 8) ^ (w15 >> 7);
+            m[i % 16] = sign1 + m[(i - 7) % 16] + sign0 + m[(i - 16) % 16];
+        }
+
+        auto ep1 = rotate_right_lanes(e, 14) ^ rotate_right_lanes(e, 18) ^ rotate_right_lanes(e, 41);
+        auto ch = (e & f) ^ (g & ~e);
+        auto temp0 = h + ep1 + ch + SHA512Constants::RoundConstants[i] + m[i % 16];
+        auto ep0 = rotate_right_lanes(a, 28) ^ rotate_right_lanes(a, 34) ^ rotate_right_lanes(a, 39);
+        auto maj = (a & b) ^ (a & c) ^ (b & c);
+        auto temp1 = ep0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp0;
+        d = c;
+        c = b;
+        b = a;
+        a = temp0 + temp1;
+    }
+
+    v[0] += a, v[1] += b, v[2] += c, v[3] += d, v[4] += e, v[5] += f, v[6] += g, v[7] += h;
+    for (size_t i = 0; i < 8; ++i)
+        __builtin_memcpy(state[i], &v[i], sizeof(u64x4));
+}
+#endif
+
+template<typename Hash, CPUFeatures>
+static void hash_many_impl(ReadonlySpan<ReadonlyBytes> messages, Span<typename Hash::DigestType> digests)
+{
+    for (size_t i = 0; i < messages.size(); ++i)
+        digests[i] = Hash::hash(messages[i].data(), messages[i].size());
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+template<>
+[[gnu::target("avx2")]] void hash_many_impl<SHA256, CPUFeatures::X86_AVX2>(ReadonlySpan<ReadonlyBytes> messages, Span<SHA256::DigestType> digests)
+{
+    hash_in_lanes<u32, 8, SHA256::BlockSize>(messages, digests, SHA256Constants::InitializationHashes, sha256_transform_lanes);
+}
+
+template<>
+[[gnu::target("avx2")]] void hash_many_impl<SHA512, CPUFeatures::X86_AVX2>(ReadonlySpan<ReadonlyBytes> messages, Span<SHA512::DigestType> digests)
+{
+    hash_in_lanes<u64, 4, SHA512::BlockSize>(messages, digests, SHA512Constants::InitializationHashes, sha512_transform_lanes);
+}
+#endif
+
+template<typename Hash>
+static void (*const hash_many_dispatched)(ReadonlySpan<ReadonlyBytes>, Span<typename Hash::DigestType>) = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    // Hashing one message after the other with SHA-NI is still faster than eight at once with AVX2.
+    if constexpr (IsSame<Hash, SHA256> && is_valid_feature(CPUFeatures::X86_SHA | CPUFeatures::X86_SSE42)) {
+        if (has_flag(features, CPUFeatures::X86_SHA | CPUFeatures::X86_SSE42))
+            return &hash_many_impl<Hash, CPUFeatures::None>;
+    }
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &hash_many_impl<Hash, CPUFeatures::X86_AVX2>;
+    }
+
+    return &hash_many_impl<Hash, CPUFeatures::None>;
+}();
+
+void SHA256::hash_many(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests)
+{
+    VERIFY(messages.size() == digests.size());
+    // There is nothing to gain from the lanes for a single message.
+    if (messages.size() == 1)
+        return hash_many_impl<SHA256, CPUFeatures::None>(messages, digests);
+    hash_many_dispatched<SHA256>(messages, digests);
+}
+
+void SHA512::hash_many(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests)
+{
+    VERIFY(messages.size() == digests.size());
+    // There is nothing to gain from the lanes for a single message.
+    if (messages.size() == 1)
+        return hash_many_impl<SHA512, CPUFeatures::None>(messages, digests);
+    hash_many_dispatched<SHA512>(messages, digests);
+}
 }
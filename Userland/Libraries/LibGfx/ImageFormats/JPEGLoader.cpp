@@ -13,6 +13,8 @@
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/String.h>
 #include <AK/Try.h>
 #include <AK/Vector.h>
@@ -20,9 +22,19 @@
 #include <LibGfx/ImageFormats/JPEGShared.h>
 #include <LibGfx/ImageFormats/TIFFLoader.h>
 #include <LibGfx/ImageFormats/TIFFMetadata.h>
+#include <LibThreading/Thread.h>
 
 namespace Gfx {
 
+using AK::SIMD::expand4;
+using AK::SIMD::f32x4;
+using AK::SIMD::i16x4;
+using AK::SIMD::i32x4;
+using AK::SIMD::load_unaligned;
+using AK::SIMD::simd_cast;
+using AK::SIMD::store_unaligned;
+using AK::SIMD::u32x4;
+
 struct MacroblockMeta {
     u32 total { 0 };
     u32 padded_total { 0 };
@@ -271,8 +283,53 @@ private:
     u64 m_current_size { buffer_size };
 };
 
+// The entropy-coded data of a scan, with the offsets at which its restart intervals start.
+// The last offset is the end of the data.
+struct EntropyCodedSegment {
+    ByteBuffer data;
+    Vector<size_t> interval_offsets;
+};
+
 class HuffmanStream {
 public:
+    // Reads the rest of the current scan. The restart markers stay in the returned data, so that it can be decoded by a
+    // HuffmanStream as usual, and the marker that ends the scan is saved for later use.
+    static ErrorOr<EntropyCodedSegment> read_entropy_coded_segment(JPEGStream& stream)
+    {
+        EntropyCodedSegment segment;
+        TRY(segment.interval_offsets.try_append(0));
+
+        if (stream.saved_marker({}).has_value())
+            return segment;
+
+        while (true) {
+            u8 const byte = TRY(stream.read_u8());
+            if (byte != 0xFF) {
+                TRY(segment.data.try_append(byte));
+                continue;
+            }
+
+            // Any marker can be preceded by fill bytes, see B.1.1.2.
+            u8 next_byte = TRY(stream.read_u8());
+            while (next_byte == 0xFF)
+                next_byte = TRY(stream.read_u8());
+
+            Marker const marker = 0xFF00 | next_byte;
+            if (next_byte != 0x00 && (marker < JPEG_RST0 || marker > JPEG_RST7)) {
+                stream.saved_marker({}) = marker;
+                break;
+            }
+
+            TRY(segment.data.try_append(0xFF));
+            TRY(segment.data.try_append(next_byte));
+            if (next_byte != 0x00)
+                TRY(segment.interval_offsets.try_append(segment.data.size()));
+        }
+
+        TRY(segment.interval_offsets.try_append(segment.data.size()));
+        return segment;
+    }
+
     ALWAYS_INLINE ErrorOr<u8> next_symbol(HuffmanTable const& table)
     {
         u16 const code = TRY(peek_bits(HuffmanTable::maximum_bits_per_code));
@@ -404,6 +461,17 @@ struct Scan {
     {
     }
 
+    // Creates a scan with the same parameters as `other`, that reads its entropy-coded data from `stream`.
+    Scan(Scan const& other, HuffmanStream stream)
+        : components(other.components)
+        , spectral_selection_start(other.spectral_selection_start)
+        , spectral_selection_end(other.spectral_selection_end)
+        , successive_approximation_high(other.successive_approximation_high)
+        , successive_approximation_low(other.successive_approximation_low)
+        , huffman_stream(stream)
+    {
+    }
+
     // B.2.3 - Scan header syntax
     Vector<ScanComponent, 4> components;
 
@@ -416,6 +484,11 @@ struct Scan {
 
     u64 end_of_bands_run_count { 0 };
 
+    // F.2.1.3.1 - Huffman decoding of DC coefficients
+    // DC coefficients are predicted from the previous one of the same component, these predictions are reset at the
+    // start of each scan and restart interval.
+    Array<i16, 4> previous_dc_values {};
+
     // See the note on Figure B.4 - Scan header syntax
     bool are_components_interleaved() const
     {
@@ -470,7 +543,6 @@ struct JPEGLoadingContext {
     u16 dc_restart_interval { 0 };
     HashMap<u8, HuffmanTable> dc_tables;
     HashMap<u8, HuffmanTable> ac_tables;
-    Array<i16, 4> previous_dc_values {};
     MacroblockMeta mblock_meta;
     JPEGStream stream;
     JPEGDecoderOptions options;
@@ -516,7 +588,7 @@ enum class JPEGDecodingMode {
 };
 
 template<JPEGDecodingMode DecodingMode>
-static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock, ScanComponent const& scan_component)
+static ErrorOr<void> add_dc(JPEGLoadingContext const& context, Scan& scan, Macroblock& macroblock, ScanComponent const& scan_component)
 {
     auto maybe_table = context.dc_tables.get(scan_component.dc_destination_id);
     if (!maybe_table.has_value()) {
@@ -525,7 +597,6 @@ static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock,
     }
 
     auto& dc_table = maybe_table.value();
-    auto& scan = *context.current_scan;
 
     auto* select_component = get_component(macroblock, scan_component.component.index);
     auto& coefficient = select_component[0];
@@ -553,7 +624,7 @@ static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock,
     if (dc_length != 0 && dc_diff < (1 << (dc_length - 1)))
         dc_diff -= (1 << dc_length) - 1;
 
-    auto& previous_dc = context.previous_dc_values[scan_component.component.index];
+    auto& previous_dc = scan.previous_dc_values[scan_component.component.index];
     previous_dc += dc_diff;
     coefficient = previous_dc << scan.successive_approximation_low;
 
@@ -597,7 +668,7 @@ static bool is_progressive(StartOfFrame::FrameType frame_type)
 }
 
 template<JPEGDecodingMode DecodingMode>
-static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock, ScanComponent const& scan_component)
+static ErrorOr<void> add_ac(JPEGLoadingContext const& context, Scan& scan, Macroblock& macroblock, ScanComponent const& scan_component)
 {
     auto maybe_table = context.ac_tables.get(scan_component.ac_destination_id);
     if (!maybe_table.has_value()) {
@@ -608,8 +679,6 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
     auto& ac_table = maybe_table.value();
     auto* select_component = get_component(macroblock, scan_component.component.index);
 
-    auto& scan = *context.current_scan;
-
     // Compute the AC coefficients.
 
     // 0th coefficient is the dc, which is already handled
@@ -731,14 +800,14 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
  * we are dealing with three components) will fill up the blocks with chroma data.
  */
 template<JPEGDecodingMode DecodingMode>
-static ErrorOr<void> build_macroblocks(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
+static ErrorOr<void> build_macroblocks(JPEGLoadingContext const& context, Scan& scan, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
 {
-    for (auto const& scan_component : context.current_scan->components) {
+    for (auto const& scan_component : scan.components) {
         for (u8 vfactor_i = 0; vfactor_i < scan_component.component.sampling_factors.vertical; vfactor_i++) {
             for (u8 hfactor_i = 0; hfactor_i < scan_component.component.sampling_factors.horizontal; hfactor_i++) {
                 // A.2.3 - Interleaved order
                 u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                if (!context.current_scan->are_components_interleaved()) {
+                if (!scan.are_components_interleaved()) {
                     macroblock_index = vcursor * context.mblock_meta.hpadded_count + (hfactor_i + (hcursor * scan_component.component.sampling_factors.vertical) + (vfactor_i * scan_component.component.sampling_factors.horizontal));
 
                     // A.2.4 Completion of partial MCU
@@ -756,17 +825,17 @@ static ErrorOr<void> build_macroblocks(JPEGLoadingContext& context, Vector<Macro
                 Macroblock& block = macroblocks[macroblock_index];
 
                 if constexpr (DecodingMode == JPEGDecodingMode::Sequential) {
-                    TRY(add_dc<DecodingMode>(context, block, scan_component));
-                    TRY(add_ac<DecodingMode>(context, block, scan_component));
+                    TRY(add_dc<DecodingMode>(context, scan, block, scan_component));
+                    TRY(add_ac<DecodingMode>(context, scan, block, scan_component));
                 } else {
-                    if (context.current_scan->spectral_selection_start == 0)
-                        TRY(add_dc<DecodingMode>(context, block, scan_component));
-                    if (context.current_scan->spectral_selection_end != 0)
-                        TRY(add_ac<DecodingMode>(context, block, scan_component));
+                    if (scan.spectral_selection_start == 0)
+                        TRY(add_dc<DecodingMode>(context, scan, block, scan_component));
+                    if (scan.spectral_selection_end != 0)
+                        TRY(add_ac<DecodingMode>(context, scan, block, scan_component));
 
                     // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
-                    if (context.current_scan->end_of_bands_run_count > 0) {
-                        --context.current_scan->end_of_bands_run_count;
+                    if (scan.end_of_bands_run_count > 0) {
+                        --scan.end_of_bands_run_count;
                         continue;
                     }
                 }
@@ -789,61 +858,164 @@ static bool is_dct_based(StartOfFrame::FrameType frame_type)
         || frame_type == StartOfFrame::FrameType::Differential_Progressive_DCT_Arithmetic;
 }
 
-static void reset_decoder(JPEGLoadingContext& context)
+static void reset_decoder(JPEGLoadingContext const& context, Scan& scan)
 {
     // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
-    context.current_scan->end_of_bands_run_count = 0;
+    scan.end_of_bands_run_count = 0;
 
     // E.2.4 Control procedure for decoding a restart interval
     if (is_dct_based(context.frame.type)) {
-        context.previous_dc_values = {};
+        scan.previous_dc_values = {};
         return;
     }
 
     VERIFY_NOT_REACHED();
 }
 
-static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static u32 mcus_per_row(JPEGLoadingContext const& context)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.sampling_factors.vertical) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.sampling_factors.horizontal) {
-            // FIXME: This is likely wrong for non-interleaved scans.
-            VERIFY(context.mblock_meta.hpadded_count % context.sampling_factors.horizontal == 0);
-            u32 number_of_mcus_decoded_so_far = ((vcursor / context.sampling_factors.vertical) * context.mblock_meta.hpadded_count + hcursor) / context.sampling_factors.horizontal;
+    // FIXME: This is likely wrong for non-interleaved scans.
+    VERIFY(context.mblock_meta.hpadded_count % context.sampling_factors.horizontal == 0);
+    return context.mblock_meta.hpadded_count / context.sampling_factors.horizontal;
+}
 
-            auto& huffman_stream = context.current_scan->huffman_stream;
+static u32 mcu_count(JPEGLoadingContext const& context)
+{
+    return mcus_per_row(context) * ceil_div(context.mblock_meta.vcount, static_cast<u32>(context.sampling_factors.vertical));
+}
 
-            if (context.dc_restart_interval > 0) {
-                if (number_of_mcus_decoded_so_far != 0 && number_of_mcus_decoded_so_far % context.dc_restart_interval == 0) {
-                    reset_decoder(context);
+// Decodes the MCUs in [first_mcu, end_mcu). The huffman stream of `scan` has to be positioned at the start of
+// first_mcu, which has to be the first MCU of the scan or of a restart interval.
+static ErrorOr<void> decode_mcus(JPEGLoadingContext const& context, Scan& scan, Vector<Macroblock>& macroblocks, u32 first_mcu, u32 end_mcu)
+{
+    auto const mcus_in_a_row = mcus_per_row(context);
 
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    TRY(huffman_stream.advance_to_byte_boundary());
+    for (u32 mcu = first_mcu; mcu < end_mcu; ++mcu) {
+        u32 const vcursor = (mcu / mcus_in_a_row) * context.sampling_factors.vertical;
+        u32 const hcursor = (mcu % mcus_in_a_row) * context.sampling_factors.horizontal;
 
-                    // Skip the restart marker (RSTn).
-                    TRY(huffman_stream.discard_bits(8));
-                }
+        if (context.dc_restart_interval > 0) {
+            if (mcu != first_mcu && mcu % context.dc_restart_interval == 0) {
+                reset_decoder(context, scan);
+
+                // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
+                //  the 0th bit of the next byte.
+                TRY(scan.huffman_stream.advance_to_byte_boundary());
+
+                // Skip the restart marker (RSTn).
+                TRY(scan.huffman_stream.discard_bits(8));
             }
+        }
 
-            auto result = [&]() {
-                if (is_progressive(context.frame.type))
-                    return build_macroblocks<JPEGDecodingMode::Progressive>(context, macroblocks, hcursor, vcursor);
-                return build_macroblocks<JPEGDecodingMode::Sequential>(context, macroblocks, hcursor, vcursor);
-            }();
+        auto result = [&]() {
+            if (is_progressive(context.frame.type))
+                return build_macroblocks<JPEGDecodingMode::Progressive>(context, scan, macroblocks, hcursor, vcursor);
+            return build_macroblocks<JPEGDecodingMode::Sequential>(context, scan, macroblocks, hcursor, vcursor);
+        }();
 
-            if (result.is_error()) {
-                if constexpr (JPEG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}: {}", number_of_mcus_decoded_so_far, result.error());
-                    dbgln("Huffman stream byte offset {:#x}", context.stream.byte_offset());
-                }
-                return result.release_error();
+        if (result.is_error()) {
+            if constexpr (JPEG_DEBUG) {
+                dbgln("Failed to build Macroblock {}: {}", mcu, result.error());
+                dbgln("Huffman stream byte offset {:#x}", context.stream.byte_offset());
             }
+            return result.release_error();
         }
     }
     return {};
 }
 
+static bool can_decode_restart_intervals_in_parallel(JPEGLoadingContext const& context)
+{
+    // Restart intervals are independent of each other in sequential scans, but the end-of-band runs of progressive
+    // scans may not stop at restart markers, see G.1.2.2.
+    if (context.options.thread_count < 2 || context.dc_restart_interval == 0 || is_progressive(context.frame.type))
+        return false;
+
+    // Restart intervals of non-interleaved scans count the blocks of a single component, which the MCU-based
+    // decode_mcus() only handles when that is the same thing.
+    if (!context.current_scan->are_components_interleaved() && context.sampling_factors != SamplingFactors { 1, 1 })
+        return false;
+
+    return mcu_count(context) > context.dc_restart_interval;
+}
+
+static ErrorOr<void> decode_restart_intervals_in_parallel(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
+    // The restart markers are located up front, and every thread then decodes a contiguous range of restart intervals
+    // from its own stream. Each range ends with an EOI marker, so that the threads see the same end of data as a
+    // stream reading the whole scan would.
+    auto segment = TRY(HuffmanStream::read_entropy_coded_segment(context.stream));
+
+    auto const total_mcu_count = mcu_count(context);
+    auto const interval_count = ceil_div(total_mcu_count, static_cast<u32>(context.dc_restart_interval));
+    auto const thread_count = min<size_t>(context.options.thread_count, interval_count);
+
+    struct IntervalRange {
+        u32 first_mcu { 0 };
+        u32 end_mcu { 0 };
+        ByteBuffer data {};
+        Optional<Error> error {};
+    };
+
+    Vector<IntervalRange> ranges;
+    TRY(ranges.try_ensure_capacity(thread_count));
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto const first_interval = static_cast<u32>(i * interval_count / thread_count);
+        auto const end_interval = static_cast<u32>((i + 1) * interval_count / thread_count);
+
+        // Missing intervals are decoded from an empty stream, like the end of a truncated scan would be.
+        auto const data_start = segment.interval_offsets[min<size_t>(first_interval, segment.interval_offsets.size() - 1)];
+        auto const data_end = segment.interval_offsets[min<size_t>(end_interval, segment.interval_offsets.size() - 1)];
+
+        auto data = TRY(ByteBuffer::create_uninitialized(data_end - data_start + 2));
+        segment.data.bytes().slice(data_start, data_end - data_start).copy_to(data);
+        data[data.size() - 2] = 0xFF;
+        data[data.size() - 1] = JPEG_EOI & 0xFF;
+
+        ranges.unchecked_append({
+            .first_mcu = first_interval * context.dc_restart_interval,
+            .end_mcu = min(end_interval * context.dc_restart_interval, total_mcu_count),
+            .data = move(data),
+        });
+    }
+
+    auto decode_range = [&](IntervalRange& range) -> ErrorOr<void> {
+        auto stream = TRY(JPEGStream::create(TRY(try_make<FixedMemoryStream>(range.data.bytes()))));
+        Scan scan { *context.current_scan, HuffmanStream { stream } };
+        return decode_mcus(context, scan, macroblocks, range.first_mcu, range.end_mcu);
+    };
+
+    auto decode_range_on_thread = [&](IntervalRange& range) -> intptr_t {
+        if (auto result = decode_range(range); result.is_error())
+            range.error = result.release_error();
+        return 0;
+    };
+
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    TRY(threads.try_ensure_capacity(ranges.size()));
+    for (auto& range : ranges) {
+        auto thread = Threading::Thread::construct([&decode_range_on_thread, &range] { return decode_range_on_thread(range); }, "JPEGDecoder"sv);
+        thread->start();
+        threads.unchecked_append(move(thread));
+    }
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    for (auto& range : ranges) {
+        if (range.error.has_value())
+            return range.error.release_value();
+    }
+    return {};
+}
+
+static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
+    if (can_decode_restart_intervals_in_parallel(context))
+        return decode_restart_intervals_in_parallel(context, macroblocks);
+
+    return decode_mcus(context, *context.current_scan, macroblocks, 0, mcu_count(context));
+}
+
 static bool is_frame_marker(Marker const marker)
 {
     // B.1.1.3 - Marker assignments
@@ -1432,9 +1604,26 @@ static void dequantize(JPEGLoadingContext const& context, Component const& compo
         block_component[k] *= quantization_table[k];
 }
 
-static void inverse_dct_8x8(i16* block_component)
+// The 16-bit samples are converted through 32-bit integers, which unlike direct conversions between 16-bit integers
+// and floats have packed instructions on every x86-64 CPU.
+static ALWAYS_INLINE i32x4 load4(i16 const* samples)
+{
+    return simd_cast<i32x4>(load_unaligned<i16x4>(samples));
+}
+
+static ALWAYS_INLINE void store4(i16* destination, i32x4 samples)
+{
+    store_unaligned(destination, simd_cast<i16x4>(samples));
+}
+
+static ALWAYS_INLINE i32x4 truncate_to_16_bits(i32x4 samples)
+{
+    return simd_cast<i32x4>(simd_cast<i16x4>(samples));
+}
+
+template<typename T>
+static ALWAYS_INLINE void inverse_dct_1d(Array<T, 8>& values)
 {
-    // Does a 2-D IDCT by doing two 1-D IDCTs as described in https://unix4lyfe.org/dct/
     // The 1-D DCT idea is described at https://unix4lyfe.org/dct-1d/, read aan.cc from bottom to top.
     static float const m0 = 2.0f * AK::cos(1.0f / 16.0f * 2.0f * AK::Pi<float>);
     static float const m1 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
@@ -1451,139 +1640,124 @@ static void inverse_dct_8x8(i16* block_component)
     static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
 
-    for (u32 k = 0; k < 8; ++k) {
-        float const g0 = block_component[0 * 8 + k] * s0;
-        float const g1 = block_component[4 * 8 + k] * s4;
-        float const g2 = block_component[2 * 8 + k] * s2;
-        float const g3 = block_component[6 * 8 + k] * s6;
-        float const g4 = block_component[5 * 8 + k] * s5;
-        float const g5 = block_component[1 * 8 + k] * s1;
-        float const g6 = block_component[7 * 8 + k] * s7;
-        float const g7 = block_component[3 * 8 + k] * s3;
-
-        float const f0 = g0;
-        float const f1 = g1;
-        float const f2 = g2;
-        float const f3 = g3;
-        float const f4 = g4 - g7;
-        float const f5 = g5 + g6;
-        float const f6 = g5 - g6;
-        float const f7 = g4 + g7;
-
-        float const e0 = f0;
-        float const e1 = f1;
-        float const e2 = f2 - f3;
-        float const e3 = f2 + f3;
-        float const e4 = f4;
-        float const e5 = f5 - f7;
-        float const e6 = f6;
-        float const e7 = f5 + f7;
-        float const e8 = f4 + f6;
-
-        float const d0 = e0;
-        float const d1 = e1;
-        float const d2 = e2 * m1;
-        float const d3 = e3;
-        float const d4 = e4 * m2;
-        float const d5 = e5 * m3;
-        float const d6 = e6 * m4;
-        float const d7 = e7;
-        float const d8 = e8 * m5;
-
-        float const c0 = d0 + d1;
-        float const c1 = d0 - d1;
-        float const c2 = d2 - d3;
-        float const c3 = d3;
-        float const c4 = d4 + d8;
-        float const c5 = d5 + d7;
-        float const c6 = d6 - d8;
-        float const c7 = d7;
-        float const c8 = c5 - c6;
-
-        float const b0 = c0 + c3;
-        float const b1 = c1 + c2;
-        float const b2 = c1 - c2;
-        float const b3 = c0 - c3;
-        float const b4 = c4 - c8;
-        float const b5 = c8;
-        float const b6 = c6 - c7;
-        float const b7 = c7;
-
-        block_component[0 * 8 + k] = b0 + b7;
-        block_component[1 * 8 + k] = b1 + b6;
-        block_component[2 * 8 + k] = b2 + b5;
-        block_component[3 * 8 + k] = b3 + b4;
-        block_component[4 * 8 + k] = b3 - b4;
-        block_component[5 * 8 + k] = b2 - b5;
-        block_component[6 * 8 + k] = b1 - b6;
-        block_component[7 * 8 + k] = b0 - b7;
-    }
-    for (u32 l = 0; l < 8; ++l) {
-        float const g0 = block_component[l * 8 + 0] * s0;
-        float const g1 = block_component[l * 8 + 4] * s4;
-        float const g2 = block_component[l * 8 + 2] * s2;
-        float const g3 = block_component[l * 8 + 6] * s6;
-        float const g4 = block_component[l * 8 + 5] * s5;
-        float const g5 = block_component[l * 8 + 1] * s1;
-        float const g6 = block_component[l * 8 + 7] * s7;
-        float const g7 = block_component[l * 8 + 3] * s3;
-
-        float const f0 = g0;
-        float const f1 = g1;
-        float const f2 = g2;
-        float const f3 = g3;
-        float const f4 = g4 - g7;
-        float const f5 = g5 + g6;
-        float const f6 = g5 - g6;
-        float const f7 = g4 + g7;
-
-        float const e0 = f0;
-        float const e1 = f1;
-        float const e2 = f2 - f3;
-        float const e3 = f2 + f3;
-        float const e4 = f4;
-        float const e5 = f5 - f7;
-        float const e6 = f6;
-        float const e7 = f5 + f7;
-        float const e8 = f4 + f6;
-
-        float const d0 = e0;
-        float const d1 = e1;
-        float const d2 = e2 * m1;
-        float const d3 = e3;
-        float const d4 = e4 * m2;
-        float const d5 = e5 * m3;
-        float const d6 = e6 * m4;
-        float const d7 = e7;
-        float const d8 = e8 * m5;
-
-        float const c0 = d0 + d1;
-        float const c1 = d0 - d1;
-        float const c2 = d2 - d3;
-        float const c3 = d3;
-        float const c4 = d4 + d8;
-        float const c5 = d5 + d7;
-        float const c6 = d6 - d8;
-        float const c7 = d7;
-        float const c8 = c5 - c6;
-
-        float const b0 = c0 + c3;
-        float const b1 = c1 + c2;
-        float const b2 = c1 - c2;
-        float const b3 = c0 - c3;
-        float const b4 = c4 - c8;
-        float const b5 = c8;
-        float const b6 = c6 - c7;
-        float const b7 = c7;
-
-        block_component[l * 8 + 0] = b0 + b7;
-        block_component[l * 8 + 1] = b1 + b6;
-        block_component[l * 8 + 2] = b2 + b5;
-        block_component[l * 8 + 3] = b3 + b4;
-        block_component[l * 8 + 4] = b3 - b4;
-        block_component[l * 8 + 5] = b2 - b5;
-        block_component[l * 8 + 6] = b1 - b6;
-        block_component[l * 8 + 7] = b0 - b7;
+    T const g0 = values[0] * s0;
+    T const g1 = values[4] * s4;
+    T const g2 = values[2] * s2;
+    T const g3 = values[6] * s6;
+    T const g4 = values[5] * s5;
+    T const g5 = values[1] * s1;
+    T const g6 = values[7] * s7;
+    T const g7 = values[3] * s3;
+
+    T const f0 = g0;
+    T const f1 = g1;
+    T const f2 = g2;
+    T const f3 = g3;
+    T const f4 = g4 - g7;
+    T const f5 = g5 + g6;
+    T const f6 = g5 - g6;
+    T const f7 = g4 + g7;
+
+    T const e0 = f0;
+    T const e1 = f1;
+    T const e2 = f2 - f3;
+    T const e3 = f2 + f3;
+    T const e4 = f4;
+    T const e5 = f5 - f7;
+    T const e6 = f6;
+    T const e7 = f5 + f7;
+    T const e8 = f4 + f6;
+
+    T const d0 = e0;
+    T const d1 = e1;
+    T const d2 = e2 * m1;
+    T const d3 = e3;
+    T const d4 = e4 * m2;
+    T const d5 = e5 * m3;
+    T const d6 = e6 * m4;
+    T const d7 = e7;
+    T const d8 = e8 * m5;
+
+    T const c0 = d0 + d1;
+    T const c1 = d0 - d1;
+    T const c2 = d2 - d3;
+    T const c3 = d3;
+    T const c4 = d4 + d8;
+    T const c5 = d5 + d7;
+    T const c6 = d6 - d8;
+    T const c7 = d7;
+    T const c8 = c5 - c6;
+
+    T const b0 = c0 + c3;
+    T const b1 = c1 + c2;
+    T const b2 = c1 - c2;
+    T const b3 = c0 - c3;
+    T const b4 = c4 - c8;
+    T const b5 = c8;
+    T const b6 = c6 - c7;
+    T const b7 = c7;
+
+    values[0] = b0 + b7;
+    values[1] = b1 + b6;
+    values[2] = b2 + b5;
+    values[3] = b3 + b4;
+    values[4] = b3 - b4;
+    values[5] = b2 - b5;
+    values[6] = b1 - b6;
+    values[7] = b0 - b7;
+}
+
+static ALWAYS_INLINE void transpose_4x4(f32x4& a, f32x4& b, f32x4& c, f32x4& d)
+{
+    auto const ab_low = __builtin_shufflevector(a, b, 0, 4, 1, 5);
+    auto const ab_high = __builtin_shufflevector(a, b, 2, 6, 3, 7);
+    auto const cd_low = __builtin_shufflevector(c, d, 0, 4, 1, 5);
+    auto const cd_high = __builtin_shufflevector(c, d, 2, 6, 3, 7);
+    a = __builtin_shufflevector(ab_low, cd_low, 0, 1, 4, 5);
+    b = __builtin_shufflevector(ab_low, cd_low, 2, 3, 6, 7);
+    c = __builtin_shufflevector(ab_high, cd_high, 0, 1, 4, 5);
+    d = __builtin_shufflevector(ab_high, cd_high, 2, 3, 6, 7);
+}
+
+// The block is stored as the left and right halves of its rows.
+static ALWAYS_INLINE void transpose_8x8(Array<f32x4, 8>& left, Array<f32x4, 8>& right)
+{
+    transpose_4x4(left[0], left[1], left[2], left[3]);
+    transpose_4x4(right[4], right[5], right[6], right[7]);
+    transpose_4x4(right[0], right[1], right[2], right[3]);
+    transpose_4x4(left[4], left[5], left[6], left[7]);
+    for (u32 i = 0; i < 4; ++i)
+        swap(right[i], left[i + 4]);
+}
+
+static void inverse_dct_8x8(i16* block_component)
+{
+    // Does a 2-D IDCT by doing two 1-D IDCTs as described in https://unix4lyfe.org/dct/
+    // Each 1-D IDCT transforms four columns at once, and the block is transposed in between to transform its rows.
+    Array<f32x4, 8> left;
+    Array<f32x4, 8> right;
+    for (u32 i = 0; i < 8; ++i) {
+        left[i] = simd_cast<f32x4>(load4(&block_component[i * 8]));
+        right[i] = simd_cast<f32x4>(load4(&block_component[i * 8 + 4]));
+    }
+
+    inverse_dct_1d(left);
+    inverse_dct_1d(right);
+
+    // The intermediate results are truncated to integers, as if they were stored back into the block.
+    for (u32 i = 0; i < 8; ++i) {
+        left[i] = simd_cast<f32x4>(truncate_to_16_bits(simd_cast<i32x4>(left[i])));
+        right[i] = simd_cast<f32x4>(truncate_to_16_bits(simd_cast<i32x4>(right[i])));
+    }
+
+    transpose_8x8(left, right);
+    inverse_dct_1d(left);
+    inverse_dct_1d(right);
+    transpose_8x8(left, right);
+
+    for (u32 i = 0; i < 8; ++i) {
+        store4(&block_component[i * 8], simd_cast<i32x4>(left[i]));
+        store4(&block_component[i * 8 + 4], simd_cast<i32x4>(right[i]));
     }
 }
 
@@ -1650,22 +1824,35 @@ static void undo_subsampling(JPEGLoadingContext const& context, Vector<Macrobloc
     }
 }
 
-static void ycbcr_to_rgb(Vector<Macroblock>& macroblocks)
+static ALWAYS_INLINE void ycbcr_to_rgb(i32x4& y_or_r, i32x4& cb_or_g, i32x4& cr_or_b)
 {
     // Conversion from YCbCr to RGB isn't specified in the first JPEG specification but in the JFIF extension:
     // See: https://www.itu.int/rec/dologin_pub.asp?lang=f&id=T-REC-T.871-201105-I!!PDF-E&type=items
     // 7 - Conversion to and from RGB
+    auto const clamp_to_8_bits = [](i32x4 value) {
+        value = value < 0 ? expand4(0) : value;
+        return value > 255 ? expand4(255) : value;
+    };
+
+    auto const y = simd_cast<f32x4>(y_or_r);
+    auto const cb = simd_cast<f32x4>(cb_or_g - 128);
+    auto const cr = simd_cast<f32x4>(cr_or_b - 128);
+    y_or_r = clamp_to_8_bits(simd_cast<i32x4>(y + 1.402f * cr));
+    cb_or_g = clamp_to_8_bits(simd_cast<i32x4>(y - 0.3441f * cb - 0.7141f * cr));
+    cr_or_b = clamp_to_8_bits(simd_cast<i32x4>(y + 1.772f * cb));
+}
+
+static void ycbcr_to_rgb(Vector<Macroblock>& macroblocks)
+{
     for (auto& macroblock : macroblocks) {
-        auto* y = macroblock.y;
-        auto* cb = macroblock.cb;
-        auto* cr = macroblock.cr;
-        for (u8 i = 0; i < 64; ++i) {
-            int r = y[i] + 1.402f * (cr[i] - 128);
-            int g = y[i] - 0.3441f * (cb[i] - 128) - 0.7141f * (cr[i] - 128);
-            int b = y[i] + 1.772f * (cb[i] - 128);
-            y[i] = clamp(r, 0, 255);
-            cb[i] = clamp(g, 0, 255);
-            cr[i] = clamp(b, 0, 255);
+        for (u8 i = 0; i < 64; i += 4) {
+            auto y = load4(&macroblock.y[i]);
+            auto cb = load4(&macroblock.cb[i]);
+            auto cr = load4(&macroblock.cr[i]);
+            ycbcr_to_rgb(y, cb, cr);
+            store4(&macroblock.r[i], y);
+            store4(&macroblock.g[i], cb);
+            store4(&macroblock.b[i], cr);
         }
     }
 }
@@ -1767,13 +1954,72 @@ static ErrorOr<void> compose_bitmap(JPEGLoadingContext& context, Vector<Macroblo
     for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
         u32 const block_row = y / 8;
         u32 const pixel_row = y % 8;
+        auto* scanline = context.bitmap->scanline(y);
         for (u32 x = 0; x < context.frame.width; x++) {
             u32 const block_column = x / 8;
             auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
             u32 const pixel_column = x % 8;
             u32 const pixel_index = pixel_row * 8 + pixel_column;
-            Color const color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+            scanline[x] = Color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] }.value();
+        }
+    }
+
+    return {};
+}
+
+static bool can_compose_bitmap_from_ycbcr(JPEGLoadingContext const& context)
+{
+    if (context.components.size() != 3)
+        return false;
+    if (context.color_transform.has_value() && *context.color_transform != ColorTransform::YCbCr)
+        return false;
+
+    // The chroma samples of an MCU must all be stored in its top-left macroblock.
+    return context.components[0].sampling_factors == context.sampling_factors
+        && context.components[1].sampling_factors == SamplingFactors { 1, 1 }
+        && context.components[2].sampling_factors == SamplingFactors { 1, 1 };
+}
+
+static ErrorOr<void> compose_bitmap_from_ycbcr(JPEGLoadingContext& context, Vector<Macroblock> const& macroblocks)
+{
+    // This does what undo_subsampling(), ycbcr_to_rgb() and compose_bitmap() do, but in a single pass over each
+    // scanline. The chroma samples are read straight from the subsampled macroblock instead of being duplicated first.
+    context.bitmap = TRY(Bitmap::create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height }));
+
+    auto const horizontal_factor = context.sampling_factors.horizontal;
+    auto const vertical_factor = context.sampling_factors.vertical;
+
+    for (u32 y = 0; y < context.frame.height; y++) {
+        u32 const block_row = y / 8;
+        u32 const pixel_row = y % 8;
+        u32 const chroma_block_row = block_row - block_row % vertical_factor;
+        u32 const chroma_pixel_row = (y % (8 * vertical_factor)) / vertical_factor;
+        auto* scanline = context.bitmap->scanline(y);
+
+        for (u32 x = 0; x < context.frame.width; x += 4) {
+            u32 const block_column = x / 8;
+            u32 const pixel_column = x % 8;
+            auto const& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
+            auto const& chroma_block = macroblocks[chroma_block_row * context.mblock_meta.hpadded_count + block_column - block_column % horizontal_factor];
+            u32 const chroma_pixel_column = ((block_column % horizontal_factor) * 8 + pixel_column) / horizontal_factor;
+
+            auto r = load4(&block.y[pixel_row * 8 + pixel_column]);
+            i32x4 g;
+            i32x4 b;
+            for (u32 i = 0; i < 4; ++i) {
+                auto const chroma_index = chroma_pixel_row * 8 + chroma_pixel_column + i / horizontal_factor;
+                g[i] = chroma_block.cb[chroma_index];
+                b[i] = chroma_block.cr[chroma_index];
+            }
+            ycbcr_to_rgb(r, g, b);
+
+            auto const pixels = simd_cast<u32x4>(r << 16 | g << 8 | b) | 0xff000000;
+            if (x + 4 <= context.frame.width) {
+                store_unaligned(&scanline[x], pixels);
+            } else {
+                for (u32 i = 0; x + i < context.frame.width; ++i)
+                    scanline[x + i] = pixels[i];
+            }
         }
     }
 
@@ -1952,6 +2198,9 @@ static ErrorOr<void> decode_jpeg(JPEGLoadingContext& context)
         dequantize(context, component, block_component);
         inverse_dct(context, block_component);
     });
+    if (can_compose_bitmap_from_ycbcr(context))
+        return compose_bitmap_from_ycbcr(context, macroblocks);
+
     undo_subsampling(context, macroblocks);
     TRY(handle_color_transform(context, macroblocks));
     if (context.components.size() == 4)
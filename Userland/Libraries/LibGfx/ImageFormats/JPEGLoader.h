@@ -25,6 +25,9 @@ struct JPEGDecoderOptions {
         PDF,
     };
     CMYK cmyk { CMYK::Normal };
+
+    // Sequential images with restart markers can have their restart intervals decoded on several threads.
+    size_t thread_count { 1 };
 };
 
 class JPEGImageDecoderPlugin : public ImageDecoderPlugin {
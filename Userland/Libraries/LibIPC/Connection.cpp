@@ -48,12 +48,53 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer, MessageKind kin
     if (!m_socket->is_open())
         return Error::from_string_literal("Trying to post_message during IPC shutdown");
 
+    if (m_outgoing_ring) {
+        // File descriptors can only be passed over the socket, and a full ring shouldn't block us either.
+        if (!buffer.has_file_descriptors() && m_outgoing_ring->try_write(buffer.message_bytes())) {
+            if (m_outgoing_ring->take_consumer_wakeup()) {
+                auto record = MessageBuffer::create_control_record(ControlRecord::Wakeup);
+                TRY(transfer_message(record, kind));
+            }
+
+            m_responsiveness_timer->start();
+            return {};
+        }
+
+        auto record = MessageBuffer::create_control_record(ControlRecord::RingPosition);
+        auto position = m_outgoing_ring->write_position();
+        TRY(record.append_data(reinterpret_cast<u8 const*>(&position), sizeof(position)));
+        TRY(transfer_message(record, kind));
+    }
+
+    TRY(transfer_message(buffer, kind));
+
+    m_responsiveness_timer->start();
+    return {};
+}
+
+ErrorOr<void> ConnectionBase::transfer_message(MessageBuffer& buffer, MessageKind kind)
+{
     if (auto result = buffer.transfer_message(*m_socket, kind == MessageKind::Sync); result.is_error()) {
         shutdown_with_error(result.error());
         return result.release_error();
     }
+    return {};
+}
 
-    m_responsiveness_timer->start();
+ErrorOr<void> ConnectionBase::enable_shared_memory_ring(size_t capacity)
+{
+    if (m_outgoing_ring)
+        return {};
+
+    auto ring = TRY(MessageRing::create(capacity));
+
+    auto record = MessageBuffer::create_control_record(ControlRecord::AttachRing);
+    auto ring_capacity = static_cast<u32>(ring->capacity());
+    TRY(record.append_data(reinterpret_cast<u8 const*>(&ring_capacity), sizeof(ring_capacity)));
+    TRY(record.append_file_descriptor(TRY(Core::System::dup(ring->fd()))));
+    TRY(transfer_message(record, MessageKind::Async));
+
+    m_outgoing_ring = move(ring);
     return {};
 }
 
@@ -160,12 +201,127 @@ ErrorOr<Vector<u8>> ConnectionBase::read_as_much_as_possible_from_socket_without
     return bytes;
 }
 
+ErrorOr<void> ConnectionBase::try_parse_messages(Vector<u8> const& bytes, size_t& index)
+{
+    u32 message_size = 0;
+    while (index + sizeof(message_size) <= bytes.size()) {
+        memcpy(&message_size, bytes.data() + index, sizeof(message_size));
+
+        if ((message_size & CONTROL_RECORD_FLAG) != 0) {
+            auto record = static_cast<ControlRecord>(message_size & ~CONTROL_RECORD_FLAG);
+            auto record_size = TRY(handle_control_record(record, bytes.span().slice(index + sizeof(message_size))));
+            if (!record_size.has_value())
+                break;
+            index += sizeof(message_size) + *record_size;
+            continue;
+        }
+
+        if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
+            break;
+        index += sizeof(message_size);
+
+        auto message = try_decode_message({ bytes.data() + index, message_size });
+        if (!message)
+            break;
+
+        index += message_size;
+        enqueue_message(message.release_nonnull());
+    }
+
+    return {};
+}
+
+// Returns the number of bytes that follow the record's first word, or nothing if not all of them were received yet.
+ErrorOr<Optional<size_t>> ConnectionBase::handle_control_record(ControlRecord record, ReadonlyBytes bytes)
+{
+    switch (record) {
+    case ControlRecord::AttachRing: {
+        u32 capacity = 0;
+        if (bytes.size() < sizeof(capacity))
+            return OptionalNone {};
+        memcpy(&capacity, bytes.data(), sizeof(capacity));
+
+        if (m_incoming_ring || m_unprocessed_fds.is_empty())
+            return Error::from_string_literal("Peer sent an invalid message ring");
+
+        m_incoming_ring = TRY(MessageRing::attach(m_unprocessed_fds.dequeue(), capacity));
+        return sizeof(capacity);
+    }
+    case ControlRecord::Wakeup:
+        return 0;
+    case ControlRecord::RingPosition: {
+        u64 position = 0;
+        if (bytes.size() < sizeof(position))
+            return OptionalNone {};
+        memcpy(&position, bytes.data(), sizeof(position));
+
+        if (!m_incoming_ring)
+            return Error::from_string_literal("Peer sent a ring position without a message ring");
+
+        m_next_message_ring_position = position;
+        return sizeof(position);
+    }
+    }
+
+    return Error::from_string_literal("Peer sent an unknown control record");
+}
+
+void ConnectionBase::enqueue_message(NonnullOwnPtr<Message> message)
+{
+    // A message that was sent over the socket after messages were written to the ring has to wait for those.
+    if (m_next_message_ring_position.has_value()) {
+        m_socket_messages_waiting_for_ring.append({ m_next_message_ring_position.release_value(), move(message) });
+        return;
+    }
+
+    m_unprocessed_messages.append(move(message));
+}
+
+// Returns whether any messages were read from the ring.
+ErrorOr<bool> ConnectionBase::drain_messages_from_ring()
+{
+    if (!m_incoming_ring)
+        return false;
+
+    auto enqueue_socket_messages_up_to = [&](u64 position) {
+        while (!m_socket_messages_waiting_for_ring.is_empty() && m_socket_messages_waiting_for_ring.first().ring_position <= position)
+            m_unprocessed_messages.append(m_socket_messages_waiting_for_ring.take_first().message);
+    };
+
+    bool did_read_messages = false;
+
+    do {
+        for (;;) {
+            auto position = m_incoming_ring->read_position();
+            auto bytes = TRY(m_incoming_ring->read_next());
+            if (!bytes.has_value())
+                break;
+
+            enqueue_socket_messages_up_to(position);
+
+            auto message = try_decode_message(*bytes);
+            if (!message)
+                return Error::from_string_literal("Failed to parse a message from the message ring");
+
+            m_unprocessed_messages.append(message.release_nonnull());
+            did_read_messages = true;
+        }
+
+        enqueue_socket_messages_up_to(m_incoming_ring->read_position());
+    } while (!m_incoming_ring->prepare_to_wait());
+
+    return did_read_messages;
+}
+
 ErrorOr<void> ConnectionBase::drain_messages_from_peer()
 {
     auto bytes = TRY(read_as_much_as_possible_from_socket_without_blocking());
 
     size_t index = 0;
-    try_parse_messages(bytes, index);
+    if (auto result = try_parse_messages(bytes, index); result.is_error()) {
+        shutdown();
+        return result.release_error();
+    }
 
     if (index < bytes.size()) {
         // Sometimes we might receive a partial message. That's okay, just stash away
@@ -179,6 +335,16 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
         m_unprocessed_bytes = move(remaining_bytes);
     }
 
+    auto did_read_messages_from_ring = drain_messages_from_ring();
+    if (did_read_messages_from_ring.is_error()) {
+        shutdown();
+        return did_read_messages_from_ring.release_error();
+    }
+    if (did_read_messages_from_ring.value()) {
+        m_responsiveness_timer->stop();
+        did_become_responsive();
+    }
+
     if (!m_unprocessed_messages.is_empty()) {
         m_deferred_invoker->schedule([strong_this = NonnullRefPtr(*this)] {
             strong_this->handle_messages();
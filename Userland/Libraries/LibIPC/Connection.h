@@ -18,6 +18,7 @@
 #include <LibIPC/File.h>
 #include <LibIPC/Forward.h>
 #include <LibIPC/Message.h>
+#include <LibIPC/MessageRing.h>
 #include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -50,6 +51,11 @@ public:
     };
     ErrorOr<void> post_message(Message const&, MessageKind = MessageKind::Async);
 
+    // Sends the messages that don't carry file descriptors through a ring in shared memory from now on. The socket is
+    // then only used to wake the peer up when it is waiting for messages.
+    ErrorOr<void> enable_shared_memory_ring(size_t capacity = MessageRing::DEFAULT_CAPACITY);
+    bool has_shared_memory_ring() const { return m_outgoing_ring != nullptr; }
+
     void shutdown();
     virtual void die() { }
 
@@ -60,7 +66,7 @@ protected:
 
     virtual void may_have_become_unresponsive() { }
     virtual void did_become_responsive() { }
-    virtual void try_parse_messages(Vector<u8> const& bytes, size_t& index) = 0;
+    virtual OwnPtr<Message> try_decode_message(ReadonlyBytes) = 0;
     virtual void shutdown_with_error(Error const&);
 
     OwnPtr<IPC::Message> wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id);
@@ -69,8 +75,14 @@ protected:
     ErrorOr<void> drain_messages_from_peer();
 
     ErrorOr<void> post_message(MessageBuffer, MessageKind);
+    ErrorOr<void> transfer_message(MessageBuffer&, MessageKind);
     void handle_messages();
 
+    ErrorOr<void> try_parse_messages(Vector<u8> const& bytes, size_t& index);
+    ErrorOr<Optional<size_t>> handle_control_record(ControlRecord, ReadonlyBytes);
+    void enqueue_message(NonnullOwnPtr<Message>);
+    ErrorOr<bool> drain_messages_from_ring();
+
     IPC::Stub& m_local_stub;
 
     NonnullOwnPtr<Core::LocalSocket> m_socket;
@@ -81,6 +93,17 @@ protected:
     Queue<IPC::File> m_unprocessed_fds;
     ByteBuffer m_unprocessed_bytes;
 
+    OwnPtr<MessageRing> m_outgoing_ring;
+    OwnPtr<MessageRing> m_incoming_ring;
+
+    // Messages that the peer sent over the socket while it had a ring, with the ring position they must be handled at.
+    struct SocketMessage {
+        u64 ring_position { 0 };
+        NonnullOwnPtr<Message> message;
+    };
+    Vector<SocketMessage> m_socket_messages_waiting_for_ring;
+    Optional<u64> m_next_message_ring_position;
+
     u32 m_local_endpoint_magic { 0 };
 
     NonnullOwnPtr<DeferredInvoker> m_deferred_invoker;
@@ -132,33 +155,20 @@ protected:
         return {};
     }
 
-    virtual void try_parse_messages(Vector<u8> const& bytes, size_t& index) override
+    virtual OwnPtr<Message> try_decode_message(ReadonlyBytes bytes) override
     {
-        u32 message_size = 0;
-        for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
-            memcpy(&message_size, bytes.data() + index, sizeof(message_size));
-            if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
-                break;
-            index += sizeof(message_size);
-            auto remaining_bytes = ReadonlyBytes { bytes.data() + index, message_size };
-
-            auto local_message = LocalEndpoint::decode_message(remaining_bytes, m_unprocessed_fds);
-            if (!local_message.is_error()) {
-                m_unprocessed_messages.append(local_message.release_value());
-                continue;
-            }
-
-            auto peer_message = PeerEndpoint::decode_message(remaining_bytes, m_unprocessed_fds);
-            if (!peer_message.is_error()) {
-                m_unprocessed_messages.append(peer_message.release_value());
-                continue;
-            }
-
-            dbgln("Failed to parse a message");
-            dbgln("Local endpoint error: {}", local_message.error());
-            dbgln("Peer endpoint error: {}", peer_message.error());
-            break;
-        }
+        auto local_message = LocalEndpoint::decode_message(bytes, m_unprocessed_fds);
+        if (!local_message.is_error())
+            return local_message.release_value();
+
+        auto peer_message = PeerEndpoint::decode_message(bytes, m_unprocessed_fds);
+        if (!peer_message.is_error())
+            return peer_message.release_value();
+
+        dbgln("Failed to parse a message");
+        dbgln("Local endpoint error: {}", local_message.error());
+        dbgln("Peer endpoint error: {}", peer_message.error());
+        return nullptr;
     }
 };
 
@@ -19,6 +19,13 @@ MessageBuffer::MessageBuffer()
     m_data.resize(sizeof(MessageSizeType));
 }
 
+MessageBuffer MessageBuffer::create_control_record(ControlRecord record)
+{
+    MessageBuffer buffer;
+    buffer.m_control_record = record;
+    return buffer;
+}
+
 ErrorOr<void> MessageBuffer::extend_data_capacity(size_t capacity)
 {
     TRY(m_data.try_ensure_capacity(m_data.size() + capacity));
@@ -38,15 +45,20 @@ ErrorOr<void> MessageBuffer::append_file_descriptor(int fd)
     return {};
 }
 
+ReadonlyBytes MessageBuffer::message_bytes() const
+{
+    return m_data.span().slice(sizeof(MessageSizeType));
+}
+
 ErrorOr<void> MessageBuffer::transfer_message(Core::LocalSocket& socket, bool block_event_loop)
 {
     Checked<MessageSizeType> checked_message_size { m_data.size() };
     checked_message_size -= sizeof(MessageSizeType);
 
-    if (checked_message_size.has_overflow())
+    if (checked_message_size.has_overflow() || (checked_message_size.value() & CONTROL_RECORD_FLAG) != 0)
         return Error::from_string_literal("Message is too large for IPC encoding");
 
-    MessageSizeType const message_size = checked_message_size.value();
+    MessageSizeType const message_size = m_control_record.has_value() ? CONTROL_RECORD_FLAG | to_underlying(*m_control_record) : checked_message_size.value();
     m_data.span().overwrite(0, reinterpret_cast<u8 const*>(&message_size), sizeof(message_size));
 
     auto raw_fds = Vector<int, 1> {};
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/Error.h>
+#include <AK/Optional.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
 #include <AK/Vector.h>
@@ -35,20 +36,42 @@ private:
     int m_fd;
 };
 
+// Control records are sent over a connection's socket in between messages. They start with a word that has the
+// CONTROL_RECORD_FLAG set, where a message starts with its size.
+enum class ControlRecord : u32 {
+    // Followed by the capacity of a MessageRing as a u32, and sent with the ring's file descriptor. Messages after this
+    // record are preceded by a RingPosition record if they are sent over the socket.
+    AttachRing = 1,
+
+    // Sent when the peer was waiting for messages to be written to the MessageRing.
+    Wakeup,
+
+    // Followed by the write position of the MessageRing as a u64. The next message must be handled after the messages
+    // that were written to the ring before that position.
+    RingPosition,
+};
+
+static constexpr u32 CONTROL_RECORD_FLAG = 0x80000000;
+
 class MessageBuffer {
 public:
     MessageBuffer();
+    static MessageBuffer create_control_record(ControlRecord);
 
     ErrorOr<void> extend_data_capacity(size_t capacity);
     ErrorOr<void> append_data(u8 const* values, size_t count);
 
     ErrorOr<void> append_file_descriptor(int fd);
 
+    bool has_file_descriptors() const { return !m_fds.is_empty(); }
+    ReadonlyBytes message_bytes() const;
+
     ErrorOr<void> transfer_message(Core::LocalSocket& socket, bool block_event_loop = false);
 
 private:
     Vector<u8, 1024> m_data;
     Vector<NonnullRefPtr<AutoCloseFileDescriptor>, 1> m_fds;
+    Optional<ControlRecord> m_control_record;
 };
 
 enum class ErrorCode : u32 {
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <LibCore/System.h>
+#include <LibIPC/File.h>
+#include <LibIPC/MessageRing.h>
+
+namespace IPC {
+
+using EntrySizeType = u32;
+
+static constexpr size_t entry_size(size_t message_size)
+{
+    return align_up_to(sizeof(EntrySizeType) + message_size, sizeof(EntrySizeType));
+}
+
+static bool is_valid_capacity(size_t capacity)
+{
+    return capacity >= MessageRing::MINIMUM_CAPACITY && capacity <= MessageRing::MAXIMUM_CAPACITY && popcount(capacity) == 1;
+}
+
+ErrorOr<NonnullOwnPtr<MessageRing>> MessageRing::create(size_t capacity)
+{
+    if (!is_valid_capacity(capacity))
+        return Error::from_string_literal("Invalid message ring capacity");
+
+    auto buffer = TRY(Core::AnonymousBuffer::create_with_size(DATA_OFFSET + capacity));
+    new (buffer.data<void>()) Header();
+
+    return adopt_nonnull_own_or_enomem(new (nothrow) MessageRing(move(buffer), capacity));
+}
+
+ErrorOr<NonnullOwnPtr<MessageRing>> MessageRing::attach(IPC::File file, size_t capacity)
+{
+    if (!is_valid_capacity(capacity))
+        return Error::from_string_literal("Invalid message ring capacity");
+
+    // Accessing a mapping beyond the end of the file that backs it would crash us.
+    auto stat = TRY(Core::System::fstat(file.fd()));
+    if (static_cast<u64>(stat.st_size) < DATA_OFFSET + capacity)
+        return Error::from_string_literal("Message ring is smaller than its capacity");
+
+    auto buffer = TRY(Core::AnonymousBuffer::create_from_anon_fd(file.take_fd(), DATA_OFFSET + capacity));
+    return adopt_nonnull_own_or_enomem(new (nothrow) MessageRing(move(buffer), capacity));
+}
+
+MessageRing::MessageRing(Core::AnonymousBuffer buffer, size_t capacity)
+    : m_buffer(move(buffer))
+    , m_capacity(capacity)
+{
+}
+
+void MessageRing::copy_to_ring(u64 position, ReadonlyBytes bytes)
+{
+    auto offset = position & (m_capacity - 1);
+    auto first_part = min(bytes.size(), m_capacity - offset);
+
+    memcpy(data() + offset, bytes.data(), first_part);
+    memcpy(data(), bytes.data() + first_part, bytes.size() - first_part);
+}
+
+void MessageRing::copy_from_ring(u64 position, Bytes bytes)
+{
+    auto offset = position & (m_capacity - 1);
+    auto first_part = min(bytes.size(), m_capacity - offset);
+
+    memcpy(bytes.data(), data() + offset, first_part);
+    memcpy(bytes.data() + first_part, data(), bytes.size() - first_part);
+}
+
+bool MessageRing::try_write(ReadonlyBytes message)
+{
+    auto size = entry_size(message.size());
+    if (size > m_capacity)
+        return false;
+
+    auto read_position = header().read_position.load();
+    if (read_position > m_write_position || m_write_position - read_position > m_capacity)
+        return false;
+    if (m_capacity - (m_write_position - read_position) < size)
+        return false;
+
+    // Entries start at a multiple of the size type, so the size of an entry never wraps around the end of the ring.
+    auto message_size = static_cast<EntrySizeType>(message.size());
+    copy_to_ring(m_write_position, { &message_size, sizeof(message_size) });
+    copy_to_ring(m_write_position + sizeof(message_size), message);
+
+    m_write_position += size;
+    header().write_position.store(m_write_position);
+    return true;
+}
+
+bool MessageRing::take_consumer_wakeup()
+{
+    return header().consumer_is_waiting.exchange(0) != 0;
+}
+
+ErrorOr<Optional<ReadonlyBytes>> MessageRing::read_next()
+{
+    auto write_position = header().write_position.load();
+    if (write_position == m_read_position)
+        return OptionalNone {};
+
+    auto available = write_position - m_read_position;
+    if (write_position < m_read_position || available > m_capacity || available < sizeof(EntrySizeType))
+        return Error::from_string_literal("Message ring is corrupted");
+
+    EntrySizeType message_size = 0;
+    copy_from_ring(m_read_position, { &message_size, sizeof(message_size) });
+    if (entry_size(message_size) > available)
+        return Error::from_string_literal("Message ring is corrupted");
+
+    // The message is copied out of the ring, as the peer could change it while we are decoding it otherwise.
+    TRY(m_message.try_resize(message_size));
+    copy_from_ring(m_read_position + sizeof(message_size), m_message.span());
+
+    m_read_position += entry_size(message_size);
+    header().read_position.store(m_read_position);
+    return Optional<ReadonlyBytes> { m_message.span() };
+}
+
+bool MessageRing::prepare_to_wait()
+{
+    // This pairs with the producer publishing its write position before it checks whether we are waiting. Either we
+    // see the new write position here, or the producer sees that we are waiting and wakes us up.
+    header().consumer_is_waiting.store(1);
+    return header().write_position.load() == m_read_position;
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Platform.h>
+#include <AK/Vector.h>
+#include <LibCore/AnonymousBuffer.h>
+#include <LibIPC/Forward.h>
+
+namespace IPC {
+
+/**
+ * A MessageRing carries the messages of one direction of an IPC connection
+ * through shared memory instead of the connection's socket. The sending
+ * process is the only producer, and the receiving process the only consumer.
+ *
+ * Messages are stored one after another as a 32-bit size followed by the
+ * message's bytes, padded to a multiple of 4 bytes. The read and write
+ * positions only ever grow, and are mapped into the ring modulo its capacity,
+ * so an entry may wrap around the end of the ring.
+ *
+ * The consumer tells the producer when it has run out of messages and will
+ * wait for the socket to become readable. The producer then sends a wakeup
+ * over the socket after its next write, so that a burst of messages costs a
+ * single socket write instead of one for every message.
+ *
+ * The peer may write anything into the shared memory, so every position and
+ * size that is read from it is validated before it is used.
+ */
+class MessageRing {
+    AK_MAKE_NONCOPYABLE(MessageRing);
+    AK_MAKE_NONMOVABLE(MessageRing);
+
+public:
+    static constexpr size_t MINIMUM_CAPACITY = 4 * KiB;
+    static constexpr size_t MAXIMUM_CAPACITY = 64 * MiB;
+    static constexpr size_t DEFAULT_CAPACITY = 1 * MiB;
+
+    // The capacity must be a power of two.
+    static ErrorOr<NonnullOwnPtr<MessageRing>> create(size_t capacity = DEFAULT_CAPACITY);
+    static ErrorOr<NonnullOwnPtr<MessageRing>> attach(IPC::File, size_t capacity);
+
+    int fd() const { return m_buffer.fd(); }
+    size_t capacity() const { return m_capacity; }
+
+    // Producer side. The write position is where the next message that is written to the ring will start.
+    u64 write_position() const { return m_write_position; }
+    [[nodiscard]] bool try_write(ReadonlyBytes message);
+    [[nodiscard]] bool take_consumer_wakeup();
+
+    // Consumer side. The returned bytes are only valid until the next call to read_next().
+    u64 read_position() const { return m_read_position; }
+    ErrorOr<Optional<ReadonlyBytes>> read_next();
+
+    // Tells the producer to wake the consumer up when it writes the next message. Returns false if messages were
+    // written since the ring was last read, in which case those should be read before waiting.
+    [[nodiscard]] bool prepare_to_wait();
+
+private:
+    struct Header {
+        AK_CACHE_ALIGNED Atomic<u64> write_position { 0 };
+        AK_CACHE_ALIGNED Atomic<u64> read_position { 0 };
+        AK_CACHE_ALIGNED Atomic<u32> consumer_is_waiting { 1 };
+    };
+
+    static constexpr size_t DATA_OFFSET = sizeof(Header);
+
+    MessageRing(Core::AnonymousBuffer, size_t capacity);
+
+    Header& header() { return *reinterpret_cast<Header*>(m_buffer.data<void>()); }
+    u8* data() { return m_buffer.data<u8>() + DATA_OFFSET; }
+
+    void copy_to_ring(u64 position, ReadonlyBytes);
+    void copy_from_ring(u64 position, Bytes);
+
+    Core::AnonymousBuffer m_buffer;
+    size_t m_capacity { 0 };
+
+    // Each side keeps its own copy of the position it owns, so that the peer can't make us read or write outside of
+    // the entries between the two positions.
+    u64 m_write_position { 0 };
+    u64 m_read_position { 0 };
+
+    Vector<u8> m_message;
+};
+
+}
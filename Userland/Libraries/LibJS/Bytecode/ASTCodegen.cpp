@@ -600,6 +600,12 @@ Bytecode::CodeGenerationErrorOr<Optional<ScopedOperand>> AssignmentExpression::g
                 // e. Perform ? PutValue(lref, rval).
                 if (is<Identifier>(*lhs)) {
                     auto& identifier = static_cast<Identifier const&>(*lhs);
+                    // OPTIMIZATION: If LHS is a local and RHS was just computed into a temporary, write the result directly into the local.
+                    if (identifier.is_local()) {
+                        auto local = generator.local(identifier.local_variable_index());
+                        if (generator.fuse_operation_into_local(rval, local))
+                            rval = local;
+                    }
                     generator.emit_set_variable(identifier, rval);
                 } else if (is<MemberExpression>(*lhs)) {
                     auto& expression = static_cast<MemberExpression const&>(*lhs);
@@ -7,7 +7,11 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/RegexTable.h>
+#include <LibJS/Heap/HeapBlock.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/SourceCode.h>
 
 namespace JS::Bytecode {
@@ -40,6 +44,17 @@ Executable::Executable(
 
 Executable::~Executable() = default;
 
+JIT::NativeExecutable const* Executable::get_or_create_native_executable()
+{
+    if (!m_did_try_jit_compilation) {
+        if (++m_run_count < g_jit_compilation_threshold)
+            return nullptr;
+        m_did_try_jit_compilation = true;
+        m_native_executable = JIT::Compiler::compile(*this);
+    }
+    return m_native_executable.ptr();
+}
+
 void Executable::dump() const
 {
     warnln("\033[37;1mJS bytecode executable\033[0m \"{}\"", name);
@@ -83,6 +98,36 @@ void Executable::dump() const
     warnln("");
 }
 
+void Executable::dump_property_lookup_cache_statistics() const
+{
+    u64 total_hits = 0;
+    u64 total_misses = 0;
+    for (auto const& cache : property_lookup_caches) {
+        total_hits += cache.hits;
+        total_misses += cache.misses;
+    }
+    if (total_hits == 0 && total_misses == 0)
+        return;
+
+    warnln("Property lookup caches for {} ({} hits, {} misses):", name, total_hits, total_misses);
+    for (size_t i = 0; i < property_lookup_caches.size(); ++i) {
+        auto const& cache = property_lookup_caches[i];
+        if (cache.hits == 0 && cache.misses == 0)
+            continue;
+        warnln("    #{:<4} hits: {:>8} misses: {:>8} shapes: {}", i, cache.hits, cache.misses, cache.number_of_remembered_shapes());
+    }
+}
+
+void Executable::dump_all_property_lookup_cache_statistics()
+{
+    cell_allocator.allocator->for_each_block([](HeapBlock& block) {
+        block.for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+            static_cast<Executable const*>(cell)->dump_property_lookup_cache_statistics();
+        });
+        return IterationDecision::Continue;
+    });
+}
+
 void Executable::visit_edges(Visitor& visitor)
 {
     Base::visit_edges(visitor);
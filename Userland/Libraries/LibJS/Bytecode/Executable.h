@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
@@ -22,14 +23,55 @@
 
 namespace JS::Bytecode {
 
+// A small polymorphic inline cache, so that sites which see a handful of different shapes don't miss constantly.
 struct PropertyLookupCache {
-    WeakPtr<Shape> shape;
-    Optional<u32> property_offset;
-    WeakPtr<Object> prototype;
-    WeakPtr<PrototypeChainValidity> prototype_chain_validity;
+    static constexpr size_t max_number_of_shapes_to_remember = 4;
+
+    struct Entry {
+        WeakPtr<Shape> shape;
+        Optional<u32> property_offset;
+
+        // If set, the property (or accessor) lives in this object on the prototype chain instead of the object itself.
+        WeakPtr<Object> prototype;
+        WeakPtr<PrototypeChainValidity> prototype_chain_validity;
+    };
+
+    // Returns the entry to fill in for the given shape: its existing entry, an unused one, or the oldest one.
+    Entry& entry_for_new_shape(Shape const& shape)
+    {
+        for (auto& entry : entries) {
+            if (entry.shape == &shape)
+                return entry;
+        }
+        for (auto& entry : entries) {
+            if (!entry.shape)
+                return entry;
+        }
+        auto& entry = entries[next_entry_to_replace];
+        next_entry_to_replace = (next_entry_to_replace + 1) % max_number_of_shapes_to_remember;
+        return entry;
+    }
+
+    size_t number_of_remembered_shapes() const
+    {
+        size_t count = 0;
+        for (auto const& entry : entries) {
+            if (entry.shape)
+                ++count;
+        }
+        return count;
+    }
+
+    AK::Array<Entry, max_number_of_shapes_to_remember> entries;
+    u8 next_entry_to_replace { 0 };
+
+    u32 hits { 0 };
+    u32 misses { 0 };
 };
 
-struct GlobalVariableCache : public PropertyLookupCache {
+struct GlobalVariableCache {
+    WeakPtr<Shape> shape;
+    Optional<u32> property_offset;
     u64 environment_serial_number { 0 };
     Optional<u32> environment_binding_index;
 };
@@ -103,9 +145,21 @@ public:
     [[nodiscard]] UnrealizedSourceRange source_range_at(size_t offset) const;
 
     void dump() const;
+    void dump_property_lookup_cache_statistics() const;
+
+    // Prints the statistics of every executable that is currently alive, e.g. to see which sites are polymorphic.
+    static void dump_all_property_lookup_cache_statistics();
+
+    // Returns the JIT-compiled version of this executable once it has run often enough to be worth compiling,
+    // or nullptr if it isn't hot yet or can't be compiled.
+    JIT::NativeExecutable const* get_or_create_native_executable();
 
 private:
     virtual void visit_edges(Visitor&) override;
+
+    OwnPtr<JIT::NativeExecutable> m_native_executable;
+    u32 m_run_count { 0 };
+    bool m_did_try_jit_compilation { false };
 };
 
 }
@@ -1198,6 +1198,53 @@ ScopedOperand Generator::copy_if_needed_to_preserve_evaluation_order(ScopedOpera
     return new_register;
 }
 
+bool Generator::fuse_operation_into_local(ScopedOperand const& value, ScopedOperand const& local)
+{
+    VERIFY(local.operand().is_local());
+
+    // NOTE: It's only safe to retarget the operation if its result is a temporary with no other dependents.
+    if (!value.operand().is_register()
+        || value.ref_count() != 1
+        || m_current_basic_block->size() == 0
+        || m_current_basic_block->is_terminated())
+        return false;
+
+    auto& last_instruction = *reinterpret_cast<Instruction const*>(m_current_basic_block->data() + m_current_basic_block->last_instruction_start_offset());
+
+    // NOTE: All of these read their operands before writing the result, so the local may also be one of the inputs.
+#define HANDLE_BINARY_OP(OpTitleCase, op_snake_case)                               \
+    if (last_instruction.type() == Instruction::Type::OpTitleCase) {               \
+        auto& operation = static_cast<Op::OpTitleCase const&>(last_instruction);   \
+        if (operation.dst() != value.operand())                                    \
+            return false;                                                          \
+        auto lhs = operation.lhs();                                                \
+        auto rhs = operation.rhs();                                                \
+        m_current_basic_block->rewind();                                           \
+        emit<Op::OpTitleCase>(local, lhs, rhs);                                    \
+        return true;                                                               \
+    }
+
+    JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(HANDLE_BINARY_OP)
+    JS_ENUMERATE_COMMON_BINARY_OPS_WITHOUT_FAST_PATH(HANDLE_BINARY_OP)
+#undef HANDLE_BINARY_OP
+
+#define HANDLE_UNARY_OP(OpTitleCase, op_snake_case)                              \
+    if (last_instruction.type() == Instruction::Type::OpTitleCase) {             \
+        auto& operation = static_cast<Op::OpTitleCase const&>(last_instruction); \
+        if (operation.dst() != value.operand())                                  \
+            return false;                                                        \
+        auto src = operation.src();                                              \
+        m_current_basic_block->rewind();                                         \
+        emit<Op::OpTitleCase>(local, src);                                       \
+        return true;                                                             \
+    }
+
+    JS_ENUMERATE_COMMON_UNARY_OPS(HANDLE_UNARY_OP)
+#undef HANDLE_UNARY_OP
+
+    return false;
+}
+
 ScopedOperand Generator::add_constant(Value value)
 {
     auto append_new_constant = [&] {
@@ -310,6 +310,11 @@ public:
 
     [[nodiscard]] ScopedOperand copy_if_needed_to_preserve_evaluation_order(ScopedOperand const&);
 
+    // If `value` is a temporary that was just produced by a binary or unary operation,
+    // rewrites that operation to write its result straight into `local` instead.
+    // Returns true if the operation was rewritten.
+    [[nodiscard]] bool fuse_operation_into_local(ScopedOperand const& value, ScopedOperand const& local);
+
     [[nodiscard]] ScopedOperand get_this(Optional<ScopedOperand> preferred_dst = {});
 
     void emit_get_by_id(ScopedOperand dst, ScopedOperand base, IdentifierTableIndex property_identifier, Optional<IdentifierTableIndex> base_identifier = {});
@@ -14,6 +14,7 @@
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/Array.h>
@@ -39,6 +40,8 @@
 namespace JS::Bytecode {
 
 bool g_dump_bytecode = false;
+bool g_jit_enabled = false;
+u32 g_jit_compilation_threshold = 16;
 
 static ByteString format_operand(StringView name, Operand operand, Bytecode::Executable const& executable)
 {
@@ -695,6 +698,19 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
     }
 }
 
+void Interpreter::run_native_executable(JIT::NativeExecutable const& native_executable)
+{
+    if (vm().did_reach_stack_space_limit()) {
+        reg(Register::exception()) = vm().throw_completion<InternalError>(ErrorType::CallStackSizeExceeded).release_value().value();
+        return;
+    }
+
+    size_t program_counter = 0;
+    TemporaryChange change(m_program_counter, Optional<size_t&>(program_counter));
+
+    native_executable.run(*this, m_registers_and_constants_and_locals.data(), running_execution_context().arguments.data(), program_counter);
+}
+
 Interpreter::ResultAndReturnRegister Interpreter::run_executable(Executable& executable, Optional<size_t> entry_point, Value initial_accumulator_value)
 {
     dbgln_if(JS_BYTECODE_DEBUG, "Bytecode::Interpreter will run unit {:p}", &executable);
@@ -732,7 +748,16 @@ Interpreter::ResultAndReturnRegister Interpreter::run_executable(Executable& exe
         running_execution_context.registers_and_constants_and_locals[executable.number_of_registers + i] = executable.constants[i];
     }
 
-    run_bytecode(entry_point.value_or(0));
+    // NOTE: Native code can only start at the beginning of an executable, so resuming e.g. a generator always
+    //       goes through the bytecode interpreter.
+    JIT::NativeExecutable const* native_executable = nullptr;
+    if (g_jit_enabled && !entry_point.has_value())
+        native_executable = executable.get_or_create_native_executable();
+
+    if (native_executable)
+        run_native_executable(*native_executable);
+    else
+        run_bytecode(entry_point.value_or(0));
 
     dbgln_if(JS_BYTECODE_DEBUG, "Bytecode::Interpreter did run unit {:p}", &executable);
 
@@ -981,44 +1006,43 @@ inline ThrowCompletionOr<Value> get_by_id(VM& vm, Optional<IdentifierTableIndex>
 
     auto& shape = base_obj->shape();
 
-    if (cache.prototype) {
-        // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
-        bool can_use_cache = [&]() -> bool {
-            if (&shape != cache.shape)
-                return false;
-            if (!cache.prototype_chain_validity)
-                return false;
-            if (!cache.prototype_chain_validity->is_valid())
-                return false;
-            return true;
-        }();
-        if (can_use_cache) {
-            auto value = cache.prototype->get_direct(cache.property_offset.value());
-            if (value.is_accessor())
-                return TRY(call(vm, value.as_accessor().getter(), this_value));
-            return value;
+    for (auto& entry : cache.entries) {
+        if (&shape != entry.shape)
+            continue;
+
+        Object* holder = base_obj;
+        if (entry.prototype) {
+            // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
+            if (!entry.prototype_chain_validity || !entry.prototype_chain_validity->is_valid())
+                break;
+            holder = entry.prototype.ptr();
         }
-    } else if (&shape == cache.shape) {
+
         // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
-        auto value = base_obj->get_direct(cache.property_offset.value());
+        ++cache.hits;
+        auto value = holder->get_direct(entry.property_offset.value());
         if (value.is_accessor())
             return TRY(call(vm, value.as_accessor().getter(), this_value));
         return value;
     }
 
+    ++cache.misses;
+
     CacheablePropertyMetadata cacheable_metadata;
     auto value = TRY(base_obj->internal_get(executable.get_identifier(property), this_value, &cacheable_metadata));
 
     if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-        cache = {};
-        cache.shape = shape;
-        cache.property_offset = cacheable_metadata.property_offset.value();
+        auto& entry = cache.entry_for_new_shape(shape);
+        entry = {};
+        entry.shape = shape;
+        entry.property_offset = cacheable_metadata.property_offset.value();
     } else if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
-        cache = {};
-        cache.shape = &base_obj->shape();
-        cache.property_offset = cacheable_metadata.property_offset.value();
-        cache.prototype = *cacheable_metadata.prototype;
-        cache.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
+        auto& entry = cache.entry_for_new_shape(base_obj->shape());
+        entry = {};
+        entry.shape = &base_obj->shape();
+        entry.property_offset = cacheable_metadata.property_offset.value();
+        entry.prototype = *cacheable_metadata.prototype;
+        entry.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
     }
 
     return value;
@@ -1156,6 +1180,45 @@ inline ThrowCompletionOr<Value> get_global(Interpreter& interpreter, IdentifierT
     return vm.throw_completion<ReferenceError>(ErrorType::UnknownIdentifier, identifier);
 }
 
+// Returns false if none of the cached shapes matched and the caller has to take the slow path.
+inline ThrowCompletionOr<bool> put_by_id_cached(VM& vm, Object& object, Value this_value, Value value, PropertyLookupCache& cache)
+{
+    auto& shape = object.shape();
+
+    for (auto& entry : cache.entries) {
+        if (&shape != entry.shape)
+            continue;
+
+        Object* holder = &object;
+        if (entry.prototype) {
+            if (!entry.prototype_chain_validity || !entry.prototype_chain_validity->is_valid())
+                break;
+            holder = entry.prototype.ptr();
+        }
+
+        auto current_value = holder->get_direct(entry.property_offset.value());
+        if (current_value.is_accessor()) {
+            auto* setter = current_value.as_accessor().setter();
+            if (!setter)
+                break;
+            ++cache.hits;
+            (void)TRY(call(vm, *setter, this_value, value));
+            return true;
+        }
+
+        // A data property further up the prototype chain would be shadowed by a new own property, which changes the shape.
+        if (holder != &object)
+            break;
+
+        ++cache.hits;
+        object.put_direct(entry.property_offset.value(), value);
+        return true;
+    }
+
+    ++cache.misses;
+    return false;
+}
+
 inline ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value this_value, Value value, Optional<DeprecatedFlyString const&> const& base_identifier, PropertyKey name, Op::PropertyKind kind, PropertyLookupCache* cache = nullptr)
 {
     // Better error message than to_object would give
@@ -1188,17 +1251,26 @@ inline ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value thi
         break;
     }
     case Op::PropertyKind::KeyValue: {
-        if (cache && cache->shape == &object->shape()) {
-            object->put_direct(*cache->property_offset, value);
+        if (cache && TRY(put_by_id_cached(vm, *object, this_value, value, *cache)))
             return {};
-        }
 
         CacheablePropertyMetadata cacheable_metadata;
         bool succeeded = TRY(object->internal_set(name, value, this_value, &cacheable_metadata));
 
-        if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-            cache->shape = object->shape();
-            cache->property_offset = cacheable_metadata.property_offset.value();
+        if (succeeded && cache && object->shape().is_cacheable()) {
+            if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
+                auto& entry = cache->entry_for_new_shape(object->shape());
+                entry = {};
+                entry.shape = object->shape();
+                entry.property_offset = cacheable_metadata.property_offset.value();
+            } else if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
+                auto& entry = cache->entry_for_new_shape(object->shape());
+                entry = {};
+                entry.shape = object->shape();
+                entry.property_offset = cacheable_metadata.property_offset.value();
+                entry.prototype = *cacheable_metadata.prototype;
+                entry.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
+            }
         }
 
         if (!succeeded && vm.in_strict_mode()) {
@@ -1301,6 +1373,7 @@ inline ThrowCompletionOr<void> put_by_value(VM& vm, Value base, Optional<Depreca
                 auto existing_value = maybe_value->value;
                 if (!existing_value.is_accessor()) {
                     storage->put(index, value);
+                    write_barrier(object, value);
                     return {};
                 }
             }
@@ -1619,11 +1692,13 @@ inline ThrowCompletionOr<void> append(VM& vm, Value lhs, Value rhs, bool is_spre
         size_t i = lhs_size;
         TRY(get_iterator_values(vm, rhs, [&i, &lhs_array](Value iterator_value) -> Optional<Completion> {
             lhs_array.indexed_properties().put(i, iterator_value, default_attributes);
+            write_barrier(lhs_array, iterator_value);
             ++i;
             return {};
         }));
     } else {
         lhs_array.indexed_properties().put(lhs_size, rhs, default_attributes);
+        write_barrier(lhs_array, rhs);
     }
 
     return {};
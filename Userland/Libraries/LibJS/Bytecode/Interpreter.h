@@ -82,6 +82,7 @@ public:
 
 private:
     void run_bytecode(size_t entry_point);
+    void run_native_executable(JIT::NativeExecutable const&);
 
     enum class HandleExceptionResponse {
         ExitFromExecutable,
@@ -102,6 +103,10 @@ private:
 };
 
 extern bool g_dump_bytecode;
+extern bool g_jit_enabled;
+
+// How many times an executable has to run before the JIT compiles it.
+extern u32 g_jit_compilation_threshold;
 
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM&, ASTNode const&, JS::FunctionKind kind, DeprecatedFlyString const& name);
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM&, ECMAScriptFunctionObject const&);
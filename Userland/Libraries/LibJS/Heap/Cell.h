@@ -55,6 +55,11 @@ public:
     State state() const { return m_state; }
     void set_state(State state) { m_state = state; }
 
+    // Cells start out young and are promoted to the old generation when they survive a collection.
+    // NOTE: Cells are only ever promoted while the heap does generational collection.
+    bool is_old() const { return m_old; }
+    void set_old(Badge<Heap>, bool b) { m_old = b; }
+
     virtual StringView class_name() const = 0;
 
     class Visitor {
@@ -168,6 +173,11 @@ public:
 
     bool overrides_must_survive_garbage_collection(Badge<Heap>) const { return m_overrides_must_survive_garbage_collection; }
 
+    // Cells that return true here promise to call write_barrier() whenever they store a reference to
+    // another cell after construction. That lets young collections skip them unless they were written to.
+    // Everything else is conservatively treated as possibly pointing into the young generation.
+    virtual bool uses_write_barriers() const { return false; }
+
     ALWAYS_INLINE Heap& heap() const { return HeapBlockBase::from_cell(this)->heap(); }
     ALWAYS_INLINE VM& vm() const { return bit_cast<HeapBase*>(&heap())->vm(); }
 
@@ -180,6 +190,7 @@ private:
     bool m_mark : 1 { false };
     bool m_overrides_must_survive_garbage_collection : 1 { false };
     State m_state : 1 { State::Live };
+    bool m_old : 1 { false };
 };
 
 }
@@ -19,6 +19,7 @@
 #include <LibJS/Heap/Handle.h>
 #include <LibJS/Heap/Heap.h>
 #include <LibJS/Heap/HeapBlock.h>
+#include <LibJS/Heap/WriteBarrier.h>
 #include <LibJS/Runtime/Object.h>
 #include <LibJS/Runtime/WeakContainer.h>
 #include <LibJS/SafeFunction.h>
@@ -71,15 +72,95 @@ void Heap::will_allocate(size_t size)
 {
     if (should_collect_on_every_allocation()) {
         m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+        collect_garbage(automatic_collection_type());
     } else if (m_allocated_bytes_since_last_gc + size > m_gc_bytes_threshold) {
         m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+        // NOTE: If marking hasn't caught up with the mutator by now, we finish the collection right away.
+        auto collection_type = automatic_collection_type();
+        if (m_uses_incremental_marking && collection_type == CollectionType::CollectGarbage && !is_incremental_marking_in_progress())
+            start_incremental_marking();
+        else
+            collect_garbage(collection_type);
+    } else if (is_incremental_marking_in_progress()) {
+        m_allocated_bytes_since_last_marking_slice += size;
+        if (m_allocated_bytes_since_last_marking_slice > INCREMENTAL_MARKING_SLICE_BYTES) {
+            m_allocated_bytes_since_last_marking_slice = 0;
+            perform_incremental_marking_slice();
+        }
     }
 
     m_allocated_bytes_since_last_gc += size;
 }
 
+Heap::CollectionType Heap::automatic_collection_type() const
+{
+    if (!m_uses_generational_collection)
+        return CollectionType::CollectGarbage;
+    // Young collections never free old cells, so fall back to a full collection once enough cells have been promoted.
+    if (m_old_generation_bytes > m_old_generation_bytes_threshold)
+        return CollectionType::CollectGarbage;
+    return CollectionType::CollectYoungGeneration;
+}
+
+void Heap::set_uses_generational_collection(bool uses_generational_collection)
+{
+    VERIFY(!m_collecting_garbage);
+    if (m_uses_generational_collection == uses_generational_collection)
+        return;
+    m_uses_generational_collection = uses_generational_collection;
+    if (uses_generational_collection)
+        return;
+
+    // Without generational collection, nothing calls write barriers on our behalf anymore, so every cell has to be young again.
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+            cell->set_old({}, false);
+        });
+        block.set_has_young_cells({}, true);
+        return IterationDecision::Continue;
+    });
+    m_remembered_cells.clear();
+    m_old_generation_cells = 0;
+    m_old_generation_bytes = 0;
+}
+
+void Heap::remember_cell(Cell& cell)
+{
+    m_remembered_cells.set(&cell);
+}
+
+void remember_written_cell(Cell& owner)
+{
+    owner.heap().remember_cell(owner);
+}
+
+void Heap::PauseTimeHistogram::record(Duration pause_time)
+{
+    auto milliseconds = pause_time.to_milliseconds();
+    size_t bucket = 0;
+    while (bucket < bucket_count - 1 && milliseconds >= (1ll << bucket))
+        ++bucket;
+    ++m_buckets[bucket];
+    ++m_count;
+    m_total_time += pause_time;
+    m_longest_time = max(m_longest_time, pause_time);
+}
+
+void Heap::PauseTimeHistogram::dump(StringView name) const
+{
+    if (m_count == 0)
+        return;
+    dbgln("{} pauses: {} (total {} ms, longest {} ms)", name, m_count, m_total_time.to_milliseconds(), m_longest_time.to_milliseconds());
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        if (!m_buckets[bucket])
+            continue;
+        if (bucket == bucket_count - 1)
+            dbgln("    >= {} ms: {}", 1ll << (bucket - 1), m_buckets[bucket]);
+        else
+            dbgln("    < {} ms: {}", 1ll << bucket, m_buckets[bucket]);
+    }
+}
+
 static void add_possible_value(HashMap<FlatPtr, HeapRoot>& possible_pointers, FlatPtr data, HeapRoot origin, FlatPtr min_block_address, FlatPtr max_block_address)
 {
     if constexpr (sizeof(FlatPtr*) == sizeof(Value)) {
@@ -271,20 +352,34 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
 #endif
 
     Core::ElapsedTimer collection_measurement_timer;
-    if (print_report)
-        collection_measurement_timer.start();
+    collection_measurement_timer.start();
+
+    if (collection_type == CollectionType::CollectYoungGeneration && !m_uses_generational_collection)
+        collection_type = CollectionType::CollectGarbage;
+
+    if (is_incremental_marking_in_progress()) {
+        // A young collection can't be squeezed in while the whole heap is being marked, so we finish that collection instead.
+        if (collection_type == CollectionType::CollectEverything)
+            abandon_incremental_marking();
+        else
+            collection_type = CollectionType::CollectGarbage;
+    }
 
-    if (collection_type == CollectionType::CollectGarbage) {
+    if (collection_type != CollectionType::CollectEverything) {
         if (m_gc_deferrals) {
             m_should_gc_when_deferral_ends = true;
             return;
         }
         HashMap<Cell*, HeapRoot> roots;
         gather_roots(roots);
-        mark_live_cells(roots);
+        if (is_incremental_marking_in_progress())
+            finish_incremental_marking(roots);
+        else
+            mark_live_cells(roots, collection_type);
     }
-    finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    finalize_unmarked_cells(collection_type);
+    sweep_dead_cells(collection_type, print_report, collection_measurement_timer);
+    m_remembered_cells.clear();
 }
 
 void Heap::gather_roots(HashMap<Cell*, HeapRoot>& roots)
@@ -390,24 +485,39 @@ NO_SANITIZE_ADDRESS void Heap::gather_conservative_roots(HashMap<Cell*, HeapRoot
 
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
+    MarkingVisitor(Heap& heap, Heap::CollectionType collection_type)
         : m_heap(heap)
+        , m_only_young_cells(collection_type == Heap::CollectionType::CollectYoungGeneration)
     {
+        // NOTE: Blocks created while marking is incremental only contain cells that were marked on allocation,
+        //       so it's fine for possible values pointing into them to be ignored.
         m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
         m_heap.for_each_block([&](auto& block) {
             m_all_live_heap_blocks.set(&block);
             return IterationDecision::Continue;
         });
+    }
 
+    void mark_roots(HashMap<Cell*, HeapRoot> const& roots)
+    {
         for (auto* root : roots.keys()) {
             visit(root);
         }
     }
 
+    void mark_allocated_cell(Cell& cell)
+    {
+        visit_impl(cell);
+    }
+
     virtual void visit_impl(Cell& cell) override
     {
         if (cell.is_marked())
             return;
+        // NOTE: A young collection doesn't trace through old cells. The young cells they point at are found
+        //       by Heap::mark_live_cells() instead.
+        if (m_only_young_cells && cell.is_old())
+            return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
         cell.set_marked(true);
@@ -427,6 +537,8 @@ public:
                 return;
             if (cell->state() != Cell::State::Live)
                 return;
+            if (m_only_young_cells && cell->is_old())
+                return;
             cell->set_marked(true);
             m_work_queue.append(*cell);
         });
@@ -434,33 +546,171 @@ public:
 
     void mark_all_live_cells()
     {
+        m_work_queue.extend(move(m_cells_to_visit_when_finishing));
         while (!m_work_queue.is_empty()) {
             m_work_queue.take_last()->visit_edges(*this);
         }
     }
 
+    // Returns true once there is nothing left to mark.
+    bool mark_live_cells_for(Duration budget)
+    {
+        static constexpr size_t cells_between_deadline_checks = 256;
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        while (!m_work_queue.is_empty()) {
+            for (size_t i = 0; i < cells_between_deadline_checks && !m_work_queue.is_empty(); ++i) {
+                auto cell = m_work_queue.take_last();
+                // Cells without write barriers can change their edges without telling us, so their edges are only
+                // visited once marking finishes. That way they are visited once, instead of now and again then.
+                if (cell->uses_write_barriers())
+                    cell->visit_edges(*this);
+                else
+                    m_cells_to_visit_when_finishing.append(cell);
+            }
+            if (timer.elapsed_time() >= budget)
+                break;
+        }
+        return m_work_queue.is_empty();
+    }
+
 private:
     Heap& m_heap;
+    bool m_only_young_cells { false };
     Vector<NonnullGCPtr<Cell>> m_work_queue;
+    Vector<NonnullGCPtr<Cell>> m_cells_to_visit_when_finishing;
     HashTable<HeapBlock*> m_all_live_heap_blocks;
     FlatPtr m_min_block_address;
     FlatPtr m_max_block_address;
 };
 
-void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots)
+void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots, CollectionType collection_type)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
 
-    MarkingVisitor visitor(*this, roots);
+    MarkingVisitor visitor(*this, collection_type);
+    visitor.mark_roots(roots);
+
+    if (collection_type == CollectionType::CollectYoungGeneration) {
+        // Old cells are considered live, but anything young they point at must be kept alive as well.
+        // Cells with write barriers only need to be looked at if they were written to since the last collection.
+        // We don't know what the other ones have been up to, so all of them need to be looked at.
+        for_each_block([&](auto& block) {
+            block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+                if (cell->is_old() && !cell->uses_write_barriers())
+                    cell->visit_edges(visitor);
+            });
+            return IterationDecision::Continue;
+        });
+        for (auto* cell : m_remembered_cells)
+            cell->visit_edges(visitor);
+    }
 
     visitor.mark_all_live_cells();
 
+    unmark_uprooted_cells();
+}
+
+void Heap::unmark_uprooted_cells()
+{
     for (auto& inverse_root : m_uprooted_cells)
         inverse_root->set_marked(false);
 
     m_uprooted_cells.clear();
 }
 
+void Heap::set_uses_incremental_marking(bool uses_incremental_marking)
+{
+    m_uses_incremental_marking = uses_incremental_marking;
+    if (!uses_incremental_marking && is_incremental_marking_in_progress())
+        collect_garbage();
+}
+
+void Heap::start_incremental_marking()
+{
+    VERIFY(!m_collecting_garbage);
+    VERIFY(!is_incremental_marking_in_progress());
+
+    if (m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    TemporaryChange change(m_collecting_garbage, true);
+    auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+
+    dbgln_if(HEAP_DEBUG, "start_incremental_marking:");
+
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    m_incremental_marking_visitor = make<MarkingVisitor>(*this, CollectionType::CollectGarbage);
+    m_incremental_marking_visitor->mark_roots(roots);
+    m_allocated_bytes_since_last_marking_slice = 0;
+
+    m_incremental_marking_pause_times.record(timer.elapsed_time());
+}
+
+void Heap::perform_incremental_marking_slice()
+{
+    VERIFY(!m_collecting_garbage);
+    VERIFY(is_incremental_marking_in_progress());
+
+    // NOTE: Cells that are still being constructed must not have their edges visited.
+    if (m_gc_deferrals)
+        return;
+
+    bool done_marking = false;
+    {
+        TemporaryChange change(m_collecting_garbage, true);
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        done_marking = m_incremental_marking_visitor->mark_live_cells_for(m_incremental_marking_slice_budget);
+        m_incremental_marking_pause_times.record(timer.elapsed_time());
+    }
+
+    if (done_marking)
+        collect_garbage();
+}
+
+void Heap::did_allocate_cell_during_incremental_marking(Cell& cell)
+{
+    // Cells allocated while marking is incremental are considered live, but their edges still have to be visited.
+    m_incremental_marking_visitor->mark_allocated_cell(cell);
+}
+
+void Heap::finish_incremental_marking(HashMap<Cell*, HeapRoot> const& roots)
+{
+    dbgln_if(HEAP_DEBUG, "finish_incremental_marking:");
+
+    auto visitor = m_incremental_marking_visitor.release_nonnull();
+    visitor->mark_roots(roots);
+
+    // The mutator may have stored unmarked cells in cells that have already been visited since we started.
+    // Cells with write barriers have told us about that through the remembered set. The others haven't been
+    // visited yet, and are visited by mark_all_live_cells() below.
+    for (auto* cell : m_remembered_cells)
+        cell->visit_edges(*visitor);
+
+    visitor->mark_all_live_cells();
+
+    unmark_uprooted_cells();
+}
+
+void Heap::abandon_incremental_marking()
+{
+    m_incremental_marking_visitor = nullptr;
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+            cell->set_marked(false);
+        });
+        return IterationDecision::Continue;
+    });
+}
+
+Duration Heap::longest_garbage_collection_pause() const
+{
+    return max(max(m_young_collection_pause_times.longest_time(), m_full_collection_pause_times.longest_time()),
+        m_incremental_marking_pause_times.longest_time());
+}
+
 bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
 {
     if (!cell.overrides_must_survive_garbage_collection({}))
@@ -468,10 +718,15 @@ bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
     return cell.must_survive_garbage_collection();
 }
 
-void Heap::finalize_unmarked_cells()
+void Heap::finalize_unmarked_cells(CollectionType collection_type)
 {
+    bool only_young_cells = collection_type == CollectionType::CollectYoungGeneration;
     for_each_block([&](auto& block) {
-        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+        if (only_young_cells && !block.has_young_cells())
+            return IterationDecision::Continue;
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (only_young_cells && cell->is_old())
+                return;
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
                 cell->finalize();
         });
@@ -479,7 +734,7 @@ void Heap::finalize_unmarked_cells()
     });
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::sweep_dead_cells(CollectionType collection_type, bool print_report, Core::ElapsedTimer const& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
@@ -487,13 +742,25 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
     size_t collected_cells = 0;
     size_t live_cells = 0;
+    size_t promoted_cells = 0;
     size_t collected_cell_bytes = 0;
     size_t live_cell_bytes = 0;
+    size_t promoted_cell_bytes = 0;
+
+    bool only_young_cells = collection_type == CollectionType::CollectYoungGeneration;
 
     for_each_block([&](auto& block) {
+        // Blocks that only hold old cells have nothing for a young collection to sweep.
+        if (only_young_cells && !block.has_young_cells())
+            return IterationDecision::Continue;
         bool block_has_live_cells = false;
         bool block_was_full = block.is_full();
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            // Old cells are added to the live totals from the old generation's totals below.
+            if (only_young_cells && cell->is_old()) {
+                block_has_live_cells = true;
+                return;
+            }
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
                 dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
                 block.deallocate(cell);
@@ -501,11 +768,19 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
                 collected_cell_bytes += block.cell_size();
             } else {
                 cell->set_marked(false);
+                if (m_uses_generational_collection && !cell->is_old()) {
+                    cell->set_old({}, true);
+                    ++promoted_cells;
+                    promoted_cell_bytes += block.cell_size();
+                }
                 block_has_live_cells = true;
                 ++live_cells;
                 live_cell_bytes += block.cell_size();
             }
         });
+        // Every cell that survived has been promoted, so the block has to be swept again only once it gets new ones.
+        if (m_uses_generational_collection)
+            block.set_has_young_cells({}, false);
         if (!block_has_live_cells)
             empty_blocks.append(&block);
         else if (block_was_full != block.is_full())
@@ -533,10 +808,29 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         });
     }
 
+    if (m_uses_generational_collection) {
+        if (only_young_cells) {
+            // Old cells only die in full collections, so these are still accurate for the blocks we skipped.
+            live_cells += m_old_generation_cells;
+            live_cell_bytes += m_old_generation_bytes;
+            m_old_generation_cells += promoted_cells;
+            m_old_generation_bytes += promoted_cell_bytes;
+        } else {
+            m_old_generation_cells = live_cells;
+            m_old_generation_bytes = live_cell_bytes;
+            m_old_generation_bytes_threshold = max(live_cell_bytes * 2, GC_MIN_BYTES_THRESHOLD);
+        }
+    }
+
     m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
 
+    Duration const time_spent = measurement_timer.elapsed_time();
+    if (only_young_cells)
+        m_young_collection_pause_times.record(time_spent);
+    else
+        m_full_collection_pause_times.record(time_spent);
+
     if (print_report) {
-        Duration const time_spent = measurement_timer.elapsed_time();
         size_t live_block_count = 0;
         for_each_block([&](auto&) {
             ++live_block_count;
@@ -545,12 +839,19 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
         dbgln("Garbage collection report");
         dbgln("=============================================");
+        dbgln("     Collection: {}", only_young_cells ? "young generation"sv : "full"sv);
         dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
         dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
         dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
+        if (m_uses_generational_collection)
+            dbgln(" Promoted cells: {} ({} bytes)", promoted_cells, promoted_cell_bytes);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
         dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
         dbgln("=============================================");
+        m_young_collection_pause_times.dump("Young collection"sv);
+        m_full_collection_pause_times.dump("Full collection"sv);
+        m_incremental_marking_pause_times.dump("Incremental marking"sv);
+        dbgln("=============================================");
     }
 }
 
@@ -566,7 +867,7 @@ void Heap::undefer_gc()
 
     if (!m_gc_deferrals) {
         if (m_should_gc_when_deferral_ends)
-            collect_garbage();
+            collect_garbage(automatic_collection_type());
         m_should_gc_when_deferral_ends = false;
     }
 }
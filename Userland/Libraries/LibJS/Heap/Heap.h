@@ -6,12 +6,15 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Badge.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/OwnPtr.h>
 #include <AK/Types.h>
+#include <AK/Time.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
 #include <LibJS/Forward.h>
@@ -28,6 +31,8 @@
 
 namespace JS {
 
+class MarkingVisitor;
+
 class Heap : public HeapBase {
     AK_MAKE_NONCOPYABLE(Heap);
     AK_MAKE_NONMOVABLE(Heap);
@@ -43,6 +48,8 @@ public:
         defer_gc();
         new (memory) T(forward<Args>(args)...);
         undefer_gc();
+        if (is_incremental_marking_in_progress()) [[unlikely]]
+            did_allocate_cell_during_incremental_marking(*memory);
         return *static_cast<T*>(memory);
     }
 
@@ -53,6 +60,8 @@ public:
         defer_gc();
         new (memory) T(forward<Args>(args)...);
         undefer_gc();
+        if (is_incremental_marking_in_progress()) [[unlikely]]
+            did_allocate_cell_during_incremental_marking(*memory);
         auto* cell = static_cast<T*>(memory);
         memory->initialize(realm);
         return *cell;
@@ -60,6 +69,7 @@ public:
 
     enum class CollectionType {
         CollectGarbage,
+        CollectYoungGeneration,
         CollectEverything,
     };
 
@@ -69,6 +79,28 @@ public:
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
+    // With generational collection, cells that survive a collection are promoted to the old generation,
+    // and most automatic collections only look for garbage among the cells allocated since the last one.
+    bool uses_generational_collection() const { return m_uses_generational_collection; }
+    void set_uses_generational_collection(bool);
+
+    // Incremental marking splits the marking phase of automatic full collections into slices of at most
+    // incremental_marking_slice_budget(), driven by allocations or by the embedder's event loop.
+    // Only the final remark and the sweep stop the world.
+    bool uses_incremental_marking() const { return m_uses_incremental_marking; }
+    void set_uses_incremental_marking(bool);
+    Duration incremental_marking_slice_budget() const { return m_incremental_marking_slice_budget; }
+    void set_incremental_marking_slice_budget(Duration budget) { m_incremental_marking_slice_budget = budget; }
+
+    bool is_incremental_marking_in_progress() const { return m_incremental_marking_visitor != nullptr; }
+    void start_incremental_marking();
+    void perform_incremental_marking_slice();
+
+    Duration longest_garbage_collection_pause() const;
+
+    // Called by write_barrier() when a cell may have started pointing at a cell the collector hasn't seen.
+    void remember_cell(Cell&);
+
     void did_create_handle(Badge<HandleImpl>, HandleImpl&);
     void did_destroy_handle(Badge<HandleImpl>, HandleImpl&);
 
@@ -111,14 +143,19 @@ private:
     }
 
     void will_allocate(size_t);
+    void did_allocate_cell_during_incremental_marking(Cell&);
+    void abandon_incremental_marking();
+    CollectionType automatic_collection_type() const;
 
     void find_min_and_max_block_addresses(FlatPtr& min_address, FlatPtr& max_address);
     void gather_roots(HashMap<Cell*, HeapRoot>&);
     void gather_conservative_roots(HashMap<Cell*, HeapRoot>&);
     void gather_asan_fake_stack_roots(HashMap<FlatPtr, HeapRoot>&, FlatPtr, FlatPtr min_block_address, FlatPtr max_block_address);
-    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells);
-    void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells, CollectionType);
+    void finish_incremental_marking(HashMap<Cell*, HeapRoot> const& live_cells);
+    void unmark_uprooted_cells();
+    void finalize_unmarked_cells(CollectionType);
+    void sweep_dead_cells(CollectionType, bool print_report, Core::ElapsedTimer const&);
 
     ALWAYS_INLINE CellAllocator& allocator_for_size(size_t cell_size)
     {
@@ -146,6 +183,36 @@ private:
 
     bool m_should_collect_on_every_allocation { false };
 
+    class PauseTimeHistogram {
+    public:
+        void record(Duration);
+        void dump(StringView name) const;
+        Duration longest_time() const { return m_longest_time; }
+
+    private:
+        // Bucket N counts pauses shorter than 2^N ms, the last one counts everything longer.
+        static constexpr size_t bucket_count = 10;
+        AK::Array<size_t, bucket_count> m_buckets {};
+        size_t m_count { 0 };
+        Duration m_total_time;
+        Duration m_longest_time;
+    };
+
+    bool m_uses_generational_collection { false };
+    HashTable<Cell*> m_remembered_cells;
+    size_t m_old_generation_bytes { 0 };
+    size_t m_old_generation_cells { 0 };
+    size_t m_old_generation_bytes_threshold { GC_MIN_BYTES_THRESHOLD };
+    PauseTimeHistogram m_young_collection_pause_times;
+    PauseTimeHistogram m_full_collection_pause_times;
+    PauseTimeHistogram m_incremental_marking_pause_times;
+
+    static constexpr size_t INCREMENTAL_MARKING_SLICE_BYTES { 256 * 1024 };
+    bool m_uses_incremental_marking { false };
+    Duration m_incremental_marking_slice_budget { Duration::from_milliseconds(5) };
+    size_t m_allocated_bytes_since_last_marking_slice { 0 };
+    OwnPtr<MarkingVisitor> m_incremental_marking_visitor;
+
     Vector<NonnullOwnPtr<CellAllocator>> m_size_based_cell_allocators;
     CellAllocator::List m_all_cell_allocators;
 
@@ -44,12 +44,17 @@ public:
 
         if (allocated_cell) {
             ASAN_UNPOISON_MEMORY_REGION(allocated_cell, m_cell_size);
+            m_has_young_cells = true;
         }
         return allocated_cell;
     }
 
     void deallocate(Cell*);
 
+    // Young collections only have to sweep the blocks that cells were allocated in since every cell was last promoted.
+    bool has_young_cells() const { return m_has_young_cells; }
+    void set_has_young_cells(Badge<Heap>, bool has_young_cells) { m_has_young_cells = has_young_cells; }
+
     template<typename Callback>
     void for_each_cell(Callback callback)
     {
@@ -111,6 +116,7 @@ private:
     CellAllocator& m_cell_allocator;
     size_t m_cell_size { 0 };
     size_t m_next_lazy_freelist_index { 0 };
+    bool m_has_young_cells { false };
     GCPtr<FreelistEntry> m_freelist;
     alignas(__BIGGEST_ALIGNMENT__) u8 m_storage[];
 
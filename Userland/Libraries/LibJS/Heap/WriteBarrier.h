@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+#include <LibJS/Heap/Cell.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS {
+
+void remember_written_cell(Cell& owner);
+
+// Must be called by cells that override Cell::uses_write_barriers() after they store a reference to
+// another cell. The owner is put in the remembered set when:
+// - an old cell starts pointing at a young one, so the next young collection treats the owner as a root.
+// - a cell that has already been marked starts pointing at an unmarked one while marking is incremental,
+//   so the final remark looks at the owner again.
+// NOTE: Cells are only old with generational collection, and only stay marked between incremental marking
+//       slices, so this is just a couple of bit checks otherwise.
+ALWAYS_INLINE void write_barrier(Cell& owner, Cell const* target)
+{
+    if (!target)
+        return;
+    bool old_to_young = owner.is_old() && !target->is_old();
+    bool marked_to_unmarked = owner.is_marked() && !target->is_marked();
+    if (old_to_young || marked_to_unmarked) [[unlikely]]
+        remember_written_cell(owner);
+}
+
+ALWAYS_INLINE void write_barrier(Cell& owner, Value value)
+{
+    if (value.is_cell())
+        write_barrier(owner, &value.as_cell());
+}
+
+// Cells befriend this through JS_OBJECT, so it can see visit_edges() even where it isn't public.
+struct WriteBarrierTraits {
+    // Only true if T overrides visit_edges() itself, rather than inheriting it from its base class.
+    template<typename T>
+    static constexpr bool declares_own_edges()
+    {
+        return IsSame<decltype(&T::visit_edges), void (T::*)(Cell::Visitor&)>;
+    }
+};
+
+}
@@ -0,0 +1,608 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BitCast.h>
+#include <AK/Debug.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/Shape.h>
+#include <LibJS/Runtime/ValueInlines.h>
+
+namespace JS::JIT {
+
+#ifdef JIT_ARCH_SUPPORTED
+
+// The functions below are called from the generated code.
+// Unless noted otherwise, they return non-zero if an exception was thrown, which is then in the exception register.
+
+template<typename OpType>
+static u64 cxx_execute(Bytecode::Interpreter& interpreter, Bytecode::Instruction const& instruction)
+{
+    auto const& op = static_cast<OpType const&>(instruction);
+    if constexpr (IsSame<decltype(op.execute_impl(interpreter)), void>) {
+        op.execute_impl(interpreter);
+        return 0;
+    } else {
+        auto result = op.execute_impl(interpreter);
+        if (result.is_error()) [[unlikely]] {
+            interpreter.reg(Bytecode::Register::exception()) = result.error_value();
+            return 1;
+        }
+        return 0;
+    }
+}
+
+static u64 cxx_to_boolean(Value value)
+{
+    return value.to_boolean();
+}
+
+static ThrowCompletionOr<Value> loosely_equals(VM& vm, Value lhs, Value rhs)
+{
+    return Value(TRY(is_loosely_equal(vm, lhs, rhs)));
+}
+
+static ThrowCompletionOr<Value> loosely_inequals(VM& vm, Value lhs, Value rhs)
+{
+    return Value(!TRY(is_loosely_equal(vm, lhs, rhs)));
+}
+
+static ThrowCompletionOr<Value> strict_equals(VM&, Value lhs, Value rhs)
+{
+    return Value(is_strictly_equal(lhs, rhs));
+}
+
+static ThrowCompletionOr<Value> strict_inequals(VM&, Value lhs, Value rhs)
+{
+    return Value(!is_strictly_equal(lhs, rhs));
+}
+
+// Comparison jumps return whether to take the true target, or COMPARISON_THREW.
+static constexpr u64 COMPARISON_THREW = 2;
+
+#    define DEFINE_COMPARISON_JUMP_SLOW_PATH(op_TitleCase, op_snake_case, numeric_operator)  \
+        static u64 cxx_jump_##op_snake_case(Bytecode::Interpreter& interpreter, Value lhs, Value rhs) \
+        {                                                                                      \
+            if (lhs.is_number() && rhs.is_number())                                            \
+                return lhs.as_double() numeric_operator rhs.as_double();                       \
+            auto result = op_snake_case(interpreter.vm(), lhs, rhs);                           \
+            if (result.is_error()) {                                                           \
+                interpreter.reg(Bytecode::Register::exception()) = result.error_value();      \
+                return COMPARISON_THREW;                                                       \
+            }                                                                                  \
+            return result.value().to_boolean();                                                \
+        }
+JS_ENUMERATE_COMPARISON_OPS(DEFINE_COMPARISON_JUMP_SLOW_PATH)
+#    undef DEFINE_COMPARISON_JUMP_SLOW_PATH
+
+static constexpr auto int32_condition_for_less_than = ::JIT::Assembler::Condition::SignedLessThan;
+static constexpr auto int32_condition_for_less_than_equals = ::JIT::Assembler::Condition::SignedLessThanOrEqualTo;
+static constexpr auto int32_condition_for_greater_than = ::JIT::Assembler::Condition::SignedGreaterThan;
+static constexpr auto int32_condition_for_greater_than_equals = ::JIT::Assembler::Condition::SignedGreaterThanOrEqualTo;
+static constexpr auto int32_condition_for_loosely_equals = ::JIT::Assembler::Condition::EqualTo;
+static constexpr auto int32_condition_for_loosely_inequals = ::JIT::Assembler::Condition::NotEqualTo;
+static constexpr auto int32_condition_for_strict_equals = ::JIT::Assembler::Condition::EqualTo;
+static constexpr auto int32_condition_for_strict_inequals = ::JIT::Assembler::Condition::NotEqualTo;
+
+// Returns the empty value if the cache can't serve this get, in which case GetById runs as usual.
+// NOTE: The object layout isn't something the generated code should know about, so the shape check happens here.
+static u64 cxx_get_by_id_cached(Value base, Bytecode::PropertyLookupCache& cache)
+{
+    auto& object = base.as_object();
+    for (auto& entry : cache.entries) {
+        if (&object.shape() != entry.shape)
+            continue;
+
+        Value value;
+        if (entry.prototype) {
+            if (!entry.prototype_chain_validity || !entry.prototype_chain_validity->is_valid())
+                return Value {}.encoded();
+            value = entry.prototype->get_direct(entry.property_offset.value());
+        } else {
+            value = object.get_direct(entry.property_offset.value());
+        }
+
+        // Getters can do anything, so leave them to GetById.
+        if (value.is_accessor())
+            return Value {}.encoded();
+        ++cache.hits;
+        return value.encoded();
+    }
+    return Value {}.encoded();
+}
+
+// Returns whether the cache could serve this put. If it couldn't, PutById runs as usual.
+static u64 cxx_put_by_id_cached(Value base, Value value, Bytecode::PropertyLookupCache& cache)
+{
+    auto& object = base.as_object();
+    for (auto& entry : cache.entries) {
+        if (&object.shape() != entry.shape)
+            continue;
+
+        // Only plain own data properties are handled here, setters are left to PutById.
+        if (entry.prototype || object.get_direct(entry.property_offset.value()).is_accessor())
+            return 0;
+        ++cache.hits;
+        object.put_direct(entry.property_offset.value(), value);
+        return 1;
+    }
+    return 0;
+}
+
+OwnPtr<NativeExecutable> Compiler::compile_executable()
+{
+    // The generated code can only be entered at the start, so there is no way to run an exception handler.
+    if (!m_executable.exception_handlers.is_empty()) {
+        dbgln_if(JIT_DEBUG, "LibJS JIT: Not compiling {} because it has exception handlers", m_executable.name);
+        return nullptr;
+    }
+
+    for (auto offset : m_executable.basic_block_start_offsets)
+        m_block_labels.set(offset, {});
+
+    m_assembler.enter();
+    m_assembler.mov(Assembler::Operand::Register(REGISTER_ARRAY_BASE), Assembler::Operand::Register(ARG0));
+    m_assembler.mov(Assembler::Operand::Register(ARGUMENTS_ARRAY_BASE), Assembler::Operand::Register(ARG1));
+    m_assembler.mov(Assembler::Operand::Register(RUNNING_INTERPRETER), Assembler::Operand::Register(ARG2));
+    m_assembler.mov(Assembler::Operand::Register(PROGRAM_COUNTER_POINTER), Assembler::Operand::Register(ARG3));
+
+    for (Bytecode::InstructionStreamIterator it(m_executable.bytecode, &m_executable); !it.at_end(); ++it) {
+        if (auto label = m_block_labels.find(it.offset()); label != m_block_labels.end())
+            label->value.link(m_assembler);
+
+        if (!compile_instruction(*it, it.offset())) {
+            dbgln_if(JIT_DEBUG, "LibJS JIT: Not compiling {} because of unsupported instruction: {}", m_executable.name, (*it).to_byte_string(m_executable));
+            return nullptr;
+        }
+    }
+
+    m_exit_label.link(m_assembler);
+    m_assembler.exit();
+
+    auto native_executable = NativeExecutable::create(m_output, m_executable.name.view());
+    if (native_executable.is_error()) {
+        dbgln("LibJS JIT: Failed to create native executable for {}: {}", m_executable.name, native_executable.error());
+        return nullptr;
+    }
+
+    dbgln_if(JIT_DEBUG, "LibJS JIT: Compiled {} ({} bytes of bytecode) into {} bytes of machine code", m_executable.name, m_executable.bytecode.size(), m_output.size());
+    return native_executable.release_value();
+}
+
+bool Compiler::compile_instruction(Bytecode::Instruction const& instruction, size_t offset)
+{
+    switch (instruction.type()) {
+#    define CASE_BYTECODE_OP(name)              \
+    case Bytecode::Instruction::Type::name: \
+        return compile_op(static_cast<Bytecode::Op::name const&>(instruction), offset);
+        ENUMERATE_BYTECODE_OPS(CASE_BYTECODE_OP)
+#    undef CASE_BYTECODE_OP
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Compiler::Assembler::Operand Compiler::vm_operand(Bytecode::Operand operand)
+{
+    return Assembler::Operand::Mem64BaseAndOffset(REGISTER_ARRAY_BASE, operand.index() * sizeof(Value));
+}
+
+void Compiler::load_vm_operand(Assembler::Reg dst, Bytecode::Operand src)
+{
+    m_assembler.mov(Assembler::Operand::Register(dst), vm_operand(src));
+}
+
+void Compiler::store_vm_operand(Bytecode::Operand dst, Assembler::Reg src)
+{
+    m_assembler.mov(vm_operand(dst), Assembler::Operand::Register(src));
+}
+
+void Compiler::store_program_counter(size_t offset)
+{
+    m_assembler.mov(Assembler::Operand::Register(SCRATCH), Assembler::Operand::Imm(offset));
+    m_assembler.mov(Assembler::Operand::Mem64BaseAndOffset(PROGRAM_COUNTER_POINTER, 0), Assembler::Operand::Register(SCRATCH));
+}
+
+void Compiler::branch_if_not_tag(Assembler::Reg reg, u64 tag, Assembler::Label& label)
+{
+    m_assembler.mov(Assembler::Operand::Register(SCRATCH), Assembler::Operand::Register(reg));
+    m_assembler.shift_right(Assembler::Operand::Register(SCRATCH), Assembler::Operand::Imm(TAG_SHIFT));
+    m_assembler.jump_if(Assembler::Operand::Register(SCRATCH), Assembler::Condition::NotEqualTo, Assembler::Operand::Imm(tag), label);
+}
+
+void Compiler::box_int32(Assembler::Reg reg)
+{
+    m_assembler.mov32(Assembler::Operand::Register(reg), Assembler::Operand::Register(reg));
+    m_assembler.mov(Assembler::Operand::Register(SCRATCH), Assembler::Operand::Imm(SHIFTED_INT32_TAG));
+    m_assembler.bitwise_or(Assembler::Operand::Register(reg), Assembler::Operand::Register(SCRATCH));
+}
+
+Compiler::Assembler::Label& Compiler::label_for(Bytecode::Label const& label)
+{
+    auto it = m_block_labels.find(label.address());
+    VERIFY(it != m_block_labels.end());
+    return it->value;
+}
+
+void Compiler::call_slow_path(Bytecode::Instruction const& instruction, size_t offset, SlowPathHandler handler)
+{
+    // Keep the program counter up to date for anything that looks at it, e.g. to build a stack trace.
+    store_program_counter(offset);
+    m_assembler.mov(Assembler::Operand::Register(ARG0), Assembler::Operand::Register(RUNNING_INTERPRETER));
+    m_assembler.mov(Assembler::Operand::Register(ARG1), Assembler::Operand::Imm(bit_cast<u64>(&instruction)));
+    m_assembler.native_call(bit_cast<u64>(handler));
+    m_assembler.jump_if(Assembler::Operand::Register(RET), Assembler::Condition::NotEqualTo, Assembler::Operand::Imm(0), m_exit_label);
+}
+
+template<typename OpType>
+bool Compiler::compile_op(OpType const& op, size_t offset)
+{
+    call_slow_path(op, offset, &cxx_execute<OpType>);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::Mov const& op, size_t)
+{
+    load_vm_operand(GPR0, op.src());
+    store_vm_operand(op.dst(), GPR0);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::GetArgument const& op, size_t)
+{
+    m_assembler.mov(Assembler::Operand::Register(GPR0), Assembler::Operand::Mem64BaseAndOffset(ARGUMENTS_ARRAY_BASE, op.index() * sizeof(Value)));
+    store_vm_operand(op.dst(), GPR0);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::SetArgument const& op, size_t)
+{
+    load_vm_operand(GPR0, op.src());
+    m_assembler.mov(Assembler::Operand::Mem64BaseAndOffset(ARGUMENTS_ARRAY_BASE, op.index() * sizeof(Value)), Assembler::Operand::Register(GPR0));
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::End const& op, size_t)
+{
+    load_vm_operand(GPR0, op.value());
+    store_vm_operand(Bytecode::Operand(Bytecode::Register::accumulator()), GPR0);
+    m_assembler.jump(m_exit_label);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::Return const& op, size_t offset)
+{
+    call_slow_path(op, offset, &cxx_execute<Bytecode::Op::Return>);
+    m_assembler.jump(m_exit_label);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::Jump const& op, size_t)
+{
+    m_assembler.jump(label_for(op.target()));
+    return true;
+}
+
+void Compiler::compile_to_boolean(Bytecode::Operand operand)
+{
+    // Booleans and Int32s are converted inline, everything else goes through Value::to_boolean().
+    Assembler::Label not_boolean;
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_operand(GPR1, operand);
+    m_assembler.mov(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    m_assembler.shift_right(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(TAG_SHIFT));
+
+    m_assembler.jump_if(Assembler::Operand::Register(GPR0), Assembler::Condition::NotEqualTo, Assembler::Operand::Imm(BOOLEAN_TAG), not_boolean);
+    m_assembler.mov32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    m_assembler.jump(end);
+
+    not_boolean.link(m_assembler);
+    m_assembler.jump_if(Assembler::Operand::Register(GPR0), Assembler::Condition::NotEqualTo, Assembler::Operand::Imm(INT32_TAG), slow_case);
+    m_assembler.mov32(Assembler::Operand::Register(GPR1), Assembler::Operand::Register(GPR1));
+    m_assembler.mov(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(0));
+    m_assembler.test(Assembler::Operand::Register(GPR1), Assembler::Operand::Register(GPR1));
+    m_assembler.set_if(Assembler::Condition::NotEqualTo, Assembler::Operand::Register(GPR0));
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    m_assembler.mov(Assembler::Operand::Register(ARG0), Assembler::Operand::Register(GPR1));
+    m_assembler.native_call(bit_cast<u64>(&cxx_to_boolean));
+
+    end.link(m_assembler);
+}
+
+bool Compiler::compile_op(Bytecode::Op::JumpIf const& op, size_t)
+{
+    compile_to_boolean(op.condition());
+    m_assembler.jump_if(Assembler::Operand::Register(RET), Assembler::Condition::NotEqualTo, Assembler::Operand::Imm(0), label_for(op.true_target()));
+    m_assembler.jump(label_for(op.false_target()));
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::JumpTrue const& op, size_t)
+{
+    compile_to_boolean(op.condition());
+    m_assembler.jump_if(Assembler::Operand::Register(RET), Assembler::Condition::NotEqualTo, Assembler::Operand::Imm(0), label_for(op.target()));
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::JumpFalse const& op, size_t)
+{
+    compile_to_boolean(op.condition());
+    m_assembler.jump_if(Assembler::Operand::Register(RET), Assembler::Condition::EqualTo, Assembler::Operand::Imm(0), label_for(op.target()));
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::JumpNullish const& op, size_t)
+{
+    load_vm_operand(GPR0, op.condition());
+    m_assembler.shift_right(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(TAG_SHIFT));
+    m_assembler.bitwise_and(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(IS_NULLISH_EXTRACT_PATTERN));
+    m_assembler.jump_if(Assembler::Operand::Register(GPR0), Assembler::Condition::EqualTo, Assembler::Operand::Imm(IS_NULLISH_PATTERN), label_for(op.true_target()));
+    m_assembler.jump(label_for(op.false_target()));
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::JumpUndefined const& op, size_t)
+{
+    load_vm_operand(GPR0, op.condition());
+    m_assembler.shift_right(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(TAG_SHIFT));
+    m_assembler.jump_if(Assembler::Operand::Register(GPR0), Assembler::Condition::EqualTo, Assembler::Operand::Imm(UNDEFINED_TAG), label_for(op.true_target()));
+    m_assembler.jump(label_for(op.false_target()));
+    return true;
+}
+
+void Compiler::compile_comparison_jump(Bytecode::Operand lhs, Bytecode::Operand rhs, Bytecode::Label const& true_target, Bytecode::Label const& false_target, size_t offset, Assembler::Condition condition, u64 (*slow_path)(Bytecode::Interpreter&, Value, Value))
+{
+    Assembler::Label slow_case;
+
+    load_vm_operand(GPR0, lhs);
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    load_vm_operand(GPR1, rhs);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+
+    m_assembler.sign_extend_32_to_64_bits(GPR0);
+    m_assembler.sign_extend_32_to_64_bits(GPR1);
+    m_assembler.cmp(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    m_assembler.jump_if(condition, label_for(true_target));
+    m_assembler.jump(label_for(false_target));
+
+    slow_case.link(m_assembler);
+    store_program_counter(offset);
+    m_assembler.mov(Assembler::Operand::Register(ARG0), Assembler::Operand::Register(RUNNING_INTERPRETER));
+    load_vm_operand(ARG1, lhs);
+    load_vm_operand(ARG2, rhs);
+    m_assembler.native_call(bit_cast<u64>(slow_path));
+    m_assembler.jump_if(Assembler::Operand::Register(RET), Assembler::Condition::EqualTo, Assembler::Operand::Imm(COMPARISON_THREW), m_exit_label);
+    m_assembler.jump_if(Assembler::Operand::Register(RET), Assembler::Condition::NotEqualTo, Assembler::Operand::Imm(0), label_for(true_target));
+    m_assembler.jump(label_for(false_target));
+}
+
+#    define DEFINE_COMPILE_COMPARISON_JUMP(op_TitleCase, op_snake_case, numeric_operator)                                                                    \
+        bool Compiler::compile_op(Bytecode::Op::Jump##op_TitleCase const& op, size_t offset)                                                               \
+        {                                                                                                                                                  \
+            compile_comparison_jump(op.lhs(), op.rhs(), op.true_target(), op.false_target(), offset, int32_condition_for_##op_snake_case, &cxx_jump_##op_snake_case); \
+            return true;                                                                                                                                   \
+        }
+JS_ENUMERATE_COMPARISON_OPS(DEFINE_COMPILE_COMPARISON_JUMP)
+#    undef DEFINE_COMPILE_COMPARISON_JUMP
+
+template<typename OpType, typename EmitFastPath>
+void Compiler::compile_int32_binary_op(OpType const& op, size_t offset, EmitFastPath emit_fast_path)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_operand(GPR0, op.lhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    load_vm_operand(GPR1, op.rhs());
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+
+    emit_fast_path(slow_case);
+    store_vm_operand(op.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    call_slow_path(op, offset, &cxx_execute<OpType>);
+
+    end.link(m_assembler);
+}
+
+bool Compiler::compile_op(Bytecode::Op::Add const& op, size_t offset)
+{
+    compile_int32_binary_op(op, offset, [&](Assembler::Label& slow_case) {
+        m_assembler.add32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1), slow_case);
+        box_int32(GPR0);
+    });
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::Sub const& op, size_t offset)
+{
+    compile_int32_binary_op(op, offset, [&](Assembler::Label& slow_case) {
+        m_assembler.sub32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1), slow_case);
+        box_int32(GPR0);
+    });
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::Mul const& op, size_t offset)
+{
+    compile_int32_binary_op(op, offset, [&](Assembler::Label& slow_case) {
+        m_assembler.mul32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1), slow_case);
+        // A zero result may have to be -0 (e.g. -1 * 0), which isn't an Int32.
+        m_assembler.jump_if(Assembler::Operand::Register(GPR0), Assembler::Condition::EqualTo, Assembler::Operand::Imm(0), slow_case);
+        box_int32(GPR0);
+    });
+    return true;
+}
+
+// NOTE: Two boxed Int32s share the same tag, so and-ing or or-ing them leaves a correctly boxed result.
+bool Compiler::compile_op(Bytecode::Op::BitwiseAnd const& op, size_t offset)
+{
+    compile_int32_binary_op(op, offset, [&](Assembler::Label&) {
+        m_assembler.bitwise_and(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    });
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::BitwiseOr const& op, size_t offset)
+{
+    compile_int32_binary_op(op, offset, [&](Assembler::Label&) {
+        m_assembler.bitwise_or(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    });
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::BitwiseXor const& op, size_t offset)
+{
+    compile_int32_binary_op(op, offset, [&](Assembler::Label&) {
+        m_assembler.bitwise_xor32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+        box_int32(GPR0);
+    });
+    return true;
+}
+
+template<typename OpType>
+void Compiler::compile_int32_comparison(OpType const& op, size_t offset, Assembler::Condition condition)
+{
+    compile_int32_binary_op(op, offset, [&](Assembler::Label&) {
+        m_assembler.sign_extend_32_to_64_bits(GPR0);
+        m_assembler.sign_extend_32_to_64_bits(GPR1);
+        m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm(0));
+        m_assembler.cmp(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+        m_assembler.set_if(condition, Assembler::Operand::Register(GPR2));
+        m_assembler.mov(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(SHIFTED_BOOLEAN_TAG));
+        m_assembler.bitwise_or(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR2));
+    });
+}
+
+bool Compiler::compile_op(Bytecode::Op::LessThan const& op, size_t offset)
+{
+    compile_int32_comparison(op, offset, int32_condition_for_less_than);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::LessThanEquals const& op, size_t offset)
+{
+    compile_int32_comparison(op, offset, int32_condition_for_less_than_equals);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::GreaterThan const& op, size_t offset)
+{
+    compile_int32_comparison(op, offset, int32_condition_for_greater_than);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::GreaterThanEquals const& op, size_t offset)
+{
+    compile_int32_comparison(op, offset, int32_condition_for_greater_than_equals);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::Increment const& op, size_t offset)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_operand(GPR0, op.dst());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    m_assembler.inc32(Assembler::Operand::Register(GPR0), slow_case);
+    box_int32(GPR0);
+    store_vm_operand(op.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    call_slow_path(op, offset, &cxx_execute<Bytecode::Op::Increment>);
+
+    end.link(m_assembler);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::Decrement const& op, size_t offset)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_operand(GPR0, op.dst());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    m_assembler.dec32(Assembler::Operand::Register(GPR0), slow_case);
+    box_int32(GPR0);
+    store_vm_operand(op.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    call_slow_path(op, offset, &cxx_execute<Bytecode::Op::Decrement>);
+
+    end.link(m_assembler);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::GetById const& op, size_t offset)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_operand(ARG0, op.base());
+    branch_if_not_tag(ARG0, OBJECT_TAG, slow_case);
+    m_assembler.mov(Assembler::Operand::Register(ARG1), Assembler::Operand::Imm(bit_cast<u64>(&m_executable.property_lookup_caches[op.cache_index()])));
+    m_assembler.native_call(bit_cast<u64>(&cxx_get_by_id_cached));
+    m_assembler.mov(Assembler::Operand::Register(GPR1), Assembler::Operand::Imm(Value {}.encoded()));
+    m_assembler.jump_if(Assembler::Operand::Register(RET), Assembler::Condition::EqualTo, Assembler::Operand::Register(GPR1), slow_case);
+    store_vm_operand(op.dst(), RET);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    call_slow_path(op, offset, &cxx_execute<Bytecode::Op::GetById>);
+
+    end.link(m_assembler);
+    return true;
+}
+
+bool Compiler::compile_op(Bytecode::Op::PutById const& op, size_t offset)
+{
+    // Only plain assignments are ever cached.
+    if (op.kind() != Bytecode::Op::PropertyKind::KeyValue) {
+        call_slow_path(op, offset, &cxx_execute<Bytecode::Op::PutById>);
+        return true;
+    }
+
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_operand(ARG0, op.base());
+    branch_if_not_tag(ARG0, OBJECT_TAG, slow_case);
+    load_vm_operand(ARG1, op.src());
+    m_assembler.mov(Assembler::Operand::Register(ARG2), Assembler::Operand::Imm(bit_cast<u64>(&m_executable.property_lookup_caches[op.cache_index()])));
+    m_assembler.native_call(bit_cast<u64>(&cxx_put_by_id_cached));
+    m_assembler.jump_if(Assembler::Operand::Register(RET), Assembler::Condition::EqualTo, Assembler::Operand::Imm(0), slow_case);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    call_slow_path(op, offset, &cxx_execute<Bytecode::Op::PutById>);
+
+    end.link(m_assembler);
+    return true;
+}
+
+#endif
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable& executable)
+{
+#ifdef JIT_ARCH_SUPPORTED
+    Compiler compiler { executable };
+    return compiler.compile_executable();
+#else
+    (void)executable;
+    return nullptr;
+#endif
+}
+
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibJIT/Assembler.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+// A baseline compiler that translates a Bytecode::Executable into machine code one instruction at a time.
+// The common cases (Int32 arithmetic and comparisons, cached property accesses) are handled inline, while
+// everything else calls into the same implementation the bytecode interpreter uses.
+class Compiler {
+public:
+    // Returns nullptr if the executable uses something the compiler doesn't support, in which case it
+    // should keep running in the bytecode interpreter.
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable&);
+
+#ifdef JIT_ARCH_SUPPORTED
+private:
+    using Assembler = ::JIT::Assembler;
+
+    // The generated code keeps everything it needs in callee-saved registers, so it survives calls into C++.
+    // NOTE: R12 and R13 can't be used as a memory base without a SIB byte or displacement, which the assembler
+    //       doesn't emit, so they only hold values that are passed around.
+    static constexpr auto REGISTER_ARRAY_BASE = Assembler::Reg::RBX;
+    static constexpr auto ARGUMENTS_ARRAY_BASE = Assembler::Reg::R14;
+    static constexpr auto PROGRAM_COUNTER_POINTER = Assembler::Reg::R15;
+    static constexpr auto RUNNING_INTERPRETER = Assembler::Reg::R12;
+
+    static constexpr auto GPR0 = Assembler::Reg::RAX;
+    static constexpr auto GPR1 = Assembler::Reg::RCX;
+    static constexpr auto GPR2 = Assembler::Reg::RDX;
+    static constexpr auto SCRATCH = Assembler::Reg::R11;
+
+    static constexpr auto ARG0 = Assembler::Reg::RDI;
+    static constexpr auto ARG1 = Assembler::Reg::RSI;
+    static constexpr auto ARG2 = Assembler::Reg::RDX;
+    static constexpr auto ARG3 = Assembler::Reg::RCX;
+    static constexpr auto RET = Assembler::Reg::RAX;
+
+    explicit Compiler(Bytecode::Executable& executable)
+        : m_executable(executable)
+        , m_assembler(m_output)
+    {
+    }
+
+    OwnPtr<NativeExecutable> compile_executable();
+    bool compile_instruction(Bytecode::Instruction const&, size_t offset);
+
+    template<typename OpType>
+    bool compile_op(OpType const&, size_t offset);
+
+    bool compile_op(Bytecode::Op::Mov const&, size_t offset);
+    bool compile_op(Bytecode::Op::GetArgument const&, size_t offset);
+    bool compile_op(Bytecode::Op::SetArgument const&, size_t offset);
+    bool compile_op(Bytecode::Op::End const&, size_t offset);
+    bool compile_op(Bytecode::Op::Return const&, size_t offset);
+    bool compile_op(Bytecode::Op::Jump const&, size_t offset);
+    bool compile_op(Bytecode::Op::JumpIf const&, size_t offset);
+    bool compile_op(Bytecode::Op::JumpTrue const&, size_t offset);
+    bool compile_op(Bytecode::Op::JumpFalse const&, size_t offset);
+    bool compile_op(Bytecode::Op::JumpNullish const&, size_t offset);
+    bool compile_op(Bytecode::Op::JumpUndefined const&, size_t offset);
+    bool compile_op(Bytecode::Op::Add const&, size_t offset);
+    bool compile_op(Bytecode::Op::Sub const&, size_t offset);
+    bool compile_op(Bytecode::Op::Mul const&, size_t offset);
+    bool compile_op(Bytecode::Op::BitwiseAnd const&, size_t offset);
+    bool compile_op(Bytecode::Op::BitwiseOr const&, size_t offset);
+    bool compile_op(Bytecode::Op::BitwiseXor const&, size_t offset);
+    bool compile_op(Bytecode::Op::LessThan const&, size_t offset);
+    bool compile_op(Bytecode::Op::LessThanEquals const&, size_t offset);
+    bool compile_op(Bytecode::Op::GreaterThan const&, size_t offset);
+    bool compile_op(Bytecode::Op::GreaterThanEquals const&, size_t offset);
+    bool compile_op(Bytecode::Op::Increment const&, size_t offset);
+    bool compile_op(Bytecode::Op::Decrement const&, size_t offset);
+    bool compile_op(Bytecode::Op::GetById const&, size_t offset);
+    bool compile_op(Bytecode::Op::PutById const&, size_t offset);
+
+#    define DECLARE_COMPILE_COMPARISON_JUMP(op_TitleCase, op_snake_case, numeric_operator) \
+        bool compile_op(Bytecode::Op::Jump##op_TitleCase const&, size_t offset);
+    JS_ENUMERATE_COMPARISON_OPS(DECLARE_COMPILE_COMPARISON_JUMP)
+#    undef DECLARE_COMPILE_COMPARISON_JUMP
+
+    // These rely on exception handlers or on suspending the executable, neither of which the generated code supports.
+    bool compile_op(Bytecode::Op::Await const&, size_t) { return false; }
+    bool compile_op(Bytecode::Op::Yield const&, size_t) { return false; }
+    bool compile_op(Bytecode::Op::EnterUnwindContext const&, size_t) { return false; }
+    bool compile_op(Bytecode::Op::ContinuePendingUnwind const&, size_t) { return false; }
+    bool compile_op(Bytecode::Op::ScheduleJump const&, size_t) { return false; }
+    bool compile_op(Bytecode::Op::LeaveFinally const&, size_t) { return false; }
+    bool compile_op(Bytecode::Op::RestoreScheduledJump const&, size_t) { return false; }
+
+    using SlowPathHandler = u64 (*)(Bytecode::Interpreter&, Bytecode::Instruction const&);
+    void call_slow_path(Bytecode::Instruction const&, size_t offset, SlowPathHandler);
+
+    // Loads both operands into GPR0 and GPR1 and runs the fast path if they're both Int32s, which leaves the boxed
+    // result in GPR0. The fast path jumps to the slow case label for anything it can't handle.
+    template<typename OpType, typename EmitFastPath>
+    void compile_int32_binary_op(OpType const&, size_t offset, EmitFastPath);
+    template<typename OpType>
+    void compile_int32_comparison(OpType const&, size_t offset, Assembler::Condition);
+    void compile_comparison_jump(Bytecode::Operand lhs, Bytecode::Operand rhs, Bytecode::Label const& true_target, Bytecode::Label const& false_target, size_t offset, Assembler::Condition, u64 (*slow_path)(Bytecode::Interpreter&, Value, Value));
+    // Leaves 0 or 1 in RET.
+    void compile_to_boolean(Bytecode::Operand);
+
+    Assembler::Operand vm_operand(Bytecode::Operand);
+    void load_vm_operand(Assembler::Reg dst, Bytecode::Operand);
+    void store_vm_operand(Bytecode::Operand, Assembler::Reg src);
+
+    void store_program_counter(size_t offset);
+    void branch_if_not_tag(Assembler::Reg, u64 tag, Assembler::Label&);
+    void box_int32(Assembler::Reg);
+
+    Assembler::Label& label_for(Bytecode::Label const&);
+
+    Bytecode::Executable& m_executable;
+    Vector<u8> m_output;
+    Assembler m_assembler;
+    HashMap<size_t, Assembler::Label> m_block_labels;
+    Assembler::Label m_exit_label;
+#endif
+};
+
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJIT/GDB.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/Value.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+ErrorOr<NonnullOwnPtr<NativeExecutable>> NativeExecutable::create(ReadonlyBytes machine_code, StringView name)
+{
+    VERIFY(!machine_code.is_empty());
+
+    auto* code = mmap(nullptr, machine_code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED)
+        return AK::Error::from_errno(errno);
+
+    memcpy(code, machine_code.data(), machine_code.size());
+
+    if (mprotect(code, machine_code.size(), PROT_READ | PROT_EXEC) < 0) {
+        auto error = AK::Error::from_errno(errno);
+        munmap(code, machine_code.size());
+        return error;
+    }
+
+    auto native_executable = adopt_own(*new NativeExecutable(static_cast<u8*>(code), machine_code.size()));
+
+    // Let GDB symbolize (and set breakpoints in) the generated code, if it's attached.
+    native_executable->m_gdb_object = ::JIT::GDB::build_gdb_image(native_executable->code_bytes(), "LibJS JIT"sv, name);
+    if (native_executable->m_gdb_object.has_value())
+        ::JIT::GDB::register_into_gdb(native_executable->m_gdb_object->span());
+
+    return native_executable;
+}
+
+NativeExecutable::NativeExecutable(u8* code, size_t size)
+    : m_code(code)
+    , m_size(size)
+{
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::unregister_from_gdb(m_gdb_object->span());
+    munmap(m_code, m_size);
+}
+
+void NativeExecutable::run(Bytecode::Interpreter& interpreter, Value* registers_and_constants_and_locals, Value* arguments, size_t& program_counter) const
+{
+    using EntryPoint = void (*)(Value* registers_and_constants_and_locals, Value* arguments, Bytecode::Interpreter*, size_t* program_counter);
+    auto entry_point = reinterpret_cast<EntryPoint>(m_code);
+    entry_point(registers_and_constants_and_locals, arguments, &interpreter, &program_counter);
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/FixedArray.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/StringView.h>
+#include <LibJS/Forward.h>
+
+namespace JS::JIT {
+
+// Machine code produced by the JIT compiler for a single Bytecode::Executable.
+// The code is copied into its own mapping, which is made executable (and no longer writable) once it's in place.
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    static ErrorOr<NonnullOwnPtr<NativeExecutable>> create(ReadonlyBytes machine_code, StringView name);
+    ~NativeExecutable();
+
+    // Runs the code from the start of the executable. When this returns, the accumulator holds the completion value,
+    // unless an exception was thrown, in which case it's in the exception register.
+    void run(Bytecode::Interpreter&, Value* registers_and_constants_and_locals, Value* arguments, size_t& program_counter) const;
+
+    ReadonlyBytes code_bytes() const { return { m_code, m_size }; }
+
+private:
+    NativeExecutable(u8* code, size_t size);
+
+    u8* m_code { nullptr };
+    size_t m_size { 0 };
+    Optional<FixedArray<u8>> m_gdb_object;
+};
+
+}
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/StringView.h>
+#include <LibJS/Heap/WriteBarrier.h>
 #include <LibJS/Runtime/FunctionObject.h>
 #include <LibJS/Runtime/VM.h>
 
@@ -24,10 +25,18 @@ public:
     }
 
     FunctionObject* getter() const { return m_getter; }
-    void set_getter(FunctionObject* getter) { m_getter = getter; }
+    void set_getter(FunctionObject* getter)
+    {
+        m_getter = getter;
+        write_barrier(*this, getter);
+    }
 
     FunctionObject* setter() const { return m_setter; }
-    void set_setter(FunctionObject* setter) { m_setter = setter; }
+    void set_setter(FunctionObject* setter)
+    {
+        m_setter = setter;
+        write_barrier(*this, setter);
+    }
 
     void visit_edges(Cell::Visitor& visitor) override
     {
@@ -37,6 +46,8 @@ public:
     }
 
 private:
+    virtual bool uses_write_barriers() const override { return true; }
+
     Accessor(FunctionObject* getter, FunctionObject* setter)
         : m_getter(getter)
         , m_setter(setter)
@@ -32,6 +32,9 @@ public:
 private:
     explicit BigInt(Crypto::SignedBigInteger);
 
+    // BigInts don't point at any other cells.
+    virtual bool uses_write_barriers() const override { return true; }
+
     Crypto::SignedBigInteger m_big_integer;
 };
 
@@ -552,6 +552,7 @@ ThrowCompletionOr<void> Object::private_field_add(PrivateName const& name, Value
 
     // 4. Append PrivateElement { [[Key]]: P, [[Kind]]: field, [[Value]]: value } to O.[[PrivateElements]].
     m_private_elements->empend(name, PrivateElement::Kind::Field, value);
+    write_barrier(*this, value);
 
     // 5. Return unused.
     return {};
@@ -579,6 +580,7 @@ ThrowCompletionOr<void> Object::private_method_or_accessor_add(PrivateElement el
         m_private_elements = make<Vector<PrivateElement>>();
 
     // 5. Append method to O.[[PrivateElements]].
+    write_barrier(*this, element.value);
     m_private_elements->append(move(element));
 
     // 6. Return unused.
@@ -635,6 +637,7 @@ ThrowCompletionOr<void> Object::private_set(PrivateName const& name, Value value
     if (entry->kind == PrivateElement::Kind::Field) {
         // a. Set entry.[[Value]] to value.
         entry->value = value;
+        write_barrier(*this, value);
         return {};
     }
     // 4. Else if entry.[[Kind]] is method, then
@@ -985,7 +988,7 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
         // b. If parent is not null, then
         if (parent) {
             // i. Return ? parent.[[Set]](P, V, Receiver).
-            return TRY(parent->internal_set(property_key, value, receiver));
+            return TRY(parent->internal_set(property_key, value, receiver, cacheable_metadata));
         }
         // c. Else,
         else {
@@ -1027,7 +1030,7 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
             // iii. Let valueDesc be the PropertyDescriptor { [[Value]]: V }.
             auto value_descriptor = PropertyDescriptor { .value = value };
 
-            if (cacheable_metadata && own_descriptor.has_value() && own_descriptor->property_offset.has_value() && shape().is_cacheable()) {
+            if (cacheable_metadata && &receiver_object == this && own_descriptor.has_value() && own_descriptor->property_offset.has_value() && shape().is_cacheable()) {
                 *cacheable_metadata = CacheablePropertyMetadata {
                     .type = CacheablePropertyMetadata::Type::OwnProperty,
                     .property_offset = own_descriptor->property_offset.value(),
@@ -1058,6 +1061,23 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
     if (!setter)
         return false;
 
+    // Non-standard: If the caller has requested cacheable metadata, let it remember where the setter lives.
+    if (cacheable_metadata && own_descriptor->property_offset.has_value() && shape().is_cacheable()) {
+        if (receiver.is_object() && &receiver.as_object() == this) {
+            *cacheable_metadata = CacheablePropertyMetadata {
+                .type = CacheablePropertyMetadata::Type::OwnProperty,
+                .property_offset = own_descriptor->property_offset.value(),
+                .prototype = nullptr,
+            };
+        } else if (shape().is_prototype_shape() && shape().prototype_chain_validity() && shape().prototype_chain_validity()->is_valid()) {
+            *cacheable_metadata = CacheablePropertyMetadata {
+                .type = CacheablePropertyMetadata::Type::InPrototypeChain,
+                .property_offset = own_descriptor->property_offset.value(),
+                .prototype = this,
+            };
+        }
+    }
+
     // 6. Perform ? Call(setter, Receiver, « V »).
     (void)TRY(call(vm, *setter, receiver, value));
 
@@ -1176,8 +1196,11 @@ Optional<ValueAndAttributes> Object::storage_get(PropertyKey const& property_key
             return {};
 
         if (m_has_intrinsic_accessors) {
-            if (auto accessor = find_intrinsic_accessor(this, property_key); accessor.has_value())
-                const_cast<Object&>(*this).m_storage[metadata->offset] = (*accessor)(shape().realm());
+            if (auto accessor = find_intrinsic_accessor(this, property_key); accessor.has_value()) {
+                auto& mutable_this = const_cast<Object&>(*this);
+                mutable_this.m_storage[metadata->offset] = (*accessor)(shape().realm());
+                write_barrier(mutable_this, mutable_this.m_storage[metadata->offset]);
+            }
         }
 
         value = m_storage[metadata->offset];
@@ -1205,6 +1228,7 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
     if (property_key.is_number()) {
         auto index = property_key.as_number();
         m_indexed_properties.put(index, value, attributes);
+        write_barrier(*this, value);
         return;
     }
 
@@ -1226,6 +1250,7 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
         else
             set_shape(*m_shape->create_put_transition(property_key_string_or_symbol, attributes));
         m_storage.append(value);
+        write_barrier(*this, value);
         return;
     }
 
@@ -1237,6 +1262,7 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
     }
 
     m_storage[metadata->offset] = value;
+    write_barrier(*this, value);
 }
 
 void Object::storage_delete(PropertyKey const& property_key)
@@ -1257,6 +1283,7 @@ void Object::storage_delete(PropertyKey const& property_key)
 
     if (m_shape->is_cacheable_dictionary()) {
         m_shape = m_shape->create_uncacheable_dictionary_transition();
+        write_barrier(*this, m_shape.ptr());
     }
     if (m_shape->is_uncacheable_dictionary()) {
         m_shape->remove_property_without_transition(property_key.to_string_or_symbol(), metadata->offset);
@@ -1264,6 +1291,7 @@ void Object::storage_delete(PropertyKey const& property_key)
         return;
     }
     m_shape = m_shape->create_delete_transition(property_key.to_string_or_symbol());
+    write_barrier(*this, m_shape.ptr());
     m_storage.remove(metadata->offset);
 }
 
@@ -1272,6 +1300,7 @@ void Object::set_prototype(Object* new_prototype)
     if (prototype() == new_prototype)
         return;
     m_shape = shape().create_prototype_transition(new_prototype);
+    write_barrier(*this, m_shape.ptr());
 }
 
 void Object::define_native_accessor(Realm& realm, PropertyKey const& property_key, Function<ThrowCompletionOr<Value>(VM&)> getter, Function<ThrowCompletionOr<Value>(VM&)> setter, PropertyAttributes attribute)
@@ -14,6 +14,7 @@
 #include <LibJS/Heap/Cell.h>
 #include <LibJS/Heap/CellAllocator.h>
 #include <LibJS/Heap/MarkedVector.h>
+#include <LibJS/Heap/WriteBarrier.h>
 #include <LibJS/Runtime/Completion.h>
 #include <LibJS/Runtime/IndexedProperties.h>
 #include <LibJS/Runtime/PrimitiveString.h>
@@ -23,10 +24,23 @@
 #include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/Value.h>
 #include <LibJS/SafeFunction.h>
+#include <typeinfo>
 
 namespace JS {
 
-#define JS_OBJECT(class_, base_class) JS_CELL(class_, base_class)
+// Objects inherit the write barriers of their base class, unless they declare edges of their own. A subclass that
+// is declared without this macro doesn't get any, as we can't tell what it has been storing.
+#define JS_OBJECT(class_, base_class)                                                                          \
+    JS_CELL(class_, base_class)                                                                                \
+    friend struct JS::WriteBarrierTraits;                                                                      \
+    static constexpr bool edges_use_write_barriers()                                                           \
+    {                                                                                                          \
+        return !JS::WriteBarrierTraits::declares_own_edges<class_>() && base_class::edges_use_write_barriers(); \
+    }                                                                                                          \
+    virtual bool uses_write_barriers() const override                                                          \
+    {                                                                                                          \
+        return typeid(*this) == typeid(class_) && edges_use_write_barriers();                                  \
+    }
 
 struct PrivateElement {
     enum class Kind {
@@ -208,12 +222,24 @@ public:
 
     virtual void visit_edges(Cell::Visitor&) override;
 
+    // All of our own edges are stored with a write barrier.
+    static constexpr bool edges_use_write_barriers() { return true; }
+
     Value get_direct(size_t index) const { return m_storage[index]; }
-    void put_direct(size_t index, Value value) { m_storage[index] = value; }
+    void put_direct(size_t index, Value value)
+    {
+        m_storage[index] = value;
+        write_barrier(*this, value);
+    }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
-    void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
+    void set_indexed_property_elements(Vector<Value>&& values)
+    {
+        for (auto value : values)
+            write_barrier(*this, value);
+        m_indexed_properties = IndexedProperties(move(values));
+    }
 
     Shape& shape() { return *m_shape; }
     Shape const& shape() const { return *m_shape; }
@@ -254,7 +280,13 @@ protected:
     bool m_is_typed_array { false };
 
 private:
-    void set_shape(Shape& shape) { m_shape = &shape; }
+    void set_shape(Shape& shape)
+    {
+        m_shape = &shape;
+        write_barrier(*this, &shape);
+    }
+
+    virtual bool uses_write_barriers() const override { return typeid(*this) == typeid(Object); }
 
     Object* prototype() { return shape().prototype(); }
 
@@ -61,6 +61,9 @@ private:
 
     virtual void visit_edges(Cell::Visitor&) override;
 
+    // Ropes only ever point at strings that existed before they did, and are never changed to point elsewhere.
+    virtual bool uses_write_barriers() const override { return true; }
+
     enum class EncodingPreference {
         UTF8,
         UTF16,
@@ -30,6 +30,9 @@ public:
 private:
     Symbol(Optional<String>, bool);
 
+    // Symbols don't point at any other cells.
+    virtual bool uses_write_barriers() const override { return true; }
+
     Optional<String> m_description;
     bool m_is_global;
 };
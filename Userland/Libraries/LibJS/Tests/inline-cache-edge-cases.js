@@ -16,3 +16,78 @@ test("Inline cache invalidated by deleting property from unique shape", () => {
     expect(first).toBe(2);
     expect(second).toBeUndefined();
 });
+
+test("Polymorphic inline cache with more shapes than it can remember", () => {
+    const objects = [];
+    for (let i = 0; i < 6; ++i) {
+        const o = {};
+        o["unique" + i] = i;
+        o.x = i * 10;
+        objects.push(o);
+    }
+
+    function get(o) {
+        return o.x;
+    }
+
+    function put(o, value) {
+        o.x = value;
+    }
+
+    for (let round = 0; round < 3; ++round) {
+        for (let i = 0; i < objects.length; ++i) {
+            expect(get(objects[i])).toBe(i * 10 + round);
+            put(objects[i], i * 10 + round + 1);
+        }
+    }
+});
+
+test("Inline cache for setters on the object and its prototype chain", () => {
+    const log = [];
+    const proto = {
+        set x(value) {
+            log.push(`proto ${value}`);
+        },
+    };
+    const own = {
+        set x(value) {
+            log.push(`own ${value}`);
+        },
+    };
+    const inherits = Object.create(proto);
+
+    function put(o, value) {
+        o.x = value;
+    }
+
+    for (let i = 0; i < 3; ++i) {
+        put(inherits, i);
+        put(own, i);
+    }
+    expect(log).toEqual(["proto 0", "own 0", "proto 1", "own 1", "proto 2", "own 2"]);
+    expect(Object.hasOwn(inherits, "x")).toBeFalse();
+
+    // Replacing the setter with a data property must not keep calling the old setter.
+    Object.defineProperty(proto, "x", { value: 1, writable: true, configurable: true });
+    put(inherits, 42);
+    expect(log).toHaveLength(6);
+    expect(Object.hasOwn(inherits, "x")).toBeTrue();
+    expect(inherits.x).toBe(42);
+    expect(proto.x).toBe(1);
+});
+
+test("Inline cache does not put to a data property found on the prototype", () => {
+    const proto = { x: 1 };
+    const a = Object.create(proto);
+    const b = Object.create(proto);
+
+    function put(o, value) {
+        o.x = value;
+    }
+
+    put(a, 2);
+    put(b, 3);
+    expect(proto.x).toBe(1);
+    expect(a.x).toBe(2);
+    expect(b.x).toBe(3);
+});
@@ -133,3 +133,39 @@ test("evaluation order", () => {
         expect(c.hasBeenCalled).toBeFalse();
     }
 });
+
+test("assigning the result of an operation to a local", () => {
+    let a = 3;
+    let b = 4;
+
+    a = a + b;
+    expect(a).toBe(7);
+
+    a = b - a;
+    expect(a).toBe(-3);
+
+    a = -a;
+    expect(a).toBe(3);
+
+    a = typeof a;
+    expect(a).toBe("number");
+
+    let c = 1;
+    expect((c = c * 10)).toBe(10);
+    expect(c).toBe(10);
+
+    let d = 5;
+    const e = (d = d << 1) + 1;
+    expect(d).toBe(10);
+    expect(e).toBe(11);
+
+    let sum = 0;
+    for (let i = 0; i < 10; i = i + 1) sum = sum + i;
+    expect(sum).toBe(45);
+
+    let f = 1;
+    expect(() => {
+        f = f + 1n;
+    }).toThrow(TypeError);
+    expect(f).toBe(1);
+});
@@ -213,33 +213,48 @@ void PlaybackManager::decode_and_queue_one_sample()
             // Get a sample to decode.
             auto sample_result = m_demuxer->get_next_sample_for_track(m_selected_video_track);
             if (sample_result.is_error()) {
-                item_to_enqueue = FrameQueueItem::error_marker(sample_result.release_error(), FrameQueueItem::no_timestamp);
-                break;
-            }
-            auto sample = sample_result.release_value();
-            container_cicp = sample.auxiliary_data().get<VideoSampleData>().container_cicp();
+                // The decoder may still be holding frames back, which have to be presented before the end of the stream.
+                if (sample_result.error().category() == DecoderErrorCategory::EndOfStream) {
+                    if (auto drain_result = m_decoder->signal_end_of_stream(); drain_result.is_error()) {
+                        item_to_enqueue = FrameQueueItem::error_marker(drain_result.release_error(), FrameQueueItem::no_timestamp);
+                        break;
+                    }
+                    if (auto frame_result = m_decoder->get_decoded_frame(); !frame_result.is_error())
+                        decoded_frame = frame_result.release_value();
+                }
 
-            // Submit the sample to the decoder.
-            auto decode_result = m_decoder->receive_sample(sample.timestamp(), sample.data());
-            if (decode_result.is_error()) {
-                item_to_enqueue = FrameQueueItem::error_marker(decode_result.release_error(), sample.timestamp());
-                break;
-            }
+                if (decoded_frame == nullptr) {
+                    item_to_enqueue = FrameQueueItem::error_marker(sample_result.release_error(), FrameQueueItem::no_timestamp);
+                    break;
+                }
+                container_cicp = m_last_container_cicp;
+            } else {
+                auto sample = sample_result.release_value();
+                container_cicp = sample.auxiliary_data().get<VideoSampleData>().container_cicp();
+                m_last_container_cicp = container_cicp;
+
+                // Submit the sample to the decoder.
+                auto decode_result = m_decoder->receive_sample(sample.timestamp(), sample.data());
+                if (decode_result.is_error()) {
+                    item_to_enqueue = FrameQueueItem::error_marker(decode_result.release_error(), sample.timestamp());
+                    break;
+                }
 
-            // Retrieve the last available frame to present.
-            while (true) {
-                auto frame_result = m_decoder->get_decoded_frame();
+                // Retrieve the last available frame to present.
+                while (true) {
+                    auto frame_result = m_decoder->get_decoded_frame();
 
-                if (frame_result.is_error()) {
-                    if (frame_result.error().category() == DecoderErrorCategory::NeedsMoreInput) {
+                    if (frame_result.is_error()) {
+                        if (frame_result.error().category() == DecoderErrorCategory::NeedsMoreInput) {
+                            break;
+                        }
+
+                        item_to_enqueue = FrameQueueItem::error_marker(frame_result.release_error(), sample.timestamp());
                         break;
                     }
 
-                    item_to_enqueue = FrameQueueItem::error_marker(frame_result.release_error(), sample.timestamp());
-                    break;
+                    decoded_frame = frame_result.release_value();
                 }
-
-                decoded_frame = frame_result.release_value();
             }
         }
 
@@ -711,7 +726,7 @@ DecoderErrorOr<NonnullOwnPtr<PlaybackManager>> PlaybackManager::create(NonnullOw
     OwnPtr<VideoDecoder> decoder;
     switch (codec_id) {
     case CodecID::VP9:
-        decoder = DECODER_TRY_ALLOC(try_make<Video::VP9::Decoder>());
+        decoder = DECODER_TRY_ALLOC(try_make<Video::VP9::Decoder>(Video::VP9::Decoder::FrameThreading::Yes));
         break;
 
     default:
@@ -13,6 +13,7 @@
 #include <AK/Time.h>
 #include <LibCore/SharedCircularQueue.h>
 #include <LibGfx/Bitmap.h>
+#include <LibMedia/Color/CodingIndependentCodePoints.h>
 #include <LibMedia/Containers/Matroska/Document.h>
 #include <LibMedia/Demuxer.h>
 #include <LibThreading/ConditionVariable.h>
@@ -178,6 +179,8 @@ private:
     NonnullOwnPtr<Demuxer> m_demuxer;
     Threading::Mutex m_decoder_mutex;
     Track m_selected_video_track;
+    // Used for the frames that the decoder outputs at the end of the stream, after the last sample.
+    CodingIndependentCodePoints m_last_container_cicp;
 
     VideoFrameQueue m_frame_queue;
 
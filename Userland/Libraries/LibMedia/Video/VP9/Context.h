@@ -22,6 +22,7 @@
 #include "Enums.h"
 #include "LookupTables.h"
 #include "MotionVector.h"
+#include "ProbabilityTables.h"
 #include "SyntaxElementCounter.h"
 #include "Utilities.h"
 
@@ -44,13 +45,13 @@ struct Quantizers {
 struct FrameContext {
 public:
     static ErrorOr<FrameContext> create(ReadonlyBytes data,
-        Vector2D<FrameBlockContext>& contexts)
+        NonnullRefPtr<DecodedFrame> decoded_frame)
     {
         return FrameContext(
             data,
             TRY(try_make<FixedMemoryStream>(data)),
             TRY(try_make<SyntaxElementCounter>()),
-            contexts);
+            move(decoded_frame));
     }
 
     FrameContext(FrameContext const&) = delete;
@@ -79,6 +80,17 @@ public:
 
     NonnullOwnPtr<SyntaxElementCounter> counter;
 
+    // The frame's block contexts and reference planes are written into this while it is decoded.
+    NonnullRefPtr<DecodedFrame> decoded_frame;
+    // The frame that this one reads its previous motion vectors and segment IDs from, if it uses them.
+    RefPtr<DecodedFrame> previous_frame;
+    // The following frames may change the probabilities and reference frames before this one has finished decoding,
+    // so it keeps its own copies of them.
+    OwnPtr<ProbabilityTables> probability_tables;
+    Array<ReferenceFrame, REFS_PER_FRAME> reference_frames;
+    // The buffers that the frame is decoded into, owned by the decoder.
+    Array<Vector<u16>, 3>* output_buffers { nullptr };
+
     u8 profile { 0 };
 
     FrameType type { FrameType::KeyFrame };
@@ -186,12 +198,13 @@ private:
     FrameContext(ReadonlyBytes data,
         NonnullOwnPtr<FixedMemoryStream> stream,
         NonnullOwnPtr<SyntaxElementCounter> counter,
-        Vector2D<FrameBlockContext>& contexts)
+        NonnullRefPtr<DecodedFrame> decoded_frame)
         : stream_data(data)
         , stream(move(stream))
         , bit_stream(MaybeOwned<Stream>(*this->stream))
         , counter(move(counter))
-        , m_block_contexts(contexts)
+        , decoded_frame(move(decoded_frame))
+        , m_block_contexts(this->decoded_frame->block_contexts)
     {
     }
 
@@ -8,10 +8,16 @@
 #pragma once
 
 #include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/Error.h>
+#include <AK/NumericLimits.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
 #include <AK/Vector.h>
 #include <LibGfx/Size.h>
 #include <LibMedia/Color/CodingIndependentCodePoints.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
 
 #include "Enums.h"
 #include "LookupTables.h"
@@ -222,27 +228,6 @@ struct FrameBlockContext {
     u8 segment_id { 0 };
 };
 
-// Block context that is kept between frames until explicitly cleared.
-struct PersistentBlockContext {
-    PersistentBlockContext()
-        : available(false)
-    {
-    }
-
-    PersistentBlockContext(FrameBlockContext const& frame_context)
-        : available(frame_context.is_available)
-        , ref_frames(frame_context.ref_frames)
-        , primary_motion_vector_pair(frame_context.primary_motion_vector_pair())
-        , segment_id(frame_context.segment_id)
-    {
-    }
-
-    bool available { false };
-    ReferenceFramePair ref_frames { ReferenceFrameType::None, ReferenceFrameType::None };
-    MotionVectorPair primary_motion_vector_pair {};
-    u8 segment_id { 0 };
-};
-
 struct SegmentFeatureStatus {
     bool enabled { false };
     u8 value { 0 };
@@ -271,12 +256,80 @@ using SegmentationPredictionContextView = Span<u8>;
 using PartitionContext = FixedArray<u8>;
 using PartitionContextView = Span<u8>;
 
+// The parts of a decoded frame that the following frames read from. With frame threading, those frames can start
+// decoding before this one is finished, so they wait for the rows that they need to be decoded first.
+class DecodedFrame final : public RefCounted<DecodedFrame> {
+public:
+    static ErrorOr<NonnullRefPtr<DecodedFrame>> try_create()
+    {
+        return adopt_nonnull_ref_or_enomem(new (nothrow) DecodedFrame());
+    }
+
+    // The samples of each plane, extended by MV_BORDER samples on every side. These are only filled in if the frame
+    // refreshes any of the reference frames.
+    Array<Vector<u16>, 3> reference_planes {};
+    // The next frame reads its previous motion vectors and segment IDs from these.
+    Vector2D<FrameBlockContext> block_contexts;
+    bool keeps_segment_ids { false };
+
+    ErrorOr<void> start_decoding(u32 tile_columns)
+    {
+        m_decoded_rows_in_tile_columns.clear_with_capacity();
+        TRY(m_decoded_rows_in_tile_columns.try_resize(tile_columns));
+        m_decoded_rows.store(0, AK::MemoryOrder::memory_order_relaxed);
+        return {};
+    }
+
+    // Rows are counted in luma samples. A frame has been decoded completely once all of its rows are.
+    void set_decoded_rows(u32 tile_column, u32 rows)
+    {
+        Threading::MutexLocker locker { m_decoded_rows_mutex };
+        m_decoded_rows_in_tile_columns[tile_column] = rows;
+
+        auto decoded_rows = NumericLimits<u32>::max();
+        for (auto column_rows : m_decoded_rows_in_tile_columns)
+            decoded_rows = min(decoded_rows, column_rows);
+        if (decoded_rows == m_decoded_rows.load(AK::MemoryOrder::memory_order_relaxed))
+            return;
+        m_decoded_rows.store(decoded_rows, AK::MemoryOrder::memory_order_release);
+        m_decoded_rows_condition.broadcast();
+    }
+
+    // This is also called if the frame failed to decode, so that the frames reading from it don't wait forever.
+    void finish_decoding()
+    {
+        Threading::MutexLocker locker { m_decoded_rows_mutex };
+        for (auto& column_rows : m_decoded_rows_in_tile_columns)
+            column_rows = NumericLimits<u32>::max();
+        m_decoded_rows.store(NumericLimits<u32>::max(), AK::MemoryOrder::memory_order_release);
+        m_decoded_rows_condition.broadcast();
+    }
+
+    void wait_for_decoded_rows(u32 rows) const
+    {
+        if (m_decoded_rows.load(AK::MemoryOrder::memory_order_acquire) >= rows)
+            return;
+
+        Threading::MutexLocker locker { m_decoded_rows_mutex };
+        while (m_decoded_rows.load(AK::MemoryOrder::memory_order_acquire) < rows)
+            m_decoded_rows_condition.wait();
+    }
+
+private:
+    DecodedFrame() = default;
+
+    Atomic<u32> m_decoded_rows { NumericLimits<u32>::max() };
+    Vector<u32, 4> m_decoded_rows_in_tile_columns;
+    mutable Threading::Mutex m_decoded_rows_mutex;
+    mutable Threading::ConditionVariable m_decoded_rows_condition { m_decoded_rows_mutex };
+};
+
 struct ReferenceFrame {
     Gfx::Size<u32> size { 0, 0 };
     bool subsampling_x { false };
     bool subsampling_y { false };
     u8 bit_depth { 0 };
-    Array<Vector<u16>, 3> frame_planes {};
+    RefPtr<DecodedFrame> frame;
 
     bool is_valid() const { return bit_depth > 0; }
 
@@ -6,6 +6,8 @@
  */
 
 #include <AK/IntegralMath.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/TypedTransfer.h>
 #include <LibGfx/Size.h>
 #include <LibMedia/Color/CodingIndependentCodePoints.h>
@@ -20,11 +22,17 @@
 
 namespace Media::Video::VP9 {
 
-Decoder::Decoder()
+Decoder::Decoder(FrameThreading frame_threading)
     : m_parser(make<Parser>(*this))
+    , m_frame_threading(frame_threading)
 {
 }
 
+Decoder::~Decoder()
+{
+    (void)finish_pending_frames();
+}
+
 DecoderErrorOr<void> Decoder::receive_sample(Duration timestamp, ReadonlyBytes chunk_data)
 {
     auto superframe_sizes = m_parser->parse_superframe_sizes(chunk_data);
@@ -48,11 +56,33 @@ DecoderErrorOr<void> Decoder::receive_sample(Duration timestamp, ReadonlyBytes c
     return {};
 }
 
+DecoderErrorOr<void> Decoder::signal_end_of_stream()
+{
+    return finish_pending_frames();
+}
+
 DecoderErrorOr<void> Decoder::decode_frame(Duration timestamp, ReadonlyBytes frame_data)
 {
+    auto& frame = m_pending_frames[m_next_pending_frame];
+    auto& previous_frame = m_pending_frames[m_next_pending_frame ^ 1];
+
+    // The probabilities that this frame is parsed with are adapted to the symbols of the previous frame.
+    if (previous_frame.frame_context.has_value() && Parser::frame_adapts_probabilities(*previous_frame.frame_context))
+        TRY(finish_pending_frame(previous_frame));
+    VERIFY(!frame.frame_context.has_value());
+
+    // The frame is decoded after this function returns with frame threading, so its data has to be kept until then.
+    if (m_frame_threading == FrameThreading::Yes) {
+        DECODER_TRY_ALLOC(frame.data.try_resize(frame_data.size()));
+        frame_data.copy_to(frame.data.bytes());
+        frame_data = frame.data.bytes();
+    }
+
     // 1. The syntax elements for the coded frame are extracted as specified in sections 6 and 7. The syntax
     // tables include function calls indicating when the block decode processes should be triggered.
-    auto frame_context = TRY(m_parser->parse_frame(frame_data));
+    auto frame_context = TRY(m_parser->parse_frame(frame_data, TRY(take_unused_decoded_frame())));
+    frame_context.output_buffers = &frame.output_buffers;
+    TRY(allocate_buffers(frame_context));
 
     // 2. If loop_filter_level is not equal to 0, the loop filter process as specified in section 8.8 is invoked once the
     // coded frame has been decoded.
@@ -65,24 +95,109 @@ DecoderErrorOr<void> Decoder::decode_frame(Duration timestamp, ReadonlyBytes fra
     // − segmentation_update_map is equal to 1.
     // This is handled by update_reference_frames.
 
+    // 4. The output process as specified in section 8.9 is invoked.
+    // This is done once the frame is decoded, by decode_pending_frame().
+
+    // 5. The reference frame update process as specified in section 8.10 is invoked.
+    // NOTE: This is done before the frame is decoded, so that the next frame can be parsed right away. The samples
+    //       are copied into the reference frames one superblock row at a time as they are decoded.
+    TRY(update_reference_frames(frame_context));
+
+    // Everything that can fail is allocated before the frame becomes pending, as a pending frame is waited for. The
+    // decoded frame is only marked as being decoded last, so that later frames don't wait for it if this fails.
+    if (m_frame_threading == FrameThreading::Yes && !frame.frame_thread)
+        frame.frame_thread = DECODER_TRY_ALLOC(Threading::WorkerThread<DecoderError>::create("VP9 Frame"sv));
+    DECODER_TRY_ALLOC(frame_context.decoded_frame->start_decoding(1u << frame_context.log2_of_tile_counts.width()));
+
+    frame.timestamp = timestamp;
+    frame.frame_context.emplace(move(frame_context));
+
+    if (m_frame_threading == FrameThreading::No)
+        return complete_pending_frame(frame, decode_pending_frame(frame));
+
+    frame.frame_thread->start_task([this, &frame]() -> DecoderErrorOr<void> {
+        return decode_pending_frame(frame);
+    });
+    m_next_pending_frame ^= 1;
+
+    // The previous frame is output once this frame has started decoding, so that the two overlap.
+    if (previous_frame.frame_context.has_value())
+        TRY(finish_pending_frame(previous_frame));
+    return {};
+}
+
+DecoderErrorOr<void> Decoder::decode_pending_frame(PendingFrame& frame)
+{
+    auto& frame_context = *frame.frame_context;
+    auto result = m_parser->decode_tiles(frame_context, frame.tile_threads);
+
+    // The following frames wait for the rows that they read from this one, so they have to be released even if it
+    // failed to decode.
+    frame_context.decoded_frame->finish_decoding();
+    TRY(result);
+
     // 4. The output process as specified in section 8.9 is invoked.
     if (frame_context.shows_a_frame()) {
         switch (frame_context.color_config.bit_depth) {
         case 8:
-            TRY(create_video_frame<u8>(timestamp, frame_context));
+            frame.output_frame = TRY(create_video_frame<u8>(frame.timestamp, frame_context));
             break;
         case 10:
         case 12:
-            TRY(create_video_frame<u16>(timestamp, frame_context));
+            frame.output_frame = TRY(create_video_frame<u16>(frame.timestamp, frame_context));
             break;
         }
     }
+    return {};
+}
 
-    // 5. The reference frame update process as specified in section 8.10 is invoked.
-    TRY(update_reference_frames(frame_context));
+DecoderErrorOr<void> Decoder::finish_pending_frame(PendingFrame& frame)
+{
+    return complete_pending_frame(frame, frame.frame_thread->wait_until_task_is_finished());
+}
+
+DecoderErrorOr<void> Decoder::complete_pending_frame(PendingFrame& frame, DecoderErrorOr<void> decode_result)
+{
+    auto frame_context = frame.frame_context.release_value();
+    auto output_frame = move(frame.output_frame);
+    TRY(decode_result);
+
+    if (Parser::frame_adapts_probabilities(frame_context))
+        TRY(m_parser->finish_frame(frame_context));
+    if (output_frame)
+        m_video_frame_queue.enqueue(output_frame.release_nonnull());
     return {};
 }
 
+DecoderErrorOr<void> Decoder::finish_pending_frames()
+{
+    DecoderErrorOr<void> result = {};
+
+    // The frame in the next slot was started first, if both are pending.
+    for (auto index : { m_next_pending_frame, static_cast<u8>(m_next_pending_frame ^ 1) }) {
+        auto& frame = m_pending_frames[index];
+        if (!frame.frame_context.has_value())
+            continue;
+        auto frame_result = finish_pending_frame(frame);
+        if (!result.is_error() && frame_result.is_error())
+            result = frame_result.release_error();
+    }
+    return result;
+}
+
+DecoderErrorOr<NonnullRefPtr<DecodedFrame>> Decoder::take_unused_decoded_frame()
+{
+    // Frames that are not referenced anymore are reused, so that their buffers don't need to be allocated again.
+    for (auto& decoded_frame : m_decoded_frames) {
+        if (decoded_frame->ref_count() == 1)
+            return decoded_frame;
+    }
+
+    auto decoded_frame = DECODER_TRY_ALLOC(DecodedFrame::try_create());
+    DECODER_TRY_ALLOC(m_decoded_frames.try_append(decoded_frame));
+    return decoded_frame;
+}
+
 inline CodingIndependentCodePoints get_cicp_color_space(FrameContext const& frame_context)
 {
     ColorPrimaries color_primaries;
@@ -143,7 +258,7 @@ inline CodingIndependentCodePoints get_cicp_color_space(FrameContext const& fram
 }
 
 template<typename T>
-DecoderErrorOr<void> Decoder::create_video_frame(Duration timestamp, FrameContext const& frame_context)
+DecoderErrorOr<NonnullOwnPtr<VideoFrame>> Decoder::create_video_frame(Duration timestamp, FrameContext const& frame_context)
 {
     // (8.9) Output process
 
@@ -170,7 +285,7 @@ DecoderErrorOr<void> Decoder::create_video_frame(Duration timestamp, FrameContex
         auto* buffer = frame->get_plane_data<T>(plane);
         auto decoded_width = plane == 0 ? decoded_y_width : decoded_uv_width;
         auto output_size = plane == 0 ? output_y_size : output_uv_size;
-        auto const* decoded_buffer = get_output_buffer(plane).data();
+        auto const* decoded_buffer = get_output_buffer(frame_context, plane).data();
 
         for (u32 row = 0; row < output_size.height(); row++) {
             for (u32 column = 0; column < output_size.width(); column++)
@@ -178,9 +293,7 @@ DecoderErrorOr<void> Decoder::create_video_frame(Duration timestamp, FrameContex
         }
     }
 
-    m_video_frame_queue.enqueue(move(frame));
-
-    return {};
+    return frame;
 }
 
 DecoderErrorOr<void> Decoder::allocate_buffers(FrameContext const& frame_context)
@@ -188,16 +301,16 @@ DecoderErrorOr<void> Decoder::allocate_buffers(FrameContext const& frame_context
     for (size_t plane = 0; plane < 3; plane++) {
         auto size = frame_context.decoded_size(plane > 0);
 
-        auto& output_buffer = get_output_buffer(plane);
+        auto& output_buffer = get_output_buffer(frame_context, plane);
         output_buffer.clear_with_capacity();
         DECODER_TRY_ALLOC(output_buffer.try_resize_and_keep_capacity(size.width() * size.height()));
     }
     return {};
 }
 
-Vector<u16>& Decoder::get_output_buffer(u8 plane)
+Vector<u16>& Decoder::get_output_buffer(FrameContext const& frame_context, u8 plane)
 {
-    return m_output_buffers[plane];
+    return (*frame_context.output_buffers)[plane];
 }
 
 DecoderErrorOr<NonnullOwnPtr<VideoFrame>> Decoder::get_decoded_frame()
@@ -210,6 +323,7 @@ DecoderErrorOr<NonnullOwnPtr<VideoFrame>> Decoder::get_decoded_frame()
 
 void Decoder::flush()
 {
+    (void)finish_pending_frames();
     m_video_frame_queue.clear();
 }
 
@@ -220,6 +334,28 @@ static inline i32 rounded_right_shift(T value, u8 bits)
     return static_cast<i32>(value);
 }
 
+template<AK::SIMD::SIMDVector T>
+static inline T rounded_right_shift(T value, u8 bits)
+{
+    return (value + static_cast<i32>(1u << (bits - 1u))) >> bits;
+}
+
+// The 1D inverse transforms run either on a single row or column of Intermediate values, or on TransformLanes, where
+// each element holds the values at that position in four neighboring rows or columns.
+using TransformLanes = AK::SIMD::i32x4;
+
+template<typename T>
+struct TransformPrecision {
+    // (8.7.1.1) The intermediate array S and the products in the butterfly functions require higher precision.
+    using Wide = i64;
+};
+
+template<>
+struct TransformPrecision<TransformLanes> {
+    // Lanes are only used for 8-bit video, where 32 bits are enough for conformant streams, like in libvpx.
+    using Wide = TransformLanes;
+};
+
 u8 Decoder::merge_prob(u8 pre_prob, u32 count_0, u32 count_1, u8 count_sat, u8 max_update_factor)
 {
     auto total_decode_count = count_0 + count_1;
@@ -345,7 +481,7 @@ u8 Decoder::adapt_prob(u8 prob, u32 counts[2])
 
 DecoderErrorOr<void> Decoder::predict_intra(u8 plane, BlockContext const& block_context, u32 x, u32 y, bool have_left, bool have_above, bool not_on_right, TransformSize tx_size, u32 block_index)
 {
-    auto& frame_buffer = get_output_buffer(plane);
+    auto& frame_buffer = get_output_buffer(block_context.frame_context, plane);
 
     // 8.5.1 Intra prediction process
 
@@ -769,10 +905,8 @@ MotionVector Decoder::clamp_motion_vector(u8 plane, BlockContext const& block_co
 
 static constexpr i32 maximum_scaled_step = 80;
 
-DecoderErrorOr<void> Decoder::prepare_referenced_frame(Gfx::Size<u32> frame_size, u8 reference_frame_index)
+DecoderErrorOr<void> Decoder::prepare_referenced_frame(Gfx::Size<u32> frame_size, ReferenceFrame& reference_frame, u8 reference_frame_index)
 {
-    ReferenceFrame& reference_frame = m_parser->m_reference_frames[reference_frame_index];
-
     // 8.5.2.3 Motion vector scaling process
     // The inputs to this process are:
     // − a variable plane specifying which plane is being predicted,
@@ -868,8 +1002,8 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, BlockContext const&
 
     // A variable refIdx specifying which reference frame is being used is set equal to
     // ref_frame_idx[ ref_frame[ refList ] - LAST_FRAME ].
-    auto reference_frame_index = block_context.frame_context.reference_frame_indices[block_context.reference_frame_types[reference_index] - ReferenceFrameType::LastFrame];
-    auto const& reference_frame = m_parser->m_reference_frames[reference_frame_index];
+    // NOTE: The frame context keeps a copy of the reference frames in the order of ref_frame_idx.
+    auto const& reference_frame = block_context.frame_context.reference_frames[block_context.reference_frame_types[reference_index] - ReferenceFrameType::LastFrame];
 
     // Scale values range from 8192 to 262144.
     // 16384 = 1:1, higher values indicate the reference frame is larger than the current frame.
@@ -912,7 +1046,7 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, BlockContext const&
     i32 offset_scaled_block_y = (base_y << SUBPEL_BITS) + scaled_vector_y;
 
     // A variable ref specifying the reference frame contents is set equal to FrameStore[ refIdx ].
-    auto& reference_frame_buffer = reference_frame.frame_planes[plane];
+    auto& reference_frame_buffer = reference_frame.frame->reference_planes[plane];
     auto reference_frame_width = Subsampling::subsampled_size(subsampling_x, reference_frame.size.width()) + MV_BORDER * 2;
 
     // The variable lastX is set equal to ( (RefFrameWidth[ refIdx ] + subX) >> subX) - 1.
@@ -945,6 +1079,10 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, BlockContext const&
     auto const last_possible_reference_index = reference_index_for_row(subpixel_row_from_reference_row(intermediate_height - sample_offset));
     VERIFY(reference_frame_buffer.size() >= last_possible_reference_index);
 
+    // The reference frame may still be decoding on another thread, so wait until the rows we read are there.
+    auto const reference_rows_end = subpixel_row_from_reference_row(intermediate_height - sample_offset) << subsampling_y;
+    reference_frame.frame->wait_for_decoded_rows(clamp(reference_rows_end, 1, static_cast<i32>(reference_frame.size.height())));
+
     VERIFY(block_buffer.size() >= static_cast<size_t>(width) * height);
 
     auto const reference_block_x = MV_BORDER + (offset_scaled_block_x >> SUBPEL_BITS);
@@ -965,12 +1103,8 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, BlockContext const&
     auto const bit_depth = block_context.frame_context.color_config.bit_depth;
     auto const* reference_start = reference_frame_buffer.data() + reference_block_y * reference_frame_width + reference_block_x;
 
-    // FIXME: We are using 16-bit products to vectorize the filter loops, but when filtering in a high bit-depth video, they will truncate.
-    //        Instead of hardcoding them, we should have the bit depth as a template parameter, and the accumulators can select a size based
-    //        on whether the bit depth > 8.
-    //        Note that we only get a benefit from this on the default CPU target. If we enable AVX2 here, we may want to specialize the
-    //        function for the CPU target and remove the cast to i16 so that it doesn't have to truncate on AVX2, where it can do the full
-    //        unrolled 32-bit product loops in one vector.
+    // FIXME: Only 8-bit video takes the vectorized paths below. High bit-depth video could use the same filter loops, as the
+    //        accumulators are 32 bits wide.
 
     if (unscaled_x && unscaled_y && bit_depth == 8) {
         if (copy_x && copy_y) {
@@ -987,23 +1121,38 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, BlockContext const&
             return {};
         }
 
-        auto horizontal_convolution_unscaled = [](auto bit_depth, auto* destination, auto width, auto height, auto const* source, auto source_stride, auto filter, auto subpixel_x) {
+        // OPTIMIZATION: Four output samples are filtered at once. In 8-bit video, no product of a filter tap and a sample
+        //               exceeds 16 bits, so this produces the same results as truncating the products to i16.
+        using FilterLanes = AK::SIMD::i32x4;
+        constexpr auto lane_count = AK::SIMD::vector_length<FilterLanes>;
+        auto round_and_clip_lanes = [](auto bit_depth, FilterLanes accumulated_samples) {
+            auto result = rounded_right_shift(accumulated_samples, 7);
+            auto const max = AK::SIMD::expand4(static_cast<i32>((1u << bit_depth) - 1u));
+            result = result < 0 ? AK::SIMD::expand4(0) : result;
+            result = result > max ? max : result;
+            return AK::SIMD::simd_cast<AK::SIMD::u16x4>(result);
+        };
+
+        auto horizontal_convolution_unscaled = [&](auto bit_depth, auto* destination, auto width, auto height, auto const* source, auto source_stride, auto filter, auto subpixel_x) {
             source -= sample_offset;
-            auto const source_end_skip = source_stride - width;
+            auto const& taps = subpel_filters[filter][subpixel_x];
 
             for (auto row = 0u; row < height; row++) {
-                for (auto column = 0u; column < width; column++) {
+                auto column = 0u;
+                for (; column + lane_count <= width; column += lane_count) {
+                    FilterLanes accumulated_samples {};
+                    for (auto t = 0; t < 8; t++)
+                        accumulated_samples += taps[t] * AK::SIMD::simd_cast<FilterLanes>(AK::SIMD::load_unaligned<AK::SIMD::u16x4>(source + column + t));
+                    AK::SIMD::store_unaligned(destination + column, round_and_clip_lanes(bit_depth, accumulated_samples));
+                }
+                for (; column < width; column++) {
                     i32 accumulated_samples = 0;
-                    for (auto t = 0; t < 8; t++) {
-                        auto sample = source[t];
-                        accumulated_samples += static_cast<i16>(subpel_filters[filter][subpixel_x][t] * sample);
-                    }
-
-                    *destination = clip_1(bit_depth, rounded_right_shift(accumulated_samples, 7));
-                    source++;
-                    destination++;
+                    for (auto t = 0; t < 8; t++)
+                        accumulated_samples += static_cast<i16>(taps[t] * source[column + t]);
+                    destination[column] = clip_1(bit_depth, rounded_right_shift(accumulated_samples, 7));
                 }
-                source += source_end_skip;
+                source += source_stride;
+                destination += width;
             }
         };
 
@@ -1012,23 +1161,25 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, BlockContext const&
             return {};
         }
 
-        auto vertical_convolution_unscaled = [](auto bit_depth, auto* destination, auto width, auto height, auto const* source, auto source_stride, auto filter, auto subpixel_y) {
-            auto const source_end_skip = source_stride - width;
+        auto vertical_convolution_unscaled = [&](auto bit_depth, auto* destination, auto width, auto height, auto const* source, auto source_stride, auto filter, auto subpixel_y) {
+            auto const& taps = subpel_filters[filter][subpixel_y];
 
             for (auto row = 0u; row < height; row++) {
-                for (auto column = 0u; column < width; column++) {
-                    auto const* scan_column = source;
+                auto column = 0u;
+                for (; column + lane_count <= width; column += lane_count) {
+                    FilterLanes accumulated_samples {};
+                    for (auto t = 0; t < 8; t++)
+                        accumulated_samples += taps[t] * AK::SIMD::simd_cast<FilterLanes>(AK::SIMD::load_unaligned<AK::SIMD::u16x4>(source + t * source_stride + column));
+                    AK::SIMD::store_unaligned(destination + column, round_and_clip_lanes(bit_depth, accumulated_samples));
+                }
+                for (; column < width; column++) {
                     i32 accumulated_samples = 0;
-                    for (auto t = 0; t < 8; t++) {
-                        auto sample = *scan_column;
-                        accumulated_samples += static_cast<i16>(subpel_filters[filter][subpixel_y][t] * sample);
-                        scan_column += source_stride;
-                    }
-                    *destination = clip_1(bit_depth, rounded_right_shift(accumulated_samples, 7));
-                    source++;
-                    destination++;
+                    for (auto t = 0; t < 8; t++)
+                        accumulated_samples += static_cast<i16>(taps[t] * source[t * source_stride + column]);
+                    destination[column] = clip_1(bit_depth, rounded_right_shift(accumulated_samples, 7));
                 }
-                source += source_end_skip;
+                source += source_stride;
+                destination += width;
             }
         };
 
@@ -1117,7 +1268,7 @@ DecoderErrorOr<void> Decoder::predict_inter(u8 plane, BlockContext const& block_
     // 6. If isCompound is equal to 1, then the variable refList is set equal to 1 and steps 2, 3, 4 and 5 are repeated
     // to form the prediction for the second reference.
     // The inter predicted samples are then derived as follows:
-    auto& frame_buffer = get_output_buffer(plane);
+    auto& frame_buffer = get_output_buffer(block_context.frame_context, plane);
     VERIFY(!frame_buffer.is_empty());
     auto frame_size = block_context.frame_context.decoded_size(plane > 0);
     auto frame_buffer_at = [&](u32 row, u32 column) -> u16& {
@@ -1280,7 +1431,7 @@ DecoderErrorOr<void> Decoder::reconstruct_templated(u8 plane, BlockContext const
 
     // 4. CurrFrame[ plane ][ y + i ][ x + j ] is set equal to Clip1( CurrFrame[ plane ][ y + i ][ x + j ] + Dequant[ i ][ j ] )
     //    for i = 0..(n0-1) and j = 0..(n0-1).
-    auto& current_buffer = get_output_buffer(plane);
+    auto& current_buffer = get_output_buffer(block_context.frame_context, plane);
     auto frame_size = block_context.frame_context.decoded_size(plane > 0);
     auto width_in_frame_buffer = min(block_size, frame_size.width() - transform_block_x);
     auto height_in_frame_buffer = min(block_size, frame_size.height() - transform_block_y);
@@ -1348,14 +1499,16 @@ inline i32 Decoder::sin64(u8 angle)
 }
 
 // (8.7.1.1) The function B( a, b, angle, 0 ) performs a butterfly rotation.
-inline void Decoder::butterfly_rotation_in_place(Span<Intermediate> data, size_t index_a, size_t index_b, u8 angle, bool flip)
+template<typename T>
+inline void Decoder::butterfly_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, u8 angle, bool flip)
 {
+    using Wide = typename TransformPrecision<T>::Wide;
     auto cos = cos64(angle);
     auto sin = sin64(angle);
     // 1. The variable x is set equal to T[ a ] * cos64( angle ) - T[ b ] * sin64( angle ).
-    i64 rotated_a = static_cast<i64>(data[index_a]) * cos - static_cast<i64>(data[index_b]) * sin;
+    Wide rotated_a = static_cast<Wide>(data[index_a]) * cos - static_cast<Wide>(data[index_b]) * sin;
     // 2. The variable y is set equal to T[ a ] * sin64( angle ) + T[ b ] * cos64( angle ).
-    i64 rotated_b = static_cast<i64>(data[index_a]) * sin + static_cast<i64>(data[index_b]) * cos;
+    Wide rotated_b = static_cast<Wide>(data[index_a]) * sin + static_cast<Wide>(data[index_b]) * cos;
     // 3. T[ a ] is set equal to Round2( x, 14 ).
     data[index_a] = rounded_right_shift(rotated_a, 14);
     // 4. T[ b ] is set equal to Round2( y, 14 ).
@@ -1374,7 +1527,8 @@ inline void Decoder::butterfly_rotation_in_place(Span<Intermediate> data, size_t
 }
 
 // (8.7.1.1) The function H( a, b, 0 ) performs a Hadamard rotation.
-inline void Decoder::hadamard_rotation_in_place(Span<Intermediate> data, size_t index_a, size_t index_b, bool flip)
+template<typename T>
+inline void Decoder::hadamard_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, bool flip)
 {
     // The function H( a, b, 1 ) performs a Hadamard rotation with flipped indices and is specified as follows:
     // 1. The function H( b, a, 0 ) is invoked.
@@ -1398,8 +1552,8 @@ inline void Decoder::hadamard_rotation_in_place(Span<Intermediate> data, size_t
     // to allow these bounds to be violated. Therefore, we can avoid the performance cost here.
 }
 
-template<u8 log2_of_block_size>
-inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_permutation(Span<Intermediate> data)
+template<u8 log2_of_block_size, typename T>
+inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_permutation(Span<T> data)
 {
     static_assert(log2_of_block_size >= 2 && log2_of_block_size <= 5, "Block size out of range.");
 
@@ -1411,8 +1565,8 @@ inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_per
         return DecoderError::corrupted("Block size was out of range"sv);
 
     // 1.1. A temporary array named copyT is set equal to T.
-    Array<Intermediate, block_size> data_copy;
-    AK::TypedTransfer<Intermediate>::copy(data_copy.data(), data.data(), block_size);
+    Array<T, block_size> data_copy;
+    AK::TypedTransfer<T>::copy(data_copy.data(), data.data(), block_size);
 
     // 1.2. T[ i ] is set equal to copyT[ brev( n, i ) ] for i = 0..((1<<n) - 1).
     for (auto i = 0u; i < block_size; i++)
@@ -1421,8 +1575,8 @@ inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_per
     return {};
 }
 
-template<u8 log2_of_block_size>
-ALWAYS_INLINE DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform(Span<Intermediate> data)
+template<u8 log2_of_block_size, typename T>
+ALWAYS_INLINE DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform(Span<T> data)
 {
     static_assert(log2_of_block_size >= 2 && log2_of_block_size <= 5, "Block size out of range.");
 
@@ -1522,8 +1676,8 @@ ALWAYS_INLINE DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform(Sp
     return {};
 }
 
-template<u8 log2_of_block_size>
-inline void Decoder::inverse_asymmetric_discrete_sine_transform_input_array_permutation(Span<Intermediate> data)
+template<u8 log2_of_block_size, typename T>
+inline void Decoder::inverse_asymmetric_discrete_sine_transform_input_array_permutation(Span<T> data)
 {
     // The variable n0 is set equal to 1<<n.
     constexpr auto block_size = 1u << log2_of_block_size;
@@ -1531,8 +1685,8 @@ inline void Decoder::inverse_asymmetric_discrete_sine_transform_input_array_perm
     // We can iterate by 2 at a time instead of taking half block size.
 
     // A temporary array named copyT is set equal to T.
-    Array<Intermediate, block_size> data_copy;
-    AK::TypedTransfer<Intermediate>::copy(data_copy.data(), data.data(), block_size);
+    Array<T, block_size> data_copy;
+    AK::TypedTransfer<T>::copy(data_copy.data(), data.data(), block_size);
 
     // The values at even locations T[ 2 * i ] are set equal to copyT[ n0 - 1 - 2 * i ] for i = 0..(n1-1).
     // The values at odd locations T[ 2 * i + 1 ] are set equal to copyT[ 2 * i ] for i = 0..(n1-1).
@@ -1542,14 +1696,14 @@ inline void Decoder::inverse_asymmetric_discrete_sine_transform_input_array_perm
     }
 }
 
-template<u8 log2_of_block_size>
-inline void Decoder::inverse_asymmetric_discrete_sine_transform_output_array_permutation(Span<Intermediate> data)
+template<u8 log2_of_block_size, typename T>
+inline void Decoder::inverse_asymmetric_discrete_sine_transform_output_array_permutation(Span<T> data)
 {
     auto block_size = 1u << log2_of_block_size;
 
     // A temporary array named copyT is set equal to T.
-    Array<Intermediate, maximum_transform_size> data_copy;
-    AK::TypedTransfer<Intermediate>::copy(data_copy.data(), data.data(), block_size);
+    Array<T, 1u << log2_of_block_size> data_copy;
+    AK::TypedTransfer<T>::copy(data_copy.data(), data.data(), block_size);
 
     // The permutation depends on n as follows:
     if (log2_of_block_size == 4) {
@@ -1573,32 +1727,34 @@ inline void Decoder::inverse_asymmetric_discrete_sine_transform_output_array_per
     }
 }
 
-inline void Decoder::inverse_asymmetric_discrete_sine_transform_4(Span<Intermediate> data)
+template<typename T>
+inline void Decoder::inverse_asymmetric_discrete_sine_transform_4(Span<T> data)
 {
+    using Wide = typename TransformPrecision<T>::Wide;
     VERIFY(data.size() == 4);
-    i64 const sinpi_1_9 = 5283;
-    i64 const sinpi_2_9 = 9929;
-    i64 const sinpi_3_9 = 13377;
-    i64 const sinpi_4_9 = 15212;
+    i32 const sinpi_1_9 = 5283;
+    i32 const sinpi_2_9 = 9929;
+    i32 const sinpi_3_9 = 13377;
+    i32 const sinpi_4_9 = 15212;
 
     // Steps are derived from pseudocode in (8.7.1.6):
     // s0 = SINPI_1_9 * T[ 0 ]
-    i64 s0 = sinpi_1_9 * data[0];
+    Wide s0 = static_cast<Wide>(data[0]) * sinpi_1_9;
     // s1 = SINPI_2_9 * T[ 0 ]
-    i64 s1 = sinpi_2_9 * data[0];
+    Wide s1 = static_cast<Wide>(data[0]) * sinpi_2_9;
     // s2 = SINPI_3_9 * T[ 1 ]
-    i64 s2 = sinpi_3_9 * data[1];
+    Wide s2 = static_cast<Wide>(data[1]) * sinpi_3_9;
     // s3 = SINPI_4_9 * T[ 2 ]
-    i64 s3 = sinpi_4_9 * data[2];
+    Wide s3 = static_cast<Wide>(data[2]) * sinpi_4_9;
     // s4 = SINPI_1_9 * T[ 2 ]
-    i64 s4 = sinpi_1_9 * data[2];
+    Wide s4 = static_cast<Wide>(data[2]) * sinpi_1_9;
     // s5 = SINPI_2_9 * T[ 3 ]
-    i64 s5 = sinpi_2_9 * data[3];
+    Wide s5 = static_cast<Wide>(data[3]) * sinpi_2_9;
     // s6 = SINPI_4_9 * T[ 3 ]
-    i64 s6 = sinpi_4_9 * data[3];
+    Wide s6 = static_cast<Wide>(data[3]) * sinpi_4_9;
     // v = T[ 0 ] - T[ 2 ] + T[ 3 ]
     // s7 = SINPI_3_9 * v
-    i64 s7 = sinpi_3_9 * (data[0] - data[2] + data[3]);
+    Wide s7 = static_cast<Wide>(data[0] - data[2] + data[3]) * sinpi_3_9;
 
     // x0 = s0 + s3 + s5
     auto x0 = s0 + s3 + s5;
@@ -1671,15 +1827,17 @@ inline void Decoder::hadamard_rotation(Span<S> source, Span<D> destination, size
     destination[index_b] = rounded_right_shift(a - b, 14);
 }
 
-inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_8(Span<Intermediate> data)
+template<typename T>
+inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_8(Span<T> data)
 {
+    using Wide = typename TransformPrecision<T>::Wide;
     VERIFY(data.size() == 8);
     // This process does an in-place transform of the array T using:
 
     // A higher precision array S for intermediate results.
     // (8.7.1.1) NOTE - The values in array S require higher precision to avoid overflow. Using signed integers with
     // 24 + BitDepth bits of precision is enough to avoid overflow.
-    Array<i64, 8> high_precision_temp;
+    Array<Wide, 8> high_precision_temp;
 
     // The following ordered steps apply:
 
@@ -1722,8 +1880,10 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
     return {};
 }
 
-inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_16(Span<Intermediate> data)
+template<typename T>
+inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_16(Span<T> data)
 {
+    using Wide = typename TransformPrecision<T>::Wide;
     VERIFY(data.size() == 16);
     // This process does an in-place transform of the array T using:
 
@@ -1731,7 +1891,7 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
     // (8.7.1.1) The inverse asymmetric discrete sine transforms also make use of an intermediate array named S.
     // The values in this array require higher precision to avoid overflow. Using signed integers with 24 +
     // BitDepth bits of precision is enough to avoid overflow.
-    Array<i64, 16> high_precision_temp;
+    Array<Wide, 16> high_precision_temp;
 
     // The following ordered steps apply:
 
@@ -1789,8 +1949,8 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
     return {};
 }
 
-template<u8 log2_of_block_size>
-inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform(Span<Intermediate> data)
+template<u8 log2_of_block_size, typename T>
+inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform(Span<T> data)
 {
     // 8.7.1.9 Inverse ADST Process
 
@@ -1820,6 +1980,10 @@ ALWAYS_INLINE DecoderErrorOr<void> Decoder::inverse_transform_2d(BlockContext co
     // This process performs a 2D inverse transform for an array of size 2^n by 2^n stored in the 2D array Dequant.
     // The input to this process is a variable n (log2_of_block_size) that specifies the base 2 logarithm of the width of the transform.
 
+    // OPTIMIZATION: 8-bit lossy blocks are transformed several rows or columns at a time, see TransformPrecision.
+    if (block_context.frame_context.color_config.bit_depth == 8 && !block_context.frame_context.lossless)
+        return inverse_transform_2d_in_lanes<log2_of_block_size>(dequantized, transform_set);
+
     // 1. Set the variable n0 (block_size) equal to 1 << n.
     constexpr auto block_size = 1u << log2_of_block_size;
 
@@ -1911,6 +2075,60 @@ ALWAYS_INLINE DecoderErrorOr<void> Decoder::inverse_transform_2d(BlockContext co
     return {};
 }
 
+template<u8 log2_of_block_size, typename T>
+ALWAYS_INLINE DecoderErrorOr<void> Decoder::inverse_transform_1d(Span<T> data, TransformType transform_type)
+{
+    switch (transform_type) {
+    case TransformType::DCT:
+        TRY(inverse_discrete_cosine_transform_array_permutation<log2_of_block_size>(data));
+        return inverse_discrete_cosine_transform<log2_of_block_size>(data);
+    case TransformType::ADST:
+        return inverse_asymmetric_discrete_sine_transform<log2_of_block_size>(data);
+    default:
+        return DecoderError::corrupted("Unknown tx_type"sv);
+    }
+}
+
+template<u8 log2_of_block_size>
+ALWAYS_INLINE DecoderErrorOr<void> Decoder::inverse_transform_2d_in_lanes(Span<Intermediate> dequantized, TransformSet transform_set)
+{
+    // This follows the steps of inverse_transform_2d() for a lossy frame, but runs the 1D transforms on TransformLanes.
+    constexpr auto block_size = 1u << log2_of_block_size;
+    constexpr auto lane_count = AK::SIMD::vector_length<TransformLanes>;
+    static_assert(block_size % lane_count == 0);
+
+    Array<TransformLanes, block_size> lanes;
+
+    // 2. The row transforms are applied to lane_count rows at once, lane k of T[ j ] holding Dequant[ i + k ][ j ].
+    for (auto i = 0u; i < block_size; i += lane_count) {
+        for (auto j = 0u; j < block_size; j++) {
+            for (auto k = 0u; k < lane_count; k++)
+                lanes[j][k] = dequantized[(i + k) * block_size + j];
+        }
+
+        TRY(inverse_transform_1d<log2_of_block_size>(lanes.span(), transform_set.second_transform));
+
+        for (auto j = 0u; j < block_size; j++) {
+            for (auto k = 0u; k < lane_count; k++)
+                dequantized[(i + k) * block_size + j] = lanes[j][k];
+        }
+    }
+
+    // 3. The column transforms are applied to lane_count columns at once, lane k of T[ i ] holding Dequant[ i ][ j + k ].
+    for (auto j = 0u; j < block_size; j += lane_count) {
+        for (auto i = 0u; i < block_size; i++)
+            lanes[i] = AK::SIMD::load_unaligned<TransformLanes>(&dequantized[i * block_size + j]);
+
+        TRY(inverse_transform_1d<log2_of_block_size>(lanes.span(), transform_set.first_transform));
+
+        // 6. Dequant[ i ][ j ] is set equal to Round2( T[ i ], Min( 6, n + 2 ) ) for i = 0..(n0-1).
+        for (auto i = 0u; i < block_size; i++)
+            AK::SIMD::store_unaligned(&dequantized[i * block_size + j], rounded_right_shift(lanes[i], min(6, log2_of_block_size + 2)));
+    }
+
+    return {};
+}
+
 DecoderErrorOr<void> Decoder::update_reference_frames(FrameContext const& frame_context)
 {
     // This process is invoked as the final step in decoding a frame.
@@ -1918,6 +2136,24 @@ DecoderErrorOr<void> Decoder::update_reference_frames(FrameContext const& frame_
     // The output from this process is an updated set of reference frames and previous motion vectors.
     // The following ordered steps apply:
 
+    auto& decoded_frame = *frame_context.decoded_frame;
+
+    // The reference frames are sized before any of them refers to this frame, so that inter prediction from them can
+    // always rely on their size.
+    if (frame_context.reference_frames_to_update_flags != 0) {
+        for (auto plane = 0u; plane < 3; plane++) {
+            auto width = frame_context.size().width();
+            auto height = frame_context.size().height();
+            if (plane > 0) {
+                width = Subsampling::subsampled_size(frame_context.color_config.subsampling_x, width);
+                height = Subsampling::subsampled_size(frame_context.color_config.subsampling_y, height);
+            }
+            auto frame_store_width = width + MV_BORDER * 2;
+            auto frame_store_height = height + MV_BORDER * 2;
+            DECODER_TRY_ALLOC(decoded_frame.reference_planes[plane].try_resize_and_keep_capacity(frame_store_width * frame_store_height));
+        }
+    }
+
     // 1. For each value of i from 0 to NUM_REF_FRAMES - 1, the following applies if bit i of refresh_frame_flags
     // is equal to 1 (i.e. if (refresh_frame_flags>>i)&1 is equal to 1):
     for (u8 i = 0; i < NUM_REF_FRAMES; i++) {
@@ -1939,57 +2175,14 @@ DecoderErrorOr<void> Decoder::update_reference_frames(FrameContext const& frame_
             // − FrameStore[ i ][ plane ][ y ][ x ] is set equal to CurrFrame[ plane ][ y ][ x ] for plane = 1..2, for x =
             // 0..((FrameWidth+subsampling_x) >> subsampling_x)-1, for y = 0..((FrameHeight+subsampling_y) >>
             // subsampling_y)-1.
-
-            // FIXME: Frame width is not equal to the buffer's stride. If we store the stride of the buffer with the reference
-            //        frame, we can just copy the framebuffer data instead. Alternatively, we should crop the output framebuffer.
-            for (auto plane = 0u; plane < 3; plane++) {
-                auto width = frame_context.size().width();
-                auto height = frame_context.size().height();
-                auto stride = frame_context.decoded_size(plane > 0).width();
-                if (plane > 0) {
-                    width = Subsampling::subsampled_size(frame_context.color_config.subsampling_x, width);
-                    height = Subsampling::subsampled_size(frame_context.color_config.subsampling_y, height);
-                }
-
-                auto const& original_buffer = get_output_buffer(plane);
-                auto& frame_store_buffer = reference_frame.frame_planes[plane];
-                auto frame_store_width = width + MV_BORDER * 2;
-                auto frame_store_height = height + MV_BORDER * 2;
-                frame_store_buffer.resize_and_keep_capacity(frame_store_width * frame_store_height);
-
-                VERIFY(original_buffer.size() >= width * height);
-                for (auto destination_y = 0u; destination_y < frame_store_height; destination_y++) {
-                    // Offset the source row by the motion vector border and then clamp it to the range of 0...height.
-                    // This will create an extended border on the top and bottom of the reference frame to avoid having to bounds check
-                    // inter-prediction.
-                    auto source_y = min(destination_y >= MV_BORDER ? destination_y - MV_BORDER : 0, height - 1);
-                    auto const* source = &original_buffer[source_y * stride];
-                    auto* destination = &frame_store_buffer[destination_y * frame_store_width + MV_BORDER];
-                    AK::TypedTransfer<RemoveReference<decltype(*destination)>>::copy(destination, source, width);
-                }
-
-                for (auto destination_y = 0u; destination_y < frame_store_height; destination_y++) {
-                    // Stretch the leftmost samples out into the border.
-                    auto sample = frame_store_buffer[destination_y * frame_store_width + MV_BORDER];
-
-                    for (auto destination_x = 0u; destination_x < MV_BORDER; destination_x++) {
-                        frame_store_buffer[destination_y * frame_store_width + destination_x] = sample;
-                    }
-
-                    // Stretch the rightmost samples out into the border.
-                    sample = frame_store_buffer[destination_y * frame_store_width + MV_BORDER + width - 1];
-
-                    for (auto destination_x = MV_BORDER + width; destination_x < frame_store_width; destination_x++) {
-                        frame_store_buffer[destination_y * frame_store_width + destination_x] = sample;
-                    }
-                }
-            }
+            // NOTE: All the reference frames that are refreshed share the decoded frame's samples, which are copied
+            //       into it by copy_superblock_row_to_reference_frame().
+            reference_frame.frame = decoded_frame;
         }
     }
 
     // 2. If show_existing_frame is equal to 0, the following applies:
     if (!frame_context.shows_existing_frame()) {
-        DECODER_TRY_ALLOC(m_parser->m_previous_block_contexts.try_resize_to_match_other_vector2d(frame_context.block_contexts()));
         // − PrevRefFrames[ row ][ col ][ list ] is set equal to RefFrames[ row ][ col ][ list ] for row = 0..MiRows-1,
         // for col = 0..MiCols-1, for list = 0..1.
         // − PrevMvs[ row ][ col ][ list ][ comp ] is set equal to Mvs[ row ][ col ][ list ][ comp ] for row = 0..MiRows-1,
@@ -2000,16 +2193,79 @@ DecoderErrorOr<void> Decoder::update_reference_frames(FrameContext const& frame_
         //   − show_existing_frame is equal to 0,
         //   − segmentation_enabled is equal to 1,
         //   − segmentation_update_map is equal to 1.
-        bool keep_segment_ids = !frame_context.shows_existing_frame() && frame_context.segmentation_enabled && frame_context.use_full_segment_id_tree;
-        frame_context.block_contexts().copy_to(m_parser->m_previous_block_contexts, [keep_segment_ids](FrameBlockContext context) {
-            auto persistent_context = PersistentBlockContext(context);
-            if (!keep_segment_ids)
-                persistent_context.segment_id = 0;
-            return persistent_context;
-        });
+        // NOTE: The next frame reads these from the decoded frame's block contexts.
+        decoded_frame.keeps_segment_ids = frame_context.segmentation_enabled && frame_context.use_full_segment_id_tree;
+        m_parser->m_previous_frame = decoded_frame;
     }
 
     return {};
 }
 
+void Decoder::copy_superblock_row_to_reference_frame(TileContext const& tile_context, u32 row_start, u32 row_end)
+{
+    auto const& frame_context = tile_context.frame_context;
+    if (frame_context.reference_frames_to_update_flags == 0)
+        return;
+
+    auto& decoded_frame = *frame_context.decoded_frame;
+    auto frame_size = frame_context.size();
+    auto luma_row_start = blocks_to_pixels(row_start);
+    auto luma_row_end = min(blocks_to_pixels(row_end), frame_size.height());
+    auto luma_column_start = blocks_to_pixels(tile_context.columns_start);
+    auto luma_column_end = min(blocks_to_pixels(tile_context.columns_end), frame_size.width());
+    if (luma_row_start >= luma_row_end || luma_column_start >= luma_column_end)
+        return;
+
+    // Each tile column copies its own part of the superblock row. The first and last tile columns extend it into the
+    // left and right borders.
+    bool is_first_column = tile_context.columns_start == 0;
+    bool is_last_column = tile_context.columns_end == frame_context.columns();
+
+    for (auto plane = 0u; plane < 3; plane++) {
+        auto subsampling_x = plane > 0 && frame_context.color_config.subsampling_x;
+        auto subsampling_y = plane > 0 && frame_context.color_config.subsampling_y;
+        auto width = Subsampling::subsampled_size(subsampling_x, frame_size.width());
+        auto height = Subsampling::subsampled_size(subsampling_y, frame_size.height());
+        auto row_start = luma_row_start >> subsampling_y;
+        auto row_end = luma_row_end == frame_size.height() ? height : luma_row_end >> subsampling_y;
+        auto column_start = luma_column_start >> subsampling_x;
+        auto column_end = luma_column_end == frame_size.width() ? width : luma_column_end >> subsampling_x;
+
+        // FIXME: Frame width is not equal to the buffer's stride. If we store the stride of the buffer with the reference
+        //        frame, we can just copy the framebuffer data instead. Alternatively, we should crop the output framebuffer.
+        auto const& original_buffer = get_output_buffer(frame_context, plane);
+        auto stride = frame_context.decoded_size(plane > 0).width();
+        VERIFY(original_buffer.size() >= (height - 1) * stride + width);
+        auto& frame_store_buffer = decoded_frame.reference_planes[plane];
+        auto frame_store_width = width + MV_BORDER * 2;
+
+        for (auto row = row_start; row < row_end; row++) {
+            auto const* source = &original_buffer[row * stride];
+            auto* destination = &frame_store_buffer[(MV_BORDER + row) * frame_store_width];
+            AK::TypedTransfer<u16>::copy(destination + MV_BORDER + column_start, source + column_start, column_end - column_start);
+
+            // Stretch the leftmost and rightmost samples out into the border.
+            for (auto destination_x = 0u; destination_x < MV_BORDER; destination_x++) {
+                if (is_first_column)
+                    destination[destination_x] = source[0];
+                if (is_last_column)
+                    destination[MV_BORDER + width + destination_x] = source[width - 1];
+            }
+        }
+
+        // Repeat the top and bottom rows into the border to avoid having to bounds check inter-prediction.
+        auto border_column_start = is_first_column ? 0 : MV_BORDER + column_start;
+        auto border_column_end = is_last_column ? frame_store_width : MV_BORDER + column_end;
+        auto copy_row_into_border = [&](u32 source_row, u32 first_destination_row, u32 last_destination_row) {
+            auto const* source = &frame_store_buffer[source_row * frame_store_width + border_column_start];
+            for (auto destination_row = first_destination_row; destination_row < last_destination_row; destination_row++)
+                AK::TypedTransfer<u16>::copy(&frame_store_buffer[destination_row * frame_store_width + border_column_start], source, border_column_end - border_column_start);
+        };
+        if (row_start == 0)
+            copy_row_into_border(MV_BORDER, 0, MV_BORDER);
+        if (row_end == height)
+            copy_row_into_border(MV_BORDER + height - 1, MV_BORDER + height, MV_BORDER * 2 + height);
+    }
+}
+
 }
@@ -7,16 +7,20 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Error.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
 #include <AK/Queue.h>
 #include <AK/Span.h>
 #include <LibMedia/Color/CodingIndependentCodePoints.h>
 #include <LibMedia/DecoderError.h>
 #include <LibMedia/VideoDecoder.h>
 #include <LibMedia/VideoFrame.h>
+#include <LibThreading/WorkerThread.h>
 
+#include "Context.h"
 #include "Parser.h"
 
 namespace Media::Video::VP9 {
@@ -25,10 +29,19 @@ class Decoder final : public VideoDecoder {
     friend class Parser;
 
 public:
-    Decoder();
-    ~Decoder() override { }
+    // With frame threading, each frame is decoded on a thread of its own while the next frame is being parsed and
+    // decoded, so the output of a frame is only available once the following sample has been received, or once
+    // signal_end_of_stream() has been called.
+    enum class FrameThreading {
+        No,
+        Yes,
+    };
+
+    explicit Decoder(FrameThreading = FrameThreading::No);
+    ~Decoder() override;
     /* (8.1) General */
     DecoderErrorOr<void> receive_sample(Duration timestamp, ReadonlyBytes) override;
+    DecoderErrorOr<void> signal_end_of_stream() override;
 
     DecoderErrorOr<NonnullOwnPtr<VideoFrame>> get_decoded_frame() override;
 
@@ -43,12 +56,30 @@ private:
     // Based on the maximum for TXSize.
     static constexpr size_t maximum_transform_size = 32ULL * 32ULL;
 
+    // A frame whose headers have been parsed, and whose tiles are being decoded.
+    struct PendingFrame {
+        Duration timestamp;
+        Optional<FrameContext> frame_context;
+        OwnPtr<VideoFrame> output_frame;
+
+        // These are kept between frames, so that they don't have to be created for every frame.
+        ByteBuffer data;
+        Array<Vector<u16>, 3> output_buffers;
+        OwnPtr<Threading::WorkerThread<DecoderError>> frame_thread;
+        Vector<NonnullOwnPtr<Threading::WorkerThread<DecoderError>>> tile_threads;
+    };
+
     DecoderErrorOr<void> decode_frame(Duration timestamp, ReadonlyBytes);
+    DecoderErrorOr<void> decode_pending_frame(PendingFrame&);
+    DecoderErrorOr<void> finish_pending_frame(PendingFrame&);
+    DecoderErrorOr<void> complete_pending_frame(PendingFrame&, DecoderErrorOr<void> decode_result);
+    DecoderErrorOr<void> finish_pending_frames();
+    DecoderErrorOr<NonnullRefPtr<DecodedFrame>> take_unused_decoded_frame();
     template<typename T>
-    DecoderErrorOr<void> create_video_frame(Duration timestamp, FrameContext const&);
+    DecoderErrorOr<NonnullOwnPtr<VideoFrame>> create_video_frame(Duration timestamp, FrameContext const&);
 
     DecoderErrorOr<void> allocate_buffers(FrameContext const&);
-    Vector<u16>& get_output_buffer(u8 plane);
+    Vector<u16>& get_output_buffer(FrameContext const&, u8 plane);
 
     /* (8.4) Probability Adaptation Process */
     u8 merge_prob(u8 pre_prob, u32 count_0, u32 count_1, u8 count_sat, u8 max_update_factor);
@@ -62,7 +93,7 @@ private:
     // (8.5.1) Intra prediction process
     DecoderErrorOr<void> predict_intra(u8 plane, BlockContext const& block_context, u32 x, u32 y, bool have_left, bool have_above, bool not_on_right, TransformSize transform_size, u32 block_index);
 
-    DecoderErrorOr<void> prepare_referenced_frame(Gfx::Size<u32> frame_size, u8 reference_frame_index);
+    DecoderErrorOr<void> prepare_referenced_frame(Gfx::Size<u32> frame_size, ReferenceFrame&, u8 reference_frame_index);
 
     // (8.5.1) Inter prediction process
     DecoderErrorOr<void> predict_inter(u8 plane, BlockContext const& block_context, u32 x, u32 y, u32 width, u32 height, u32 block_index);
@@ -90,6 +121,11 @@ private:
     // (8.7) Inverse transform process
     template<u8 log2_of_block_size>
     DecoderErrorOr<void> inverse_transform_2d(BlockContext const&, Span<Intermediate> dequantized, TransformSet);
+    // The same process for 8-bit lossy frames, transforming several rows or columns at once.
+    template<u8 log2_of_block_size>
+    DecoderErrorOr<void> inverse_transform_2d_in_lanes(Span<Intermediate> dequantized, TransformSet);
+    template<u8 log2_of_block_size, typename T>
+    DecoderErrorOr<void> inverse_transform_1d(Span<T> data, TransformType);
 
     // (8.7.1) 1D Transforms
     // (8.7.1.1) Butterfly functions
@@ -97,9 +133,11 @@ private:
     inline i32 cos64(u8 angle);
     inline i32 sin64(u8 angle);
     // The function B( a, b, angle, 0 ) performs a butterfly rotation.
-    inline void butterfly_rotation_in_place(Span<Intermediate> data, size_t index_a, size_t index_b, u8 angle, bool flip);
+    template<typename T>
+    inline void butterfly_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, u8 angle, bool flip);
     // The function H( a, b, 0 ) performs a Hadamard rotation.
-    inline void hadamard_rotation_in_place(Span<Intermediate> data, size_t index_a, size_t index_b, bool flip);
+    template<typename T>
+    inline void hadamard_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, bool flip);
     // The function SB( a, b, angle, 0 ) performs a butterfly rotation.
     // Spec defines the source as array T, and the destination array as S.
     template<typename S, typename D>
@@ -113,39 +151,49 @@ private:
     inline DecoderErrorOr<void> inverse_walsh_hadamard_transform(Span<Intermediate> data, u8 log2_of_block_size, u8 shift);
 
     // (8.7.1.2) Inverse DCT array permutation process
-    template<u8 log2_of_block_size>
-    inline DecoderErrorOr<void> inverse_discrete_cosine_transform_array_permutation(Span<Intermediate> data);
+    template<u8 log2_of_block_size, typename T>
+    inline DecoderErrorOr<void> inverse_discrete_cosine_transform_array_permutation(Span<T> data);
     // (8.7.1.3) Inverse DCT process
-    template<u8 log2_of_block_size>
-    inline DecoderErrorOr<void> inverse_discrete_cosine_transform(Span<Intermediate> data);
+    template<u8 log2_of_block_size, typename T>
+    inline DecoderErrorOr<void> inverse_discrete_cosine_transform(Span<T> data);
 
     // (8.7.1.4) This process performs the in-place permutation of the array T of length 2 n which is required as the first step of
     // the inverse ADST.
-    template<u8 log2_of_block_size>
-    inline void inverse_asymmetric_discrete_sine_transform_input_array_permutation(Span<Intermediate> data);
+    template<u8 log2_of_block_size, typename T>
+    inline void inverse_asymmetric_discrete_sine_transform_input_array_permutation(Span<T> data);
     // (8.7.1.5) This process performs the in-place permutation of the array T of length 2 n which is required before the final
     // step of the inverse ADST.
-    template<u8 log2_of_block_size>
-    inline void inverse_asymmetric_discrete_sine_transform_output_array_permutation(Span<Intermediate> data);
+    template<u8 log2_of_block_size, typename T>
+    inline void inverse_asymmetric_discrete_sine_transform_output_array_permutation(Span<T> data);
 
     // (8.7.1.6) This process does an in-place transform of the array T to perform an inverse ADST.
-    inline void inverse_asymmetric_discrete_sine_transform_4(Span<Intermediate> data);
+    template<typename T>
+    inline void inverse_asymmetric_discrete_sine_transform_4(Span<T> data);
     // (8.7.1.7) This process does an in-place transform of the array T using a higher precision array S for intermediate
     // results.
-    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform_8(Span<Intermediate> data);
+    template<typename T>
+    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform_8(Span<T> data);
     // (8.7.1.8) This process does an in-place transform of the array T using a higher precision array S for intermediate
     // results.
-    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform_16(Span<Intermediate> data);
+    template<typename T>
+    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform_16(Span<T> data);
     // (8.7.1.9) This process performs an in-place inverse ADST process on the array T of size 2 n for 2 ≤ n ≤ 4.
-    template<u8 log2_of_block_size>
-    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform(Span<Intermediate> data);
+    template<u8 log2_of_block_size, typename T>
+    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform(Span<T> data);
 
     /* (8.10) Reference Frame Update Process */
     DecoderErrorOr<void> update_reference_frames(FrameContext const&);
+    // Copies a superblock row of a tile column into the decoded frame's reference planes as soon as it is decoded, so
+    // that the next frame can predict from it before this frame is finished.
+    void copy_superblock_row_to_reference_frame(TileContext const&, u32 row_start, u32 row_end);
 
     NonnullOwnPtr<Parser> m_parser;
+    FrameThreading m_frame_threading { FrameThreading::No };
 
-    Vector<u16> m_output_buffers[3];
+    // With frame threading, the previous frame can still be decoding while the next one is started.
+    Array<PendingFrame, 2> m_pending_frames;
+    u8 m_next_pending_frame { 0 };
+    Vector<NonnullRefPtr<DecodedFrame>> m_decoded_frames;
 
     Queue<NonnullOwnPtr<VideoFrame>, 1> m_video_frame_queue;
 };
@@ -83,15 +83,14 @@ Vector<size_t> Parser::parse_superframe_sizes(ReadonlyBytes frame_data)
 }
 
 /* (6.1) */
-DecoderErrorOr<FrameContext> Parser::parse_frame(ReadonlyBytes frame_data)
+DecoderErrorOr<FrameContext> Parser::parse_frame(ReadonlyBytes frame_data, NonnullRefPtr<DecodedFrame> decoded_frame)
 {
     if (!m_probability_tables)
         m_probability_tables = DECODER_TRY_ALLOC(try_make<ProbabilityTables>());
 
-    // NOTE: m_reusable_frame_block_contexts does not need to retain any data between frame decodes.
-    //       This is only stored so that we don't need to allocate a frame's block contexts on each
-    //       call to this function, since it will rarely change sizes.
-    auto frame_context = DECODER_TRY_ALLOC(FrameContext::create(frame_data, m_reusable_frame_block_contexts));
+    // NOTE: The decoded frame's block contexts don't need to retain any data between frame decodes. The decoder
+    //       reuses decoded frames so that we don't need to allocate the block contexts for every frame.
+    auto frame_context = DECODER_TRY_ALLOC(FrameContext::create(frame_data, move(decoded_frame)));
     TRY(uncompressed_header(frame_context));
     // FIXME: This should not be an error. Spec says that we consume padding bits until the end of the sample.
     if (frame_context.header_size_in_bytes == 0)
@@ -101,9 +100,22 @@ DecoderErrorOr<FrameContext> Parser::parse_frame(ReadonlyBytes frame_data)
 
     TRY(compressed_header(frame_context));
 
-    TRY(m_decoder.allocate_buffers(frame_context));
+    frame_context.probability_tables = DECODER_TRY_ALLOC(try_make<ProbabilityTables>(*m_probability_tables));
+    if (frame_context.use_previous_frame_motion_vectors || frame_context.segmentation_enabled)
+        frame_context.previous_frame = m_previous_frame;
 
-    TRY(decode_tiles(frame_context));
+    if (!frame_adapts_probabilities(frame_context))
+        TRY(finish_frame(frame_context));
+    return frame_context;
+}
+
+bool Parser::frame_adapts_probabilities(FrameContext const& frame_context)
+{
+    return !frame_context.error_resilient_mode && !frame_context.parallel_decoding_mode;
+}
+
+DecoderErrorOr<void> Parser::finish_frame(FrameContext const& frame_context)
+{
     TRY(refresh_probs(frame_context));
 
     m_previous_frame_type = frame_context.type;
@@ -118,12 +130,12 @@ DecoderErrorOr<FrameContext> Parser::parse_frame(ReadonlyBytes frame_data)
         m_previous_segmentation_features = frame_context.segmentation_features;
     }
 
-    return frame_context;
+    return {};
 }
 
 DecoderErrorOr<void> Parser::refresh_probs(FrameContext const& frame_context)
 {
-    if (!frame_context.error_resilient_mode && !frame_context.parallel_decoding_mode) {
+    if (frame_adapts_probabilities(frame_context)) {
         m_probability_tables->load_probs(frame_context.probability_context_index);
         TRY(m_decoder.adapt_coef_probs(frame_context));
         if (frame_context.is_inter_predicted()) {
@@ -257,7 +269,9 @@ DecoderErrorOr<void> Parser::uncompressed_header(FrameContext& frame_context)
             frame_context.high_precision_motion_vectors_allowed = TRY_READ(frame_context.bit_stream.read_bit());
             frame_context.interpolation_filter = TRY(read_interpolation_filter(frame_context.bit_stream));
             for (auto i = 0; i < REFS_PER_FRAME; i++) {
-                TRY(m_decoder.prepare_referenced_frame(frame_size, frame_context.reference_frame_indices[i]));
+                // The reference frames are copied, since the following frames may replace them before this one is decoded.
+                frame_context.reference_frames[i] = m_reference_frames[frame_context.reference_frame_indices[i]];
+                TRY(m_decoder.prepare_referenced_frame(frame_size, frame_context.reference_frames[i], frame_context.reference_frame_indices[i]));
             }
         }
     }
@@ -582,7 +596,7 @@ DecoderErrorOr<void> Parser::parse_tile_counts(FrameContext& frame_context)
 
 void Parser::setup_past_independence()
 {
-    m_previous_block_contexts.reset();
+    m_previous_frame = nullptr;
     m_previous_loop_filter_ref_deltas[ReferenceFrameType::None] = 1;
     m_previous_loop_filter_ref_deltas[ReferenceFrameType::LastFrame] = 0;
     m_previous_loop_filter_ref_deltas[ReferenceFrameType::GoldenFrame] = -1;
@@ -889,7 +903,7 @@ static u32 get_tile_offset(u32 tile_start, u32 frame_size_in_blocks, u32 tile_si
     return min(offset, frame_size_in_blocks);
 }
 
-DecoderErrorOr<void> Parser::decode_tiles(FrameContext& frame_context)
+DecoderErrorOr<void> Parser::decode_tiles(FrameContext& frame_context, Vector<NonnullOwnPtr<Threading::WorkerThread<DecoderError>>>& tile_threads)
 {
     auto log2_dimensions = frame_context.log2_of_tile_counts;
     auto tile_cols = 1u << log2_dimensions.width();
@@ -933,36 +947,36 @@ DecoderErrorOr<void> Parser::decode_tiles(FrameContext& frame_context)
         }
     }
 
-    auto decode_tile_column = [this, tile_rows](auto& column_workloads) -> DecoderErrorOr<void> {
+    auto decode_tile_column = [this, tile_rows](auto& column_workloads, u32 tile_column) -> DecoderErrorOr<void> {
         VERIFY(column_workloads.size() == tile_rows);
         for (auto tile_row = 0u; tile_row < tile_rows; tile_row++)
-            TRY(decode_tile(column_workloads[tile_row]));
+            TRY(decode_tile(column_workloads[tile_row], tile_column));
         return {};
     };
 
 #ifdef VP9_TILE_THREADING
     auto const worker_count = tile_cols - 1;
 
-    if (m_worker_threads.size() < worker_count) {
-        m_worker_threads.clear();
-        m_worker_threads.ensure_capacity(worker_count);
+    if (tile_threads.size() < worker_count) {
+        tile_threads.clear();
+        tile_threads.ensure_capacity(worker_count);
         for (auto i = 0u; i < worker_count; i++)
-            m_worker_threads.append(DECODER_TRY_ALLOC(Threading::WorkerThread<DecoderError>::create("Decoder Worker"sv)));
+            tile_threads.append(DECODER_TRY_ALLOC(Threading::WorkerThread<DecoderError>::create("Decoder Worker"sv)));
     }
-    VERIFY(m_worker_threads.size() >= worker_count);
+    VERIFY(tile_threads.size() >= worker_count);
 
     // Start tile column decoding tasks in thread workers starting from the second column.
     for (auto tile_col = 1u; tile_col < tile_cols; tile_col++) {
         auto& column_workload = tile_workloads[tile_col];
-        m_worker_threads[tile_col - 1]->start_task([&decode_tile_column, &column_workload]() -> DecoderErrorOr<void> {
-            return decode_tile_column(column_workload);
+        tile_threads[tile_col - 1]->start_task([&decode_tile_column, &column_workload, tile_col]() -> DecoderErrorOr<void> {
+            return decode_tile_column(column_workload, tile_col);
         });
     }
 
     // Decode the first column in this thread.
-    auto result = decode_tile_column(tile_workloads[0]);
+    auto result = decode_tile_column(tile_workloads[0], 0);
 
-    for (auto& worker_thread : m_worker_threads) {
+    for (auto& worker_thread : tile_threads) {
         auto task_result = worker_thread->wait_until_task_is_finished();
         if (!result.is_error() && task_result.is_error())
             result = move(task_result);
@@ -971,8 +985,9 @@ DecoderErrorOr<void> Parser::decode_tiles(FrameContext& frame_context)
     if (result.is_error())
         return result;
 #else
-    for (auto& column_workloads : tile_workloads)
-        TRY(decode_tile_column(column_workloads));
+    (void)tile_threads;
+    for (auto tile_col = 0u; tile_col < tile_cols; tile_col++)
+        TRY(decode_tile_column(tile_workloads[tile_col], tile_col));
 #endif
 
     // Sum up all tile contexts' syntax element counters after all decodes have finished.
@@ -985,13 +1000,25 @@ DecoderErrorOr<void> Parser::decode_tiles(FrameContext& frame_context)
     return {};
 }
 
-DecoderErrorOr<void> Parser::decode_tile(TileContext& tile_context)
+DecoderErrorOr<void> Parser::decode_tile(TileContext& tile_context, u32 tile_column)
 {
+    auto const& frame_context = tile_context.frame_context;
+
     for (auto row = tile_context.rows_start; row < tile_context.rows_end; row += 8) {
+        auto rows_end = min(row + 8, frame_context.rows());
+
+        // The previous frame may still be decoding, so wait for the motion vectors and segment IDs that we read from it.
+        if (frame_context.previous_frame)
+            frame_context.previous_frame->wait_for_decoded_rows(blocks_to_pixels(rows_end));
+
         clear_left_context(tile_context);
         for (auto col = tile_context.columns_start; col < tile_context.columns_end; col += 8) {
             TRY(decode_partition(tile_context, row, col, Block_64x64));
         }
+
+        // Let the following frames read the superblock row, once it is stored in the reference frames.
+        m_decoder.copy_superblock_row_to_reference_frame(tile_context, row, rows_end);
+        frame_context.decoded_frame->set_decoded_rows(tile_column, rows_end == frame_context.rows() ? NumericLimits<u32>::max() : blocks_to_pixels(rows_end));
     }
     TRY_READ(tile_context.decoder.finish_decode());
     return {};
@@ -1015,7 +1042,7 @@ DecoderErrorOr<void> Parser::decode_partition(TileContext& tile_context, u32 row
     bool has_cols = (column + half_block_8x8) < tile_context.frame_context.columns();
     u32 row_in_tile = row - tile_context.rows_start;
     u32 column_in_tile = column - tile_context.columns_start;
-    auto partition = TreeParser::parse_partition(tile_context.decoder, *m_probability_tables, *tile_context.counter, has_rows, has_cols, subsize, num_8x8, tile_context.above_partition_context, tile_context.left_partition_context, row_in_tile, column_in_tile, !tile_context.frame_context.is_inter_predicted());
+    auto partition = TreeParser::parse_partition(tile_context.decoder, *tile_context.frame_context.probability_tables, *tile_context.counter, has_rows, has_cols, subsize, num_8x8, tile_context.above_partition_context, tile_context.left_partition_context, row_in_tile, column_in_tile, !tile_context.frame_context.is_inter_predicted());
 
     auto child_subsize = subsize_lookup[partition][subsize];
     if (child_subsize < Block_8x8 || partition == PartitionNone) {
@@ -1090,14 +1117,14 @@ void Parser::intra_frame_mode_info(BlockContext& block_context, FrameBlockContex
     // FIXME: This if statement is also present in parse_default_intra_mode. The selection of parameters for
     //        the probability table lookup should be inlined here.
     if (block_context.size >= Block_8x8) {
-        auto mode = TreeParser::parse_default_intra_mode(block_context.decoder, *m_probability_tables, block_context.size, above_context, left_context, block_context.sub_block_prediction_modes, 0, 0);
+        auto mode = TreeParser::parse_default_intra_mode(block_context.decoder, *block_context.frame_context.probability_tables, block_context.size, above_context, left_context, block_context.sub_block_prediction_modes, 0, 0);
         for (auto& block_sub_mode : block_context.sub_block_prediction_modes)
             block_sub_mode = mode;
     } else {
         auto size_in_sub_blocks = block_context.get_size_in_sub_blocks();
         for (auto idy = 0; idy < 2; idy += size_in_sub_blocks.height()) {
             for (auto idx = 0; idx < 2; idx += size_in_sub_blocks.width()) {
-                auto sub_mode = TreeParser::parse_default_intra_mode(block_context.decoder, *m_probability_tables, block_context.size, above_context, left_context, block_context.sub_block_prediction_modes, idx, idy);
+                auto sub_mode = TreeParser::parse_default_intra_mode(block_context.decoder, *block_context.frame_context.probability_tables, block_context.size, above_context, left_context, block_context.sub_block_prediction_modes, idx, idy);
 
                 for (auto y = 0; y < size_in_sub_blocks.height(); y++) {
                     for (auto x = 0; x < size_in_sub_blocks.width(); x++) {
@@ -1108,7 +1135,7 @@ void Parser::intra_frame_mode_info(BlockContext& block_context, FrameBlockContex
             }
         }
     }
-    block_context.uv_prediction_mode = TreeParser::parse_default_uv_mode(block_context.decoder, *m_probability_tables, block_context.y_prediction_mode());
+    block_context.uv_prediction_mode = TreeParser::parse_default_uv_mode(block_context.decoder, *block_context.frame_context.probability_tables, block_context.y_prediction_mode());
 }
 
 void Parser::set_intra_segment_id(BlockContext& block_context)
@@ -1123,14 +1150,14 @@ bool Parser::read_should_skip_residuals(BlockContext& block_context, FrameBlockC
 {
     if (block_context.get_segment_feature(SegmentFeature::SkipResidualsOverride).enabled)
         return true;
-    return TreeParser::parse_skip(block_context.decoder, *m_probability_tables, block_context.counter, above_context, left_context);
+    return TreeParser::parse_skip(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, above_context, left_context);
 }
 
 TransformSize Parser::read_tx_size(BlockContext& block_context, FrameBlockContext above_context, FrameBlockContext left_context, bool allow_select)
 {
     auto max_tx_size = max_txsize_lookup[block_context.size];
     if (allow_select && block_context.frame_context.transform_mode == TransformMode::Select && block_context.size >= Block_8x8)
-        return (TreeParser::parse_tx_size(block_context.decoder, *m_probability_tables, block_context.counter, max_tx_size, above_context, left_context));
+        return (TreeParser::parse_tx_size(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, max_tx_size, above_context, left_context));
     return min(max_tx_size, tx_mode_to_biggest_tx_size[to_underlying(block_context.frame_context.transform_mode)]);
 }
 
@@ -1181,6 +1208,14 @@ void Parser::set_inter_segment_id(BlockContext& block_context)
 
 u8 Parser::get_segment_id(BlockContext const& block_context)
 {
+    // PrevSegmentIds is only kept if the previous frame updated its segmentation map, and is cleared otherwise.
+    auto const& previous_frame = block_context.frame_context.previous_frame;
+    if (!previous_frame || !previous_frame->keeps_segment_ids)
+        return 0;
+    auto const& previous_block_contexts = previous_frame->block_contexts;
+    if (previous_block_contexts.height() != block_context.frame_context.rows() || previous_block_contexts.width() != block_context.frame_context.columns())
+        return 0;
+
     auto bw = num_8x8_blocks_wide_lookup[block_context.size];
     auto bh = num_8x8_blocks_high_lookup[block_context.size];
     auto xmis = min(block_context.frame_context.columns() - block_context.column, (u32)bw);
@@ -1188,7 +1223,7 @@ u8 Parser::get_segment_id(BlockContext const& block_context)
     u8 segment = 7;
     for (size_t y = 0; y < ymis; y++) {
         for (size_t x = 0; x < xmis; x++) {
-            segment = min(segment, m_previous_block_contexts.index_at(block_context.row + y, block_context.column + x));
+            segment = min(segment, previous_block_contexts.at(block_context.row + y, block_context.column + x).segment_id);
         }
     }
     return segment;
@@ -1199,7 +1234,7 @@ bool Parser::read_is_inter(BlockContext& block_context, FrameBlockContext above_
     auto reference_frame_override_feature = block_context.get_segment_feature(SegmentFeature::ReferenceFrameOverride);
     if (reference_frame_override_feature.enabled)
         return reference_frame_override_feature.value != ReferenceFrameType::None;
-    return TreeParser::parse_block_is_inter_predicted(block_context.decoder, *m_probability_tables, block_context.counter, above_context, left_context);
+    return TreeParser::parse_block_is_inter_predicted(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, above_context, left_context);
 }
 
 void Parser::intra_block_mode_info(BlockContext& block_context)
@@ -1208,14 +1243,14 @@ void Parser::intra_block_mode_info(BlockContext& block_context)
     VERIFY(!block_context.is_inter_predicted());
     auto& sub_modes = block_context.sub_block_prediction_modes;
     if (block_context.size >= Block_8x8) {
-        auto mode = TreeParser::parse_intra_mode(block_context.decoder, *m_probability_tables, block_context.counter, block_context.size);
+        auto mode = TreeParser::parse_intra_mode(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, block_context.size);
         for (auto& block_sub_mode : sub_modes)
             block_sub_mode = mode;
     } else {
         auto size_in_sub_blocks = block_context.get_size_in_sub_blocks();
         for (auto idy = 0; idy < 2; idy += size_in_sub_blocks.height()) {
             for (auto idx = 0; idx < 2; idx += size_in_sub_blocks.width()) {
-                auto sub_intra_mode = TreeParser::parse_sub_intra_mode(block_context.decoder, *m_probability_tables, block_context.counter);
+                auto sub_intra_mode = TreeParser::parse_sub_intra_mode(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter);
                 for (auto y = 0; y < size_in_sub_blocks.height(); y++) {
                     for (auto x = 0; x < size_in_sub_blocks.width(); x++)
                         sub_modes[(idy + y) * 2 + idx + x] = sub_intra_mode;
@@ -1223,7 +1258,7 @@ void Parser::intra_block_mode_info(BlockContext& block_context)
             }
         }
     }
-    block_context.uv_prediction_mode = TreeParser::parse_uv_mode(block_context.decoder, *m_probability_tables, block_context.counter, block_context.y_prediction_mode());
+    block_context.uv_prediction_mode = TreeParser::parse_uv_mode(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, block_context.y_prediction_mode());
 }
 
 static void select_best_reference_motion_vectors(BlockContext& block_context, MotionVectorPair reference_motion_vectors, BlockMotionVectorCandidates& candidates, ReferenceIndex);
@@ -1244,17 +1279,17 @@ void Parser::inter_block_mode_info(BlockContext& block_context, FrameBlockContex
     if (block_context.get_segment_feature(SegmentFeature::SkipResidualsOverride).enabled) {
         block_context.y_prediction_mode() = PredictionMode::ZeroMv;
     } else if (block_context.size >= Block_8x8) {
-        block_context.y_prediction_mode() = TreeParser::parse_inter_mode(block_context.decoder, *m_probability_tables, block_context.counter, block_context.mode_context[block_context.reference_frame_types.primary]);
+        block_context.y_prediction_mode() = TreeParser::parse_inter_mode(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, block_context.mode_context[block_context.reference_frame_types.primary]);
     }
     if (block_context.frame_context.interpolation_filter == Switchable)
-        block_context.interpolation_filter = TreeParser::parse_interpolation_filter(block_context.decoder, *m_probability_tables, block_context.counter, above_context, left_context);
+        block_context.interpolation_filter = TreeParser::parse_interpolation_filter(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, above_context, left_context);
     else
         block_context.interpolation_filter = block_context.frame_context.interpolation_filter;
     if (block_context.size < Block_8x8) {
         auto size_in_sub_blocks = block_context.get_size_in_sub_blocks();
         for (auto idy = 0; idy < 2; idy += size_in_sub_blocks.height()) {
             for (auto idx = 0; idx < 2; idx += size_in_sub_blocks.width()) {
-                block_context.y_prediction_mode() = TreeParser::parse_inter_mode(block_context.decoder, *m_probability_tables, block_context.counter, block_context.mode_context[block_context.reference_frame_types.primary]);
+                block_context.y_prediction_mode() = TreeParser::parse_inter_mode(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, block_context.mode_context[block_context.reference_frame_types.primary]);
                 if (block_context.y_prediction_mode() == PredictionMode::NearestMv || block_context.y_prediction_mode() == PredictionMode::NearMv) {
                     select_best_sub_block_reference_motion_vectors(block_context, motion_vector_candidates, idy * 2 + idx, ReferenceIndex::Primary);
                     if (block_context.is_compound())
@@ -1287,7 +1322,7 @@ void Parser::read_ref_frames(BlockContext& block_context, FrameBlockContext abov
     ReferenceMode compound_mode = block_context.frame_context.reference_mode;
     auto fixed_reference = block_context.frame_context.fixed_reference_type;
     if (compound_mode == ReferenceModeSelect)
-        compound_mode = TreeParser::parse_comp_mode(block_context.decoder, *m_probability_tables, block_context.counter, fixed_reference, above_context, left_context);
+        compound_mode = TreeParser::parse_comp_mode(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, fixed_reference, above_context, left_context);
     if (compound_mode == CompoundReference) {
         auto variable_references = block_context.frame_context.variable_reference_types;
 
@@ -1296,7 +1331,7 @@ void Parser::read_ref_frames(BlockContext& block_context, FrameBlockContext abov
         if (block_context.frame_context.reference_frame_sign_biases[fixed_reference])
             swap(fixed_reference_index, variable_reference_index);
 
-        auto variable_reference_selection = TreeParser::parse_comp_ref(block_context.decoder, *m_probability_tables, block_context.counter, fixed_reference, variable_references, variable_reference_index, above_context, left_context);
+        auto variable_reference_selection = TreeParser::parse_comp_ref(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, fixed_reference, variable_references, variable_reference_index, above_context, left_context);
 
         block_context.reference_frame_types[fixed_reference_index] = fixed_reference;
         block_context.reference_frame_types[variable_reference_index] = variable_references[variable_reference_selection];
@@ -1305,9 +1340,9 @@ void Parser::read_ref_frames(BlockContext& block_context, FrameBlockContext abov
 
     // FIXME: Maybe consolidate this into a tree. Context is different between part 1 and 2 but still, it would look nice here.
     ReferenceFrameType primary_type = ReferenceFrameType::LastFrame;
-    auto single_ref_p1 = TreeParser::parse_single_ref_part_1(block_context.decoder, *m_probability_tables, block_context.counter, above_context, left_context);
+    auto single_ref_p1 = TreeParser::parse_single_ref_part_1(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, above_context, left_context);
     if (single_ref_p1) {
-        auto single_ref_p2 = TreeParser::parse_single_ref_part_2(block_context.decoder, *m_probability_tables, block_context.counter, above_context, left_context);
+        auto single_ref_p2 = TreeParser::parse_single_ref_part_2(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, above_context, left_context);
         primary_type = single_ref_p2 ? ReferenceFrameType::AltRefFrame : ReferenceFrameType::GoldenFrame;
     }
     block_context.reference_frame_types = { primary_type, ReferenceFrameType::None };
@@ -1351,35 +1386,35 @@ MotionVector Parser::read_motion_vector(BlockContext const& block_context, Block
 {
     auto use_high_precision = block_context.frame_context.high_precision_motion_vectors_allowed && should_use_high_precision_motion_vector(candidates[reference_index].best_vector);
     MotionVector delta_vector;
-    auto joint = TreeParser::parse_motion_vector_joint(block_context.decoder, *m_probability_tables, block_context.counter);
+    auto joint = TreeParser::parse_motion_vector_joint(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter);
     if ((joint & MotionVectorNonZeroRow) != 0)
-        delta_vector.set_row(read_single_motion_vector_component(block_context.decoder, block_context.counter, 0, use_high_precision));
+        delta_vector.set_row(read_single_motion_vector_component(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, 0, use_high_precision));
     if ((joint & MotionVectorNonZeroColumn) != 0)
-        delta_vector.set_column(read_single_motion_vector_component(block_context.decoder, block_context.counter, 1, use_high_precision));
+        delta_vector.set_column(read_single_motion_vector_component(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, 1, use_high_precision));
 
     return candidates[reference_index].best_vector + delta_vector;
 }
 
 // read_mv_component( comp ) in the spec.
-i32 Parser::read_single_motion_vector_component(BooleanDecoder& decoder, SyntaxElementCounter& counter, u8 component, bool use_high_precision)
+i32 Parser::read_single_motion_vector_component(BooleanDecoder& decoder, ProbabilityTables const& probability_tables, SyntaxElementCounter& counter, u8 component, bool use_high_precision)
 {
-    auto mv_sign = TreeParser::parse_motion_vector_sign(decoder, *m_probability_tables, counter, component);
-    auto mv_class = TreeParser::parse_motion_vector_class(decoder, *m_probability_tables, counter, component);
+    auto mv_sign = TreeParser::parse_motion_vector_sign(decoder, probability_tables, counter, component);
+    auto mv_class = TreeParser::parse_motion_vector_class(decoder, probability_tables, counter, component);
     u32 magnitude;
     if (mv_class == MvClass0) {
-        auto mv_class0_bit = TreeParser::parse_motion_vector_class0_bit(decoder, *m_probability_tables, counter, component);
-        auto mv_class0_fr = TreeParser::parse_motion_vector_class0_fr(decoder, *m_probability_tables, counter, component, mv_class0_bit);
-        auto mv_class0_hp = TreeParser::parse_motion_vector_class0_hp(decoder, *m_probability_tables, counter, component, use_high_precision);
+        auto mv_class0_bit = TreeParser::parse_motion_vector_class0_bit(decoder, probability_tables, counter, component);
+        auto mv_class0_fr = TreeParser::parse_motion_vector_class0_fr(decoder, probability_tables, counter, component, mv_class0_bit);
+        auto mv_class0_hp = TreeParser::parse_motion_vector_class0_hp(decoder, probability_tables, counter, component, use_high_precision);
         magnitude = ((mv_class0_bit << 3) | (mv_class0_fr << 1) | mv_class0_hp) + 1;
     } else {
         u32 bits = 0;
         for (u8 i = 0; i < mv_class; i++) {
-            auto mv_bit = TreeParser::parse_motion_vector_bit(decoder, *m_probability_tables, counter, component, i);
+            auto mv_bit = TreeParser::parse_motion_vector_bit(decoder, probability_tables, counter, component, i);
             bits |= mv_bit << i;
         }
         magnitude = CLASS0_SIZE << (mv_class + 2);
-        auto mv_fr = TreeParser::parse_motion_vector_fr(decoder, *m_probability_tables, counter, component);
-        auto mv_hp = TreeParser::parse_motion_vector_hp(decoder, *m_probability_tables, counter, component, use_high_precision);
+        auto mv_fr = TreeParser::parse_motion_vector_fr(decoder, probability_tables, counter, component);
+        auto mv_hp = TreeParser::parse_motion_vector_hp(decoder, probability_tables, counter, component, use_high_precision);
         magnitude += ((bits << 3) | (mv_fr << 1) | mv_hp) + 1;
     }
     return (mv_sign ? -1 : 1) * static_cast<i32>(magnitude);
@@ -1518,10 +1553,10 @@ bool Parser::tokens(BlockContext& block_context, size_t plane, u32 sub_block_col
         else
             tokens_context = TreeParser::get_context_for_other_tokens(token_cache, transform_size, transform_set, plane, token_position, block_context.is_inter_predicted(), band);
 
-        if (check_for_more_coefficients && !TreeParser::parse_more_coefficients(block_context.decoder, *m_probability_tables, block_context.counter, tokens_context))
+        if (check_for_more_coefficients && !TreeParser::parse_more_coefficients(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, tokens_context))
             break;
 
-        auto token = TreeParser::parse_token(block_context.decoder, *m_probability_tables, block_context.counter, tokens_context);
+        auto token = TreeParser::parse_token(block_context.decoder, *block_context.frame_context.probability_tables, block_context.counter, tokens_context);
         token_cache[token_position] = energy_class[token];
 
         i32 coef;
@@ -1585,8 +1620,12 @@ static void add_motion_vector_to_list_deduped(MotionVector const& vector, Vector
 MotionVectorCandidate Parser::get_motion_vector_from_current_or_previous_frame(BlockContext const& block_context, MotionVector candidate_vector, ReferenceIndex reference_index, bool use_prev)
 {
     if (use_prev) {
-        auto const& prev_context = m_previous_block_contexts.at(candidate_vector.row(), candidate_vector.column());
-        return { prev_context.ref_frames[reference_index], prev_context.primary_motion_vector_pair[reference_index] };
+        // The previous frame's motion vectors are cleared by setup_past_independence().
+        auto const& previous_frame = block_context.frame_context.previous_frame;
+        if (!previous_frame)
+            return { ReferenceFrameType::None, {} };
+        auto const& prev_context = previous_frame->block_contexts.at(candidate_vector.row(), candidate_vector.column());
+        return { prev_context.ref_frames[reference_index], prev_context.primary_motion_vector_pair()[reference_index] };
     }
 
     auto const& current_context = block_context.frame_block_contexts().at(candidate_vector.row(), candidate_vector.column());
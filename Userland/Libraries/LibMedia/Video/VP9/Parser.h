@@ -40,7 +40,14 @@ class Parser {
 public:
     explicit Parser(Decoder&);
     ~Parser();
-    DecoderErrorOr<FrameContext> parse_frame(ReadonlyBytes);
+    // Parses the headers of a frame. Its tiles are decoded separately by decode_tiles().
+    DecoderErrorOr<FrameContext> parse_frame(ReadonlyBytes, NonnullRefPtr<DecodedFrame>);
+    DecoderErrorOr<void> decode_tiles(FrameContext&, Vector<NonnullOwnPtr<Threading::WorkerThread<DecoderError>>>& tile_threads);
+
+    // The probabilities that the next frame is parsed with depend on the symbols decoded in a frame that adapts them,
+    // so such a frame must be finished before the next one can be parsed. Other frames are finished by parse_frame().
+    static bool frame_adapts_probabilities(FrameContext const&);
+    DecoderErrorOr<void> finish_frame(FrameContext const&);
 
 private:
     /* Annex B: Superframes are a method of storing multiple coded frames into a single chunk
@@ -91,8 +98,7 @@ private:
     u8 update_mv_prob(BooleanDecoder&, u8 prob);
 
     /* (6.4) Decode Tiles Syntax */
-    DecoderErrorOr<void> decode_tiles(FrameContext&);
-    DecoderErrorOr<void> decode_tile(TileContext&);
+    DecoderErrorOr<void> decode_tile(TileContext&, u32 tile_column);
     void clear_left_context(TileContext&);
     DecoderErrorOr<void> decode_partition(TileContext&, u32 row, u32 column, BlockSubsize subsize);
     DecoderErrorOr<void> decode_block(TileContext&, u32 row, u32 column, BlockSubsize subsize);
@@ -110,7 +116,7 @@ private:
     void read_ref_frames(BlockContext&, FrameBlockContext above_context, FrameBlockContext left_context);
     MotionVectorPair get_motion_vector(BlockContext const&, BlockMotionVectorCandidates const&);
     MotionVector read_motion_vector(BlockContext const&, BlockMotionVectorCandidates const&, ReferenceIndex);
-    i32 read_single_motion_vector_component(BooleanDecoder&, SyntaxElementCounter&, u8 component, bool use_high_precision);
+    i32 read_single_motion_vector_component(BooleanDecoder&, ProbabilityTables const&, SyntaxElementCounter&, u8 component, bool use_high_precision);
     DecoderErrorOr<bool> residual(BlockContext&, bool has_block_above, bool has_block_left);
     bool tokens(BlockContext&, size_t plane, u32 x, u32 y, TransformSize, TransformSet, Array<u8, 1024> token_cache);
     i32 read_coef(BooleanDecoder&, u8 bit_depth, Token token);
@@ -135,13 +141,11 @@ private:
 
     ReferenceFrame m_reference_frames[NUM_REF_FRAMES];
 
-    Vector2D<FrameBlockContext> m_reusable_frame_block_contexts;
-    Vector2D<PersistentBlockContext> m_previous_block_contexts;
+    // The last decoded frame, whose motion vectors and segment IDs the next frame may use.
+    RefPtr<DecodedFrame> m_previous_frame;
 
     OwnPtr<ProbabilityTables> m_probability_tables;
     Decoder& m_decoder;
-
-    Vector<NonnullOwnPtr<Threading::WorkerThread<DecoderError>>> m_worker_threads;
 };
 
 }
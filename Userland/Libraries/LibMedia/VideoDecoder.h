@@ -21,6 +21,9 @@ public:
     virtual DecoderErrorOr<void> receive_sample(Duration timestamp, ReadonlyBytes sample) = 0;
     DecoderErrorOr<void> receive_sample(Duration timestamp, ByteBuffer const& sample) { return receive_sample(timestamp, sample.span()); }
     virtual DecoderErrorOr<NonnullOwnPtr<VideoFrame>> get_decoded_frame() = 0;
+    // Decoders may hold frames back until they receive the following samples. This makes them output those frames
+    // when there are no more samples to come.
+    virtual DecoderErrorOr<void> signal_end_of_stream() { return {}; }
 
     virtual void flush() = 0;
 };
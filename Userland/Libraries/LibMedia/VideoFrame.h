@@ -94,6 +94,8 @@ public:
 
     DecoderErrorOr<void> output_to_bitmap(Gfx::Bitmap& bitmap) override;
 
+    Subsampling const& subsampling() const { return m_subsampling; }
+
     u8* get_raw_plane_data(u32 plane)
     {
         switch (plane) {
@@ -200,6 +200,16 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
         state.string_position_in_code_units = view_index;
         bool succeeded = false;
 
+        // The prefilter works on raw bytes, so it can't be used when the VM compares code points or ignores case.
+        auto const& prefilter = m_pattern->parser_result.optimization_data.prefilter;
+        Optional<ReadonlyBytes> prefilter_haystack;
+        if (prefilter.has_value() && view.is_string_view() && !view.unicode() && !input.regex_options.has_flag_set(AllFlags::Insensitive))
+            prefilter_haystack = view.string_view().bytes();
+
+        // Nothing in this view can match, skip straight to the next one.
+        if (prefilter_haystack.has_value() && !prefilter->may_contain_match(*prefilter_haystack))
+            view_index = view_length + 1;
+
         if (view_index == view_length && m_pattern->parser_result.match_length_minimum == 0) {
             // Run the code until it tries to consume something.
             // This allows non-consuming code to run on empty strings, for instance
@@ -235,6 +245,13 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
 
+            if (prefilter_haystack.has_value() && continue_search) {
+                auto candidate = prefilter->find_candidate(*prefilter_haystack, view_index);
+                if (!candidate.has_value())
+                    break;
+                view_index = *candidate;
+            }
+
             auto& match_length_minimum = m_pattern->parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
@@ -253,7 +270,20 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             state.instruction_position = 0;
             state.repetition_marks.clear();
 
-            auto success = execute(input, state, operations);
+            bool success;
+            if (auto const& nfa = m_pattern->parser_result.optimization_data.nfa; nfa.has_value() && continue_search) {
+                // The NFA tries all the remaining start positions in a single pass over the input.
+                auto match_start = nfa->search(m_pattern->parser_result.bytecode, input, state, operations);
+                if (!match_start.has_value())
+                    break;
+                if (*match_start == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
+                    break;
+                view_index = *match_start;
+                success = true;
+            } else {
+                success = execute(input, state, operations);
+            }
+
             if (success) {
                 succeeded = true;
 
@@ -439,6 +469,9 @@ bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t
         return true;
     }
 
+    if (auto const& nfa = m_pattern->parser_result.optimization_data.nfa; nfa.has_value())
+        return nfa->match(m_pattern->parser_result.bytecode, input, state, operations);
+
     BumpAllocatedLinkedList<MatchState> states_to_try_next;
 #if REGEX_DEBUG
     size_t recursion_level = 0;
@@ -0,0 +1,616 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/HashMap.h>
+#include <AK/NumericLimits.h>
+#include <AK/RefCounted.h>
+#include <LibRegex/RegexNFA.h>
+
+namespace regex {
+
+Optional<NFAProgram> NFAProgram::compile(ByteCode const& bytecode)
+{
+    NFAProgram program;
+    auto& instructions = program.m_instructions;
+
+    // Branch targets are bytecode positions until every instruction has been created.
+    HashMap<size_t, size_t> instruction_index_for_position;
+
+    auto note_capture_group = [&](size_t id) {
+        program.m_capture_group_count = max(program.m_capture_group_count, id + 1);
+    };
+
+    auto bytecode_size = bytecode.size();
+    MatchState state;
+    while (state.instruction_position < bytecode_size) {
+        auto& opcode = bytecode.get_opcode(state);
+        auto position = state.instruction_position;
+        auto next_position = position + opcode.size();
+        instruction_index_for_position.set(position, instructions.size());
+
+        auto append_jump = [&](ssize_t offset) {
+            instructions.append({ .type = Instruction::Type::Jump, .argument = next_position + offset });
+        };
+        auto append_split = [&](size_t preferred, size_t alternative) {
+            instructions.append({ .type = Instruction::Type::Split, .argument = preferred, .alternative = alternative });
+        };
+
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto& compare = static_cast<OpCode_Compare const&>(opcode);
+            auto argument_position = position + 3;
+
+            // A plain string compare consumes several code points at once, split it into one compare per character.
+            if (compare.arguments_count() == 1 && static_cast<CharacterCompareType>(bytecode.at(argument_position)) == CharacterCompareType::String) {
+                auto length = bytecode.at(argument_position + 1);
+                // NOTE: Anything else may be a sequence of code units, which can only be compared as a whole.
+                for (size_t i = 0; i < length; ++i) {
+                    if (!is_ascii(bytecode.at(argument_position + 2 + i)))
+                        return {};
+                }
+                for (size_t i = 0; i < length; ++i) {
+                    instructions.append({ .type = Instruction::Type::Compare, .is_expanded_compare = true, .argument = program.m_expanded_compares.size() });
+                    program.m_expanded_compares.empend(static_cast<ByteCodeValueType>(OpCodeId::Compare));
+                    program.m_expanded_compares.empend(static_cast<ByteCodeValueType>(1)); // number of arguments
+                    program.m_expanded_compares.empend(static_cast<ByteCodeValueType>(2)); // size of arguments
+                    program.m_expanded_compares.empend(static_cast<ByteCodeValueType>(CharacterCompareType::Char));
+                    program.m_expanded_compares.empend(bytecode.at(argument_position + 2 + i));
+                }
+                break;
+            }
+
+            // Everything else has to match exactly one code point. Backreferences depend on the captures of a
+            // single thread, and strings inside a class can match any number of code points.
+            for (size_t i = 0; i < compare.arguments_count(); ++i) {
+                switch (static_cast<CharacterCompareType>(bytecode.at(argument_position++))) {
+                case CharacterCompareType::String:
+                case CharacterCompareType::Reference:
+                    return {};
+                case CharacterCompareType::Char:
+                case CharacterCompareType::CharClass:
+                case CharacterCompareType::CharRange:
+                case CharacterCompareType::Property:
+                case CharacterCompareType::GeneralCategory:
+                case CharacterCompareType::Script:
+                case CharacterCompareType::ScriptExtension:
+                    ++argument_position;
+                    break;
+                case CharacterCompareType::LookupTable:
+                    argument_position += 1 + bytecode.at(argument_position);
+                    break;
+                default:
+                    break;
+                }
+            }
+            instructions.append({ .type = Instruction::Type::Compare, .argument = position });
+            break;
+        }
+        case OpCodeId::Jump:
+            append_jump(static_cast<OpCode_Jump const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            // The optimizer only turns forks into ForkReplace forks where that doesn't change what matches.
+            append_split(next_position + static_cast<OpCode_ForkJump const&>(opcode).offset(), next_position);
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            append_split(next_position, next_position + static_cast<OpCode_ForkStay const&>(opcode).offset());
+            break;
+        case OpCodeId::JumpNonEmpty: {
+            // The backtracking VM only takes this branch if the loop body has consumed something since its checkpoint.
+            // If it hasn't, the loop head has already been visited at this position, so the thread that would take the
+            // branch is dropped here as well, and only the one that falls through survives.
+            auto& jump = static_cast<OpCode_JumpNonEmpty const&>(opcode);
+            auto target = next_position + jump.offset();
+            switch (jump.form()) {
+            case OpCodeId::Jump:
+            case OpCodeId::ForkJump:
+            case OpCodeId::ForkReplaceJump:
+                append_split(target, next_position);
+                break;
+            case OpCodeId::ForkStay:
+            case OpCodeId::ForkReplaceStay:
+                append_split(next_position, target);
+                break;
+            default:
+                return {};
+            }
+            break;
+        }
+        case OpCodeId::Checkpoint:
+            break;
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary:
+            instructions.append({ .type = Instruction::Type::Assert, .argument = position });
+            break;
+        case OpCodeId::SaveLeftCaptureGroup: {
+            auto id = static_cast<OpCode_SaveLeftCaptureGroup const&>(opcode).id();
+            note_capture_group(id);
+            instructions.append({ .type = Instruction::Type::SaveLeftCaptureGroup, .argument = id });
+            break;
+        }
+        case OpCodeId::SaveRightCaptureGroup: {
+            auto id = static_cast<OpCode_SaveRightCaptureGroup const&>(opcode).id();
+            note_capture_group(id);
+            instructions.append({ .type = Instruction::Type::SaveRightCaptureGroup, .argument = id });
+            break;
+        }
+        case OpCodeId::SaveRightNamedCaptureGroup: {
+            auto& save = static_cast<OpCode_SaveRightNamedCaptureGroup const&>(opcode);
+            note_capture_group(save.id());
+            if (program.m_capture_group_names.size() <= save.id())
+                program.m_capture_group_names.resize(save.id() + 1);
+            program.m_capture_group_names[save.id()] = save.name();
+            instructions.append({ .type = Instruction::Type::SaveRightCaptureGroup, .argument = save.id() });
+            break;
+        }
+        case OpCodeId::ClearCaptureGroup: {
+            auto id = static_cast<OpCode_ClearCaptureGroup const&>(opcode).id();
+            note_capture_group(id);
+            instructions.append({ .type = Instruction::Type::ClearCaptureGroup, .argument = id });
+            break;
+        }
+        case OpCodeId::Exit:
+            instructions.append({ .type = Instruction::Type::Fail });
+            break;
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::FailForks:
+        case OpCodeId::Repeat:
+        case OpCodeId::ResetRepeat:
+            // Lookaround and counted repetitions need state that isn't tied to an instruction.
+            return {};
+        }
+
+        state.instruction_position = next_position;
+    }
+
+    // Running off the end of the bytecode means the pattern has matched.
+    auto match_index = instructions.size();
+    instruction_index_for_position.set(bytecode_size, match_index);
+    instructions.append({ .type = Instruction::Type::Match });
+
+    auto resolve = [&](size_t& target) {
+        if (target >= bytecode_size) {
+            target = match_index;
+            return true;
+        }
+        auto index = instruction_index_for_position.get(target);
+        if (!index.has_value())
+            return false;
+        target = *index;
+        return true;
+    };
+
+    for (auto& instruction : instructions) {
+        if (instruction.type == Instruction::Type::Jump && !resolve(instruction.argument))
+            return {};
+        if (instruction.type == Instruction::Type::Split && (!resolve(instruction.argument) || !resolve(instruction.alternative)))
+            return {};
+    }
+
+    return program;
+}
+
+namespace {
+
+// The code points a Compare may consume: exactly for ASCII, and only whether there are any for everything else.
+struct CodePointSet {
+    Array<u64, 2> ascii { 0, 0 };
+    bool has_non_ascii { false };
+
+    void add(u32 code_point)
+    {
+        if (!is_ascii(code_point)) {
+            has_non_ascii = true;
+            return;
+        }
+        ascii[code_point / 64] |= 1ull << (code_point % 64);
+
+        // The pattern may be matched case-insensitively, so a letter stands for both of its cases.
+        if (is_ascii_alpha(code_point)) {
+            auto other_case = is_ascii_lower_alpha(code_point) ? to_ascii_uppercase(code_point) : to_ascii_lowercase(code_point);
+            ascii[other_case / 64] |= 1ull << (other_case % 64);
+        }
+    }
+
+    void add(CodePointSet const& other)
+    {
+        ascii[0] |= other.ascii[0];
+        ascii[1] |= other.ascii[1];
+        has_non_ascii |= other.has_non_ascii;
+    }
+
+    bool overlaps(CodePointSet const& other) const
+    {
+        return (ascii[0] & other.ascii[0]) != 0 || (ascii[1] & other.ascii[1]) != 0 || (has_non_ascii && other.has_non_ascii);
+    }
+};
+
+}
+
+static bool ascii_matches_character_class(u32 code_point, CharClass character_class)
+{
+    switch (character_class) {
+    case CharClass::Alnum:
+        return is_ascii_alphanumeric(code_point);
+    case CharClass::Alpha:
+        return is_ascii_alpha(code_point);
+    case CharClass::Blank:
+        return is_ascii_blank(code_point);
+    case CharClass::Cntrl:
+        return is_ascii_control(code_point);
+    case CharClass::Digit:
+        return is_ascii_digit(code_point);
+    case CharClass::Graph:
+        return is_ascii_graphical(code_point);
+    case CharClass::Lower:
+        return is_ascii_lower_alpha(code_point);
+    case CharClass::Print:
+        return is_ascii_printable(code_point);
+    case CharClass::Punct:
+        return is_ascii_punctuation(code_point);
+    case CharClass::Space:
+        return is_ascii_space(code_point);
+    case CharClass::Upper:
+        return is_ascii_upper_alpha(code_point);
+    case CharClass::Word:
+        return is_ascii_alphanumeric(code_point) || code_point == '_';
+    case CharClass::Xdigit:
+        return is_ascii_hex_digit(code_point);
+    }
+
+    VERIFY_NOT_REACHED();
+}
+
+// Returns the code points the Compare at `position` may consume, or nothing if that can't be worked out.
+static Optional<CodePointSet> code_points_of_compare(ByteCode const& bytecode, size_t position)
+{
+    CodePointSet code_points;
+
+    auto arguments_count = bytecode.at(position + 1);
+    auto argument_position = position + 3;
+    for (size_t i = 0; i < arguments_count; ++i) {
+        switch (static_cast<CharacterCompareType>(bytecode.at(argument_position++))) {
+        case CharacterCompareType::Char: {
+            auto value = bytecode.at(argument_position++);
+            // Outside of ASCII, case-insensitive matching can equate code points that are far apart, e.g. K and U+212A.
+            if (!is_ascii(value))
+                return {};
+            code_points.add(value);
+            break;
+        }
+        case CharacterCompareType::CharRange: {
+            CharRange range { bytecode.at(argument_position++) };
+            for (u32 code_point = range.from; code_point <= min(range.to, 0x7fu); ++code_point)
+                code_points.add(code_point);
+            if (range.to > 0x7f)
+                code_points.has_non_ascii = true;
+            break;
+        }
+        case CharacterCompareType::CharClass: {
+            auto character_class = static_cast<CharClass>(bytecode.at(argument_position++));
+            for (u32 code_point = 0; code_point <= 0x7f; ++code_point) {
+                if (ascii_matches_character_class(code_point, character_class))
+                    code_points.add(code_point);
+            }
+            // With the Unicode flag, even \w and \s match some code points outside of ASCII.
+            if (character_class != CharClass::Digit && character_class != CharClass::Xdigit)
+                code_points.has_non_ascii = true;
+            break;
+        }
+        default:
+            // Inverted classes, Unicode properties and lookup tables can match just about anything.
+            return {};
+        }
+    }
+    return code_points;
+}
+
+bool NFAProgram::has_ambiguous_loop(ByteCode const& bytecode) const
+{
+    // Collects the code points that can be consumed first after reaching an instruction, i.e. by the Compares that
+    // are reachable from it without consuming anything.
+    Vector<bool> visited;
+    Vector<size_t> pending;
+    auto first_code_points = [&](size_t start) -> Optional<CodePointSet> {
+        visited.clear_with_capacity();
+        visited.resize(m_instructions.size());
+        pending.clear_with_capacity();
+        pending.append(start);
+
+        CodePointSet code_points;
+        while (!pending.is_empty()) {
+            auto index = pending.take_last();
+            if (visited[index])
+                continue;
+            visited[index] = true;
+
+            auto const& instruction = m_instructions[index];
+            switch (instruction.type) {
+            case Instruction::Type::Compare: {
+                auto compare_code_points = code_points_of_compare(instruction.is_expanded_compare ? m_expanded_compares : bytecode, instruction.argument);
+                if (!compare_code_points.has_value())
+                    return {};
+                code_points.add(*compare_code_points);
+                break;
+            }
+            case Instruction::Type::Jump:
+                pending.append(instruction.argument);
+                break;
+            case Instruction::Type::Split:
+                pending.append(instruction.argument);
+                pending.append(instruction.alternative);
+                break;
+            case Instruction::Type::Assert:
+            case Instruction::Type::SaveLeftCaptureGroup:
+            case Instruction::Type::SaveRightCaptureGroup:
+            case Instruction::Type::ClearCaptureGroup:
+                pending.append(index + 1);
+                break;
+            case Instruction::Type::Fail:
+            case Instruction::Type::Match:
+                break;
+            }
+        }
+        return code_points;
+    };
+
+    // A choice is only ambiguous if both of its branches can go on with the same code point. Otherwise, the next code
+    // point decides which one is taken, and backtracking never has to try the other one, as in (a|b)*.
+    auto is_ambiguous_split = [&](Instruction const& split) {
+        auto preferred = first_code_points(split.argument);
+        if (!preferred.has_value())
+            return true;
+        auto alternative = first_code_points(split.alternative);
+        return !alternative.has_value() || preferred->overlaps(*alternative);
+    };
+
+    auto has_ambiguous_split_between = [&](size_t start, size_t end) {
+        for (size_t i = start + 1; i < end; ++i) {
+            if (m_instructions[i].type == Instruction::Type::Split && is_ambiguous_split(m_instructions[i]))
+                return true;
+        }
+        return false;
+    };
+
+    for (size_t i = 0; i < m_instructions.size(); ++i) {
+        auto const& instruction = m_instructions[i];
+        if (instruction.type == Instruction::Type::Jump && instruction.argument <= i && has_ambiguous_split_between(instruction.argument, i))
+            return true;
+        if (instruction.type == Instruction::Type::Split) {
+            if (instruction.argument <= i && has_ambiguous_split_between(instruction.argument, i))
+                return true;
+            if (instruction.alternative <= i && has_ambiguous_split_between(instruction.alternative, i))
+                return true;
+        }
+    }
+    return false;
+}
+
+bool NFAProgram::match(ByteCode const& bytecode, MatchInput const& input, MatchState& state, size_t& operations) const
+{
+    return run(bytecode, input, state, operations, Mode::Anchored).has_value();
+}
+
+Optional<size_t> NFAProgram::search(ByteCode const& bytecode, MatchInput const& input, MatchState& state, size_t& operations) const
+{
+    return run(bytecode, input, state, operations, Mode::Search);
+}
+
+Optional<size_t> NFAProgram::run(ByteCode const& bytecode, MatchInput const& input, MatchState& state, size_t& operations, Mode mode) const
+{
+    static constexpr size_t no_position = NumericLimits<size_t>::max();
+
+    struct Position {
+        size_t code_points { 0 };
+        size_t code_units { 0 };
+    };
+
+    // Three slots per capture group: where its left parenthesis was last seen, and where its match starts and ends.
+    // Forking a thread is much more common than saving a capture group, so threads share their slots until one of
+    // them writes to them.
+    struct CaptureSlots : public RefCounted<CaptureSlots> {
+        explicit CaptureSlots(Vector<size_t> slots)
+            : slots(move(slots))
+        {
+        }
+
+        Vector<size_t> slots;
+    };
+
+    struct Thread {
+        size_t instruction { 0 };
+        size_t start { 0 };
+        NonnullRefPtr<CaptureSlots> capture_slots;
+    };
+
+    auto write_capture_slot = [](Thread& thread, size_t slot, size_t value) {
+        if (thread.capture_slots->slots[slot] == value)
+            return;
+        if (thread.capture_slots->ref_count() > 1)
+            thread.capture_slots = adopt_ref(*new CaptureSlots(thread.capture_slots->slots));
+        thread.capture_slots->slots[slot] = value;
+    };
+
+    auto const& view = input.view;
+
+    Vector<size_t> no_captures;
+    no_captures.resize(m_capture_group_count * 3);
+    for (auto& slot : no_captures)
+        slot = no_position;
+    auto empty_capture_slots = adopt_ref(*new CaptureSlots(move(no_captures)));
+
+    // Each instruction is added to a thread list at most once per step, by the thread with the highest priority.
+    Vector<u32> generation_of_last_addition;
+    generation_of_last_addition.resize(m_instructions.size());
+    u32 generation = 1;
+
+    MatchState scratch_state;
+    auto execute_opcode = [&](Instruction const& instruction, Position position) {
+        scratch_state.instruction_position = instruction.argument;
+        scratch_state.string_position = position.code_points;
+        scratch_state.string_position_in_code_units = position.code_units;
+        auto& code = instruction.is_expanded_compare ? m_expanded_compares : bytecode;
+        return code.get_opcode(scratch_state).execute(input, scratch_state) == ExecutionResult::Continue;
+    };
+
+    // Follows all the instructions that don't consume input, in priority order, and appends the threads that end up
+    // waiting for the next code point (or that have matched) to the list.
+    Vector<Thread> pending_threads;
+    auto add_thread = [&](Vector<Thread>& list, Thread thread, Position position) {
+        pending_threads.append(move(thread));
+        while (!pending_threads.is_empty()) {
+            auto thread = pending_threads.take_last();
+            ++operations;
+
+            if (generation_of_last_addition[thread.instruction] == generation)
+                continue;
+            generation_of_last_addition[thread.instruction] = generation;
+
+            auto const& instruction = m_instructions[thread.instruction];
+            switch (instruction.type) {
+            case Instruction::Type::Compare:
+            case Instruction::Type::Match:
+                list.append(move(thread));
+                break;
+            case Instruction::Type::Assert:
+                if (execute_opcode(instruction, position)) {
+                    ++thread.instruction;
+                    pending_threads.append(move(thread));
+                }
+                break;
+            case Instruction::Type::Jump:
+                thread.instruction = instruction.argument;
+                pending_threads.append(move(thread));
+                break;
+            case Instruction::Type::Split: {
+                // The stack is last-in first-out, so the preferred branch goes on top.
+                auto alternative = thread;
+                alternative.instruction = instruction.alternative;
+                pending_threads.append(move(alternative));
+                thread.instruction = instruction.argument;
+                pending_threads.append(move(thread));
+                break;
+            }
+            case Instruction::Type::SaveLeftCaptureGroup:
+                write_capture_slot(thread, instruction.argument * 3, position.code_points);
+                ++thread.instruction;
+                pending_threads.append(move(thread));
+                break;
+            case Instruction::Type::SaveRightCaptureGroup: {
+                auto left = thread.capture_slots->slots[instruction.argument * 3];
+                if (left == no_position || left > position.code_points)
+                    break;
+                write_capture_slot(thread, instruction.argument * 3 + 1, left);
+                write_capture_slot(thread, instruction.argument * 3 + 2, position.code_points);
+                ++thread.instruction;
+                pending_threads.append(move(thread));
+                break;
+            }
+            case Instruction::Type::ClearCaptureGroup:
+                write_capture_slot(thread, instruction.argument * 3 + 1, no_position);
+                write_capture_slot(thread, instruction.argument * 3 + 2, no_position);
+                ++thread.instruction;
+                pending_threads.append(move(thread));
+                break;
+            case Instruction::Type::Fail:
+                break;
+            }
+        }
+    };
+
+    Vector<Thread> current_threads;
+    Vector<Thread> next_threads;
+    Optional<Thread> matching_thread;
+    Position match_end;
+
+    Position position { state.string_position, state.string_position_in_code_units };
+    add_thread(current_threads, { 0, position.code_points, empty_capture_slots }, position);
+
+    for (;;) {
+        auto is_at_end = position.code_points >= view.length();
+
+        Position next_position;
+        if (!is_at_end) {
+            next_position.code_points = position.code_points + 1;
+            next_position.code_units = position.code_units + (view.unicode() ? view.length_of_code_point(view[position.code_units]) : 1);
+        }
+
+        ++generation;
+        next_threads.clear_with_capacity();
+        for (auto& thread : current_threads) {
+            auto const& instruction = m_instructions[thread.instruction];
+            if (instruction.type == Instruction::Type::Match) {
+                // All the remaining threads have a lower priority than this one, so they don't matter anymore.
+                matching_thread = move(thread);
+                match_end = position;
+                break;
+            }
+
+            ++operations;
+            if (is_at_end || !execute_opcode(instruction, position))
+                continue;
+            VERIFY(scratch_state.string_position == next_position.code_points);
+
+            ++thread.instruction;
+            add_thread(next_threads, move(thread), next_position);
+        }
+
+        if (is_at_end)
+            break;
+
+        swap(current_threads, next_threads);
+        position = next_position;
+
+        // A match starting here has a lower priority than any that started earlier, and none can beat one that was already found.
+        if (mode == Mode::Search && !matching_thread.has_value())
+            add_thread(current_threads, { 0, position.code_points, empty_capture_slots }, position);
+
+        // A search has to go on even when no thread is left, as a thread started at a later position can still match.
+        if (current_threads.is_empty() && (mode == Mode::Anchored || matching_thread.has_value()))
+            break;
+    }
+
+    if (!matching_thread.has_value())
+        return {};
+
+    state.string_position = match_end.code_points;
+    state.string_position_in_code_units = match_end.code_units;
+
+    if (m_capture_group_count != 0) {
+        while (state.capture_group_matches.size() <= input.match_index)
+            state.capture_group_matches.empend();
+
+        auto& groups = state.capture_group_matches.mutable_at(input.match_index);
+        groups.clear();
+        groups.resize(m_capture_group_count);
+
+        for (size_t id = 0; id < m_capture_group_count; ++id) {
+            auto start = matching_thread->capture_slots->slots[id * 3 + 1];
+            auto end = matching_thread->capture_slots->slots[id * 3 + 2];
+            if (start == no_position)
+                continue;
+
+            auto match_view = view.substring_view(start, end - start);
+            if (input.regex_options & AllFlags::StringCopyMatches)
+                groups[id] = { match_view.to_byte_string(), input.line, start, input.global_offset + start };
+            else
+                groups[id] = { match_view, input.line, start, input.global_offset + start };
+
+            if (id < m_capture_group_names.size() && m_capture_group_names[id].has_value())
+                groups[id].capture_group_name = *m_capture_group_names[id];
+        }
+    }
+
+    return matching_thread->start;
+}
+
+}
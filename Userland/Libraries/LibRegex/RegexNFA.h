@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// A Thompson NFA built from the bytecode of a pattern, simulated in lock-step over the input (a "Pike VM").
+// Unlike the backtracking Matcher, the time spent is linear in the length of the input, no matter how ambiguous the
+// pattern is. Threads are kept in the priority order of the forks that created them, so the match and its capture
+// groups are the same as the ones the backtracking VM would have found.
+// Only patterns without backreferences, lookaround and counted repetitions can be compiled.
+class NFAProgram {
+public:
+    static Optional<NFAProgram> compile(ByteCode const&);
+
+    // Matches starting exactly at state.string_position, like Matcher::execute().
+    bool match(ByteCode const&, MatchInput const&, MatchState&, size_t& operations) const;
+
+    // Finds the leftmost match starting at or after state.string_position, and returns where it starts.
+    Optional<size_t> search(ByteCode const&, MatchInput const&, MatchState&, size_t& operations) const;
+
+    // Whether some loop of the pattern has a choice to make on each iteration whose branches can both go on with the
+    // same input, e.g. (a|aa)* or (a+)+, but not (a|b)*. These are the patterns that can make the backtracking VM
+    // take exponential time.
+    bool has_ambiguous_loop(ByteCode const&) const;
+
+    size_t size() const { return m_instructions.size(); }
+
+private:
+    struct Instruction {
+        enum class Type : u8 {
+            Compare,
+            Assert,
+            Jump,
+            Split,
+            SaveLeftCaptureGroup,
+            SaveRightCaptureGroup,
+            ClearCaptureGroup,
+            Fail,
+            Match,
+        };
+
+        Type type;
+
+        // Compare and Assert: whether the opcode lives in m_expanded_compares rather than in the pattern's bytecode.
+        bool is_expanded_compare { false };
+
+        // Compare and Assert: the position of the opcode in the bytecode.
+        // Jump and Split: the preferred target. Capture group operations: the group id.
+        size_t argument { 0 };
+
+        // Split: the target that is only tried after everything reachable from `argument`.
+        size_t alternative { 0 };
+    };
+
+    enum class Mode {
+        Anchored,
+        Search,
+    };
+
+    Optional<size_t> run(ByteCode const&, MatchInput const&, MatchState&, size_t& operations, Mode) const;
+
+    Vector<Instruction> m_instructions;
+
+    // Multi-character string compares are split into one single-character compare each, so that every Compare
+    // instruction consumes exactly one code point.
+    ByteCode m_expanded_compares;
+
+    Vector<Optional<StringView>> m_capture_group_names;
+    size_t m_capture_group_count { 0 };
+};
+
+}
@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CharacterTypes.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
+#include <AK/HashTable.h>
 #include <AK/Queue.h>
 #include <AK/QuickSort.h>
 #include <AK/RedBlackTree.h>
@@ -28,6 +30,8 @@ void Regex<Parser>::run_optimization_passes()
 {
     parser_result.bytecode.flatten();
 
+    attempt_extract_prefilter();
+
     auto blocks = split_basic_blocks(parser_result.bytecode);
     if (attempt_rewrite_entire_match_as_substring_search(blocks))
         return;
@@ -37,6 +41,8 @@ void Regex<Parser>::run_optimization_passes()
     attempt_rewrite_loops_as_atomic_groups(blocks);
 
     parser_result.bytecode.flatten();
+
+    attempt_compile_as_nfa();
 }
 
 template<typename Parser>
@@ -905,6 +911,306 @@ void Regex<Parser>::attempt_rewrite_loops_as_atomic_groups(BasicBlockList const&
     }
 }
 
+template<typename Parser>
+void Regex<Parser>::attempt_compile_as_nfa()
+{
+    // Without backreferences and lookaround, the pattern can run on a Thompson NFA, which takes linear time.
+    // The backtracking VM is usually faster though, so only switch over if some loop has a choice to make in every
+    // iteration that the input doesn't decide, as in (a|aa)*b; those are the patterns that can make backtracking take
+    // exponential time.
+    auto nfa = NFAProgram::compile(parser_result.bytecode);
+    if (!nfa.has_value() || !nfa->has_ambiguous_loop(parser_result.bytecode))
+        return;
+
+    dbgln_if(REGEX_DEBUG, "Matching '{}' with an NFA of {} instructions", pattern_value, nfa->size());
+    parser_result.optimization_data.nfa = nfa.release_value();
+}
+
+static bool byte_may_match_character_class(u8 byte, CharClass character_class)
+{
+    switch (character_class) {
+    case CharClass::Alnum:
+        return is_ascii_alphanumeric(byte);
+    case CharClass::Alpha:
+        return is_ascii_alpha(byte);
+    case CharClass::Blank:
+        return is_ascii_blank(byte);
+    case CharClass::Cntrl:
+        return is_ascii_control(byte);
+    case CharClass::Digit:
+        return is_ascii_digit(byte);
+    case CharClass::Graph:
+        return is_ascii_graphical(byte);
+    case CharClass::Lower:
+        return is_ascii_lower_alpha(byte);
+    case CharClass::Print:
+        return is_ascii_printable(byte);
+    case CharClass::Punct:
+        return is_ascii_punctuation(byte);
+    case CharClass::Space:
+        // Some of the non-ASCII bytes are spaces as well (e.g. U+00A0), don't bother finding out which.
+        return is_ascii_space(byte) || byte >= 0x80;
+    case CharClass::Upper:
+        return is_ascii_upper_alpha(byte);
+    case CharClass::Word:
+        return is_ascii_alphanumeric(byte) || byte == '_';
+    case CharClass::Xdigit:
+        return is_ascii_hex_digit(byte);
+    }
+
+    VERIFY_NOT_REACHED();
+}
+
+// Marks every byte the Compare at `position` can consume first, or returns false if that can't be worked out.
+static bool collect_leading_bytes_of_compare(ByteCode const& bytecode, size_t position, Array<bool, 256>& leading_bytes)
+{
+    auto add_range = [&](u32 from, u32 to) {
+        // Code points above 0xff can never match a single byte.
+        for (u32 byte = from; byte <= min(to, 0xffu); ++byte)
+            leading_bytes[byte] = true;
+    };
+
+    auto arguments_count = bytecode.at(position + 1);
+    auto argument_position = position + 3;
+    for (size_t i = 0; i < arguments_count; ++i) {
+        switch (static_cast<CharacterCompareType>(bytecode.at(argument_position++))) {
+        case CharacterCompareType::Char: {
+            auto value = bytecode.at(argument_position++);
+            add_range(value, value);
+            break;
+        }
+        case CharacterCompareType::String: {
+            // Inside a class, a string is one of the alternatives; it's too rare to care about.
+            auto length = bytecode.at(argument_position++);
+            if (arguments_count != 1 || length == 0)
+                return false;
+            auto value = bytecode.at(argument_position);
+            add_range(value, value);
+            argument_position += length;
+            break;
+        }
+        case CharacterCompareType::CharRange: {
+            CharRange range { bytecode.at(argument_position++) };
+            add_range(range.from, range.to);
+            break;
+        }
+        case CharacterCompareType::LookupTable: {
+            auto count = bytecode.at(argument_position++);
+            for (size_t j = 0; j < count; ++j) {
+                CharRange range { bytecode.at(argument_position++) };
+                add_range(range.from, range.to);
+            }
+            break;
+        }
+        case CharacterCompareType::CharClass: {
+            auto character_class = static_cast<CharClass>(bytecode.at(argument_position++));
+            for (size_t byte = 0; byte < 256; ++byte) {
+                if (byte_may_match_character_class(byte, character_class))
+                    leading_bytes[byte] = true;
+            }
+            break;
+        }
+        default:
+            // Inverted classes, Unicode properties and backreferences can start with just about anything.
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the string a Compare at `position` consumes, if it only consumes a fixed ASCII string.
+static Optional<StringView> literal_of_compare(ByteCode const& bytecode, size_t position, StringBuilder& storage)
+{
+    if (bytecode.at(position + 1) != 1)
+        return {};
+
+    auto argument_position = position + 3;
+    size_t length = 1;
+    switch (static_cast<CharacterCompareType>(bytecode.at(argument_position++))) {
+    case CharacterCompareType::Char:
+        break;
+    case CharacterCompareType::String:
+        length = bytecode.at(argument_position++);
+        break;
+    default:
+        return {};
+    }
+
+    storage.clear();
+    for (size_t i = 0; i < length; ++i) {
+        auto value = bytecode.at(argument_position + i);
+        if (!is_ascii(value))
+            return {};
+        storage.append(static_cast<char>(value));
+    }
+    return storage.string_view();
+}
+
+template<typename Parser>
+void Regex<Parser>::attempt_extract_prefilter()
+{
+    auto& bytecode = parser_result.bytecode;
+    auto bytecode_size = bytecode.size();
+    Prefilter prefilter;
+    StringBuilder literal;
+    MatchState state;
+
+    auto is_zero_width = [](OpCodeId id) {
+        switch (id) {
+        case OpCodeId::Checkpoint:
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary:
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            return true;
+        default:
+            return false;
+        }
+    };
+
+    // The literal prefix: every match starts by running the bytecode up to the first fork or jump, e.g. "foo" in foo\d+.
+    StringBuilder prefix;
+    for (state.instruction_position = 0; state.instruction_position < bytecode_size;) {
+        auto& opcode = bytecode.get_opcode(state);
+        if (opcode.opcode_id() == OpCodeId::Compare) {
+            auto string = literal_of_compare(bytecode, state.instruction_position, literal);
+            if (!string.has_value())
+                break;
+            prefix.append(*string);
+        } else if (!is_zero_width(opcode.opcode_id())) {
+            break;
+        }
+        state.instruction_position += opcode.size();
+    }
+
+    if (!prefix.is_empty()) {
+        prefilter.set_literal_prefix(prefix.to_byte_string());
+    } else {
+        // The leading bytes: whatever the first Compare on each path from the start can consume, e.g. [0-9a-f] in
+        // (\d|[a-f])+. If some path can get to the end without consuming anything, there is nothing to filter on.
+        Array<bool, 256> leading_bytes {};
+        Vector<size_t> positions_to_visit { 0 };
+        HashTable<size_t> visited;
+        auto has_leading_bytes = [&] {
+            while (!positions_to_visit.is_empty()) {
+                auto position = positions_to_visit.take_last();
+                if (visited.set(position) != HashSetResult::InsertedNewEntry)
+                    continue;
+                if (position >= bytecode_size)
+                    return false;
+
+                state.instruction_position = position;
+                auto& opcode = bytecode.get_opcode(state);
+                auto next_position = position + opcode.size();
+                switch (opcode.opcode_id()) {
+                case OpCodeId::Compare:
+                    if (!collect_leading_bytes_of_compare(bytecode, position, leading_bytes))
+                        return false;
+                    break;
+                case OpCodeId::Jump:
+                    positions_to_visit.append(next_position + static_cast<OpCode_Jump const&>(opcode).offset());
+                    break;
+                case OpCodeId::JumpNonEmpty:
+                    positions_to_visit.append(next_position + static_cast<OpCode_JumpNonEmpty const&>(opcode).offset());
+                    positions_to_visit.append(next_position);
+                    break;
+                case OpCodeId::ForkJump:
+                case OpCodeId::ForkReplaceJump:
+                    positions_to_visit.append(next_position + static_cast<OpCode_ForkJump const&>(opcode).offset());
+                    positions_to_visit.append(next_position);
+                    break;
+                case OpCodeId::ForkStay:
+                case OpCodeId::ForkReplaceStay:
+                    positions_to_visit.append(next_position + static_cast<OpCode_ForkStay const&>(opcode).offset());
+                    positions_to_visit.append(next_position);
+                    break;
+                default:
+                    if (!is_zero_width(opcode.opcode_id()))
+                        return false;
+                    positions_to_visit.append(next_position);
+                    break;
+                }
+            }
+            return true;
+        }();
+        if (has_leading_bytes)
+            prefilter.set_leading_bytes(leading_bytes);
+    }
+
+    // The required literal: the longest run of literal compares that every match has to go through, e.g. "@example.com"
+    // in \w+@example\.com. A compare is on every path if no forward jump skips over it; backward jumps only repeat
+    // things. Lookarounds are left alone, as whatever they compare doesn't have to be there in the negative case.
+    Vector<Detail::Block> forward_jumps;
+    for (state.instruction_position = 0; state.instruction_position < bytecode_size;) {
+        auto& opcode = bytecode.get_opcode(state);
+        auto next_position = state.instruction_position + opcode.size();
+        Optional<ssize_t> offset;
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Jump:
+            offset = static_cast<OpCode_Jump const&>(opcode).offset();
+            break;
+        case OpCodeId::JumpNonEmpty:
+            offset = static_cast<OpCode_JumpNonEmpty const&>(opcode).offset();
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            offset = static_cast<OpCode_ForkJump const&>(opcode).offset();
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            offset = static_cast<OpCode_ForkStay const&>(opcode).offset();
+            break;
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::FailForks:
+        case OpCodeId::Exit:
+            forward_jumps.append({ 0, bytecode_size });
+            break;
+        default:
+            break;
+        }
+        if (offset.has_value() && *offset > 0)
+            forward_jumps.append({ state.instruction_position, next_position + *offset });
+        state.instruction_position = next_position;
+    }
+
+    auto is_on_every_path = [&](size_t position) {
+        return all_of(forward_jumps, [&](auto& jump) { return position <= jump.start || position >= jump.end; });
+    };
+
+    StringBuilder current_run;
+    ByteString required_literal;
+    for (state.instruction_position = 0; state.instruction_position < bytecode_size;) {
+        auto& opcode = bytecode.get_opcode(state);
+        Optional<StringView> string;
+        if (opcode.opcode_id() == OpCodeId::Compare && is_on_every_path(state.instruction_position))
+            string = literal_of_compare(bytecode, state.instruction_position, literal);
+
+        if (string.has_value()) {
+            current_run.append(*string);
+            if (current_run.length() > required_literal.length())
+                required_literal = current_run.to_byte_string();
+        } else if (!is_zero_width(opcode.opcode_id())) {
+            current_run.clear();
+        }
+        state.instruction_position += opcode.size();
+    }
+
+    // The literal prefix already checks for itself.
+    if (required_literal.length() > prefix.length())
+        prefilter.set_required_literal(move(required_literal));
+
+    if (!prefilter.is_useful())
+        return;
+
+    dbgln_if(REGEX_DEBUG, "Prefilter for '{}': {}", pattern_value, prefilter.to_byte_string());
+    parser_result.optimization_data.prefilter = move(prefilter);
+}
+
 void Optimizer::append_alternation(ByteCode& target, ByteCode&& left, ByteCode&& right)
 {
     Array<ByteCode, 2> alternatives;
@@ -9,7 +9,9 @@
 #include "RegexByteCode.h"
 #include "RegexError.h"
 #include "RegexLexer.h"
+#include "RegexNFA.h"
 #include "RegexOptions.h"
+#include "RegexPrefilter.h"
 
 #include <AK/Forward.h>
 #include <AK/StringBuilder.h>
@@ -58,6 +60,10 @@ public:
 
         struct {
             Optional<ByteString> pure_substring_search;
+            // If set, matching runs in linear time on this instead of on the backtracking VM.
+            Optional<NFAProgram> nfa;
+            // If set, only positions this lets through have to be tried.
+            Optional<Prefilter> prefilter;
         } optimization_data {};
     };
 
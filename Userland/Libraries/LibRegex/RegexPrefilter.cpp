@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "RegexPrefilter.h"
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/MemMem.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
+#include <AK/StringBuilder.h>
+
+namespace regex {
+
+using AK::SIMD::u8x16;
+
+static constexpr size_t max_leading_byte_ranges = 4;
+
+void Prefilter::set_leading_bytes(Array<bool, 256> const& leading_bytes)
+{
+    m_has_leading_bytes = true;
+    m_is_leading_byte = leading_bytes;
+
+    m_leading_byte_ranges.clear_with_capacity();
+    for (size_t byte = 0; byte < 256; ++byte) {
+        if (!leading_bytes[byte])
+            continue;
+        if (!m_leading_byte_ranges.is_empty() && m_leading_byte_ranges.last().to == byte - 1) {
+            m_leading_byte_ranges.last().to = byte;
+            continue;
+        }
+        if (m_leading_byte_ranges.size() == max_leading_byte_ranges) {
+            m_leading_byte_ranges.clear_with_capacity();
+            break;
+        }
+        m_leading_byte_ranges.append({ static_cast<u8>(byte), static_cast<u8>(byte) });
+    }
+}
+
+void Prefilter::set_literal_prefix(ByteString prefix)
+{
+    VERIFY(!prefix.is_empty());
+
+    Array<bool, 256> leading_bytes {};
+    leading_bytes[static_cast<u8>(prefix[0])] = true;
+    set_leading_bytes(leading_bytes);
+
+    m_literal_prefix = move(prefix);
+}
+
+void Prefilter::set_required_literal(ByteString literal)
+{
+    m_required_literal = move(literal);
+}
+
+Optional<size_t> Prefilter::find_leading_byte(ReadonlyBytes haystack, size_t start) const
+{
+    auto position = start;
+
+    if (!m_leading_byte_ranges.is_empty()) {
+        u8x16 range_starts[max_leading_byte_ranges];
+        u8x16 range_widths[max_leading_byte_ranges];
+        for (size_t i = 0; i < m_leading_byte_ranges.size(); ++i) {
+            range_starts[i] = u8x16 {} + m_leading_byte_ranges[i].from;
+            range_widths[i] = u8x16 {} + static_cast<u8>(m_leading_byte_ranges[i].to - m_leading_byte_ranges[i].from);
+        }
+
+        for (; position + sizeof(u8x16) <= haystack.size(); position += sizeof(u8x16)) {
+            auto chunk = AK::SIMD::load_unaligned<u8x16>(haystack.offset(position));
+
+            // Unsigned wrap-around turns each range check into a single comparison.
+            auto hits = (chunk - range_starts[0]) <= range_widths[0];
+            for (size_t i = 1; i < m_leading_byte_ranges.size(); ++i)
+                hits |= (chunk - range_starts[i]) <= range_widths[i];
+
+            u64 halves[2];
+            __builtin_memcpy(halves, &hits, sizeof(halves));
+            // NOTE: This assumes a little-endian host, the first byte of the chunk ends up in the lowest bits.
+            if (halves[0] != 0)
+                return position + count_trailing_zeroes(halves[0]) / 8;
+            if (halves[1] != 0)
+                return position + sizeof(u64) + count_trailing_zeroes(halves[1]) / 8;
+        }
+    }
+
+    for (; position < haystack.size(); ++position) {
+        if (m_is_leading_byte[haystack[position]])
+            return position;
+    }
+    return {};
+}
+
+Optional<size_t> Prefilter::find_candidate(ReadonlyBytes haystack, size_t start) const
+{
+    if (!m_has_leading_bytes)
+        return start;
+
+    while (start < haystack.size()) {
+        auto position = find_leading_byte(haystack, start);
+        if (!position.has_value())
+            return {};
+
+        if (m_literal_prefix.length() <= 1)
+            return position;
+
+        if (m_literal_prefix.length() > haystack.size() - *position)
+            return {};
+        if (__builtin_memcmp(haystack.offset(*position), m_literal_prefix.characters(), m_literal_prefix.length()) == 0)
+            return position;
+
+        start = *position + 1;
+    }
+    return {};
+}
+
+bool Prefilter::may_contain_match(ReadonlyBytes haystack) const
+{
+    if (m_required_literal.is_empty())
+        return true;
+    return AK::memmem_optional(haystack.data(), haystack.size(), m_required_literal.characters(), m_required_literal.length()).has_value();
+}
+
+ByteString Prefilter::to_byte_string() const
+{
+    StringBuilder builder;
+    if (!m_literal_prefix.is_empty())
+        builder.appendff("prefix '{}' ", m_literal_prefix);
+    if (!m_required_literal.is_empty())
+        builder.appendff("required literal '{}' ", m_required_literal);
+    if (m_has_leading_bytes) {
+        builder.append("leading bytes"sv);
+        for (size_t byte = 0; byte < 256; ++byte) {
+            if (m_is_leading_byte[byte])
+                builder.appendff(" {:02x}", byte);
+        }
+    }
+    return builder.to_byte_string();
+}
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/ByteString.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// Facts about every possible match of a pattern that can be checked against the raw bytes of the input much faster
+// than the VM could, so that the matcher only has to run the VM at positions where a match can actually start.
+// These work on bytes, so they only apply to non-Unicode, case-sensitive matching of a StringView.
+class Prefilter {
+public:
+    // Every match starts with one of these bytes.
+    void set_leading_bytes(Array<bool, 256> const&);
+
+    // Every match starts with this string.
+    void set_literal_prefix(ByteString);
+
+    // Every match contains this string somewhere.
+    void set_required_literal(ByteString);
+
+    bool is_useful() const { return m_has_leading_bytes || !m_required_literal.is_empty(); }
+
+    // Returns the first position at or after `start` where a match could start.
+    Optional<size_t> find_candidate(ReadonlyBytes haystack, size_t start) const;
+
+    // Returns false if nothing in the haystack can match.
+    bool may_contain_match(ReadonlyBytes haystack) const;
+
+    ByteString to_byte_string() const;
+
+private:
+    struct ByteRange {
+        u8 from;
+        u8 to;
+    };
+
+    Optional<size_t> find_leading_byte(ReadonlyBytes haystack, size_t start) const;
+
+    ByteString m_literal_prefix;
+    ByteString m_required_literal;
+
+    bool m_has_leading_bytes { false };
+    Array<bool, 256> m_is_leading_byte {};
+
+    // The leading bytes as a few ranges, which can be checked for sixteen bytes at a time. Empty if they don't fit.
+    Vector<ByteRange, 4> m_leading_byte_ranges;
+};
+
+}
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <AK/ByteString.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -760,16 +761,40 @@ private:
 class Statement : public ASTNode {
 public:
     ResultOr<ResultSet> execute(AK::NonnullRefPtr<Database> database, ReadonlySpan<Value> placeholder_values = {}) const;
+    ResultOr<NonnullOwnPtr<Cursor>> open_cursor(AK::NonnullRefPtr<Database> database, ReadonlySpan<Value> placeholder_values = {}) const;
 
     virtual ResultOr<ResultSet> execute(ExecutionContext&) const
     {
         return Result { SQLCommand::Unknown, SQLErrorCode::NotYetImplemented };
     }
+
+    // By default, the statement is executed when the cursor is opened, and the cursor returns the rows of its result.
+    virtual ResultOr<NonnullOwnPtr<Cursor>> open_cursor(ExecutionContext&) const;
+
+    virtual ResultOr<Vector<ByteString>> query_plan(ExecutionContext&) const
+    {
+        return Result { SQLCommand::Explain, SQLErrorCode::NotYetImplemented, "EXPLAIN is only supported for SELECT, UPDATE, and DELETE statements"sv };
+    }
 };
 
 class ErrorStatement final : public Statement {
 };
 
+class Explain : public Statement {
+public:
+    explicit Explain(NonnullRefPtr<Statement> statement)
+        : m_statement(move(statement))
+    {
+    }
+
+    NonnullRefPtr<Statement> const& statement() const { return m_statement; }
+
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    NonnullRefPtr<Statement> m_statement;
+};
+
 class CreateSchema : public Statement {
 public:
     CreateSchema(ByteString schema_name, bool is_error_if_schema_exists)
@@ -831,6 +856,38 @@ private:
     bool m_is_error_if_table_exists;
 };
 
+class CreateIndex : public Statement {
+public:
+    struct IndexedColumn {
+        ByteString column_name;
+        Order order { Order::Ascending };
+    };
+
+    CreateIndex(ByteString schema_name, ByteString index_name, ByteString table_name, Vector<IndexedColumn> indexed_columns, bool is_error_if_index_exists)
+        : m_schema_name(move(schema_name))
+        , m_index_name(move(index_name))
+        , m_table_name(move(table_name))
+        , m_indexed_columns(move(indexed_columns))
+        , m_is_error_if_index_exists(is_error_if_index_exists)
+    {
+    }
+
+    ByteString const& schema_name() const { return m_schema_name; }
+    ByteString const& index_name() const { return m_index_name; }
+    ByteString const& table_name() const { return m_table_name; }
+    Vector<IndexedColumn> const& indexed_columns() const { return m_indexed_columns; }
+    bool is_error_if_index_exists() const { return m_is_error_if_index_exists; }
+
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    ByteString m_schema_name;
+    ByteString m_index_name;
+    ByteString m_table_name;
+    Vector<IndexedColumn> m_indexed_columns;
+    bool m_is_error_if_index_exists;
+};
+
 class AlterTable : public Statement {
 public:
     ByteString const& schema_name() const { return m_schema_name; }
@@ -1023,6 +1080,7 @@ public:
     RefPtr<ReturningClause> const& returning_clause() const { return m_returning_clause; }
 
     virtual ResultOr<ResultSet> execute(ExecutionContext&) const override;
+    virtual ResultOr<Vector<ByteString>> query_plan(ExecutionContext&) const override;
 
 private:
     RefPtr<CommonTableExpressionList> m_common_table_expression_list;
@@ -1050,6 +1108,7 @@ public:
     RefPtr<ReturningClause> const& returning_clause() const { return m_returning_clause; }
 
     virtual ResultOr<ResultSet> execute(ExecutionContext&) const override;
+    virtual ResultOr<Vector<ByteString>> query_plan(ExecutionContext&) const override;
 
 private:
     RefPtr<CommonTableExpressionList> m_common_table_expression_list;
@@ -1081,6 +1140,8 @@ public:
     Vector<NonnullRefPtr<OrderingTerm>> const& ordering_term_list() const { return m_ordering_term_list; }
     RefPtr<LimitClause> const& limit_clause() const { return m_limit_clause; }
     ResultOr<ResultSet> execute(ExecutionContext&) const override;
+    ResultOr<NonnullOwnPtr<Cursor>> open_cursor(ExecutionContext&) const override;
+    ResultOr<Vector<ByteString>> query_plan(ExecutionContext&) const override;
 
 private:
     RefPtr<CommonTableExpressionList> m_common_table_expression_list;
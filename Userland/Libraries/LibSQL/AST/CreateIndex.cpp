@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Meta.h>
+
+namespace SQL::AST {
+
+ResultOr<ResultSet> CreateIndex::execute(ExecutionContext& context) const
+{
+    auto table_def = TRY(context.database->get_table(m_schema_name, m_table_name));
+    auto index_def = TRY(IndexDef::create(table_def, m_index_name, false));
+
+    for (auto const& indexed_column : m_indexed_columns) {
+        auto column_index = table_def->columns().find_first_index_if([&](auto const& column) { return column->name() == indexed_column.column_name; });
+        if (!column_index.has_value())
+            return Result { SQLCommand::Create, SQLErrorCode::ColumnDoesNotExist, indexed_column.column_name };
+
+        if (indexed_column.order == Order::Descending)
+            return Result { SQLCommand::Create, SQLErrorCode::NotYetImplemented, "Descending indexes are not yet implemented"sv };
+
+        index_def->append_column(indexed_column.column_name, table_def->columns()[*column_index]->type());
+    }
+
+    if (auto result = context.database->add_index(*table_def, *index_def); result.is_error()) {
+        if (result.error().error() != SQLErrorCode::IndexExists || m_is_error_if_index_exists)
+            return result.release_error();
+    }
+
+    return ResultSet { SQLCommand::Create };
+}
+
+}
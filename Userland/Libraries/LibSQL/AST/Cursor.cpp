@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/AST/Cursor.h>
+
+namespace SQL::AST {
+
+class ResultSetCursor final : public Cursor {
+public:
+    explicit ResultSetCursor(ResultSet result)
+        : Cursor(result.column_names())
+        , m_result(move(result))
+    {
+    }
+
+private:
+    virtual ResultOr<Optional<Vector<Value>>> read_next_row() override
+    {
+        if (m_next_row_index == m_result.size())
+            return Optional<Vector<Value>> {};
+        return m_result[m_next_row_index++].row.take_data();
+    }
+
+    ResultSet m_result;
+    size_t m_next_row_index { 0 };
+};
+
+ErrorOr<NonnullOwnPtr<Cursor>> Cursor::create(ResultSet result)
+{
+    return adopt_nonnull_own_or_enomem<Cursor>(new (nothrow) ResultSetCursor(move(result)));
+}
+
+ResultOr<bool> Cursor::has_next_row()
+{
+    if (m_next_row.has_value())
+        return true;
+    if (m_is_exhausted)
+        return false;
+
+    m_next_row = TRY(read_next_row());
+    m_is_exhausted = !m_next_row.has_value();
+    return !m_is_exhausted;
+}
+
+ResultOr<Vector<Vector<Value>>> Cursor::fetch(size_t max_row_count)
+{
+    Vector<Vector<Value>> rows;
+
+    while (rows.size() < max_row_count && TRY(has_next_row())) {
+        TRY(rows.try_append(m_next_row.release_value()));
+    }
+
+    m_fetched_row_count += rows.size();
+    return rows;
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Result.h>
+#include <LibSQL/ResultSet.h>
+#include <LibSQL/Value.h>
+
+namespace SQL::AST {
+
+/**
+ * A Cursor produces the rows of a statement's result when they are fetched.
+ * SELECT statements on a single table whose rows don't have to be sorted
+ * read each row from the table when it is fetched, so only the rows that are
+ * fetched at once are held in memory. Other statements are executed as a
+ * whole when the cursor is opened, and their result is fetched from memory.
+ */
+class Cursor {
+    AK_MAKE_NONCOPYABLE(Cursor);
+    AK_MAKE_NONMOVABLE(Cursor);
+
+public:
+    static ErrorOr<NonnullOwnPtr<Cursor>> create(ResultSet);
+    virtual ~Cursor() = default;
+
+    Vector<ByteString> const& column_names() const { return m_column_names; }
+    size_t fetched_row_count() const { return m_fetched_row_count; }
+
+    ResultOr<bool> has_next_row();
+
+    // Returns at most the given number of rows. Fewer rows are only returned once the result is exhausted.
+    ResultOr<Vector<Vector<Value>>> fetch(size_t max_row_count);
+
+protected:
+    explicit Cursor(Vector<ByteString> column_names)
+        : m_column_names(move(column_names))
+    {
+    }
+
+    virtual ResultOr<Optional<Vector<Value>>> read_next_row() = 0;
+
+private:
+    Vector<ByteString> m_column_names;
+    Optional<Vector<Value>> m_next_row;
+    bool m_is_exhausted { false };
+    size_t m_fetched_row_count { 0 };
+};
+
+}
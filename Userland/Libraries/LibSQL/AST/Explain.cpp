@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/ResultSet.h>
+#include <LibSQL/Tuple.h>
+
+namespace SQL::AST {
+
+ResultOr<ResultSet> Explain::execute(ExecutionContext& context) const
+{
+    auto query_plan = TRY(m_statement->query_plan(context));
+
+    auto descriptor = adopt_ref(*new TupleDescriptor);
+    descriptor->append({ .name = "detail" });
+
+    ResultSet result { SQLCommand::Explain, { "detail" } };
+    TRY(result.try_ensure_capacity(query_plan.size()));
+
+    for (auto& step : query_plan) {
+        Tuple tuple(descriptor);
+        tuple[0] = move(step);
+
+        result.insert_row(tuple, Tuple {});
+    }
+
+    return result;
+}
+
+}
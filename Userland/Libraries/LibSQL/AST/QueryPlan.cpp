@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AllOf.h>
+#include <AK/HashMap.h>
+#include <AK/TypeCasts.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Row.h>
+
+namespace SQL::AST {
+
+struct ColumnBound {
+    Value value;
+    bool inclusive { true };
+};
+
+// What the WHERE clause tells us about the values of a single column. Values are normalized the same way as the
+// values in index keys, so that they can be compared with each other and used as bounds of an index scan.
+struct ColumnConstraint {
+    Optional<Value> equal_to;
+    Optional<ColumnBound> lower;
+    Optional<ColumnBound> upper;
+
+    // NULL compares less than any other value, so only equality and lower bounds exclude rows with a NULL in the column.
+    bool excludes_null() const { return equal_to.has_value() || lower.has_value(); }
+};
+
+// Splits `a AND (b AND c)` into its terms a, b, and c. A row only matches the expression if it matches every term.
+static void collect_conjunction_terms(Expression const& expression, Vector<Expression const*>& terms)
+{
+    if (is<BinaryOperatorExpression>(expression)) {
+        auto const& binary_operator_expression = verify_cast<BinaryOperatorExpression>(expression);
+        if (binary_operator_expression.type() == BinaryOperator::And) {
+            collect_conjunction_terms(*binary_operator_expression.lhs(), terms);
+            collect_conjunction_terms(*binary_operator_expression.rhs(), terms);
+            return;
+        }
+    }
+
+    if (is<ChainedExpression>(expression)) {
+        auto const& chained_expression = verify_cast<ChainedExpression>(expression);
+        if (chained_expression.expressions().size() == 1) {
+            collect_conjunction_terms(*chained_expression.expressions().first(), terms);
+            return;
+        }
+    }
+
+    terms.append(&expression);
+}
+
+static bool is_constant(Expression const& expression)
+{
+    if (is<NumericLiteral>(expression) || is<StringLiteral>(expression) || is<BooleanLiteral>(expression) || is<NullLiteral>(expression) || is<Placeholder>(expression))
+        return true;
+    if (is<UnaryOperatorExpression>(expression))
+        return is_constant(*verify_cast<UnaryOperatorExpression>(expression).expression());
+    return false;
+}
+
+static RefPtr<ColumnDef> referenced_column(Expression const& expression, TableDef const& table)
+{
+    if (!is<ColumnNameExpression>(expression))
+        return {};
+
+    auto const& column_name_expression = verify_cast<ColumnNameExpression>(expression);
+    if (!column_name_expression.table_name().is_empty() && column_name_expression.table_name() != table.name())
+        return {};
+
+    for (auto const& column : table.columns()) {
+        if (column->name() == column_name_expression.column_name())
+            return column;
+    }
+    return {};
+}
+
+// Returns the operator that gives the same result when the operands are swapped, i.e. `1 < a` is `a > 1`.
+static BinaryOperator swap_operands(BinaryOperator type)
+{
+    switch (type) {
+    case BinaryOperator::LessThan:
+        return BinaryOperator::GreaterThan;
+    case BinaryOperator::LessThanEquals:
+        return BinaryOperator::GreaterThanEquals;
+    case BinaryOperator::GreaterThan:
+        return BinaryOperator::LessThan;
+    case BinaryOperator::GreaterThanEquals:
+        return BinaryOperator::LessThanEquals;
+    default:
+        return type;
+    }
+}
+
+static void tighten_lower_bound(Optional<ColumnBound>& lower, ColumnBound bound)
+{
+    if (lower.has_value()) {
+        auto comparison = bound.value.compare(lower->value);
+        if (comparison < 0 || (comparison == 0 && lower->inclusive <= bound.inclusive))
+            return;
+    }
+    lower = move(bound);
+}
+
+static void tighten_upper_bound(Optional<ColumnBound>& upper, ColumnBound bound)
+{
+    if (upper.has_value()) {
+        auto comparison = bound.value.compare(upper->value);
+        if (comparison > 0 || (comparison == 0 && upper->inclusive <= bound.inclusive))
+            return;
+    }
+    upper = move(bound);
+}
+
+static ResultOr<HashMap<ByteString, ColumnConstraint>> collect_column_constraints(ExecutionContext& context, TableDef const& table, Expression const& where_clause)
+{
+    Vector<Expression const*> terms;
+    collect_conjunction_terms(where_clause, terms);
+
+    HashMap<ByteString, ColumnConstraint> constraints;
+
+    for (auto const* term : terms) {
+        if (!is<BinaryOperatorExpression>(*term))
+            continue;
+
+        auto const& comparison = verify_cast<BinaryOperatorExpression>(*term);
+        auto type = comparison.type();
+
+        auto column = referenced_column(*comparison.lhs(), table);
+        auto const* value_expression = comparison.rhs().ptr();
+        if (!column) {
+            column = referenced_column(*comparison.rhs(), table);
+            value_expression = comparison.lhs().ptr();
+            type = swap_operands(type);
+        }
+        if (!column || !is_constant(*value_expression))
+            continue;
+
+        auto value = TRY(value_expression->evaluate(context));
+        if (!value.is_type_compatible_with(column->type()))
+            continue;
+
+        auto index_value = Database::index_value(value, column->type());
+        if (!index_value.has_value())
+            continue;
+
+        switch (type) {
+        case BinaryOperator::Equals: {
+            auto& constraint = constraints.ensure(column->name());
+            if (!constraint.equal_to.has_value())
+                constraint.equal_to = index_value.release_value();
+            break;
+        }
+        case BinaryOperator::GreaterThan:
+        case BinaryOperator::GreaterThanEquals:
+            tighten_lower_bound(constraints.ensure(column->name()).lower, { index_value.release_value(), type == BinaryOperator::GreaterThanEquals });
+            break;
+        case BinaryOperator::LessThan:
+        case BinaryOperator::LessThanEquals:
+            tighten_upper_bound(constraints.ensure(column->name()).upper, { index_value.release_value(), type == BinaryOperator::LessThanEquals });
+            break;
+        default:
+            break;
+        }
+    }
+
+    return constraints;
+}
+
+ResultOr<QueryPlan> QueryPlan::create(ExecutionContext& context, NonnullRefPtr<TableDef> table, RefPtr<Expression> const& where_clause, Vector<NonnullRefPtr<OrderingTerm>> const& ordering_terms)
+{
+    QueryPlan plan { move(table) };
+    plan.m_has_ordering = !ordering_terms.is_empty();
+    plan.m_satisfies_ordering = ordering_terms.is_empty();
+
+    if (!where_clause || plan.m_table->num_indexes() == 0)
+        return plan;
+
+    auto constraints = TRY(collect_column_constraints(context, *plan.m_table, *where_clause));
+    if (constraints.is_empty())
+        return plan;
+
+    // An index is most useful if it can be scanned for a single combination of values of its leading columns, followed
+    // by a range of values of the next column.
+    RefPtr<IndexDef> best_index;
+    size_t best_equal_columns = 0;
+    bool best_has_range = false;
+
+    for (auto const& index : plan.m_table->indexes()) {
+        auto const& key_parts = index->key_definition();
+
+        // Rows with a NULL in any of the indexed columns are not in the index, so it can only be used if the WHERE
+        // clause can't match those rows.
+        if (!all_of(key_parts, [&](auto const& key_part) {
+                auto constraint = constraints.get(key_part->name());
+                return constraint.has_value() && constraint->excludes_null();
+            }))
+            continue;
+
+        size_t equal_columns = 0;
+        while (equal_columns < key_parts.size() && constraints.get(key_parts[equal_columns]->name())->equal_to.has_value())
+            ++equal_columns;
+
+        bool has_range = false;
+        if (equal_columns < key_parts.size()) {
+            auto const& constraint = *constraints.get(key_parts[equal_columns]->name());
+            has_range = constraint.lower.has_value() || constraint.upper.has_value();
+        }
+
+        if (!best_index || (equal_columns * 2 + has_range) > (best_equal_columns * 2 + best_has_range)) {
+            best_index = index;
+            best_equal_columns = equal_columns;
+            best_has_range = has_range;
+        }
+    }
+
+    if (!best_index)
+        return plan;
+
+    plan.m_index = best_index;
+    auto const& key_parts = best_index->key_definition();
+
+    for (size_t ix = 0; ix < best_equal_columns; ++ix) {
+        auto const& name = key_parts[ix]->name();
+        auto const& value = *constraints.get(name)->equal_to;
+
+        plan.m_range.lower.append(value);
+        plan.m_range.upper.append(value);
+        plan.m_index_constraints.append(ByteString::formatted("{}=?", name));
+    }
+
+    if (best_has_range) {
+        auto const& name = key_parts[best_equal_columns]->name();
+        auto const& constraint = *constraints.get(name);
+
+        if (constraint.lower.has_value()) {
+            plan.m_range.lower.append(constraint.lower->value);
+            plan.m_range.lower_inclusive = constraint.lower->inclusive;
+            plan.m_index_constraints.append(ByteString::formatted("{}{}?", name, constraint.lower->inclusive ? ">="sv : ">"sv));
+        }
+        if (constraint.upper.has_value()) {
+            plan.m_range.upper.append(constraint.upper->value);
+            plan.m_range.upper_inclusive = constraint.upper->inclusive;
+            plan.m_index_constraints.append(ByteString::formatted("{}{}?", name, constraint.upper->inclusive ? "<="sv : "<"sv));
+        }
+    }
+
+    // The index returns rows sorted by the columns that follow the ones that are compared for equality. Those have
+    // the same value in every row, so they may be part of the ordering terms as well.
+    size_t next_key_part = best_equal_columns;
+    plan.m_satisfies_ordering = all_of(ordering_terms, [&](auto const& term) {
+        if (term->order() != Order::Ascending || !term->collation_name().is_empty())
+            return false;
+
+        auto column = referenced_column(*term->expression(), *plan.m_table);
+        if (!column)
+            return false;
+
+        for (size_t ix = 0; ix < best_equal_columns; ++ix) {
+            if (key_parts[ix]->name() == column->name())
+                return true;
+        }
+
+        if (next_key_part < key_parts.size() && key_parts[next_key_part]->name() == column->name()) {
+            ++next_key_part;
+            return true;
+        }
+        return false;
+    });
+
+    return plan;
+}
+
+ErrorOr<Vector<Row>> QueryPlan::rows(Database& database) const
+{
+    if (!m_index)
+        return database.select_all(*m_table);
+    return database.select_range(*m_table, *m_index, m_range);
+}
+
+ErrorOr<NonnullOwnPtr<RowScan>> QueryPlan::scan(Database& database) const
+{
+    if (!m_index)
+        return database.scan_all(*m_table);
+    return database.scan_range(*m_table, *m_index, m_range);
+}
+
+Vector<ByteString> QueryPlan::describe() const
+{
+    Vector<ByteString> steps;
+
+    if (m_index)
+        steps.append(ByteString::formatted("SEARCH {} USING INDEX {} ({})", m_table->name(), m_index->name(), ByteString::join(" AND "sv, m_index_constraints)));
+    else
+        steps.append(ByteString::formatted("SCAN {}", m_table->name()));
+
+    if (m_has_ordering && !m_satisfies_ordering)
+        steps.append("SORT ROWS FOR ORDER BY");
+
+    return steps;
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Result.h>
+
+namespace SQL::AST {
+
+/**
+ * A QueryPlan decides how the rows of a single table are read for a statement. If the WHERE clause
+ * compares indexed columns with constant values, the rows are read with a range scan of that index
+ * instead of reading every row of the table. The WHERE clause must still be evaluated for every row
+ * the plan returns, as the plan is only guaranteed to return all the rows that can match it.
+ */
+class QueryPlan {
+public:
+    static ResultOr<QueryPlan> create(ExecutionContext&, NonnullRefPtr<TableDef>, RefPtr<Expression> const& where_clause, Vector<NonnullRefPtr<OrderingTerm>> const& ordering_terms);
+
+    bool uses_index() const { return !m_index.is_null(); }
+
+    // Whether the rows are returned in the order asked for by the ordering terms, so that they don't have to be sorted.
+    bool satisfies_ordering() const { return m_satisfies_ordering; }
+
+    ErrorOr<Vector<Row>> rows(Database&) const;
+    ErrorOr<NonnullOwnPtr<RowScan>> scan(Database&) const;
+    Vector<ByteString> describe() const;
+
+private:
+    explicit QueryPlan(NonnullRefPtr<TableDef> table)
+        : m_table(move(table))
+    {
+    }
+
+    NonnullRefPtr<TableDef> m_table;
+    RefPtr<IndexDef> m_index;
+    IndexRange m_range;
+    Vector<ByteString> m_index_constraints;
+    bool m_has_ordering { false };
+    bool m_satisfies_ordering { false };
+};
+
+}
@@ -6,6 +6,8 @@
 
 #include <AK/NumericLimits.h>
 #include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/Cursor.h>
+#include <LibSQL/AST/QueryPlan.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
@@ -37,15 +39,21 @@ static ByteString result_column_name(ResultColumn const& column, size_t column_i
     return fallback_column_name();
 }
 
-ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
-{
+struct ResultColumns {
     Vector<NonnullRefPtr<ResultColumn const>> columns;
-    Vector<ByteString> column_names;
+    Vector<ByteString> names;
+};
+
+static ResultOr<ResultColumns> resolve_result_columns(Select const& select, ExecutionContext& context)
+{
+    ResultColumns result_columns;
+    auto& columns = result_columns.columns;
+    auto& column_names = result_columns.names;
 
-    auto const& result_column_list = this->result_column_list();
+    auto const& result_column_list = select.result_column_list();
     VERIFY(!result_column_list.is_empty());
 
-    for (auto& table_descriptor : table_or_subquery_list()) {
+    for (auto& table_descriptor : select.table_or_subquery_list()) {
         if (!table_descriptor->is_table())
             return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
 
@@ -83,6 +91,45 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
         }
     }
 
+    return result_columns;
+}
+
+struct RowLimit {
+    size_t offset { 0 };
+    size_t limit { NumericLimits<size_t>::max() };
+};
+
+static ResultOr<RowLimit> evaluate_limit_clause(LimitClause const& limit_clause, ExecutionContext& context)
+{
+    RowLimit row_limit;
+
+    auto limit = TRY(limit_clause.limit_expression()->evaluate(context));
+    if (!limit.is_null()) {
+        auto limit_value_maybe = limit.to_int<size_t>();
+        if (!limit_value_maybe.has_value())
+            return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "LIMIT clause must evaluate to an integer value"sv };
+
+        row_limit.limit = limit_value_maybe.value();
+    }
+
+    if (limit_clause.offset_expression() != nullptr) {
+        auto offset = TRY(limit_clause.offset_expression()->evaluate(context));
+        if (!offset.is_null()) {
+            auto offset_value_maybe = offset.to_int<size_t>();
+            if (!offset_value_maybe.has_value())
+                return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "OFFSET clause must evaluate to an integer value"sv };
+
+            row_limit.offset = offset_value_maybe.value();
+        }
+    }
+
+    return row_limit;
+}
+
+ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
+{
+    auto [columns, column_names] = TRY(resolve_result_columns(*this, context));
+
     ResultSet result { SQLCommand::Select, move(column_names) };
 
     auto descriptor = adopt_ref(*new TupleDescriptor);
@@ -92,6 +139,9 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     tuple.append(Value { true });
     rows.append(tuple);
 
+    // Rows that are read with an index scan may already be in the order the ordering terms ask for.
+    bool rows_are_ordered { false };
+
     for (auto& table_descriptor : table_or_subquery_list()) {
         if (!table_descriptor->is_table())
             return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
@@ -103,9 +153,17 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
         auto old_descriptor_size = descriptor->size();
         descriptor->extend(table_def->to_tuple_descriptor());
 
+        Vector<Row> table_rows;
+        if (table_or_subquery_list().size() == 1) {
+            auto plan = TRY(QueryPlan::create(context, table_def, where_clause(), m_ordering_term_list));
+            table_rows = TRY(plan.rows(*context.database));
+            rows_are_ordered = plan.satisfies_ordering();
+        } else {
+            table_rows = TRY(context.database->select_all(*table_def));
+        }
+
         while (!rows.is_empty() && (rows.first().size() == old_descriptor_size)) {
             auto cartesian_row = rows.take_first();
-            auto table_rows = TRY(context.database->select_all(*table_def));
 
             for (auto& table_row : table_rows) {
                 auto new_row = cartesian_row;
@@ -117,9 +175,11 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
 
     bool has_ordering { false };
     auto sort_descriptor = adopt_ref(*new TupleDescriptor);
-    for (auto& term : m_ordering_term_list) {
-        sort_descriptor->append(TupleElementDescriptor { .order = term->order() });
-        has_ordering = true;
+    if (!rows_are_ordered) {
+        for (auto& term : m_ordering_term_list) {
+            sort_descriptor->append(TupleElementDescriptor { .order = term->order() });
+            has_ordering = true;
+        }
     }
     Tuple sort_key(sort_descriptor);
 
@@ -151,33 +211,130 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     }
 
     if (m_limit_clause != nullptr) {
-        size_t limit_value = NumericLimits<size_t>::max();
-        size_t offset_value = 0;
+        auto row_limit = TRY(evaluate_limit_clause(*m_limit_clause, context));
+        result.limit(row_limit.offset, row_limit.limit);
+    }
+
+    return result;
+}
+
+// Produces the rows of a SELECT statement on a single table while they are read from it. This is only possible when
+// the rows don't have to be sorted, as the last row that is read may have to be returned first otherwise.
+class SelectCursor final : public Cursor {
+public:
+    SelectCursor(Select const& statement, ExecutionContext const& context, ResultColumns result_columns, TableDef& table, NonnullOwnPtr<RowScan> scan, RowLimit row_limit)
+        : Cursor(move(result_columns.names))
+        , m_statement(statement)
+        , m_placeholder_values(context.placeholder_values)
+        , m_context { context.database, m_statement.ptr(), m_placeholder_values.span(), nullptr }
+        , m_columns(move(result_columns.columns))
+        , m_scan(move(scan))
+        , m_rows_to_skip(row_limit.offset)
+        , m_rows_to_return(row_limit.limit)
+    {
+        // Expressions look up columns in the current row, which is laid out the same way as the rows of Select::execute.
+        auto descriptor = adopt_ref(*new TupleDescriptor);
+        descriptor->empend("__unity__"sv);
+        descriptor->extend(table.to_tuple_descriptor());
+
+        m_unity_row = Tuple { descriptor };
+        m_unity_row.append(Value { true });
+    }
+
+private:
+    virtual ResultOr<Optional<Vector<Value>>> read_next_row() override
+    {
+        while (m_rows_to_return > 0) {
+            auto table_row = TRY(m_scan->next());
+            if (!table_row.has_value())
+                break;
+
+            auto row = m_unity_row;
+            row.extend(*table_row);
+            m_context.current_row = &row;
+
+            if (auto const& where_clause = m_statement->where_clause()) {
+                auto where_result = TRY(where_clause->evaluate(m_context)).to_bool();
+                if (!where_result.has_value() || !where_result.value())
+                    continue;
+            }
+
+            if (m_rows_to_skip > 0) {
+                --m_rows_to_skip;
+                continue;
+            }
 
-        auto limit = TRY(m_limit_clause->limit_expression()->evaluate(context));
-        if (!limit.is_null()) {
-            auto limit_value_maybe = limit.to_int<size_t>();
-            if (!limit_value_maybe.has_value())
-                return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "LIMIT clause must evaluate to an integer value"sv };
+            Vector<Value> values;
+            TRY(values.try_ensure_capacity(m_columns.size()));
+            for (auto const& column : m_columns)
+                values.unchecked_append(TRY(column->expression()->evaluate(m_context)));
 
-            limit_value = limit_value_maybe.value();
+            m_context.current_row = nullptr;
+            --m_rows_to_return;
+            return values;
         }
 
-        if (m_limit_clause->offset_expression() != nullptr) {
-            auto offset = TRY(m_limit_clause->offset_expression()->evaluate(context));
-            if (!offset.is_null()) {
-                auto offset_value_maybe = offset.to_int<size_t>();
-                if (!offset_value_maybe.has_value())
-                    return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "OFFSET clause must evaluate to an integer value"sv };
+        m_context.current_row = nullptr;
+        return Optional<Vector<Value>> {};
+    }
 
-                offset_value = offset_value_maybe.value();
-            }
+    NonnullRefPtr<Select const> m_statement;
+    Vector<Value> m_placeholder_values;
+    ExecutionContext m_context;
+    Vector<NonnullRefPtr<ResultColumn const>> m_columns;
+    NonnullOwnPtr<RowScan> m_scan;
+    Tuple m_unity_row;
+    size_t m_rows_to_skip { 0 };
+    size_t m_rows_to_return { 0 };
+};
+
+ResultOr<NonnullOwnPtr<Cursor>> Select::open_cursor(ExecutionContext& context) const
+{
+    if (table_or_subquery_list().size() != 1 || !table_or_subquery_list()[0]->is_table())
+        return Statement::open_cursor(context);
+
+    auto const& table_descriptor = table_or_subquery_list()[0];
+    auto table_def = TRY(context.database->get_table(table_descriptor->schema_name(), table_descriptor->table_name()));
+    if (table_def->num_columns() == 0)
+        return Statement::open_cursor(context);
+
+    auto plan = TRY(QueryPlan::create(context, table_def, where_clause(), m_ordering_term_list));
+    if (!plan.satisfies_ordering())
+        return Statement::open_cursor(context);
+
+    auto result_columns = TRY(resolve_result_columns(*this, context));
+
+    RowLimit row_limit;
+    if (m_limit_clause != nullptr)
+        row_limit = TRY(evaluate_limit_clause(*m_limit_clause, context));
+
+    auto scan = TRY(plan.scan(*context.database));
+    return TRY(adopt_nonnull_own_or_enomem<Cursor>(new (nothrow) SelectCursor(*this, context, move(result_columns), *table_def, move(scan), row_limit)));
+}
+
+ResultOr<Vector<ByteString>> Select::query_plan(ExecutionContext& context) const
+{
+    Vector<ByteString> steps;
+
+    for (auto& table_descriptor : table_or_subquery_list()) {
+        if (!table_descriptor->is_table())
+            return Result { SQLCommand::Explain, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
+
+        auto table_def = TRY(context.database->get_table(table_descriptor->schema_name(), table_descriptor->table_name()));
+
+        if (table_or_subquery_list().size() == 1) {
+            auto plan = TRY(QueryPlan::create(context, table_def, where_clause(), m_ordering_term_list));
+            return plan.describe();
         }
 
-        result.limit(offset_value, limit_value);
+        // FIXME: Use indexes for joins as well.
+        steps.append(ByteString::formatted("SCAN {}", table_def->name()));
     }
 
-    return result;
+    if (!m_ordering_term_list.is_empty())
+        steps.append("SORT ROWS FOR ORDER BY");
+
+    return steps;
 }
 
 }
@@ -5,6 +5,7 @@
  */
 
 #include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/Cursor.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
@@ -22,4 +23,21 @@ ResultOr<ResultSet> Statement::execute(AK::NonnullRefPtr<Database> database, Rea
     return result;
 }
 
+ResultOr<NonnullOwnPtr<Cursor>> Statement::open_cursor(AK::NonnullRefPtr<Database> database, ReadonlySpan<Value> placeholder_values) const
+{
+    ExecutionContext context { move(database), this, placeholder_values, nullptr };
+    auto cursor = TRY(open_cursor(context));
+
+    // FIXME: When transactional sessions are supported, don't auto-commit modifications.
+    TRY(context.database->commit());
+
+    return cursor;
+}
+
+ResultOr<NonnullOwnPtr<Cursor>> Statement::open_cursor(ExecutionContext& context) const
+{
+    auto result = TRY(execute(context));
+    return TRY(Cursor::create(move(result)));
+}
+
 }
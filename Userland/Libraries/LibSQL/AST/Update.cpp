@@ -5,6 +5,7 @@
  */
 
 #include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/QueryPlan.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
@@ -17,9 +18,10 @@ ResultOr<ResultSet> Update::execute(ExecutionContext& context) const
     auto const& table_name = m_qualified_table_name->table_name();
     auto table_def = TRY(context.database->get_table(schema_name, table_name));
 
+    auto plan = TRY(QueryPlan::create(context, table_def, where_clause(), {}));
     Vector<Row> matched_rows;
 
-    for (auto& table_row : TRY(context.database->select_all(*table_def))) {
+    for (auto& table_row : TRY(plan.rows(*context.database))) {
         context.current_row = &table_row;
 
         if (auto const& where_clause = this->where_clause()) {
@@ -60,4 +62,11 @@ ResultOr<ResultSet> Update::execute(ExecutionContext& context) const
     return result;
 }
 
+ResultOr<Vector<ByteString>> Update::query_plan(ExecutionContext& context) const
+{
+    auto table_def = TRY(context.database->get_table(m_qualified_table_name->schema_name(), m_qualified_table_name->table_name()));
+    auto plan = TRY(QueryPlan::create(context, table_def, where_clause(), {}));
+    return plan.describe();
+}
+
 }
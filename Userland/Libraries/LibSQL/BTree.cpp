@@ -103,6 +103,49 @@ BTreeIterator BTree::find(Key const& key)
     return end();
 }
 
+// Returns an iterator to the first key in sort order for which the predicate holds. The predicate must be
+// false for a (possibly empty) run of keys at the start of the tree and true for all keys after that.
+template<typename Predicate>
+BTreeIterator BTree::first_key_where(Predicate predicate)
+{
+    if (!m_root)
+        initialize_root();
+
+    TreeNode* candidate_node = nullptr;
+    size_t candidate_index = 0;
+
+    for (auto* node = m_root.ptr(); node;) {
+        size_t ix = 0;
+        while (ix < node->size() && !predicate((*node)[ix]))
+            ++ix;
+
+        // Keys in a node are larger than all keys in the subtrees to their left, so the first
+        // matching key in a node is a better candidate than any matching key in an ancestor.
+        if (ix < node->size()) {
+            candidate_node = node;
+            candidate_index = ix;
+        }
+
+        if (node->is_leaf())
+            break;
+        node = node->down_node(ix);
+    }
+
+    if (!candidate_node)
+        return end();
+    return BTreeIterator(candidate_node, (int)candidate_index);
+}
+
+BTreeIterator BTree::lower_bound(Key const& key)
+{
+    return first_key_where([&](Key const& entry) { return entry.compare(key) >= 0; });
+}
+
+BTreeIterator BTree::upper_bound(Key const& key)
+{
+    return first_key_where([&](Key const& entry) { return entry.compare(key) > 0; });
+}
+
 void BTree::list_tree()
 {
     if (!m_root)
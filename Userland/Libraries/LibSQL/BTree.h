@@ -101,6 +101,8 @@ public:
     bool update_key_pointer(Key const&);
     Optional<u32> get(Key&);
     BTreeIterator find(Key const& key);
+    BTreeIterator lower_bound(Key const& key);
+    BTreeIterator upper_bound(Key const& key);
     BTreeIterator begin();
     static BTreeIterator end();
     void list_tree();
@@ -111,6 +113,10 @@ private:
     BTree(Serializer&, NonnullRefPtr<TupleDescriptor> const&, bool unique, Block::Index);
     void initialize_root();
     TreeNode* new_root();
+
+    template<typename Predicate>
+    BTreeIterator first_key_where(Predicate);
+
     OwnPtr<TreeNode> m_root { nullptr };
 
     friend BTreeIterator;
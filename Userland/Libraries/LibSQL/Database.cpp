@@ -15,9 +15,9 @@
 
 namespace SQL {
 
-ErrorOr<NonnullRefPtr<Database>> Database::create(ByteString name)
+ErrorOr<NonnullRefPtr<Database>> Database::create(ByteString name, u32 block_size)
 {
-    auto heap = TRY(Heap::create(move(name)));
+    auto heap = TRY(Heap::create(move(name), block_size));
     return adopt_nonnull_ref_or_enomem(new (nothrow) Database(move(heap)));
 }
 
@@ -47,6 +47,11 @@ ResultOr<void> Database::open()
         m_heap->set_table_columns_root(m_table_columns->root());
     };
 
+    m_table_indexes = TRY(BTree::create(m_serializer, IndexDef::index_def()->to_tuple_descriptor(), m_heap->table_indexes_root()));
+    m_table_indexes->on_new_root = [&]() {
+        m_heap->set_table_indexes_root(m_table_indexes->root());
+    };
+
     m_open = true;
 
     auto ensure_schema_exists = [&](auto schema_name) -> ResultOr<NonnullRefPtr<SchemaDef>> {
@@ -83,7 +88,16 @@ Database::~Database() = default;
 ErrorOr<void> Database::commit()
 {
     VERIFY(is_open());
-    TRY(m_heap->flush());
+    TRY(m_heap->commit());
+    if (!m_uses_group_commit)
+        TRY(m_heap->sync());
+    return {};
+}
+
+ErrorOr<void> Database::sync()
+{
+    VERIFY(is_open());
+    TRY(m_heap->sync());
     return {};
 }
 
@@ -172,16 +186,228 @@ ResultOr<NonnullRefPtr<TableDef>> Database::get_table(ByteString const& schema,
     for (auto it = m_table_columns->find(column_key); !it.is_end() && ((*it)["table_hash"].to_int<u32>() == table_hash); ++it)
         table_def->append_column(*it);
 
+    auto index_key = IndexDef::make_key(table_def);
+    for (auto it = m_table_indexes->find(index_key); !it.is_end() && ((*it)["table_hash"].to_int<u32>() == table_hash); ++it) {
+        auto index_def = TRY(IndexDef::create(table_def, (*it)["index_name"].to_byte_string(), (*it)["unique"].to_int<u32>() == 1u, (*it).block_index()));
+
+        auto index_hash = index_def->hash();
+        auto key_part_key = ColumnDef::make_key(index_def);
+        for (auto part = m_table_columns->find(key_part_key); !part.is_end() && ((*part)["table_hash"].to_int<u32>() == index_hash); ++part)
+            index_def->append_column(*part);
+
+        table_def->append_index(move(index_def));
+    }
+
     return table_def;
 }
 
-ErrorOr<Vector<Row>> Database::select_all(TableDef& table)
+ResultOr<void> Database::add_index(TableDef& table, IndexDef& index)
 {
+    VERIFY(is_open());
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
-    Vector<Row> ret;
-    for (auto block_index = table.block_index(); block_index; block_index = ret.last().next_block_index())
-        ret.append(m_serializer.deserialize_block<Row>(block_index, table, block_index));
-    return ret;
+    VERIFY(index.parent() == &table);
+
+    if (!m_table_indexes->insert(index.key()))
+        return Result { SQLCommand::Create, SQLErrorCode::IndexExists, index.name() };
+
+    for (auto& key_part : index.key_definition()) {
+        if (!m_table_columns->insert(key_part->key()))
+            VERIFY_NOT_REACHED();
+    }
+
+    table.append_index(index);
+
+    auto tree = TRY(index_tree(index));
+    for (auto& row : TRY(select_all(table))) {
+        if (auto key = TRY(index_key(index, row)); key.has_value())
+            tree->insert(*key);
+    }
+
+    return {};
+}
+
+// Index keys hold the values of the indexed columns, normalized such that values of the same column always compare
+// consistently: integral numbers in integer columns are stored as integers, so that large values stay exact, while
+// other numbers and booleans are stored as doubles. NULLs are never equal to anything, so rows that have a NULL in an
+// indexed column are left out of that index.
+Optional<Value> Database::index_value(Value const& value, SQLType column_type)
+{
+    if (value.is_null())
+        return {};
+
+    switch (value.type()) {
+    case SQLType::Text:
+        return value;
+    case SQLType::Integer:
+        if (column_type == SQLType::Integer) {
+            if (auto integer = value.to_int<i64>(); integer.has_value())
+                return Value { *integer };
+            return value;
+        }
+        [[fallthrough]];
+    case SQLType::Float: {
+        auto number = value.to_double();
+        if (!number.has_value())
+            return {};
+
+        // Integers and doubles compare exactly, so a fractional value can still be stored in an integer column's index.
+        if (column_type == SQLType::Integer && trunc(*number) == *number && *number >= -0x1p63 && *number < 0x1p63)
+            return Value { static_cast<i64>(*number) };
+        return Value { *number };
+    }
+    case SQLType::Boolean:
+        return Value { *value.to_bool() ? 1.0 : 0.0 };
+    default:
+        return {};
+    }
+}
+
+ErrorOr<NonnullRefPtr<BTree>> Database::index_tree(IndexDef& index)
+{
+    if (auto it = m_index_trees.find(index.hash()); it != m_index_trees.end())
+        return it->value;
+
+    // The block index of the row is the last part of every key. This keeps keys unique when several rows have the
+    // same values in the indexed columns, so that the entry of one particular row can be found again.
+    auto descriptor = adopt_ref(*new TupleDescriptor);
+    for (auto const& key_part : index.key_definition()) {
+        auto type = key_part->type() == SQLType::Text || key_part->type() == SQLType::Integer ? key_part->type() : SQLType::Float;
+        descriptor->append({ "", "", key_part->name(), type, Order::Ascending });
+    }
+    descriptor->append({ "", "", "$row", SQLType::Integer, Order::Ascending });
+
+    auto tree = TRY(BTree::create(m_serializer, descriptor, index.block_index()));
+    tree->on_new_root = [this, index = NonnullRefPtr<IndexDef> { index }, tree = tree.ptr()]() {
+        index->set_block_index(tree->root());
+        VERIFY(m_table_indexes->update_key_pointer(index->key()));
+    };
+
+    m_index_trees.set(index.hash(), tree);
+    return tree;
+}
+
+ErrorOr<Optional<Key>> Database::index_key(IndexDef& index, Row const& row)
+{
+    auto tree = TRY(index_tree(index));
+
+    Key key(tree->descriptor());
+    for (size_t ix = 0; ix < index.size(); ++ix) {
+        auto const& key_part = index.key_definition()[ix];
+        auto value = index_value(row[key_part->name()], key_part->type());
+        if (!value.has_value())
+            return Optional<Key> {};
+        key[ix] = value.release_value();
+    }
+
+    key[index.size()] = Value { row.block_index() };
+    key.set_block_index(row.block_index());
+    return key;
+}
+
+ErrorOr<void> Database::insert_index_keys(Row const& row)
+{
+    for (auto& index : row.table().indexes()) {
+        auto key = TRY(index_key(*index, row));
+        if (!key.has_value())
+            continue;
+
+        // If the row's block was used before by a row with the same values, its tombstone is brought back to life.
+        auto tree = TRY(index_tree(*index));
+        if (!tree->update_key_pointer(*key))
+            tree->insert(*key);
+    }
+    return {};
+}
+
+// FIXME: BTree can't delete keys yet. Until it can, the entry of a removed row is kept as a tombstone that points at
+//        block 0, and is skipped when scanning the index.
+ErrorOr<void> Database::remove_index_keys(Row const& row)
+{
+    for (auto& index : row.table().indexes()) {
+        auto key = TRY(index_key(*index, row));
+        if (!key.has_value())
+            continue;
+
+        key->set_block_index(0);
+        auto tree = TRY(index_tree(*index));
+        tree->update_key_pointer(*key);
+    }
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<RowScan>> Database::scan_all(TableDef& table)
+{
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+
+    auto scan = TRY(adopt_nonnull_own_or_enomem(new (nothrow) RowScan(*this, table)));
+    scan->m_next_block_index = table.block_index();
+    return scan;
+}
+
+ErrorOr<NonnullOwnPtr<RowScan>> Database::scan_range(TableDef& table, IndexDef& index, IndexRange const& range)
+{
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    VERIFY(index.parent() == &table);
+
+    auto scan = TRY(adopt_nonnull_own_or_enomem(new (nothrow) RowScan(*this, table)));
+
+    auto make_bound = [&](Vector<Value> const& values) -> Optional<Key> {
+        Key bound(adopt_ref(*new TupleDescriptor));
+        for (size_t ix = 0; ix < values.size(); ++ix) {
+            auto normalized_value = index_value(values[ix], index.key_definition()[ix]->type());
+            if (!normalized_value.has_value())
+                return {};
+            bound.append(normalized_value.release_value());
+        }
+        return bound;
+    };
+
+    // A comparison with NULL is never true, so nothing is in range.
+    auto lower = make_bound(range.lower);
+    auto upper = make_bound(range.upper);
+    if (!lower.has_value() || !upper.has_value())
+        return scan;
+
+    scan->m_index = index;
+    scan->m_tree = TRY(index_tree(index));
+    scan->m_iterator = scan->m_tree->begin();
+    if (!range.lower.is_empty())
+        scan->m_iterator = range.lower_inclusive ? scan->m_tree->lower_bound(*lower) : scan->m_tree->upper_bound(*lower);
+
+    if (!range.upper.is_empty()) {
+        scan->m_upper_bound = upper.release_value();
+        scan->m_upper_bound_inclusive = range.upper_inclusive;
+    }
+    return scan;
+}
+
+ErrorOr<Vector<Row>> Database::read_all_rows(RowScan& scan)
+{
+    Vector<Row> rows;
+    for (auto row = TRY(scan.next()); row.has_value(); row = TRY(scan.next()))
+        TRY(rows.try_append(row.release_value()));
+    return rows;
+}
+
+ErrorOr<Vector<Row>> Database::select_all(TableDef& table)
+{
+    auto scan = TRY(scan_all(table));
+    return read_all_rows(*scan);
+}
+
+ErrorOr<Vector<Row>> Database::select_range(TableDef& table, IndexDef& index, IndexRange const& range)
+{
+    auto scan = TRY(scan_range(table, index, range));
+    return read_all_rows(*scan);
+}
+
+ErrorOr<void> Database::preserve_row_for_open_scans(TableDef const& table, Block::Index block_index, Optional<Row> const& old_row)
+{
+    for (auto* scan : m_open_scans) {
+        if (scan->m_table.ptr() == &table && !scan->is_finished() && !scan->is_invalidated())
+            TRY(scan->preserve_row(block_index, old_row));
+    }
+    return {};
 }
 
 ErrorOr<Vector<Row>> Database::match(TableDef& table, Key const& key)
@@ -204,12 +430,11 @@ ErrorOr<void> Database::insert(Row& row)
 {
     VERIFY(m_table_cache.get(row.table().key().hash()).has_value());
     // TODO: implement table constraints such as unique, foreign key, etc.
-
     row.set_block_index(m_heap->request_new_block_index());
+    TRY(preserve_row_for_open_scans(row.table(), row.block_index(), {}));
     row.set_next_block_index(row.table().block_index());
-    TRY(update(row));
-
-    // TODO update indexes defined on table.
+    write_row(row);
+    TRY(insert_index_keys(row));
 
     auto table_key = row.table().key();
     table_key.set_block_index(row.block_index());
@@ -223,6 +448,12 @@ ErrorOr<void> Database::remove(Row& row)
     auto& table = row.table();
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
 
+    // The row may have been read before rows next to it were removed, so its next row is read from storage.
+    auto stored_row = m_serializer.deserialize_block<Row>(row.block_index(), table, row.block_index());
+    row.set_next_block_index(stored_row.next_block_index());
+    TRY(preserve_row_for_open_scans(table, row.block_index(), stored_row));
+
+    TRY(remove_index_keys(row));
     TRY(m_heap->free_storage(row.block_index()));
 
     if (table.block_index() == row.block_index()) {
@@ -238,8 +469,9 @@ ErrorOr<void> Database::remove(Row& row)
         auto current = m_serializer.deserialize_block<Row>(block_index, table, block_index);
 
         if (current.next_block_index() == row.block_index()) {
+            TRY(preserve_row_for_open_scans(table, block_index, current));
             current.set_next_block_index(row.next_block_index());
-            TRY(update(current));
+            write_row(current);
             break;
         }
 
@@ -251,14 +483,141 @@ ErrorOr<void> Database::remove(Row& row)
 
 ErrorOr<void> Database::update(Row& tuple)
 {
-    VERIFY(m_table_cache.get(tuple.table().key().hash()).has_value());
+    auto& table = tuple.table();
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
     // TODO: implement table constraints such as unique, foreign key, etc.
 
+    // Like in remove(), the next row is read from storage in case the rows next to this one have been removed.
+    auto old_row = m_serializer.deserialize_block<Row>(tuple.block_index(), table, tuple.block_index());
+    tuple.set_next_block_index(old_row.next_block_index());
+    TRY(preserve_row_for_open_scans(table, tuple.block_index(), old_row));
+    write_row(tuple);
+
+    for (auto& index : table.indexes()) {
+        auto old_key = TRY(index_key(*index, old_row));
+        auto new_key = TRY(index_key(*index, tuple));
+        if (old_key == new_key)
+            continue;
+
+        auto tree = TRY(index_tree(*index));
+        if (old_key.has_value()) {
+            old_key->set_block_index(0);
+            tree->update_key_pointer(*old_key);
+        }
+        if (new_key.has_value() && !tree->update_key_pointer(*new_key))
+            tree->insert(*new_key);
+    }
+
+    return {};
+}
+
+void Database::write_row(Row& row)
+{
     m_serializer.reset();
-    m_serializer.serialize_and_write<Tuple>(tuple);
+    m_serializer.serialize_and_write<Tuple>(row);
+}
+
+RowScan::RowScan(Database& database, TableDef& table)
+    : m_database(database)
+    , m_table(table)
+{
+    m_database->m_open_scans.append(this);
+}
 
-    // TODO update indexes defined on table.
+RowScan::~RowScan()
+{
+    m_database->m_open_scans.remove_first_matching([this](auto* scan) { return scan == this; });
+}
+
+ErrorOr<Optional<Row>> RowScan::next()
+{
+    if (m_is_invalidated)
+        return Error::from_string_literal("Scan was invalidated as too many of its rows were written while it was open");
+
+    if (m_tree.is_null()) {
+        if (m_next_block_index == 0)
+            return Optional<Row> {};
+
+        auto row = read_row(m_next_block_index);
+        m_next_block_index = row.next_block_index();
+        return row;
+    }
+
+    if (m_iterator_is_stale) {
+        m_iterator = m_tree->lower_bound(*m_resume_key);
+        m_resume_key.clear();
+        m_iterator_is_stale = false;
+    }
+
+    for (; !m_iterator.is_end(); ++m_iterator) {
+        auto const& key = *m_iterator;
+
+        if (m_upper_bound.has_value()) {
+            auto comparison = key.compare(*m_upper_bound);
+            if (comparison > 0 || (comparison == 0 && !m_upper_bound_inclusive))
+                break;
+        }
+
+        // A row that was written after the scan was opened is only returned for the key it had back then. The key of
+        // a removed row is a tombstone that doesn't point at the row anymore, so the row is found by its last part.
+        auto block_index = key[key.size() - 1].to_int<Block::Index>().value();
+        if (auto preserved_row = m_preserved_rows.get(block_index); preserved_row.has_value()) {
+            if (!preserved_row->has_value())
+                continue;
+
+            auto old_key = TRY(m_database->index_key(*m_index, preserved_row->value()));
+            if (!old_key.has_value() || *old_key != key)
+                continue;
+
+            ++m_iterator;
+            return preserved_row->value();
+        }
+
+        if (key.block_index() == 0)
+            continue;
+
+        ++m_iterator;
+        return read_row(block_index);
+    }
+
+    m_iterator = BTree::end();
+    return Optional<Row> {};
+}
+
+bool RowScan::is_finished() const
+{
+    if (m_tree.is_null())
+        return m_next_block_index == 0;
+    return !m_iterator_is_stale && m_iterator.is_end();
+}
+
+ErrorOr<void> RowScan::preserve_row(Block::Index block_index, Optional<Row> const& old_row)
+{
+    // Writing a row also writes the keys of the row to the indexes of its table.
+    if (m_tree && !m_iterator_is_stale) {
+        m_resume_key = *m_iterator;
+        m_iterator_is_stale = true;
+    }
+
+    // Only the contents from when the scan was opened matter, not those of later writes.
+    if (m_preserved_rows.contains(block_index))
+        return {};
+
+    if (m_preserved_rows.size() >= m_database->maximum_preserved_row_count()) {
+        m_preserved_rows.clear();
+        m_is_invalidated = true;
+        return {};
+    }
+
+    TRY(m_preserved_rows.try_set(block_index, old_row));
     return {};
 }
 
+Row RowScan::read_row(Block::Index block_index)
+{
+    if (auto preserved_row = m_preserved_rows.get(block_index); preserved_row.has_value() && preserved_row->has_value())
+        return preserved_row->value();
+    return m_database->m_serializer.deserialize_block<Row>(block_index, *m_table, block_index);
+}
+
 }
@@ -10,14 +10,83 @@
 #include <AK/ByteString.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefPtr.h>
+#include <LibSQL/BTree.h>
 #include <LibSQL/Forward.h>
 #include <LibSQL/Heap.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Result.h>
+#include <LibSQL/Row.h>
 #include <LibSQL/Serializer.h>
 
 namespace SQL {
 
+/**
+ * The range of keys visited by an index scan. Bounds are prefixes of the
+ * index's key; an empty bound leaves that side of the range open.
+ */
+struct IndexRange {
+    Vector<Value> lower;
+    bool lower_inclusive { true };
+    Vector<Value> upper;
+    bool upper_inclusive { true };
+};
+
+/**
+ * A RowScan reads the rows of a table one at a time, either in the order they
+ * are stored in or in the order of an index. Rows are only read from the heap
+ * when they are asked for, so a scan doesn't hold more than one row in memory.
+ *
+ * Every scan returns the rows as they were when it was opened. Before the
+ * database writes a row, it gives the row's previous contents to the open
+ * scans of its table, which return those instead of what is in the heap.
+ * Index keys that were added after a scan was opened are skipped, and an
+ * index scan finds its position again by key once the index was modified.
+ *
+ * A scan that was left open while its table was rewritten would hold on to
+ * every old row. Once it preserves more rows than the database allows, it
+ * drops them and fails when it is asked for its next row.
+ */
+class RowScan {
+    AK_MAKE_NONCOPYABLE(RowScan);
+    AK_MAKE_NONMOVABLE(RowScan);
+
+public:
+    ~RowScan();
+
+    ErrorOr<Optional<Row>> next();
+
+private:
+    friend class Database;
+
+    RowScan(Database&, TableDef&);
+
+    bool is_finished() const;
+    bool is_invalidated() const { return m_is_invalidated; }
+    ErrorOr<void> preserve_row(Block::Index, Optional<Row> const&);
+    Row read_row(Block::Index);
+
+    NonnullRefPtr<Database> m_database;
+    NonnullRefPtr<TableDef> m_table;
+
+    // The next row of a table scan.
+    Block::Index m_next_block_index { 0 };
+
+    // The position and end of an index scan. The iterator can't be used anymore once the index was modified, so
+    // the scan then remembers the key it was at instead.
+    RefPtr<IndexDef> m_index;
+    RefPtr<BTree> m_tree;
+    BTreeIterator m_iterator { BTree::end() };
+    Optional<Key> m_resume_key;
+    bool m_iterator_is_stale { false };
+    Optional<Key> m_upper_bound;
+    bool m_upper_bound_inclusive { true };
+
+    // The contents of rows from when the scan was opened, for rows that have been written since. A block that
+    // didn't hold a row of the table back then maps to an empty row.
+    HashMap<Block::Index, Optional<Row>> m_preserved_rows;
+    bool m_is_invalidated { false };
+};
+
 /**
  * A Database object logically connects a Heap with the SQL data we want
  * to store in it. It has BTree pointers for B-Trees holding the definitions
@@ -25,13 +94,27 @@ namespace SQL {
  */
 class Database : public RefCounted<Database> {
 public:
-    static ErrorOr<NonnullRefPtr<Database>> create(ByteString);
+    static ErrorOr<NonnullRefPtr<Database>> create(ByteString, u32 block_size = Block::DEFAULT_SIZE);
     ~Database();
 
     ResultOr<void> open();
     bool is_open() const { return m_open; }
     ErrorOr<void> commit();
+    ErrorOr<void> sync();
+
+    // With group commit, commit() doesn't wait for the transaction to be durable. The caller
+    // then makes many transactions durable at once by calling sync().
+    bool uses_group_commit() const { return m_uses_group_commit; }
+    void set_uses_group_commit(bool uses_group_commit) { m_uses_group_commit = uses_group_commit; }
+
+    // The number of old rows an open scan may preserve before it is invalidated.
+    static constexpr size_t DEFAULT_MAXIMUM_PRESERVED_ROW_COUNT = 10'000;
+    size_t maximum_preserved_row_count() const { return m_maximum_preserved_row_count; }
+    void set_maximum_preserved_row_count(size_t count) { m_maximum_preserved_row_count = count; }
+    size_t open_scan_count() const { return m_open_scans.size(); }
+
     ErrorOr<size_t> file_size_in_bytes() const { return m_heap->file_size_in_bytes(); }
+    Heap& heap() { return *m_heap; }
 
     ResultOr<void> add_schema(SchemaDef const&);
     static Key get_schema_key(ByteString const&);
@@ -41,24 +124,46 @@ public:
     static Key get_table_key(ByteString const&, ByteString const&);
     ResultOr<NonnullRefPtr<TableDef>> get_table(ByteString const&, ByteString const&);
 
+    ResultOr<void> add_index(TableDef&, IndexDef&);
+    static Optional<Value> index_value(Value const&, SQLType column_type);
+
+    ErrorOr<NonnullOwnPtr<RowScan>> scan_all(TableDef&);
+    ErrorOr<NonnullOwnPtr<RowScan>> scan_range(TableDef&, IndexDef&, IndexRange const&);
     ErrorOr<Vector<Row>> select_all(TableDef&);
+    ErrorOr<Vector<Row>> select_range(TableDef&, IndexDef&, IndexRange const&);
     ErrorOr<Vector<Row>> match(TableDef&, Key const&);
     ErrorOr<void> insert(Row&);
     ErrorOr<void> remove(Row&);
     ErrorOr<void> update(Row&);
 
 private:
+    friend class RowScan;
+
     explicit Database(NonnullRefPtr<Heap>);
 
+    static ErrorOr<Vector<Row>> read_all_rows(RowScan&);
+    ErrorOr<void> preserve_row_for_open_scans(TableDef const&, Block::Index, Optional<Row> const&);
+
+    ErrorOr<NonnullRefPtr<BTree>> index_tree(IndexDef&);
+    ErrorOr<Optional<Key>> index_key(IndexDef&, Row const&);
+    ErrorOr<void> insert_index_keys(Row const&);
+    ErrorOr<void> remove_index_keys(Row const&);
+    void write_row(Row&);
+
     bool m_open { false };
+    bool m_uses_group_commit { false };
+    size_t m_maximum_preserved_row_count { DEFAULT_MAXIMUM_PRESERVED_ROW_COUNT };
     NonnullRefPtr<Heap> m_heap;
     Serializer m_serializer;
     RefPtr<BTree> m_schemas;
     RefPtr<BTree> m_tables;
     RefPtr<BTree> m_table_columns;
+    RefPtr<BTree> m_table_indexes;
 
     HashMap<u32, NonnullRefPtr<SchemaDef>> m_schema_cache;
     HashMap<u32, NonnullRefPtr<TableDef>> m_table_cache;
+    HashMap<u32, NonnullRefPtr<BTree>> m_index_trees;
+    Vector<RowScan*> m_open_scans;
 };
 
 }
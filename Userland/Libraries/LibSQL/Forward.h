@@ -16,11 +16,13 @@ class Index;
 class IndexNode;
 class IndexDef;
 class Key;
+class PageCache;
 class KeyPartDef;
 class Relation;
 class Result;
 class ResultSet;
 class Row;
+class RowScan;
 class SchemaDef;
 class Serializer;
 class TableDef;
@@ -29,6 +31,7 @@ class Tuple;
 class TupleDescriptor;
 struct TupleElementDescriptor;
 class Value;
+class WriteAheadLog;
 }
 
 namespace SQL::AST {
@@ -46,13 +49,16 @@ class ColumnDefinition;
 class ColumnNameExpression;
 class CommonTableExpression;
 class CommonTableExpressionList;
+class CreateIndex;
 class CreateTable;
+class Cursor;
 class Delete;
 class DropColumn;
 class DropTable;
 class ErrorExpression;
 class ErrorStatement;
 class ExistsExpression;
+class Explain;
 class Expression;
 class GroupByClause;
 class InChainedExpression;
@@ -7,75 +7,113 @@
 
 #include <AK/ByteString.h>
 #include <AK/Format.h>
-#include <AK/QuickSort.h>
 #include <LibCore/System.h>
 #include <LibSQL/Heap.h>
+#include <LibSQL/PageCache.h>
+#include <LibSQL/WriteAheadLog.h>
 #include <sys/stat.h>
 
 namespace SQL {
 
-ErrorOr<NonnullRefPtr<Heap>> Heap::create(ByteString file_name)
+ErrorOr<NonnullRefPtr<Heap>> Heap::create(ByteString file_name, u32 block_size)
 {
-    return adopt_nonnull_ref_or_enomem(new (nothrow) Heap(move(file_name)));
+    if (!Block::is_valid_size(block_size))
+        return Error::from_string_literal("Heap::create(): block size must be a power of two between 4 KiB and 16 KiB");
+    return adopt_nonnull_ref_or_enomem(new (nothrow) Heap(move(file_name), block_size));
 }
 
-Heap::Heap(ByteString file_name)
+Heap::Heap(ByteString file_name, u32 block_size)
     : m_name(move(file_name))
+    , m_block_size(block_size)
 {
 }
 
 Heap::~Heap()
 {
-    if (m_file && !m_write_ahead_log.is_empty()) {
-        if (auto maybe_error = flush(); maybe_error.is_error())
-            warnln("~Heap({}): {}", name(), maybe_error.error());
-    }
+    if (!m_file || !m_write_ahead_log)
+        return;
+
+    // Checkpointing leaves a heap file that doesn't need the log to be opened again.
+    if (auto maybe_error = flush(); maybe_error.is_error())
+        warnln("~Heap({}): {}", name(), maybe_error.error());
+    else if (auto maybe_error = checkpoint(); maybe_error.is_error())
+        warnln("~Heap({}): {}", name(), maybe_error.error());
 }
 
 ErrorOr<void> Heap::open()
 {
     VERIFY(!m_file);
 
-    size_t file_size = 0;
+    bool file_exists = true;
     struct stat stat_buffer;
     if (stat(name().characters(), &stat_buffer) != 0) {
         if (errno != ENOENT) {
             warnln("Heap::open({}): could not stat: {}"sv, name(), strerror(errno));
             return Error::from_string_literal("Heap::open(): could not stat file");
         }
+        file_exists = false;
     } else if (!S_ISREG(stat_buffer.st_mode)) {
         warnln("Heap::open({}): can only use regular files"sv, name());
         return Error::from_string_literal("Heap::open(): can only use regular files");
-    } else {
-        file_size = stat_buffer.st_size;
     }
 
+    auto file = TRY(Core::File::open(name(), Core::File::OpenMode::ReadWrite));
+    m_file_descriptor = file->fd();
+    m_file = TRY(Core::InputBufferedFile::create(move(file)));
+
+    // The version and block size have to be known before any block can be read from the heap file or the log.
+    if (file_exists && stat_buffer.st_size > 0) {
+        if (auto error_maybe = read_heap_file_header(); error_maybe.is_error()) {
+            m_file = nullptr;
+            return error_maybe.release_error();
+        }
+
+        // FIXME: We should more gracefully handle version incompatibilities. For now, we drop the database.
+        if (m_version != VERSION) {
+            dbgln_if(SQL_DEBUG, "Heap file {} opened has incompatible version {}. Deleting for version {}.", name(), m_version, VERSION);
+            m_file = nullptr;
+
+            TRY(Core::System::unlink(name()));
+            return open();
+        }
+    } else if (file_exists) {
+        // A heap file that is still empty has only ever been written to the log, e.g. because the process crashed
+        // before the first checkpoint. The log then knows the block size the heap was created with.
+        if (auto log_block_size = TRY(WriteAheadLog::read_block_size(write_ahead_log_name())); log_block_size.has_value())
+            m_block_size = *log_block_size;
+    }
+
+    m_page_cache = TRY(PageCache::create(PAGE_CACHE_SIZE / m_block_size));
+
+    // Transactions that were committed to the log but not checkpointed, e.g. because the process crashed, are
+    // recovered by copying them to the heap file before anything is read from it. A log without a heap file belongs
+    // to a heap that was deleted, so it is discarded instead.
+    m_write_ahead_log = TRY(WriteAheadLog::open(write_ahead_log_name(), m_block_size));
+    if (file_exists)
+        TRY(checkpoint());
+    else
+        TRY(m_write_ahead_log->reset());
+
+    if (m_uses_mapped_reads)
+        TRY(map_heap_file());
+
+    auto file_size = TRY(file_size_in_bytes());
     if (file_size > 0) {
-        m_next_block = file_size / Block::SIZE;
+        m_next_block = file_size / m_block_size;
         m_highest_block_written = m_next_block - 1;
     }
 
-    auto file = TRY(Core::File::open(name(), Core::File::OpenMode::ReadWrite));
-    m_file = TRY(Core::InputBufferedFile::create(move(file)));
-
     if (file_size > 0) {
         if (auto error_maybe = read_zero_block(); error_maybe.is_error()) {
             m_file = nullptr;
+            m_mapped_file = nullptr;
+            m_write_ahead_log = nullptr;
             return error_maybe.release_error();
         }
     } else {
         TRY(initialize_zero_block());
     }
 
-    // FIXME: We should more gracefully handle version incompatibilities. For now, we drop the database.
-    if (m_version != VERSION) {
-        dbgln_if(SQL_DEBUG, "Heap file {} opened has incompatible version {}. Deleting for version {}.", name(), m_version, VERSION);
-        m_file = nullptr;
-
-        TRY(Core::System::unlink(name()));
-        return open();
-    }
-
     // Perform a heap scan to find all free blocks
     // FIXME: this is very inefficient; store free blocks in a persistent heap structure
     for (Block::Index index = 1; index <= m_highest_block_written; ++index) {
@@ -85,19 +123,50 @@ ErrorOr<void> Heap::open()
             TRY(m_free_block_indices.try_append(index));
     }
 
-    dbgln_if(SQL_DEBUG, "Heap file {} opened; number of blocks = {}; free blocks = {}", name(), m_highest_block_written, m_free_block_indices.size());
+    dbgln_if(SQL_DEBUG, "Heap file {} opened; block size = {}; number of blocks = {}; free blocks = {}", name(), m_block_size, m_highest_block_written, m_free_block_indices.size());
+    return {};
+}
+
+ErrorOr<void> Heap::set_uses_mapped_reads(bool uses_mapped_reads)
+{
+    m_uses_mapped_reads = uses_mapped_reads;
+    if (!m_file)
+        return {};
+
+    if (!m_uses_mapped_reads) {
+        m_mapped_file = nullptr;
+        return {};
+    }
+    return map_heap_file();
+}
+
+ErrorOr<void> Heap::map_heap_file()
+{
+    VERIFY(m_file);
+    m_mapped_file = nullptr;
+
+    // An empty file can't be mapped. Its blocks are all still in the log, so there is nothing to read from it yet.
+    if (TRY(Core::System::fstat(m_file_descriptor)).st_size == 0)
+        return {};
+
+    m_mapped_file = TRY(Core::MappedFile::map_from_fd_and_close(TRY(Core::System::dup(m_file_descriptor)), name()));
     return {};
 }
 
 ErrorOr<size_t> Heap::file_size_in_bytes() const
 {
     TRY(m_file->seek(0, SeekMode::FromEndPosition));
-    return TRY(m_file->tell());
+    auto file_size = TRY(m_file->tell());
+
+    // Blocks in the write-ahead log are part of the heap, even if they haven't been copied to the heap file yet.
+    if (auto highest_block_index = m_write_ahead_log->highest_block_index(); highest_block_index.has_value())
+        return max(file_size, (*highest_block_index + 1) * static_cast<size_t>(m_block_size));
+    return file_size;
 }
 
 bool Heap::has_block(Block::Index index) const
 {
-    return (index <= m_highest_block_written || m_write_ahead_log.contains(index))
+    return (index <= m_highest_block_written || m_dirty_blocks.contains(index) || m_write_ahead_log->contains(index))
         && !m_free_block_indices.contains_slow(index);
 }
 
@@ -116,9 +185,9 @@ ErrorOr<ByteBuffer> Heap::read_storage(Block::Index index)
     ByteBuffer data;
     while (index > 0) {
         auto block = TRY(read_block(index));
-        dbgln_if(SQL_DEBUG, "  -> {} bytes", block.size_in_bytes());
-        TRY(data.try_append(block.data().bytes().slice(0, block.size_in_bytes())));
-        index = block.next_block();
+        dbgln_if(SQL_DEBUG, "  -> {} bytes", block->size_in_bytes());
+        TRY(data.try_append(block->data().bytes().slice(0, block->size_in_bytes())));
+        index = block->next_block();
     }
     return data;
 }
@@ -138,15 +207,15 @@ ErrorOr<void> Heap::write_storage(Block::Index index, ReadonlyBytes data)
     u32 offset_in_data = 0;
     Block::Index existing_next_block_index = 0;
     while (remaining_size > 0) {
-        auto block_data_size = AK::min(remaining_size, Block::DATA_SIZE);
+        auto block_data_size = AK::min(remaining_size, this->block_data_size());
         remaining_size -= block_data_size;
 
         ByteBuffer block_data;
         if (has_block(index)) {
             auto existing_block = TRY(read_block(index));
-            block_data = existing_block.data();
+            block_data = existing_block->data();
             TRY(block_data.try_resize(block_data_size));
-            existing_next_block_index = existing_block.next_block();
+            existing_next_block_index = existing_block->next_block();
         } else {
             block_data = TRY(ByteBuffer::create_uninitialized(block_data_size));
             existing_next_block_index = 0;
@@ -159,7 +228,7 @@ ErrorOr<void> Heap::write_storage(Block::Index index, ReadonlyBytes data)
             next_block_index = 0;
 
         block_data.bytes().overwrite(0, data.offset(offset_in_data), block_data_size);
-        TRY(write_block({ index, block_data_size, next_block_index, move(block_data) }));
+        TRY(write_block(TRY(try_make_ref_counted<Block>(index, block_data_size, next_block_index, move(block_data)))));
 
         index = next_block_index;
         offset_in_data += block_data_size;
@@ -177,25 +246,36 @@ ErrorOr<ByteBuffer> Heap::read_raw_block(Block::Index index)
     VERIFY(m_file);
     VERIFY(index < m_next_block);
 
-    if (auto wal_entry = m_write_ahead_log.get(index); wal_entry.has_value())
-        return wal_entry.value();
+    if (auto dirty_block = m_dirty_blocks.get(index); dirty_block.has_value())
+        return dirty_block.value();
+    if (m_write_ahead_log->contains(index))
+        return m_write_ahead_log->read_block(index);
+
+    u64 offset = static_cast<u64>(index) * m_block_size;
+    if (m_mapped_file && offset + m_block_size <= m_mapped_file->bytes().size())
+        return ByteBuffer::copy(m_mapped_file->bytes().slice(offset, m_block_size));
 
-    TRY(m_file->seek(index * Block::SIZE, SeekMode::SetPosition));
-    auto buffer = TRY(ByteBuffer::create_uninitialized(Block::SIZE));
+    TRY(m_file->seek(offset, SeekMode::SetPosition));
+    auto buffer = TRY(ByteBuffer::create_uninitialized(m_block_size));
     TRY(m_file->read_until_filled(buffer));
     return buffer;
 }
 
-ErrorOr<Block> Heap::read_block(Block::Index index)
+ErrorOr<NonnullRefPtr<Block>> Heap::read_block(Block::Index index)
 {
     dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
 
+    if (auto cached_block = m_page_cache->get(index))
+        return cached_block.release_nonnull();
+
     auto buffer = TRY(read_raw_block(index));
     auto size_in_bytes = *reinterpret_cast<u32*>(buffer.offset_pointer(0));
     auto next_block = *reinterpret_cast<Block::Index*>(buffer.offset_pointer(sizeof(u32)));
-    auto data = TRY(buffer.slice(Block::HEADER_SIZE, Block::DATA_SIZE));
+    auto data = TRY(buffer.slice(Block::HEADER_SIZE, block_data_size()));
 
-    return Block { index, size_in_bytes, next_block, move(data) };
+    auto block = TRY(try_make_ref_counted<Block>(index, size_in_bytes, next_block, move(data)));
+    TRY(m_page_cache->set(block));
+    return block;
 }
 
 ErrorOr<void> Heap::write_raw_block(Block::Index index, ReadonlyBytes data)
@@ -203,9 +283,9 @@ ErrorOr<void> Heap::write_raw_block(Block::Index index, ReadonlyBytes data)
     dbgln_if(SQL_DEBUG, "Write raw block {}", index);
 
     VERIFY(m_file);
-    VERIFY(data.size() == Block::SIZE);
+    VERIFY(data.size() == m_block_size);
 
-    TRY(m_file->seek(index * Block::SIZE, SeekMode::SetPosition));
+    TRY(m_file->seek(static_cast<u64>(index) * m_block_size, SeekMode::SetPosition));
     TRY(m_file->write_until_depleted(data));
 
     if (index > m_highest_block_written)
@@ -214,35 +294,39 @@ ErrorOr<void> Heap::write_raw_block(Block::Index index, ReadonlyBytes data)
     return {};
 }
 
-ErrorOr<void> Heap::write_raw_block_to_wal(Block::Index index, ByteBuffer&& data)
+ErrorOr<void> Heap::write_dirty_block(Block::Index index, ByteBuffer&& data)
 {
     dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
     VERIFY(index < m_next_block);
-    VERIFY(data.size() == Block::SIZE);
+    VERIFY(data.size() == m_block_size);
 
-    TRY(m_write_ahead_log.try_set(index, move(data)));
+    m_page_cache->remove(index);
+    TRY(m_dirty_blocks.try_set(index, move(data)));
 
     return {};
 }
 
-ErrorOr<void> Heap::write_block(Block const& block)
+ErrorOr<void> Heap::write_block(NonnullRefPtr<Block> block)
 {
-    dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, block.index());
-    VERIFY(block.index() < m_next_block);
-    VERIFY(block.next_block() < m_next_block);
-    VERIFY(block.size_in_bytes() > 0);
-    VERIFY(block.data().size() <= Block::DATA_SIZE);
+    dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, block->index());
+    VERIFY(block->index() < m_next_block);
+    VERIFY(block->next_block() < m_next_block);
+    VERIFY(block->size_in_bytes() > 0);
+    VERIFY(block->data().size() <= block_data_size());
 
-    auto size_in_bytes = block.size_in_bytes();
-    auto next_block = block.next_block();
+    auto size_in_bytes = block->size_in_bytes();
+    auto next_block = block->next_block();
 
-    auto heap_data = TRY(ByteBuffer::create_zeroed(Block::SIZE));
+    auto heap_data = TRY(ByteBuffer::create_zeroed(m_block_size));
     heap_data.overwrite(0, &size_in_bytes, sizeof(size_in_bytes));
     heap_data.overwrite(sizeof(size_in_bytes), &next_block, sizeof(next_block));
 
-    block.data().bytes().copy_to(heap_data.bytes().slice(Block::HEADER_SIZE));
+    block->data().bytes().copy_to(heap_data.bytes().slice(Block::HEADER_SIZE));
 
-    return write_raw_block_to_wal(block.index(), move(heap_data));
+    TRY(write_dirty_block(block->index(), move(heap_data)));
+
+    // The block is most likely read again soon, e.g. when the next key is inserted into a B-Tree node.
+    return m_page_cache->set(move(block));
 }
 
 ErrorOr<void> Heap::free_storage(Block::Index index)
@@ -252,8 +336,8 @@ ErrorOr<void> Heap::free_storage(Block::Index index)
 
     while (index > 0) {
         auto block = TRY(read_block(index));
-        TRY(free_block(block));
-        index = block.next_block();
+        TRY(free_block(*block));
+        index = block->next_block();
     }
     return {};
 }
@@ -267,33 +351,96 @@ ErrorOr<void> Heap::free_block(Block const& block)
     VERIFY(has_block(index));
 
     // Zero out freed blocks to facilitate a free block scan upon opening the database later
-    auto zeroed_data = TRY(ByteBuffer::create_zeroed(Block::SIZE));
-    TRY(write_raw_block_to_wal(index, move(zeroed_data)));
+    auto zeroed_data = TRY(ByteBuffer::create_zeroed(m_block_size));
+    TRY(write_dirty_block(index, move(zeroed_data)));
 
     return m_free_block_indices.try_append(index);
 }
 
+ErrorOr<void> Heap::commit()
+{
+    VERIFY(m_file);
+    TRY(m_write_ahead_log->append_transaction(m_dirty_blocks));
+    m_dirty_blocks.clear();
+    return {};
+}
+
+ErrorOr<void> Heap::sync()
+{
+    VERIFY(m_file);
+    TRY(m_write_ahead_log->sync());
+
+    if (m_write_ahead_log->frame_count() * m_block_size >= CHECKPOINT_SIZE)
+        TRY(checkpoint());
+    return {};
+}
+
 ErrorOr<void> Heap::flush()
+{
+    TRY(commit());
+    return sync();
+}
+
+ErrorOr<void> Heap::checkpoint()
 {
     VERIFY(m_file);
-    auto indices = m_write_ahead_log.keys();
-    quick_sort(indices);
-    for (auto index : indices) {
-        dbgln_if(SQL_DEBUG, "Flushing block {}", index);
-        auto& data = m_write_ahead_log.get(index).value();
+    if (m_write_ahead_log->is_empty())
+        return {};
+
+    // The log has to be durable before the heap file is changed, or a crash while copying the blocks would lose them.
+    TRY(m_write_ahead_log->sync());
+
+    for (auto index : m_write_ahead_log->block_indices()) {
+        dbgln_if(SQL_DEBUG, "Checkpointing block {}", index);
+        auto data = TRY(m_write_ahead_log->read_block(index));
         TRY(write_raw_block(index, data));
     }
-    m_write_ahead_log.clear();
-    dbgln_if(SQL_DEBUG, "WAL flushed; new number of blocks = {}", m_highest_block_written);
-    return {};
+    TRY(Core::System::fsync(m_file_descriptor));
+
+    // The heap file may have grown, so the mapping has to be recreated to cover the blocks that were added to it.
+    if (m_uses_mapped_reads)
+        TRY(map_heap_file());
+
+    dbgln_if(SQL_DEBUG, "WAL checkpointed; new number of blocks = {}", m_highest_block_written);
+    return m_write_ahead_log->reset();
 }
 
 constexpr static auto FILE_ID = "SerenitySQL "sv;
 constexpr static auto VERSION_OFFSET = FILE_ID.length();
-constexpr static auto SCHEMAS_ROOT_OFFSET = VERSION_OFFSET + sizeof(u32);
+constexpr static auto BLOCK_SIZE_OFFSET = VERSION_OFFSET + sizeof(u32);
+constexpr static auto SCHEMAS_ROOT_OFFSET = BLOCK_SIZE_OFFSET + sizeof(u32);
 constexpr static auto TABLES_ROOT_OFFSET = SCHEMAS_ROOT_OFFSET + sizeof(u32);
 constexpr static auto TABLE_COLUMNS_ROOT_OFFSET = TABLES_ROOT_OFFSET + sizeof(u32);
-constexpr static auto USER_VALUES_OFFSET = TABLE_COLUMNS_ROOT_OFFSET + sizeof(u32);
+constexpr static auto TABLE_INDEXES_ROOT_OFFSET = TABLE_COLUMNS_ROOT_OFFSET + sizeof(u32);
+constexpr static auto USER_VALUES_OFFSET = TABLE_INDEXES_ROOT_OFFSET + sizeof(u32);
+
+// Reads the part of the zero block that is needed to read the rest of the heap from the heap file itself. The zero
+// block can't be read as a whole yet, because there may be a more recent version of it in the log.
+ErrorOr<void> Heap::read_heap_file_header()
+{
+    Array<u8, SCHEMAS_ROOT_OFFSET> header;
+    TRY(m_file->seek(0, SeekMode::SetPosition));
+    TRY(m_file->read_until_filled(header));
+
+    if (StringView { header.data(), FILE_ID.length() } != FILE_ID) {
+        warnln("{}: Zero page corrupt. This is probably not a {} heap file"sv, name(), FILE_ID);
+        return Error::from_string_literal("Heap()::read_heap_file_header(): Zero page corrupt. This is probably not a SerenitySQL heap file");
+    }
+
+    memcpy(&m_version, header.data() + VERSION_OFFSET, sizeof(u32));
+    if (m_version != VERSION)
+        return {};
+
+    u32 block_size = 0;
+    memcpy(&block_size, header.data() + BLOCK_SIZE_OFFSET, sizeof(u32));
+    if (!Block::is_valid_size(block_size)) {
+        warnln("{}: Zero page corrupt. Invalid block size {}"sv, name(), block_size);
+        return Error::from_string_literal("Heap()::read_heap_file_header(): Zero page corrupt. Invalid block size");
+    }
+
+    m_block_size = block_size;
+    return {};
+}
 
 ErrorOr<void> Heap::read_zero_block()
 {
@@ -309,6 +456,7 @@ ErrorOr<void> Heap::read_zero_block()
 
     memcpy(&m_version, block.offset_pointer(VERSION_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Version: {}.{}", (m_version & 0xFFFF0000) >> 16, (m_version & 0x0000FFFF));
+    dbgln_if(SQL_DEBUG, "Block size: {}", m_block_size);
 
     memcpy(&m_schemas_root, block.offset_pointer(SCHEMAS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Schemas root node: {}", m_schemas_root);
@@ -319,6 +467,9 @@ ErrorOr<void> Heap::read_zero_block()
     memcpy(&m_table_columns_root, block.offset_pointer(TABLE_COLUMNS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Table columns root node: {}", m_table_columns_root);
 
+    memcpy(&m_table_indexes_root, block.offset_pointer(TABLE_INDEXES_ROOT_OFFSET), sizeof(u32));
+    dbgln_if(SQL_DEBUG, "Table indexes root node: {}", m_table_indexes_root);
+
     memcpy(m_user_values.data(), block.offset_pointer(USER_VALUES_OFFSET), m_user_values.size() * sizeof(u32));
     for (auto ix = 0u; ix < m_user_values.size(); ix++) {
         if (m_user_values[ix])
@@ -334,21 +485,24 @@ ErrorOr<void> Heap::update_zero_block()
     dbgln_if(SQL_DEBUG, "Schemas root node: {}", m_schemas_root);
     dbgln_if(SQL_DEBUG, "Tables root node: {}", m_tables_root);
     dbgln_if(SQL_DEBUG, "Table Columns root node: {}", m_table_columns_root);
+    dbgln_if(SQL_DEBUG, "Table Indexes root node: {}", m_table_indexes_root);
     for (auto ix = 0u; ix < m_user_values.size(); ix++) {
         if (m_user_values[ix] > 0)
             dbgln_if(SQL_DEBUG, "User value {}: {}", ix, m_user_values[ix]);
     }
 
-    auto buffer = TRY(ByteBuffer::create_zeroed(Block::SIZE));
+    auto buffer = TRY(ByteBuffer::create_zeroed(m_block_size));
     auto buffer_bytes = buffer.bytes();
     buffer_bytes.overwrite(0, FILE_ID.characters_without_null_termination(), FILE_ID.length());
     buffer_bytes.overwrite(VERSION_OFFSET, &m_version, sizeof(u32));
+    buffer_bytes.overwrite(BLOCK_SIZE_OFFSET, &m_block_size, sizeof(u32));
     buffer_bytes.overwrite(SCHEMAS_ROOT_OFFSET, &m_schemas_root, sizeof(u32));
     buffer_bytes.overwrite(TABLES_ROOT_OFFSET, &m_tables_root, sizeof(u32));
     buffer_bytes.overwrite(TABLE_COLUMNS_ROOT_OFFSET, &m_table_columns_root, sizeof(u32));
+    buffer_bytes.overwrite(TABLE_INDEXES_ROOT_OFFSET, &m_table_indexes_root, sizeof(u32));
     buffer_bytes.overwrite(USER_VALUES_OFFSET, m_user_values.data(), m_user_values.size() * sizeof(u32));
 
-    return write_raw_block_to_wal(0, move(buffer));
+    return write_dirty_block(0, move(buffer));
 }
 
 ErrorOr<void> Heap::initialize_zero_block()
@@ -357,6 +511,7 @@ ErrorOr<void> Heap::initialize_zero_block()
     m_schemas_root = 0;
     m_tables_root = 0;
     m_table_columns_root = 0;
+    m_table_indexes_root = 0;
     m_next_block = 1;
     m_highest_block_written = 0;
     for (auto& user : m_user_values)
@@ -11,28 +11,39 @@
 #include <AK/ByteString.h>
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/Vector.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <LibSQL/Forward.h>
 
 namespace SQL {
 
 /**
- * A Block represents a single discrete chunk of 1024 bytes inside the Heap, and
- * acts as the container format for the actual data we are storing. This structure
- * is used for everything except block 0, the zero / super block.
+ * A Block represents a single discrete chunk of the Heap, and acts as the
+ * container format for the actual data we are storing. This structure is used
+ * for everything except block 0, the zero / super block.
  *
- * If data needs to be stored that is larger than 1016 bytes, Blocks are chained
- * together by setting the next block index and the data is reconstructed by
- * repeatedly reading blocks until the next block index is 0.
+ * All blocks of a Heap have the same size, which is chosen when the heap file
+ * is created. If data needs to be stored that is larger than the data part of
+ * a block, Blocks are chained together by setting the next block index and the
+ * data is reconstructed by repeatedly reading blocks until the next block index
+ * is 0.
  */
-class Block {
+class Block : public RefCounted<Block> {
 public:
     typedef u32 Index;
 
-    static constexpr u32 SIZE = 1024;
+    static constexpr u32 MINIMUM_SIZE = 4 * KiB;
+    static constexpr u32 MAXIMUM_SIZE = 16 * KiB;
+    static constexpr u32 DEFAULT_SIZE = MINIMUM_SIZE;
     static constexpr u32 HEADER_SIZE = sizeof(u32) + sizeof(Index);
-    static constexpr u32 DATA_SIZE = SIZE - HEADER_SIZE;
+
+    static constexpr bool is_valid_size(u32 size)
+    {
+        return size >= MINIMUM_SIZE && size <= MAXIMUM_SIZE && is_power_of_two(size);
+    }
 
     Block(Index index, u32 size_in_bytes, Index next_block, ByteBuffer data)
         : m_index(index)
@@ -63,15 +74,43 @@ private:
  *
  * A Heap can be thought of the backing storage of a single database. It's
  * assumed that a single SQL database is backed by a single Heap.
+ *
+ * Blocks that are written are kept in memory until they are committed. A
+ * commit appends them to the heap's WriteAheadLog, and they are copied to
+ * the heap file itself when the log is checkpointed.
+ *
+ * Blocks that are read are kept in a PageCache, so that the B-Trees and table
+ * scans that read the same blocks over and over again don't have to read them
+ * from the heap file or the log each time.
  */
 class Heap : public RefCounted<Heap> {
 public:
-    static constexpr u32 VERSION = 5;
+    static constexpr u32 VERSION = 7;
+
+    // The log is checkpointed when it is synced and holds at least this many bytes of blocks.
+    static constexpr size_t CHECKPOINT_SIZE = 4 * MiB;
 
-    static ErrorOr<NonnullRefPtr<Heap>> create(ByteString);
+    // The number of bytes of blocks kept in the page cache.
+    static constexpr size_t PAGE_CACHE_SIZE = 4 * MiB;
+
+    // The block size is only used when the heap file is created. Existing heap files keep the block size they were
+    // created with.
+    static ErrorOr<NonnullRefPtr<Heap>> create(ByteString, u32 block_size = Block::DEFAULT_SIZE);
     virtual ~Heap();
 
     ByteString const& name() const { return m_name; }
+    u32 block_size() const { return m_block_size; }
+    u32 block_data_size() const { return m_block_size - Block::HEADER_SIZE; }
+
+    // Reads blocks from a memory mapping of the heap file instead of reading them from the file.
+    bool uses_mapped_reads() const { return m_uses_mapped_reads; }
+    ErrorOr<void> set_uses_mapped_reads(bool);
+
+    PageCache const& page_cache() const
+    {
+        VERIFY(m_page_cache);
+        return *m_page_cache;
+    }
 
     ErrorOr<void> open();
     ErrorOr<size_t> file_size_in_bytes() const;
@@ -102,6 +141,15 @@ public:
         m_table_columns_root = root;
         update_zero_block().release_value_but_fixme_should_propagate_errors();
     }
+
+    Block::Index table_indexes_root() const { return m_table_indexes_root; }
+
+    void set_table_indexes_root(Block::Index root)
+    {
+        m_table_indexes_root = root;
+        update_zero_block().release_value_but_fixme_should_propagate_errors();
+    }
+
     u32 version() const { return m_version; }
 
     u32 user_value(size_t index) const
@@ -119,19 +167,34 @@ public:
     ErrorOr<void> write_storage(Block::Index, ReadonlyBytes);
     ErrorOr<void> free_storage(Block::Index);
 
+    // Appends the blocks written since the last commit to the write-ahead log as a single transaction.
+    ErrorOr<void> commit();
+
+    // Waits until all committed transactions are durable.
+    ErrorOr<void> sync();
+
+    // Commits and syncs.
     ErrorOr<void> flush();
 
+    // Copies all blocks from the write-ahead log to the heap file.
+    ErrorOr<void> checkpoint();
+
 private:
-    explicit Heap(ByteString);
+    Heap(ByteString, u32 block_size);
+
+    ByteString write_ahead_log_name() const { return ByteString::formatted("{}-wal", m_name); }
 
     ErrorOr<ByteBuffer> read_raw_block(Block::Index);
     ErrorOr<void> write_raw_block(Block::Index, ReadonlyBytes);
-    ErrorOr<void> write_raw_block_to_wal(Block::Index, ByteBuffer&&);
+    ErrorOr<void> write_dirty_block(Block::Index, ByteBuffer&&);
 
-    ErrorOr<Block> read_block(Block::Index);
-    ErrorOr<void> write_block(Block const&);
+    ErrorOr<NonnullRefPtr<Block>> read_block(Block::Index);
+    ErrorOr<void> write_block(NonnullRefPtr<Block>);
     ErrorOr<void> free_block(Block const&);
 
+    ErrorOr<void> map_heap_file();
+
+    ErrorOr<void> read_heap_file_header();
     ErrorOr<void> read_zero_block();
     ErrorOr<void> initialize_zero_block();
     ErrorOr<void> update_zero_block();
@@ -139,14 +202,21 @@ private:
     ByteString m_name;
 
     OwnPtr<Core::InputBufferedFile> m_file;
+    int m_file_descriptor { -1 };
+    OwnPtr<Core::MappedFile> m_mapped_file;
+    bool m_uses_mapped_reads { false };
+    OwnPtr<WriteAheadLog> m_write_ahead_log;
+    OwnPtr<PageCache> m_page_cache;
+    u32 m_block_size { Block::DEFAULT_SIZE };
     Block::Index m_highest_block_written { 0 };
     Block::Index m_next_block { 1 };
     Block::Index m_schemas_root { 0 };
     Block::Index m_tables_root { 0 };
     Block::Index m_table_columns_root { 0 };
+    Block::Index m_table_indexes_root { 0 };
     u32 m_version { VERSION };
     Array<u32, 16> m_user_values { 0 };
-    HashMap<Block::Index, ByteBuffer> m_write_ahead_log;
+    HashMap<Block::Index, ByteBuffer> m_dirty_blocks;
     Vector<Block::Index> m_free_block_indices;
 };
 
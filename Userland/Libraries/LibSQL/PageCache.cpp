@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/PageCache.h>
+
+namespace SQL {
+
+ErrorOr<NonnullOwnPtr<PageCache>> PageCache::create(size_t capacity)
+{
+    VERIFY(capacity > 0);
+    return adopt_nonnull_own_or_enomem(new (nothrow) PageCache(capacity));
+}
+
+PageCache::PageCache(size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+PageCache::~PageCache()
+{
+    clear();
+}
+
+RefPtr<Block> PageCache::get(Block::Index index)
+{
+    auto entry = m_entries.get(index);
+    if (!entry.has_value()) {
+        ++m_misses;
+        return {};
+    }
+
+    ++m_hits;
+    m_entries_by_use.prepend(**entry);
+    return (*entry)->block;
+}
+
+ErrorOr<void> PageCache::set(NonnullRefPtr<Block> block)
+{
+    if (auto entry = m_entries.get(block->index()); entry.has_value()) {
+        (*entry)->block = move(block);
+        m_entries_by_use.prepend(**entry);
+        return {};
+    }
+
+    if (m_entries.size() >= m_capacity) {
+        auto& least_recently_used = *m_entries_by_use.last();
+        remove(least_recently_used.block->index());
+    }
+
+    auto index = block->index();
+    auto entry = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Entry { move(block) }));
+    m_entries_by_use.prepend(*entry);
+    TRY(m_entries.try_set(index, move(entry)));
+    return {};
+}
+
+void PageCache::remove(Block::Index index)
+{
+    auto entry = m_entries.take(index);
+    if (entry.has_value())
+        m_entries_by_use.remove(**entry);
+}
+
+void PageCache::clear()
+{
+    m_entries_by_use.clear();
+    m_entries.clear();
+}
+
+}
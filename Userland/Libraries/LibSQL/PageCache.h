@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefPtr.h>
+#include <LibSQL/Heap.h>
+
+namespace SQL {
+
+/**
+ * A PageCache holds the most recently used Blocks of a Heap. When it is full,
+ * the block that was used least recently is evicted to make room for a new one.
+ */
+class PageCache {
+    AK_MAKE_NONCOPYABLE(PageCache);
+    AK_MAKE_NONMOVABLE(PageCache);
+
+public:
+    static ErrorOr<NonnullOwnPtr<PageCache>> create(size_t capacity);
+    ~PageCache();
+
+    size_t capacity() const { return m_capacity; }
+    size_t size() const { return m_entries.size(); }
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+
+    RefPtr<Block> get(Block::Index);
+    ErrorOr<void> set(NonnullRefPtr<Block>);
+    void remove(Block::Index);
+    void clear();
+
+private:
+    explicit PageCache(size_t capacity);
+
+    struct Entry {
+        NonnullRefPtr<Block> block;
+        IntrusiveListNode<Entry> list_node {};
+    };
+
+    size_t m_capacity { 0 };
+    HashMap<Block::Index, NonnullOwnPtr<Entry>> m_entries;
+
+    // The most recently used entry comes first.
+    IntrusiveList<&Entry::list_node> m_entries_by_use;
+
+    size_t m_hits { 0 };
+    size_t m_misses { 0 };
+};
+
+}
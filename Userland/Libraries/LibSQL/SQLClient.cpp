@@ -69,6 +69,27 @@ void SQLClient::next_result(u64 statement_id, u64 execution_id, Vector<Value> co
     on_next_result(move(result));
 }
 
+// Unlike next_result(), the server doesn't send more rows of a cursor until they are fetched with async_fetch_results().
+void SQLClient::next_results(u64 statement_id, u64 execution_id, Vector<Vector<Value>> const& rows)
+{
+    if (!on_next_results) {
+        for (auto const& row : rows) {
+            StringBuilder builder;
+            builder.join(", "sv, row, "\"{}\""sv);
+            outln("{}", builder.string_view());
+        }
+        return;
+    }
+
+    ExecutionResults results {
+        .statement_id = statement_id,
+        .execution_id = execution_id,
+        .rows = move(const_cast<Vector<Vector<Value>>&>(rows)),
+    };
+
+    on_next_results(move(results));
+}
+
 void SQLClient::results_exhausted(u64 statement_id, u64 execution_id, size_t total_rows)
 {
     if (!on_results_exhausted) {
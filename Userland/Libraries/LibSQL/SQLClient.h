@@ -40,6 +40,13 @@ struct ExecutionResult {
     Vector<Value> values;
 };
 
+struct ExecutionResults {
+    u64 statement_id { 0 };
+    u64 execution_id { 0 };
+
+    Vector<Vector<Value>> rows;
+};
+
 struct ExecutionComplete {
     u64 statement_id { 0 };
     u64 execution_id { 0 };
@@ -63,12 +70,14 @@ public:
     Function<void(ExecutionSuccess)> on_execution_success;
     Function<void(ExecutionError)> on_execution_error;
     Function<void(ExecutionResult)> on_next_result;
+    Function<void(ExecutionResults)> on_next_results;
     Function<void(ExecutionComplete)> on_results_exhausted;
 
 private:
     virtual void execution_success(u64 statement_id, u64 execution_id, Vector<ByteString> const& column_names, bool has_results, size_t created, size_t updated, size_t deleted) override;
     virtual void execution_error(u64 statement_id, u64 execution_id, SQLErrorCode const& code, ByteString const& message) override;
     virtual void next_result(u64 statement_id, u64 execution_id, Vector<SQL::Value> const&) override;
+    virtual void next_results(u64 statement_id, u64 execution_id, Vector<Vector<SQL::Value>> const&) override;
     virtual void results_exhausted(u64 statement_id, u64 execution_id, size_t total_rows) override;
 };
 
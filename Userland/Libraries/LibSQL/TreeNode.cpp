@@ -160,10 +160,11 @@ bool TreeNode::insert(Key const& key)
 bool TreeNode::update_key_pointer(Key const& key)
 {
     dbgln_if(SQL_DEBUG, "[#{}] UPDATE({}, {})", block_index(), key.to_byte_string(), key.block_index());
-    if (!is_leaf())
-        return node_for(key)->update_key_pointer(key);
 
+    // Keys are stored in non-leaf nodes as well, so we have to look at the entries of every node on the way down.
     for (auto ix = 0u; ix < size(); ix++) {
+        if (!is_leaf() && key < m_entries[ix])
+            return down_node(ix)->update_key_pointer(key);
         if (key == m_entries[ix]) {
             dbgln_if(SQL_DEBUG, "[#{}] {} == {}",
                 block_index(), key.to_byte_string(), m_entries[ix].to_byte_string());
@@ -175,6 +176,8 @@ bool TreeNode::update_key_pointer(Key const& key)
             return true;
         }
     }
+    if (!is_leaf())
+        return down_node(size())->update_key_pointer(key);
     return false;
 }
 
@@ -271,7 +274,7 @@ void TreeNode::just_insert(Key const& key, TreeNode* right)
             m_entries.insert(ix, key);
             VERIFY(is_leaf() == (right == nullptr));
             m_down.insert(ix + 1, DownPointer(this, right));
-            if (length() > Block::DATA_SIZE) {
+            if (length() > tree().serializer().heap().block_data_size()) {
                 split();
             } else {
                 dump_if(SQL_DEBUG, "To WAL");
@@ -283,7 +286,7 @@ void TreeNode::just_insert(Key const& key, TreeNode* right)
     m_entries.append(key);
     m_down.empend(this, right);
 
-    if (length() > Block::DATA_SIZE) {
+    if (length() > tree().serializer().heap().block_data_size()) {
         split();
     } else {
         dump_if(SQL_DEBUG, "To WAL");
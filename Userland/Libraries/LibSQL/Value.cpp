@@ -445,6 +445,27 @@ u32 Value::hash() const
         });
 }
 
+// Integers are not converted to doubles or the other way around here, since either conversion can round, which would
+// make different values compare equal.
+template<Integer T>
+static int compare_integer_with_double(T integer, double value)
+{
+    if (isnan(value))
+        return 1;
+    if (value >= static_cast<double>(NumericLimits<T>::max()))
+        return -1;
+    if (value < (IsSigned<T> ? static_cast<double>(NumericLimits<T>::min()) : 0.0))
+        return 1;
+
+    auto truncated = trunc(value);
+    auto truncated_integer = static_cast<T>(truncated);
+    if (integer != truncated_integer)
+        return integer < truncated_integer ? -1 : 1;
+    if (value == truncated)
+        return 0;
+    return value > truncated ? -1 : 1;
+}
+
 int Value::compare(Value const& other) const
 {
     if (is_null())
@@ -455,15 +476,28 @@ int Value::compare(Value const& other) const
     return m_value->visit(
         [&](ByteString const& value) -> int { return value.view().compare(other.to_byte_string()); },
         [&](Integer auto value) -> int {
+            if (auto const* other_value = other.m_value->get_pointer<double>())
+                return compare_integer_with_double(value, *other_value);
+
             auto casted = other.to_int<IntegerType<decltype(value)>>();
-            if (!casted.has_value())
+            if (!casted.has_value()) {
+                // An integer that doesn't fit into our type is either larger than any signed or smaller than any
+                // unsigned value.
+                if (other.is_int())
+                    return IsSigned<decltype(value)> ? -1 : 1;
                 return 1;
+            }
 
             if (value == *casted)
                 return 0;
             return value < *casted ? -1 : 1;
         },
         [&](double value) -> int {
+            if (auto const* other_value = other.m_value->get_pointer<i64>())
+                return -compare_integer_with_double(*other_value, value);
+            if (auto const* other_value = other.m_value->get_pointer<u64>())
+                return -compare_integer_with_double(*other_value, value);
+
             auto casted = other.to_double();
             if (!casted.has_value())
                 return 1;
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/QuickSort.h>
+#include <AK/Random.h>
+#include <LibCore/System.h>
+#include <LibSQL/WriteAheadLog.h>
+
+namespace SQL {
+
+static constexpr u32 MAGIC = 0x53514c57; // "SQLW"
+
+struct LogHeader {
+    u32 magic;
+    u32 version;
+    u32 block_size;
+    u32 checkpoint_sequence;
+    u32 salt[2];
+    u32 checksum[2];
+};
+static_assert(sizeof(LogHeader) == 32);
+
+struct FrameHeader {
+    Block::Index block_index;
+
+    // The number of frames in the transaction if this is its last frame, zero otherwise.
+    u32 transaction_size;
+
+    // The salt of the log when the frame was written. Frames that were written before the log was last reset have
+    // a different salt, and are not part of the log anymore.
+    u32 salt[2];
+
+    u32 checksum[2];
+};
+static_assert(sizeof(FrameHeader) == 24);
+
+static constexpr size_t CHECKSUMMED_HEADER_SIZE = offsetof(LogHeader, checksum);
+static constexpr size_t CHECKSUMMED_FRAME_HEADER_SIZE = offsetof(FrameHeader, checksum);
+
+// This is the checksum that SQLite uses for its write-ahead log: a Fletcher-like sum over pairs of 32-bit words.
+// Checksums are cumulative, so the checksum of a frame covers all frames before it as well.
+static void update_checksum(Array<u32, 2>& checksum, ReadonlyBytes bytes)
+{
+    VERIFY(bytes.size() % (2 * sizeof(u32)) == 0);
+
+    auto s0 = checksum[0];
+    auto s1 = checksum[1];
+
+    for (size_t offset = 0; offset < bytes.size(); offset += 2 * sizeof(u32)) {
+        u32 words[2];
+        memcpy(words, bytes.offset(offset), sizeof(words));
+
+        s0 += words[0] + s1;
+        s1 += words[1] + s0;
+    }
+
+    checksum = { s0, s1 };
+}
+
+// Returns the header of the log if it was written by this version for blocks of a valid size.
+static ErrorOr<Optional<LogHeader>> read_valid_header(Core::File& file, Array<u32, 2>& checksum)
+{
+    auto file_size = TRY(file.seek(0, SeekMode::FromEndPosition));
+    if (file_size < sizeof(LogHeader))
+        return OptionalNone {};
+
+    LogHeader header;
+    TRY(file.seek(0, SeekMode::SetPosition));
+    TRY(file.read_until_filled({ &header, sizeof(header) }));
+
+    checksum = { 0, 0 };
+    update_checksum(checksum, { &header, CHECKSUMMED_HEADER_SIZE });
+
+    if (header.magic != MAGIC || header.version != WriteAheadLog::VERSION || !Block::is_valid_size(header.block_size) || header.checksum[0] != checksum[0] || header.checksum[1] != checksum[1])
+        return OptionalNone {};
+    return header;
+}
+
+ErrorOr<Optional<u32>> WriteAheadLog::read_block_size(ByteString const& file_name)
+{
+    auto file_or_error = Core::File::open(file_name, Core::File::OpenMode::Read);
+    if (file_or_error.is_error()) {
+        if (file_or_error.error().is_errno() && file_or_error.error().code() == ENOENT)
+            return OptionalNone {};
+        return file_or_error.release_error();
+    }
+
+    Array<u32, 2> checksum;
+    auto header = TRY(read_valid_header(*file_or_error.value(), checksum));
+    if (!header.has_value())
+        return OptionalNone {};
+    return header->block_size;
+}
+
+ErrorOr<NonnullOwnPtr<WriteAheadLog>> WriteAheadLog::open(ByteString file_name, u32 block_size)
+{
+    auto file = TRY(Core::File::open(file_name, Core::File::OpenMode::ReadWrite));
+    auto log = TRY(adopt_nonnull_own_or_enomem(new (nothrow) WriteAheadLog(move(file_name), move(file), block_size)));
+    TRY(log->recover());
+    return log;
+}
+
+WriteAheadLog::WriteAheadLog(ByteString file_name, NonnullOwnPtr<Core::File> file, u32 block_size)
+    : m_name(move(file_name))
+    , m_file(move(file))
+    , m_block_size(block_size)
+{
+}
+
+size_t WriteAheadLog::frame_size() const
+{
+    return sizeof(FrameHeader) + m_block_size;
+}
+
+Vector<Block::Index> WriteAheadLog::block_indices() const
+{
+    auto indices = m_frame_offsets.keys();
+    quick_sort(indices);
+    return indices;
+}
+
+ErrorOr<ByteBuffer> WriteAheadLog::read_block(Block::Index index)
+{
+    auto frame_offset = m_frame_offsets.get(index);
+    VERIFY(frame_offset.has_value());
+
+    TRY(m_file->seek(*frame_offset + sizeof(FrameHeader), SeekMode::SetPosition));
+    auto buffer = TRY(ByteBuffer::create_uninitialized(m_block_size));
+    TRY(m_file->read_until_filled(buffer));
+    return buffer;
+}
+
+ErrorOr<void> WriteAheadLog::append_transaction(HashMap<Block::Index, ByteBuffer> const& blocks)
+{
+    if (blocks.is_empty())
+        return {};
+
+    auto indices = blocks.keys();
+    quick_sort(indices);
+
+    // The frames of a transaction are written with a single write, and are only added to the log once all of them
+    // have been written.
+    auto frames = TRY(ByteBuffer::create_uninitialized(indices.size() * frame_size()));
+    auto checksum = m_checksum;
+
+    for (size_t i = 0; i < indices.size(); ++i) {
+        auto const& data = blocks.get(indices[i]).value();
+        VERIFY(data.size() == m_block_size);
+
+        auto frame = frames.bytes().slice(i * frame_size(), frame_size());
+        data.bytes().copy_to(frame.slice(sizeof(FrameHeader)));
+
+        FrameHeader header {
+            .block_index = indices[i],
+            .transaction_size = i + 1 == indices.size() ? static_cast<u32>(indices.size()) : 0,
+            .salt = { m_salt[0], m_salt[1] },
+            .checksum = { 0, 0 },
+        };
+        frame.overwrite(0, &header, sizeof(header));
+
+        update_checksum(checksum, frame.slice(0, CHECKSUMMED_FRAME_HEADER_SIZE));
+        update_checksum(checksum, frame.slice(sizeof(FrameHeader)));
+        frame.overwrite(CHECKSUMMED_FRAME_HEADER_SIZE, checksum.data(), sizeof(header.checksum));
+    }
+
+    TRY(m_file->seek(m_end_of_log, SeekMode::SetPosition));
+    TRY(m_file->write_until_depleted(frames));
+
+    for (size_t i = 0; i < indices.size(); ++i) {
+        TRY(m_frame_offsets.try_set(indices[i], m_end_of_log + i * frame_size()));
+        m_highest_block_index = max(m_highest_block_index.value_or(0), indices[i]);
+    }
+
+    dbgln_if(SQL_DEBUG, "{}: appended transaction of {} frames at offset {}", m_name, indices.size(), m_end_of_log);
+
+    m_end_of_log += frames.size();
+    m_frame_count += indices.size();
+    m_checksum = checksum;
+    m_needs_sync = true;
+    return {};
+}
+
+ErrorOr<void> WriteAheadLog::sync()
+{
+    if (!m_needs_sync)
+        return {};
+
+    TRY(Core::System::fsync(m_file->fd()));
+    m_needs_sync = false;
+    return {};
+}
+
+ErrorOr<void> WriteAheadLog::reset()
+{
+    // A new salt makes sure frames from before the reset are never mistaken for frames of the new log, even if they
+    // are still in the file because we crashed before it was truncated.
+    ++m_checkpoint_sequence;
+    m_salt[0] += 1;
+    m_salt[1] = get_random<u32>();
+
+    m_frame_offsets.clear();
+    m_frame_count = 0;
+    m_highest_block_index.clear();
+
+    TRY(m_file->truncate(0));
+    return write_header();
+}
+
+ErrorOr<void> WriteAheadLog::write_header()
+{
+    LogHeader header {
+        .magic = MAGIC,
+        .version = VERSION,
+        .block_size = m_block_size,
+        .checkpoint_sequence = m_checkpoint_sequence,
+        .salt = { m_salt[0], m_salt[1] },
+        .checksum = { 0, 0 },
+    };
+
+    m_checksum = { 0, 0 };
+    update_checksum(m_checksum, { &header, CHECKSUMMED_HEADER_SIZE });
+    header.checksum[0] = m_checksum[0];
+    header.checksum[1] = m_checksum[1];
+
+    TRY(m_file->seek(0, SeekMode::SetPosition));
+    TRY(m_file->write_until_depleted({ &header, sizeof(header) }));
+
+    m_end_of_log = sizeof(header);
+    m_needs_sync = true;
+    return {};
+}
+
+ErrorOr<void> WriteAheadLog::recover()
+{
+    Array<u32, 2> checksum { 0, 0 };
+    auto maybe_header = TRY(read_valid_header(*m_file, checksum));
+    if (!maybe_header.has_value() || maybe_header->block_size != m_block_size) {
+        dbgln_if(SQL_DEBUG, "{}: invalid header, discarding log", m_name);
+        return reset();
+    }
+
+    auto file_size = TRY(m_file->seek(0, SeekMode::FromEndPosition));
+    auto const& header = *maybe_header;
+    TRY(m_file->seek(sizeof(header), SeekMode::SetPosition));
+
+    m_checkpoint_sequence = header.checkpoint_sequence;
+    m_salt = { header.salt[0], header.salt[1] };
+    m_checksum = checksum;
+    m_end_of_log = sizeof(header);
+
+    HashMap<Block::Index, u64> transaction_frame_offsets;
+    auto frame = TRY(ByteBuffer::create_uninitialized(frame_size()));
+
+    for (u64 offset = sizeof(header); offset + frame_size() <= file_size; offset += frame_size()) {
+        TRY(m_file->read_until_filled(frame));
+
+        FrameHeader frame_header;
+        memcpy(&frame_header, frame.data(), sizeof(frame_header));
+        if (frame_header.salt[0] != m_salt[0] || frame_header.salt[1] != m_salt[1])
+            break;
+
+        update_checksum(checksum, frame.bytes().slice(0, CHECKSUMMED_FRAME_HEADER_SIZE));
+        update_checksum(checksum, frame.bytes().slice(sizeof(FrameHeader)));
+        if (frame_header.checksum[0] != checksum[0] || frame_header.checksum[1] != checksum[1])
+            break;
+
+        TRY(transaction_frame_offsets.try_set(frame_header.block_index, offset));
+        if (frame_header.transaction_size == 0)
+            continue;
+        if (frame_header.transaction_size != transaction_frame_offsets.size())
+            break;
+
+        for (auto const& [index, frame_offset] : transaction_frame_offsets) {
+            TRY(m_frame_offsets.try_set(index, frame_offset));
+            m_highest_block_index = max(m_highest_block_index.value_or(0), index);
+        }
+        m_frame_count += transaction_frame_offsets.size();
+        transaction_frame_offsets.clear();
+
+        m_checksum = checksum;
+        m_end_of_log = offset + frame_size();
+    }
+
+    // Anything after the last commit frame was written by a transaction that didn't finish committing.
+    if (m_end_of_log < file_size) {
+        dbgln_if(SQL_DEBUG, "{}: discarding {} bytes of incomplete transactions", m_name, file_size - m_end_of_log);
+        TRY(m_file->truncate(m_end_of_log));
+        m_needs_sync = true;
+    }
+
+    dbgln_if(SQL_DEBUG, "{}: recovered {} frames for {} blocks", m_name, m_frame_count, m_frame_offsets.size());
+    return {};
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibCore/File.h>
+#include <LibSQL/Heap.h>
+
+namespace SQL {
+
+/**
+ * The WriteAheadLog makes the blocks written to a Heap durable without
+ * writing them to their place in the heap file. Every committed transaction
+ * is appended to the end of the log as a sequence of frames, one for each
+ * modified block, and the last frame of a transaction marks it as committed.
+ *
+ * Each frame carries a checksum that continues from the checksum of the
+ * frame before it. When the log is opened, it is read up to the first frame
+ * that doesn't match its checksum, which is where the process crashed while
+ * appending to the log. Frames of a transaction that has no commit frame
+ * before that point are discarded.
+ *
+ * Blocks are read from the log until a checkpoint copies the most recent
+ * version of each block in it to the heap file and empties the log.
+ */
+class WriteAheadLog {
+    AK_MAKE_NONCOPYABLE(WriteAheadLog);
+    AK_MAKE_NONMOVABLE(WriteAheadLog);
+
+public:
+    static constexpr u32 VERSION = 1;
+
+    // A log that was written for blocks of another size is discarded.
+    static ErrorOr<NonnullOwnPtr<WriteAheadLog>> open(ByteString, u32 block_size);
+
+    // The block size of an existing log, if it has a valid header.
+    static ErrorOr<Optional<u32>> read_block_size(ByteString const&);
+
+    ByteString const& name() const { return m_name; }
+    u32 block_size() const { return m_block_size; }
+
+    bool is_empty() const { return m_frame_offsets.is_empty(); }
+    size_t frame_count() const { return m_frame_count; }
+    bool contains(Block::Index index) const { return m_frame_offsets.contains(index); }
+    Optional<Block::Index> highest_block_index() const { return m_highest_block_index; }
+    Vector<Block::Index> block_indices() const;
+
+    ErrorOr<ByteBuffer> read_block(Block::Index);
+    ErrorOr<void> append_transaction(HashMap<Block::Index, ByteBuffer> const&);
+    ErrorOr<void> sync();
+    ErrorOr<void> reset();
+
+private:
+    WriteAheadLog(ByteString, NonnullOwnPtr<Core::File>, u32 block_size);
+
+    size_t frame_size() const;
+
+    ErrorOr<void> recover();
+    ErrorOr<void> write_header();
+
+    ByteString m_name;
+    NonnullOwnPtr<Core::File> m_file;
+    u32 m_block_size { 0 };
+    u32 m_checkpoint_sequence { 0 };
+    Array<u32, 2> m_salt { 0, 0 };
+    Array<u32, 2> m_checksum { 0, 0 };
+    u64 m_end_of_log { 0 };
+    size_t m_frame_count { 0 };
+    HashMap<Block::Index, u64> m_frame_offsets;
+    Optional<Block::Index> m_highest_block_index;
+    bool m_needs_sync { false };
+};
+
+}
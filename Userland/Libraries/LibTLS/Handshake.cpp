@@ -7,6 +7,7 @@
 
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/Memory.h>
 #include <AK/Random.h>
 
 #include <LibCore/Timer.h>
@@ -34,6 +35,24 @@ ByteBuffer TLSv12::build_hello()
     builder.append(version);
     builder.append(m_context.local_random, sizeof(m_context.local_random));
 
+    // Offer to resume the last session with this server, if we remember one.
+    auto& session_cache = m_context.options.session_cache;
+    if (session_cache && !m_context.extensions.SNI.is_empty())
+        m_context.offered_session = session_cache->find(m_context.extensions.SNI);
+
+    if (m_context.offered_session.has_value()) {
+        auto& session = *m_context.offered_session;
+        if (!session.session_ticket.is_empty()) {
+            // RFC 5077 section 3.4: The server echoes a session ID generated by the client to signal that
+            //                       it accepted the ticket.
+            fill_with_random(m_context.session_id);
+            m_context.session_id_size = sizeof(m_context.session_id);
+        } else if (session.session_id.size() <= sizeof(m_context.session_id)) {
+            session.session_id.bytes().copy_to(m_context.session_id);
+            m_context.session_id_size = session.session_id.size();
+        }
+    }
+
     builder.append(m_context.session_id_size);
     if (m_context.session_id_size)
         builder.append(m_context.session_id, m_context.session_id_size);
@@ -89,6 +108,13 @@ ByteBuffer TLSv12::build_hello()
     if (enable_extended_master_secret)
         extension_length += 4;
 
+    // Ask for a session ticket whenever there is somewhere to keep it, and hand back the one we have.
+    ReadonlyBytes session_ticket;
+    if (m_context.offered_session.has_value())
+        session_ticket = m_context.offered_session->session_ticket;
+    if (session_cache)
+        extension_length += 4 + session_ticket.size();
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -139,6 +165,13 @@ ByteBuffer TLSv12::build_hello()
         builder.append((u16)0);
     }
 
+    if (session_cache) {
+        // session_ticket extension
+        builder.append((u16)ExtensionType::SESSION_TICKET);
+        builder.append((u16)session_ticket.size());
+        builder.append(session_ticket);
+    }
+
     if (alpn_length) {
         // TODO
         VERIFY_NOT_REACHED();
@@ -169,25 +202,26 @@ ByteBuffer TLSv12::build_change_cipher_spec()
     return packet;
 }
 
+// RFC 5246 section 7.4.9: "In previous versions of TLS, the verify_data was always 12 octets
+//                          long.  In the current version of TLS, it depends on the cipher
+//                          suite.  Any cipher suite which does not explicitly specify
+//                          verify_data_length has a verify_data_length equal to 12."
+// Simplification: Assume that verify_data_length is always 12.
+static constexpr u32 verify_data_length = 12;
+
 ByteBuffer TLSv12::build_handshake_finished()
 {
     PacketBuilder builder { ContentType::HANDSHAKE, m_context.options.version, 12 + 64 };
     builder.append((u8)HandshakeType::FINISHED);
 
-    // RFC 5246 section 7.4.9: "In previous versions of TLS, the verify_data was always 12 octets
-    //                          long.  In the current version of TLS, it depends on the cipher
-    //                          suite.  Any cipher suite which does not explicitly specify
-    //                          verify_data_length has a verify_data_length equal to 12."
-    // Simplification: Assume that verify_data_length is always 12.
-    constexpr u32 verify_data_length = 12;
-
     builder.append_u24(verify_data_length);
 
     u8 out[verify_data_length];
     auto outbuffer = Bytes { out, verify_data_length };
     ByteBuffer dummy;
 
-    auto digest = m_context.handshake_hash.digest();
+    // The server's finished message covers ours as well, so keep hashing after this.
+    auto digest = m_context.handshake_hash.peek();
     auto hashbuf = ReadonlyBytes { digest.immutable_data(), m_context.handshake_hash.digest_size() };
     pseudorandom_function(outbuffer, m_context.master_key, (u8 const*)"client finished", 15, hashbuf, dummy);
 
@@ -225,10 +259,30 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         return (i8)Error::NeedMoreData;
     }
 
-    // TODO: Compare Hashes
-    dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+    if (buffer.size() - index < verify_data_length)
+        return (i8)Error::NeedMoreData;
+
+    u8 expected[verify_data_length];
+    ByteBuffer dummy;
+    auto digest = m_context.handshake_hash.peek();
+    auto hashbuf = ReadonlyBytes { digest.immutable_data(), m_context.handshake_hash.digest_size() };
+    pseudorandom_function({ expected, verify_data_length }, m_context.master_key, (u8 const*)"server finished", 15, hashbuf, dummy);
+
+    if (!timing_safe_compare(expected, buffer.offset_pointer(index), verify_data_length)) {
+        dbgln("server finished message does not match the handshake");
+        if (m_context.is_resumed_session)
+            forget_offered_session();
+        return (i8)Error::NotSafe;
+    }
+
     m_context.connection_status = ConnectionStatus::Established;
 
+    // In an abbreviated handshake, the server finishes first and we still have to follow up with our finished message.
+    if (m_context.is_resumed_session)
+        write_packets = WritePacketStage::Finished;
+
+    store_session_in_cache();
+
     if (m_handshake_timeout_timer) {
         // Disable the handshake timeout timer as handshake has been established.
         m_handshake_timeout_timer->stop();
@@ -308,6 +362,20 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("unsupported: DTLS");
             payload_res = (i8)Error::UnexpectedMessage;
             break;
+        case HandshakeType::NEW_SESSION_TICKET:
+            if (m_context.handshake_messages[3] >= 1) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[3];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            if (m_context.is_server) {
+                dbgln("unsupported: server mode");
+                VERIFY_NOT_REACHED();
+            }
+            payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            break;
         case HandshakeType::CERTIFICATE:
             if (m_context.handshake_messages[4] >= 1) {
                 dbgln("unexpected certificate message");
@@ -164,6 +164,57 @@ bool TLSv12::compute_master_secret_from_pre_master_secret(size_t length)
     return true;
 }
 
+void TLSv12::forget_offered_session()
+{
+    if (!m_context.offered_session.has_value())
+        return;
+    m_context.offered_session.clear();
+
+    // The server no longer knows the session, so offering it again would only cost the next connection a round trip.
+    if (auto& session_cache = m_context.options.session_cache)
+        session_cache->remove(m_context.extensions.SNI);
+}
+
+void TLSv12::store_session_in_cache()
+{
+    auto& session_cache = m_context.options.session_cache;
+    if (!session_cache || m_context.extensions.SNI.is_empty())
+        return;
+
+    // A resumed session keeps its master secret, but the server may have handed out a fresh ticket for it.
+    CachedSession session;
+    if (m_context.offered_session.has_value())
+        session = m_context.offered_session.release_value();
+
+    if (!m_context.session_ticket.is_empty())
+        session.session_ticket = move(m_context.session_ticket);
+    if (session.session_ticket.is_empty()) {
+        auto session_id = ByteBuffer::copy(m_context.session_id, m_context.session_id_size);
+        if (session_id.is_error())
+            return;
+        session.session_id = session_id.release_value();
+    }
+
+    // Without either, the server has no way of finding the session again.
+    if (session.session_id.is_empty() && session.session_ticket.is_empty())
+        return;
+
+    auto master_key = ByteBuffer::copy(m_context.master_key);
+    if (master_key.is_error())
+        return;
+    session.master_key = master_key.release_value();
+    session.cipher = m_context.cipher;
+    session.extended_master_secret = m_context.extensions.extended_master_secret;
+
+    auto lifetime = SessionCache::maximum_session_lifetime;
+    if (m_context.session_ticket_lifetime_hint != 0)
+        lifetime = min(lifetime, Duration::from_seconds(m_context.session_ticket_lifetime_hint));
+    if (!m_context.is_resumed_session || m_context.session_ticket_lifetime_hint != 0)
+        session.expiry = UnixDateTime::now() + lifetime;
+
+    session_cache->store(m_context.extensions.SNI, move(session));
+}
+
 void TLSv12::build_rsa_pre_master_secret(PacketBuilder& builder)
 {
     u8 random_bytes[48];
@@ -61,6 +61,12 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
+    // RFC 5246 section 7.4.1.3: The server echoes the session ID from the client hello if it agrees to resume that session.
+    bool is_resuming_session = m_context.offered_session.has_value()
+        && session_length != 0
+        && session_length == m_context.session_id_size
+        && ReadonlyBytes { m_context.session_id, m_context.session_id_size } == buffer.slice(res, session_length);
+
     if (session_length && session_length <= 32) {
         memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
         m_context.session_id_size = session_length;
@@ -190,17 +196,86 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         } else if (extension_type == ExtensionType::EXTENDED_MASTER_SECRET) {
             m_context.extensions.extended_master_secret = true;
             res += extension_length;
+        } else if (extension_type == ExtensionType::SESSION_TICKET) {
+            // RFC 5077 section 3.2: An empty SessionTicket extension announces a NewSessionTicket message.
+            res += extension_length;
         } else {
             dbgln("Encountered unknown extension {} with length {}", enum_to_string(extension_type), extension_length);
             res += extension_length;
         }
     }
 
+    if (!is_resuming_session) {
+        forget_offered_session();
+        return res;
+    }
+
+    auto& session = *m_context.offered_session;
+    if (session.cipher != m_context.cipher) {
+        dbgln("Server resumed a session with a different cipher suite");
+        forget_offered_session();
+        return (i8)Error::NotSafe;
+    }
+
+    // RFC 7627 section 5.3: The extended master secret extension has to agree with the original session's.
+    if (session.extended_master_secret != m_context.extensions.extended_master_secret) {
+        dbgln("Server resumed a session with a different extended master secret setting");
+        forget_offered_session();
+        return (i8)Error::NotSafe;
+    }
+
+    dbgln_if(TLS_DEBUG, "Resuming session with {}", m_context.extensions.SNI);
+
+    // The abbreviated handshake goes straight to the change cipher spec, with keys derived from the old master secret.
+    m_context.master_key = move(session.master_key);
+    m_context.is_resumed_session = true;
+    if (!expand_key())
+        return (i8)Error::UnknownError;
+    m_context.connection_status = ConnectionStatus::KeyExchange;
+
     return res;
 }
 
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    // RFC 5077 section 3.3: The ticket is sent before the server's change cipher spec, and only if we asked for one.
+    if (!m_context.options.session_cache || m_context.connection_status < ConnectionStatus::Negotiating || m_context.connection_status == ConnectionStatus::Established) {
+        dbgln("unexpected new session ticket message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    if (buffer.size() < 9)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    auto lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    auto ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (size != 6u + ticket_length)
+        return (i8)Error::BrokenPacket;
+
+    auto ticket_result = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    if (ticket_result.is_error()) {
+        dbgln("new_session_ticket failed: Not enough memory");
+        return (i8)Error::OutOfMemory;
+    }
+    m_context.session_ticket = ticket_result.release_value();
+    m_context.session_ticket_lifetime_hint = lifetime_hint;
+
+    dbgln_if(TLS_DEBUG, "Received a session ticket of {} bytes, lifetime hint {}s", ticket_length, lifetime_hint);
+
+    return size + 3;
+}
+
 ssize_t TLSv12::handle_server_hello_done(ReadonlyBytes buffer)
 {
+    if (m_context.is_resumed_session) {
+        dbgln("unexpected server hello done in an abbreviated handshake");
+        return (i8)Error::UnexpectedMessage;
+    }
+
     if (buffer.size() < 3)
         return (i8)Error::NeedMoreData;
 
@@ -56,7 +56,10 @@ void TLSv12::write_packet(ByteBuffer& packet, bool immediately)
     if (m_context.tls_buffer.size() + packet.size() > 16 * KiB)
         schedule_or_perform_flush(true);
 
-    if (m_context.tls_buffer.try_append(packet.data(), packet.size()).is_error()) {
+    if (m_context.tls_buffer.is_empty()) {
+        // Nothing else is waiting to be sent, so the record can become the send buffer as it is.
+        m_context.tls_buffer = move(packet);
+    } else if (m_context.tls_buffer.try_append(packet.data(), packet.size()).is_error()) {
         // Toooooo bad, drop the record on the ground.
         return;
     }
@@ -102,36 +105,27 @@ void TLSv12::update_packet(ByteBuffer& packet)
                 });
 
             if (m_context.crypto.created == 1) {
-                // `buffer' will continue to be encrypted
-                auto buffer_result = ByteBuffer::create_uninitialized(length);
-                if (buffer_result.is_error()) {
-                    dbgln("LibTLS: Failed to allocate enough memory");
-                    VERIFY_NOT_REACHED();
-                }
-                auto buffer = buffer_result.release_value();
-                size_t buffer_position = 0;
+                // The record is encrypted where it is: The payload moves up to make room for the explicit IV, and the
+                // MAC, padding or tag are written behind it. PacketBuilder leaves enough spare capacity for all of that.
+                auto payload_size = packet.size() - header_size;
                 auto iv_size = iv_length();
+                auto ciphertext_size = header_size + iv_size + length + (is_aead() ? 16 : 0);
 
-                // copy the packet, sans the header
-                buffer.overwrite(buffer_position, packet.offset_pointer(header_size), packet.size() - header_size);
-                buffer_position += packet.size() - header_size;
+                // The MAC covers the plaintext record, so it has to be computed before anything moves around.
+                ByteBuffer mac;
+                if (mac_size)
+                    mac = hmac_message(packet, {}, mac_size, true);
 
-                ByteBuffer ct;
+                if (packet.try_resize(ciphertext_size).is_error()) {
+                    dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
+                    VERIFY_NOT_REACHED();
+                }
+                __builtin_memmove(packet.offset_pointer(header_size + iv_size), packet.offset_pointer(header_size), payload_size);
 
                 m_cipher_local.visit(
                     [&](Empty&) { VERIFY_NOT_REACHED(); },
                     [&](Crypto::Cipher::AESCipher::GCMMode& gcm) {
                         VERIFY(is_aead());
-                        // We need enough space for a header, the data, a tag, and the IV
-                        auto ct_buffer_result = ByteBuffer::create_uninitialized(length + header_size + iv_size + 16);
-                        if (ct_buffer_result.is_error()) {
-                            dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
-                            VERIFY_NOT_REACHED();
-                        }
-                        ct = ct_buffer_result.release_value();
-
-                        // copy the header over
-                        ct.overwrite(0, packet.data(), header_size - 2);
 
                         // AEAD AAD (13)
                         // Seq. no (8)
@@ -143,7 +137,7 @@ void TLSv12::update_packet(ByteBuffer& packet)
                         FixedMemoryStream aad_stream { aad_bytes };
 
                         u64 seq_no = AK::convert_between_host_and_network_endian(m_context.local_sequence_number);
-                        u16 len = AK::convert_between_host_and_network_endian((u16)(packet.size() - header_size));
+                        u16 len = AK::convert_between_host_and_network_endian((u16)payload_size);
 
                         MUST(aad_stream.write_value(seq_no));                              // sequence number
                         MUST(aad_stream.write_until_depleted(packet.bytes().slice(0, 3))); // content-type + version
@@ -162,70 +156,46 @@ void TLSv12::update_packet(ByteBuffer& packet)
                         memset(iv_bytes.offset(12), 0, 4);
 
                         // write the random part of the iv out
-                        iv_bytes.slice(4, 8).copy_to(ct.bytes().slice(header_size));
+                        iv_bytes.slice(4, 8).copy_to(packet.bytes().slice(header_size));
 
-                        // Write the encrypted data and the tag
+                        // Write the encrypted data and the tag. GCM reads each block before it writes it, so it can
+                        // encrypt in place.
+                        auto payload = packet.bytes().slice(header_size + iv_size, length);
                         gcm.encrypt(
-                            packet.bytes().slice(header_size, length),
-                            ct.bytes().slice(header_size + 8, length),
+                            payload,
+                            payload,
                             iv_bytes,
                             aad_bytes,
-                            ct.bytes().slice(header_size + 8 + length, 16));
-
-                        VERIFY(header_size + 8 + length + 16 == ct.size());
+                            packet.bytes().slice(header_size + iv_size + length, 16));
                     },
                     [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                         VERIFY(!is_aead());
-                        // We need enough space for a header, iv_length bytes of IV and whatever the packet contains
-                        auto ct_buffer_result = ByteBuffer::create_uninitialized(length + header_size + iv_size);
-                        if (ct_buffer_result.is_error()) {
-                            dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
-                            VERIFY_NOT_REACHED();
-                        }
-                        ct = ct_buffer_result.release_value();
-
-                        // copy the header over
-                        ct.overwrite(0, packet.data(), header_size - 2);
-
-                        // get the appropriate HMAC value for the entire packet
-                        auto mac = hmac_message(packet, {}, mac_size, true);
+                        auto position = header_size + iv_size + payload_size;
 
                         // write the MAC
-                        buffer.overwrite(buffer_position, mac.data(), mac.size());
-                        buffer_position += mac.size();
+                        packet.overwrite(position, mac.data(), mac.size());
+                        position += mac.size();
 
                         // Apply the padding (a packet MUST always be padded)
-                        memset(buffer.offset_pointer(buffer_position), padding - 1, padding);
-                        buffer_position += padding;
+                        memset(packet.offset_pointer(position), padding - 1, padding);
+                        position += padding;
 
-                        VERIFY(buffer_position == buffer.size());
+                        VERIFY(position == packet.size());
+                        VERIFY(length % block_size == 0);
 
-                        auto iv_buffer_result = ByteBuffer::create_uninitialized(iv_size);
-                        if (iv_buffer_result.is_error()) {
-                            dbgln("LibTLS: Failed to allocate memory for IV");
-                            VERIFY_NOT_REACHED();
-                        }
-                        auto iv = iv_buffer_result.release_value();
+                        // write a random IV into the ciphertext portion of the message
+                        auto iv = packet.bytes().slice(header_size, iv_size);
                         fill_with_random(iv);
 
-                        // write it into the ciphertext portion of the message
-                        ct.overwrite(header_size, iv.data(), iv.size());
-
-                        VERIFY(header_size + iv_size + length == ct.size());
-                        VERIFY(length % block_size == 0);
-
-                        // get a block to encrypt into
-                        auto view = ct.bytes().slice(header_size + iv_size, length);
-                        cbc.encrypt(buffer, view, iv);
+                        // CBC also reads each block before it writes it.
+                        auto view = packet.bytes().slice(header_size + iv_size, length);
+                        cbc.encrypt(view, view, iv);
                     });
 
                 // store the correct ciphertext length into the packet
-                u16 ct_length = (u16)ct.size() - header_size;
-
-                ByteReader::store(ct.offset_pointer(header_size - 2), AK::convert_between_host_and_network_endian(ct_length));
+                u16 ct_length = (u16)packet.size() - header_size;
 
-                // replace the packet with the ciphertext
-                packet = ct;
+                ByteReader::store(packet.offset_pointer(header_size - 2), AK::convert_between_host_and_network_endian(ct_length));
             }
         }
     }
@@ -306,7 +276,7 @@ ByteBuffer TLSv12::hmac_message(ReadonlyBytes buf, Optional<ReadonlyBytes> const
     return mac_result.release_value();
 }
 
-ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
+ssize_t TLSv12::handle_message(Bytes buffer)
 {
     auto res { 5ll };
     size_t header_size = res;
@@ -365,14 +335,6 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                 }
 
                 auto packet_length = length - iv_length() - 16;
-                auto payload = plain;
-                auto decrypted_result = ByteBuffer::create_uninitialized(packet_length);
-                if (decrypted_result.is_error()) {
-                    dbgln("Failed to allocate memory for the packet");
-                    return_value = Error::DecryptionFailed;
-                    return;
-                }
-                decrypted = decrypted_result.release_value();
 
                 // AEAD AAD (13)
                 // Seq. no (8)
@@ -391,8 +353,7 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                 MUST(aad_stream.write_value(len));                                       // length
                 VERIFY(MUST(aad_stream.tell()) == MUST(aad_stream.size()));
 
-                auto nonce = payload.slice(0, iv_length());
-                payload = payload.slice(iv_length());
+                auto nonce = buffer.slice(header_size, iv_length());
 
                 // AEAD IV (12)
                 // IV (4)
@@ -405,12 +366,13 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                 nonce.copy_to(iv_bytes.slice(4));
                 memset(iv_bytes.offset(12), 0, 4);
 
-                auto ciphertext = payload.slice(0, payload.size() - 16);
-                auto tag = payload.slice(ciphertext.size());
+                auto ciphertext = buffer.slice(header_size + iv_length(), packet_length);
+                auto tag = buffer.slice(header_size + iv_length() + packet_length, 16);
 
+                // Decrypt the record right where it is in the message buffer, GCM reads each block before it writes it.
                 auto consistency = gcm.decrypt(
                     ciphertext,
-                    decrypted,
+                    ciphertext,
                     iv_bytes,
                     aad_bytes,
                     tag);
@@ -424,12 +386,13 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                     return;
                 }
 
-                plain = decrypted;
+                plain = ciphertext;
             },
             [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                 VERIFY(!is_aead());
                 auto iv_size = iv_length();
 
+                // CBC decryption needs the previous ciphertext block, so it can't overwrite the record as it goes.
                 auto decrypted_result = cbc.create_aligned_buffer(length - iv_size);
                 if (decrypted_result.is_error()) {
                     dbgln("Failed to allocate memory for the packet");
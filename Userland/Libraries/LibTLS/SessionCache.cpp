@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+Optional<CachedSession> SessionCache::find(StringView server_name)
+{
+    return m_sessions.with_locked([&](auto& sessions) -> Optional<CachedSession> {
+        auto it = sessions.find(server_name);
+        if (it == sessions.end())
+            return {};
+
+        if (it->value.expiry <= UnixDateTime::now()) {
+            sessions.remove(it);
+            return {};
+        }
+
+        auto& session = it->value;
+        auto session_id = ByteBuffer::copy(session.session_id);
+        auto session_ticket = ByteBuffer::copy(session.session_ticket);
+        auto master_key = ByteBuffer::copy(session.master_key);
+        if (session_id.is_error() || session_ticket.is_error() || master_key.is_error())
+            return {};
+
+        return CachedSession {
+            .session_id = session_id.release_value(),
+            .session_ticket = session_ticket.release_value(),
+            .cipher = session.cipher,
+            .master_key = master_key.release_value(),
+            .extended_master_secret = session.extended_master_secret,
+            .expiry = session.expiry,
+        };
+    });
+}
+
+void SessionCache::store(ByteString server_name, CachedSession session)
+{
+    if (server_name.is_empty() || m_capacity == 0)
+        return;
+
+    m_sessions.with_locked([&](auto& sessions) {
+        if (sessions.size() >= m_capacity && !sessions.contains(server_name)) {
+            // Make room by evicting the session that would have expired first.
+            auto oldest = sessions.begin();
+            for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+                if (it->value.expiry < oldest->value.expiry)
+                    oldest = it;
+            }
+            sessions.remove(oldest);
+        }
+        sessions.set(move(server_name), move(session));
+    });
+}
+
+void SessionCache::remove(StringView server_name)
+{
+    m_sessions.with_locked([&](auto& sessions) {
+        sessions.remove(server_name);
+    });
+}
+
+void SessionCache::clear()
+{
+    m_sessions.with_locked([](auto& sessions) {
+        sessions.clear();
+    });
+}
+
+}
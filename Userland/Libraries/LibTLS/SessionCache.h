@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/Time.h>
+#include <LibTLS/CipherSuite.h>
+#include <LibThreading/MutexProtected.h>
+
+namespace TLS {
+
+// Everything a client needs to resume a session with an abbreviated handshake (RFC 5246 section 7.3),
+// either by session ID or by presenting a session ticket (RFC 5077).
+struct CachedSession {
+    ByteBuffer session_id;
+    ByteBuffer session_ticket;
+    CipherSuite cipher { CipherSuite::TLS_NULL_WITH_NULL_NULL };
+    ByteBuffer master_key;
+    bool extended_master_secret { false };
+    UnixDateTime expiry;
+};
+
+// A client-side session cache, keyed by the server name that the session was negotiated with.
+// Connections that share a cache skip the key exchange and certificate verification when they
+// reconnect to a server that still remembers the session. It can be shared between threads.
+class SessionCache : public RefCounted<SessionCache> {
+public:
+    static constexpr size_t default_capacity = 256;
+
+    // RFC 5246 section F.1.4: "An upper limit of 24 hours is suggested for session ID lifetimes".
+    static constexpr Duration maximum_session_lifetime = Duration::from_seconds(24 * 60 * 60);
+
+    static NonnullRefPtr<SessionCache> create(size_t capacity = default_capacity)
+    {
+        return adopt_ref(*new SessionCache(capacity));
+    }
+
+    Optional<CachedSession> find(StringView server_name);
+    void store(ByteString server_name, CachedSession);
+    void remove(StringView server_name);
+    void clear();
+
+private:
+    explicit SessionCache(size_t capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    size_t m_capacity { 0 };
+    Threading::MutexProtected<HashMap<ByteString, CachedSession>> m_sessions;
+};
+
+}
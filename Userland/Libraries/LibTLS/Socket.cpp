@@ -17,6 +17,9 @@
 // which will be sent as a single record containing a single ApplicationData message.
 constexpr static size_t MaximumApplicationDataChunkSize = 16 * KiB;
 
+// The record header, an explicit IV, the largest MAC and a full block of padding, which update_packet() adds in place.
+constexpr static size_t MaximumRecordOverhead = 5 + 16 + 48 + 16;
+
 namespace TLS {
 
 ErrorOr<Bytes> TLSv12::read_some(Bytes bytes)
@@ -40,8 +43,9 @@ ErrorOr<size_t> TLSv12::write_some(ReadonlyBytes bytes)
     }
 
     for (size_t offset = 0; offset < bytes.size(); offset += MaximumApplicationDataChunkSize) {
-        PacketBuilder builder { ContentType::APPLICATION_DATA, m_context.options.version, bytes.size() - offset };
-        builder.append(bytes.slice(offset, min(bytes.size() - offset, MaximumApplicationDataChunkSize)));
+        auto chunk = bytes.slice(offset, min(bytes.size() - offset, MaximumApplicationDataChunkSize));
+        PacketBuilder builder { ContentType::APPLICATION_DATA, m_context.options.version, chunk.size() + MaximumRecordOverhead };
+        builder.append(chunk);
         auto packet = builder.build();
 
         update_packet(packet);
@@ -202,12 +206,16 @@ ErrorOr<void> TLSv12::read_from_socket()
     if (!check_connection_state(true))
         return {};
 
-    u8 buffer[16 * KiB];
-    Bytes bytes { buffer, array_size(buffer) };
-    Bytes read_bytes {};
+    size_t read_size = 0;
     auto& stream = underlying_stream();
+    auto& message_buffer = m_context.message_buffer;
     do {
+        // Read straight into the message buffer, behind whatever is left of a partial record, so that the records
+        // can be decrypted right where they landed.
+        auto buffered_size = message_buffer.size();
+        auto bytes = TRY(message_buffer.get_bytes_for_writing(16 * KiB));
         auto result = stream.read_some(bytes);
+        message_buffer.trim(buffered_size + (result.is_error() ? 0 : result.value().size()), false);
         if (result.is_error()) {
             if (result.error().is_errno() && result.error().code() != EINTR) {
                 if (result.error().code() != EAGAIN)
@@ -216,11 +224,12 @@ ErrorOr<void> TLSv12::read_from_socket()
             }
             continue;
         }
-        read_bytes = result.release_value();
-        consume(read_bytes);
-    } while (!read_bytes.is_empty() && !m_context.critical_error);
+        read_size = result.value().size();
+        if (read_size != 0)
+            consume_message_buffer();
+    } while (read_size != 0 && !m_context.critical_error);
 
-    if (m_context.should_expect_successful_read && read_bytes.is_empty()) {
+    if (m_context.should_expect_successful_read && read_size == 0) {
         // read_some() returned an empty span, this is either an EOF (from improper closure)
         // or some sort of weird even that is showing itself as an EOF.
         // To guard against servers closing the connection weirdly or just improperly, make sure
@@ -70,10 +70,10 @@ public:
     }
     inline ByteBuffer build()
     {
-        auto length = m_current_length;
+        // Hand over the buffer along with its spare capacity, so that the record can be encrypted in place.
+        m_packet_data.trim(m_current_length, false);
         m_current_length = 0;
-        // FIXME: Propagate errors.
-        return MUST(m_packet_data.slice(0, length));
+        return move(m_packet_data);
     }
     inline void set(size_t offset, u8 value)
     {
@@ -28,23 +28,15 @@
 
 namespace TLS {
 
-void TLSv12::consume(ReadonlyBytes record)
+void TLSv12::consume_message_buffer()
 {
     if (m_context.critical_error) {
         dbgln("There has been a critical error ({}), refusing to continue", (i8)m_context.critical_error);
+        m_context.message_buffer.clear();
         return;
     }
 
-    if (record.size() == 0) {
-        return;
-    }
-
-    dbgln_if(TLS_DEBUG, "Consuming {} bytes", record.size());
-
-    if (m_context.message_buffer.try_append(record).is_error()) {
-        dbgln("Not enough space in message buffer, dropping the record");
-        return;
-    }
+    dbgln_if(TLS_DEBUG, "Consuming {} bytes", m_context.message_buffer.size());
 
     size_t index { 0 };
     size_t buffer_length = m_context.message_buffer.size();
@@ -96,8 +88,10 @@ void TLSv12::consume(ReadonlyBytes record)
     }
 
     if (index) {
-        // FIXME: Propagate errors.
-        m_context.message_buffer = MUST(m_context.message_buffer.slice(index, m_context.message_buffer.size() - index));
+        // Move the start of the next record to the front, the socket reads the rest of it in behind.
+        auto remaining = m_context.message_buffer.size() - index;
+        __builtin_memmove(m_context.message_buffer.data(), m_context.message_buffer.offset_pointer(index), remaining);
+        m_context.message_buffer.trim(remaining, false);
     }
 }
 
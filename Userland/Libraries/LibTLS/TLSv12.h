@@ -20,6 +20,7 @@
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -194,6 +195,7 @@ struct Options {
     OPTION_WITH_DEFAULTS(Function<void()>, finish_callback, [] {})
     OPTION_WITH_DEFAULTS(Function<Vector<Certificate>()>, certificate_provider, [] { return Vector<Certificate> {}; })
     OPTION_WITH_DEFAULTS(bool, enable_extended_master_secret, true)
+    OPTION_WITH_DEFAULTS(RefPtr<SessionCache>, session_cache, )
 
 #undef OPTION_WITH_DEFAULTS
 };
@@ -316,6 +318,12 @@ struct Context {
     } server_diffie_hellman_params;
 
     OwnPtr<Crypto::Curves::EllipticCurve> server_key_exchange_curve;
+
+    // The session from options.session_cache that was offered in the client hello, if any.
+    Optional<CachedSession> offered_session;
+    bool is_resumed_session { false };
+    ByteBuffer session_ticket;
+    u32 session_ticket_lifetime_hint { 0 };
 };
 
 class TLSv12 final : public Core::Socket {
@@ -367,6 +375,7 @@ public:
     explicit TLSv12(StreamVariantType, Options);
 
     bool is_established() const { return m_context.connection_status == ConnectionStatus::Established; }
+    bool is_resumed_session() const { return m_context.is_resumed_session; }
 
     void set_sni(StringView sni)
     {
@@ -411,7 +420,7 @@ public:
 private:
     void setup_connection();
 
-    void consume(ReadonlyBytes record);
+    void consume_message_buffer();
 
     ByteBuffer hmac_message(ReadonlyBytes buf, Optional<ReadonlyBytes> const buf2, size_t mac_length, bool local = false);
     void ensure_hmac(size_t digest_size, bool local);
@@ -449,9 +458,10 @@ private:
     ssize_t handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_ecdhe_ecdsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_server_hello_done(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
-    ssize_t handle_message(ReadonlyBytes);
+    ssize_t handle_message(Bytes);
 
     void pseudorandom_function(Bytes output, ReadonlyBytes secret, u8 const* label, size_t label_length, ReadonlyBytes seed, ReadonlyBytes seed_b);
 
@@ -528,6 +538,9 @@ private:
 
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
+    void store_session_in_cache();
+    void forget_offered_session();
+
     void try_disambiguate_error() const;
 
     bool m_eof { false };
@@ -116,6 +116,8 @@ static consteval size_t __testjs_last()
 static constexpr auto TOP_LEVEL_TEST_NAME = "__$$TOP_LEVEL$$__";
 extern RefPtr<JS::VM> g_vm;
 extern bool g_collect_on_every_allocation;
+extern bool g_use_generational_collection;
+extern bool g_use_incremental_marking;
 extern ByteString g_currently_running_test;
 struct FunctionWithLength {
     JS::ThrowCompletionOr<JS::Value> (*function)(JS::VM&);
@@ -301,6 +303,8 @@ inline JSFileResult TestRunner::run_file_test(ByteString const& test_path)
     g_vm->pop_execution_context();
 
     g_vm->heap().set_should_collect_on_every_allocation(g_collect_on_every_allocation);
+    g_vm->heap().set_uses_generational_collection(g_use_generational_collection);
+    g_vm->heap().set_uses_incremental_marking(g_use_incremental_marking);
 
     if (g_run_file) {
         auto result = g_run_file(test_path, *realm, global_execution_context);
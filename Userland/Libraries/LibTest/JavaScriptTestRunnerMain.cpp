@@ -20,6 +20,8 @@ namespace JS {
 
 RefPtr<::JS::VM> g_vm;
 bool g_collect_on_every_allocation = false;
+bool g_use_generational_collection = false;
+bool g_use_incremental_marking = false;
 ByteString g_currently_running_test;
 HashMap<ByteString, FunctionWithLength> s_exposed_global_functions;
 Function<void()> g_main_hook;
@@ -117,6 +119,8 @@ int main(int argc, char** argv)
     args_parser.add_option(print_json, "Show results as JSON", "json", 'j');
     args_parser.add_option(per_file, "Show detailed per-file results as JSON (implies -j)", "per-file");
     args_parser.add_option(g_collect_on_every_allocation, "Collect garbage after every allocation", "collect-often", 'g');
+    args_parser.add_option(g_use_generational_collection, "Use generational garbage collection", "generational-gc");
+    args_parser.add_option(g_use_incremental_marking, "Use incremental marking", "incremental-marking");
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
     args_parser.add_option(test_glob, "Only run tests matching the given glob", "filter", 'f', "glob");
     for (auto& entry : g_extra_args)
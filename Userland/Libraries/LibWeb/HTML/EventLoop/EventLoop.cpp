@@ -376,6 +376,14 @@ void EventLoop::process()
 
     // FIXME:     2. If there are no tasks in the event loop's task queues and the WorkerGlobalScope object's closing flag is true, then destroy the event loop, aborting these steps, resuming the run a worker steps described in the Web workers section below.
 
+    // AD-HOC: Give an incremental garbage collection a chance to make progress between tasks,
+    //         and keep coming back until it's done.
+    if (heap().is_incremental_marking_in_progress()) {
+        heap().perform_incremental_marking_slice();
+        if (heap().is_incremental_marking_in_progress())
+            schedule();
+    }
+
     // If there are eligible tasks in the queue, schedule a new round of processing. :^)
     if (m_task_queue->has_runnable_tasks() || (!m_microtask_queue->is_empty() && !m_performing_a_microtask_checkpoint))
         schedule();
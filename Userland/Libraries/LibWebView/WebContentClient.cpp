@@ -15,6 +15,10 @@ WebContentClient::WebContentClient(NonnullOwnPtr<Core::LocalSocket> socket, View
     : IPC::ConnectionToServer<WebContentClientEndpoint, WebContentServerEndpoint>(*this, move(socket))
 {
     m_views.set(0, &view);
+
+    // Most of the messages we send to WebContent don't carry file descriptors, so they can skip the socket.
+    if (auto result = enable_shared_memory_ring(); result.is_error())
+        dbgln("WebContentClient: Unable to create a message ring, sending messages over the socket: {}", result.error());
 }
 
 void WebContentClient::die()
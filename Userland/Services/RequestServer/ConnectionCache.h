@@ -174,6 +174,7 @@ struct InferredServerProperties {
 extern Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<Core::TCPSocket, Core::Socket>>>>>> g_tcp_connection_cache;
 extern Threading::RWLockProtected<HashMap<ConnectionKey, NonnullOwnPtr<Vector<NonnullOwnPtr<Connection<TLS::TLSv12>>>>>> g_tls_connection_cache;
 extern Threading::RWLockProtected<HashMap<ByteString, InferredServerProperties>> g_inferred_server_properties;
+extern NonnullRefPtr<TLS::SessionCache> g_tls_session_cache;
 
 void request_did_finish(URL::URL const&, Core::Socket const*);
 void dump_jobs();
@@ -198,6 +199,7 @@ Coroutine<ErrorOr<void>> recreate_socket_if_needed(T& connection, URL::URL const
 
         if constexpr (IsSame<TLS::TLSv12, SocketType>) {
             TLS::Options options;
+            options.set_session_cache(g_tls_session_cache);
             options.set_alert_handler([&connection](TLS::AlertDescription alert) {
                 Core::NetworkJob::Error reason;
                 if (alert == TLS::AlertDescription::HANDSHAKE_FAILURE)
@@ -267,7 +269,15 @@ Coroutine<void> async_get_or_create_connection(auto& cache, URL::URL url, auto j
             socket_for_url->is_being_started = false;
         };
 
-        auto connection_result = co_await proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+        // Reconnecting to a server we've talked to before can then resume the TLS session instead of doing a full handshake.
+        TLS::Options tls_options;
+        tls_options.set_session_cache(g_tls_session_cache);
+        auto connection_result = co_await [&] {
+            if constexpr (IsSame<TLS::TLSv12, typename ConnectionType::SocketType>)
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url, move(tls_options));
+            else
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+        }();
         if (connection_result.is_error()) {
             dbgln("ConnectionCache: Connection to {} failed: {}", url, connection_result.error());
             Core::deferred_invoke([job] {
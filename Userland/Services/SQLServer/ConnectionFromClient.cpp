@@ -38,6 +38,7 @@ ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::LocalSocket> sock
 void ConnectionFromClient::die()
 {
     s_connections.remove(client_id());
+    DatabaseConnection::disconnect_all_of_client(client_id());
 
     if (on_disconnect)
         on_disconnect();
@@ -111,4 +112,40 @@ void ConnectionFromClient::ready_for_next_result(SQL::StatementID statement_id,
     async_execution_error(statement_id, execution_id, SQL::SQLErrorCode::StatementUnavailable, ByteString::formatted("{}", statement_id));
 }
 
+Messages::SQLServer::OpenCursorResponse ConnectionFromClient::open_cursor(SQL::StatementID statement_id, Vector<SQL::Value> const& placeholder_values)
+{
+    dbgln_if(SQLSERVER_DEBUG, "ConnectionFromClient::open_cursor(statement_id: {})", statement_id);
+
+    auto statement = SQLStatement::statement_for(statement_id);
+    if (statement && statement->connection().client_id() == client_id())
+        return statement->open_cursor(move(const_cast<Vector<SQL::Value>&>(placeholder_values)));
+
+    dbgln_if(SQLSERVER_DEBUG, "Statement has disappeared");
+    async_execution_error(statement_id, -1, SQL::SQLErrorCode::StatementUnavailable, ByteString::formatted("{}", statement_id));
+    return Optional<SQL::ExecutionID> {};
+}
+
+void ConnectionFromClient::fetch_results(SQL::StatementID statement_id, SQL::ExecutionID execution_id, u32 row_count)
+{
+    dbgln_if(SQLSERVER_DEBUG, "ConnectionFromClient::fetch_results(statement_id: {}, execution_id: {}, row_count: {})", statement_id, execution_id, row_count);
+    auto statement = SQLStatement::statement_for(statement_id);
+
+    if (statement && statement->connection().client_id() == client_id()) {
+        statement->fetch_results(execution_id, row_count);
+        return;
+    }
+
+    dbgln_if(SQLSERVER_DEBUG, "Statement has disappeared");
+    async_execution_error(statement_id, execution_id, SQL::SQLErrorCode::StatementUnavailable, ByteString::formatted("{}", statement_id));
+}
+
+void ConnectionFromClient::close_cursor(SQL::StatementID statement_id, SQL::ExecutionID execution_id)
+{
+    dbgln_if(SQLSERVER_DEBUG, "ConnectionFromClient::close_cursor(statement_id: {}, execution_id: {})", statement_id, execution_id);
+    auto statement = SQLStatement::statement_for(statement_id);
+
+    if (statement && statement->connection().client_id() == client_id())
+        statement->close_cursor(execution_id);
+}
+
 }
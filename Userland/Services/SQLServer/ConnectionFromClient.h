@@ -38,6 +38,9 @@ private:
     virtual Messages::SQLServer::PrepareStatementResponse prepare_statement(SQL::ConnectionID, ByteString const&) override;
     virtual Messages::SQLServer::ExecuteStatementResponse execute_statement(SQL::StatementID, Vector<SQL::Value> const& placeholder_values) override;
     virtual void ready_for_next_result(SQL::StatementID, SQL::ExecutionID) override;
+    virtual Messages::SQLServer::OpenCursorResponse open_cursor(SQL::StatementID, Vector<SQL::Value> const& placeholder_values) override;
+    virtual void fetch_results(SQL::StatementID, SQL::ExecutionID, u32 row_count) override;
+    virtual void close_cursor(SQL::StatementID, SQL::ExecutionID) override;
     virtual void disconnect(SQL::ConnectionID) override;
 
     ByteString m_database_path;
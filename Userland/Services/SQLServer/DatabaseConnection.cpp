@@ -5,6 +5,7 @@
  */
 
 #include <AK/LexicalPath.h>
+#include <LibCore/EventLoop.h>
 #include <SQLServer/DatabaseConnection.h>
 #include <SQLServer/SQLStatement.h>
 
@@ -12,6 +13,7 @@ namespace SQLServer {
 
 static HashMap<SQL::ConnectionID, NonnullRefPtr<DatabaseConnection>> s_connections;
 static SQL::ConnectionID s_next_connection_id = 0;
+static HashMap<ByteString, Vector<Function<void(ErrorOr<void>)>>> s_pending_syncs;
 
 static ErrorOr<NonnullRefPtr<SQL::Database>> find_or_create_database(StringView database_path, StringView database_name)
 {
@@ -32,6 +34,19 @@ RefPtr<DatabaseConnection> DatabaseConnection::connection_for(SQL::ConnectionID
     return nullptr;
 }
 
+void DatabaseConnection::disconnect_all_of_client(int client_id)
+{
+    // Disconnecting removes the connection from s_connections, so the connections are collected first.
+    Vector<NonnullRefPtr<DatabaseConnection>> client_connections;
+    for (auto const& connection : s_connections) {
+        if (connection.value->client_id() == client_id)
+            client_connections.append(connection.value);
+    }
+
+    for (auto& connection : client_connections)
+        connection->disconnect();
+}
+
 ErrorOr<NonnullRefPtr<DatabaseConnection>> DatabaseConnection::create(StringView database_path, ByteString database_name, int client_id)
 {
     if (LexicalPath path(database_name); (path.title() != database_name) || (path.dirname() != "."))
@@ -43,6 +58,10 @@ ErrorOr<NonnullRefPtr<DatabaseConnection>> DatabaseConnection::create(StringView
             warnln("Could not open database: {}", result.error().error_string());
             return Error::from_string_view("Could not open database"sv);
         }
+
+        // Clients are only told about the results of their statements once the database is synced, so there's no
+        // need to sync every single transaction.
+        database->set_uses_group_commit(true);
     }
 
     return adopt_nonnull_ref_or_enomem(new (nothrow) DatabaseConnection(move(database), move(database_name), client_id));
@@ -61,6 +80,7 @@ DatabaseConnection::DatabaseConnection(NonnullRefPtr<SQL::Database> database, By
 void DatabaseConnection::disconnect()
 {
     dbgln_if(SQLSERVER_DEBUG, "DatabaseConnection::disconnect(connection_id {}, database '{}'", connection_id(), m_database_name);
+    SQLStatement::remove_statements_of(*this);
     s_connections.remove(connection_id());
 }
 
@@ -72,4 +92,28 @@ SQL::ResultOr<SQL::StatementID> DatabaseConnection::prepare_statement(StringView
     return statement->statement_id();
 }
 
+void DatabaseConnection::when_synced(Function<void(ErrorOr<void>)> callback)
+{
+    auto& pending_syncs = s_pending_syncs.ensure(m_database_name);
+    pending_syncs.append(move(callback));
+    if (pending_syncs.size() > 1)
+        return;
+
+    // The sync runs after all statements that are already queued for execution, so the transactions of all of those
+    // statements are made durable together.
+    Core::deferred_invoke([database = m_database, database_name = m_database_name]() {
+        auto callbacks = s_pending_syncs.take(database_name).release_value();
+        auto result = database->sync();
+
+        dbgln_if(SQLSERVER_DEBUG, "DatabaseConnection: synced database '{}' for {} statements", database_name, callbacks.size());
+
+        for (auto& callback : callbacks) {
+            if (result.is_error())
+                callback(Error::copy(result.error()));
+            else
+                callback({});
+        }
+    });
+}
+
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
 #include <LibSQL/Database.h>
@@ -20,6 +21,7 @@ public:
     static ErrorOr<NonnullRefPtr<DatabaseConnection>> create(StringView database_path, ByteString database_name, int client_id);
 
     static RefPtr<DatabaseConnection> connection_for(SQL::ConnectionID connection_id);
+    static void disconnect_all_of_client(int client_id);
     SQL::ConnectionID connection_id() const { return m_connection_id; }
     int client_id() const { return m_client_id; }
     NonnullRefPtr<SQL::Database> database() { return m_database; }
@@ -27,6 +29,9 @@ public:
     void disconnect();
     SQL::ResultOr<SQL::StatementID> prepare_statement(StringView sql);
 
+    // Invokes the callback once all transactions committed to the database so far are durable.
+    void when_synced(Function<void(ErrorOr<void>)>);
+
 private:
     DatabaseConnection(NonnullRefPtr<SQL::Database> database, ByteString database_name, int client_id);
 
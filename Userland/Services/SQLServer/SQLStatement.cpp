@@ -23,6 +23,18 @@ RefPtr<SQLStatement> SQLStatement::statement_for(SQL::StatementID statement_id)
     return nullptr;
 }
 
+void SQLStatement::remove_statements_of(DatabaseConnection const& connection)
+{
+    s_statements.remove_all_matching([&](auto, auto& statement) {
+        if (statement->m_connection.ptr() != &connection)
+            return false;
+
+        // An open cursor keeps a scan of its table alive, which holds on to every row that is written after it.
+        statement->m_ongoing_executions.clear();
+        return true;
+    });
+}
+
 SQL::ResultOr<NonnullRefPtr<SQLStatement>> SQLStatement::create(DatabaseConnection& connection, StringView sql)
 {
     auto parser = SQL::AST::Parser(SQL::AST::Lexer(sql));
@@ -60,7 +72,17 @@ void SQLStatement::report_error(SQL::Result result, SQL::ExecutionID execution_i
 Optional<SQL::ExecutionID> SQLStatement::execute(Vector<SQL::Value> placeholder_values)
 {
     dbgln_if(SQLSERVER_DEBUG, "SQLStatement::execute(statement_id {}", statement_id());
+    return start_execution(move(placeholder_values), RowDelivery::Push);
+}
+
+Optional<SQL::ExecutionID> SQLStatement::open_cursor(Vector<SQL::Value> placeholder_values)
+{
+    dbgln_if(SQLSERVER_DEBUG, "SQLStatement::open_cursor(statement_id {}", statement_id());
+    return start_execution(move(placeholder_values), RowDelivery::Fetch);
+}
 
+Optional<SQL::ExecutionID> SQLStatement::start_execution(Vector<SQL::Value> placeholder_values, RowDelivery delivery)
+{
     auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
     if (!client_connection) {
         warnln("Cannot yield next result. Client disconnected");
@@ -69,43 +91,91 @@ Optional<SQL::ExecutionID> SQLStatement::execute(Vector<SQL::Value> placeholder_
 
     auto execution_id = m_next_execution_id++;
 
-    Core::deferred_invoke([this, strong_this = NonnullRefPtr(*this), placeholder_values = move(placeholder_values), execution_id] {
-        auto execution_result = m_statement->execute(connection().database(), placeholder_values);
+    Core::deferred_invoke([this, strong_this = NonnullRefPtr(*this), placeholder_values = move(placeholder_values), execution_id, delivery] {
+        auto execution_result = execute_statement(placeholder_values);
 
         if (execution_result.is_error()) {
             report_error(execution_result.release_error(), execution_id);
             return;
         }
 
-        auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
-        if (!client_connection) {
-            warnln("Cannot return statement execution results. Client disconnected");
-            return;
-        }
+        // Results are only sent once the statement's changes are durable, so that a client never sees a success for
+        // changes that could still be lost. Statements from all clients that execute before then share one sync.
+        connection().when_synced([this, strong_this = NonnullRefPtr(*this), result = execution_result.release_value(), execution_id, delivery](ErrorOr<void> sync_result) mutable {
+            if (sync_result.is_error()) {
+                report_error(sync_result.release_error(), execution_id);
+                return;
+            }
 
-        auto result = execution_result.release_value();
-        auto result_size = result.size();
-
-        if (should_send_result_rows(result)) {
-            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), true, 0, 0, 0);
-
-            m_ongoing_executions.set(execution_id, { move(result), result_size });
-            ready_for_next_result(execution_id);
-        } else {
-            if (result.command() == SQL::SQLCommand::Insert)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, result_size, 0, 0);
-            else if (result.command() == SQL::SQLCommand::Update)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, result_size, 0);
-            else if (result.command() == SQL::SQLCommand::Delete)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, result_size);
-            else
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, 0);
-        }
+            result.visit(
+                [&](SQL::ResultSet& result) { send_result(move(result), execution_id); },
+                [&](NonnullOwnPtr<SQL::AST::Cursor>& cursor) { send_rows(move(cursor), execution_id, delivery); });
+        });
     });
 
     return execution_id;
 }
 
+SQL::ResultOr<SQLStatement::ExecutionResult> SQLStatement::execute_statement(Vector<SQL::Value> const& placeholder_values)
+{
+    // A SELECT produces its rows while they are sent to the client, instead of building its whole result up front.
+    if (is<SQL::AST::Select>(*m_statement))
+        return ExecutionResult { TRY(m_statement->open_cursor(connection().database(), placeholder_values)) };
+
+    auto result = TRY(m_statement->execute(connection().database(), placeholder_values));
+    if (should_send_result_rows(result))
+        return ExecutionResult { TRY(SQL::AST::Cursor::create(move(result))) };
+
+    return ExecutionResult { move(result) };
+}
+
+void SQLStatement::send_result(SQL::ResultSet result, SQL::ExecutionID execution_id)
+{
+    auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
+    if (!client_connection) {
+        warnln("Cannot return statement execution results. Client disconnected");
+        return;
+    }
+
+    auto result_size = result.size();
+
+    if (result.command() == SQL::SQLCommand::Insert)
+        client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, result_size, 0, 0);
+    else if (result.command() == SQL::SQLCommand::Update)
+        client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, result_size, 0);
+    else if (result.command() == SQL::SQLCommand::Delete)
+        client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, result_size);
+    else
+        client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, 0);
+}
+
+void SQLStatement::send_rows(NonnullOwnPtr<SQL::AST::Cursor> cursor, SQL::ExecutionID execution_id, RowDelivery delivery)
+{
+    auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
+    if (!client_connection) {
+        warnln("Cannot return statement execution results. Client disconnected");
+        return;
+    }
+
+    auto has_next_row = cursor->has_next_row();
+    if (has_next_row.is_error()) {
+        report_error(has_next_row.release_error(), execution_id);
+        return;
+    }
+
+    if (!has_next_row.value()) {
+        client_connection->async_execution_success(statement_id(), execution_id, cursor->column_names(), false, 0, 0, 0);
+        return;
+    }
+
+    client_connection->async_execution_success(statement_id(), execution_id, cursor->column_names(), true, 0, 0, 0);
+    m_ongoing_executions.set(execution_id, move(cursor));
+
+    // A client that opened a cursor asks for the rows itself once it is ready for them.
+    if (delivery == RowDelivery::Push)
+        ready_for_next_result(execution_id);
+}
+
 void SQLStatement::ready_for_next_result(SQL::ExecutionID execution_id)
 {
     auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
@@ -114,19 +184,66 @@ void SQLStatement::ready_for_next_result(SQL::ExecutionID execution_id)
         return;
     }
 
-    auto execution = m_ongoing_executions.get(execution_id);
-    if (!execution.has_value()) {
+    auto cursor = m_ongoing_executions.get(execution_id);
+    if (!cursor.has_value())
+        return;
+
+    auto rows = (*cursor)->fetch(1);
+    if (rows.is_error()) {
+        m_ongoing_executions.remove(execution_id);
+        report_error(rows.release_error(), execution_id);
         return;
     }
 
-    if (execution->result.is_empty()) {
-        client_connection->async_results_exhausted(statement_id(), execution_id, execution->result_size);
+    if (rows.value().is_empty()) {
+        client_connection->async_results_exhausted(statement_id(), execution_id, (*cursor)->fetched_row_count());
         m_ongoing_executions.remove(execution_id);
         return;
     }
 
-    auto result_row = execution->result.take_first();
-    client_connection->async_next_result(statement_id(), execution_id, result_row.row.take_data());
+    client_connection->async_next_result(statement_id(), execution_id, move(rows.value().first()));
+}
+
+void SQLStatement::fetch_results(SQL::ExecutionID execution_id, size_t row_count)
+{
+    auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
+    if (!client_connection) {
+        warnln("Cannot yield next results. Client disconnected");
+        return;
+    }
+
+    auto cursor = m_ongoing_executions.get(execution_id);
+    if (!cursor.has_value())
+        return;
+
+    // Only the rows that were asked for are read, so the rows of a result are never all in memory at the same time.
+    auto rows = (*cursor)->fetch(min(row_count, MAX_FETCH_ROW_COUNT));
+    if (rows.is_error()) {
+        m_ongoing_executions.remove(execution_id);
+        report_error(rows.release_error(), execution_id);
+        return;
+    }
+
+    if (!rows.value().is_empty())
+        client_connection->async_next_results(statement_id(), execution_id, rows.release_value());
+
+    auto has_next_row = (*cursor)->has_next_row();
+    if (has_next_row.is_error()) {
+        m_ongoing_executions.remove(execution_id);
+        report_error(has_next_row.release_error(), execution_id);
+        return;
+    }
+
+    if (!has_next_row.value()) {
+        client_connection->async_results_exhausted(statement_id(), execution_id, (*cursor)->fetched_row_count());
+        m_ongoing_executions.remove(execution_id);
+    }
+}
+
+void SQLStatement::close_cursor(SQL::ExecutionID execution_id)
+{
+    dbgln_if(SQLSERVER_DEBUG, "SQLStatement::close_cursor(statement_id {}, execution_id {}", statement_id(), execution_id);
+    m_ongoing_executions.remove(execution_id);
 }
 
 bool SQLStatement::should_send_result_rows(SQL::ResultSet const& result) const
@@ -136,6 +253,7 @@ bool SQLStatement::should_send_result_rows(SQL::ResultSet const& result) const
 
     switch (result.command()) {
     case SQL::SQLCommand::Describe:
+    case SQL::SQLCommand::Explain:
     case SQL::SQLCommand::Select:
         return true;
     default:
@@ -8,8 +8,10 @@
 
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
+#include <AK/Variant.h>
 #include <AK/Vector.h>
 #include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/Cursor.h>
 #include <LibSQL/Result.h>
 #include <LibSQL/ResultSet.h>
 #include <LibSQL/Type.h>
@@ -24,24 +26,48 @@ public:
 
     static RefPtr<SQLStatement> statement_for(SQL::StatementID statement_id);
     SQL::StatementID statement_id() const { return m_statement_id; }
-    DatabaseConnection& connection() { return m_connection; }
+    DatabaseConnection& connection() { return *m_connection; }
+
+    // Drops the statements of a connection that is going away, together with the cursors of their executions.
+    static void remove_statements_of(DatabaseConnection const&);
+
+    // The maximum number of rows that are sent to the client for a single fetch_results() call.
+    static constexpr size_t MAX_FETCH_ROW_COUNT = 1000;
+
+    // Executes the statement, and pushes the rows of its result to the client one at a time.
     Optional<SQL::ExecutionID> execute(Vector<SQL::Value> placeholder_values);
     void ready_for_next_result(SQL::ExecutionID);
 
+    // Executes the statement, and leaves it to the client to fetch the rows of its result in batches.
+    Optional<SQL::ExecutionID> open_cursor(Vector<SQL::Value> placeholder_values);
+    void fetch_results(SQL::ExecutionID, size_t row_count);
+    void close_cursor(SQL::ExecutionID);
+
 private:
     SQLStatement(DatabaseConnection&, NonnullRefPtr<SQL::AST::Statement> statement);
 
+    enum class RowDelivery {
+        Push,
+        Fetch,
+    };
+
+    // Statements that produce rows are executed into a cursor, all others into the ResultSet that is reported to the client.
+    using ExecutionResult = Variant<SQL::ResultSet, NonnullOwnPtr<SQL::AST::Cursor>>;
+
+    Optional<SQL::ExecutionID> start_execution(Vector<SQL::Value> placeholder_values, RowDelivery);
+    SQL::ResultOr<ExecutionResult> execute_statement(Vector<SQL::Value> const& placeholder_values);
+    void send_result(SQL::ResultSet, SQL::ExecutionID);
+    void send_rows(NonnullOwnPtr<SQL::AST::Cursor>, SQL::ExecutionID, RowDelivery);
     bool should_send_result_rows(SQL::ResultSet const& result) const;
     void report_error(SQL::Result, SQL::ExecutionID execution_id);
 
-    DatabaseConnection& m_connection;
+    // Executions that were deferred may still run after the connection was disconnected, so it is kept alive.
+    NonnullRefPtr<DatabaseConnection> m_connection;
     SQL::StatementID m_statement_id { 0 };
 
-    struct Execution {
-        SQL::ResultSet result;
-        size_t result_size { 0 };
-    };
-    HashMap<SQL::ExecutionID, Execution> m_ongoing_executions;
+    // The rows of an execution are read from its cursor as they are sent to the client, so the whole result is
+    // never held in memory if the statement can produce its rows lazily.
+    HashMap<SQL::ExecutionID, NonnullOwnPtr<SQL::AST::Cursor>> m_ongoing_executions;
     SQL::ExecutionID m_next_execution_id { 0 };
 
     NonnullRefPtr<SQL::AST::Statement> m_statement;
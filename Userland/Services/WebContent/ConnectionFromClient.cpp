@@ -62,6 +62,10 @@ ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::LocalSocket> sock
     , m_page_host(PageHost::create(*this))
 {
     m_input_event_queue_timer = Web::Platform::Timer::create_single_shot(0, [this] { process_next_input_event(); });
+
+    // Most of the messages we send to the browser don't carry file descriptors, so they can skip the socket.
+    if (auto result = enable_shared_memory_ring(); result.is_error())
+        dbgln("WebContent: Unable to create a message ring, sending messages over the socket: {}", result.error());
 }
 
 ConnectionFromClient::~ConnectionFromClient() = default;
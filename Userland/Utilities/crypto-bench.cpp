@@ -16,8 +16,11 @@
 #include <LibCrypto/Authentication/Poly1305.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Checksum/cksum.h>
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/ChaCha20.h>
+#include <LibCrypto/Curves/SECPxxxr1.h>
+#include <LibCrypto/Curves/X25519.h>
 #include <LibCrypto/Forward.h>
 #include <LibCrypto/Hash/BLAKE2b.h>
 #include <LibCrypto/Hash/MD5.h>
@@ -33,8 +36,11 @@
     E(sha256, hash, Hash::SHA256)                                    \
     E(sha512, hash, Hash::SHA512)                                    \
     E(blake2b, hash, Hash::BLAKE2b)                                  \
+    E(sha256_many, multihash, Hash::SHA256)                          \
+    E(sha512_many, multihash, Hash::SHA512)                          \
     E(adler32, checksum, Checksum::Adler32)                          \
     E(crc32, checksum, Checksum::CRC32)                              \
+    E(cksum, checksum, Checksum::cksum)                              \
     E(hmac_md5, auth, Authentication::HMAC<Crypto::Hash::MD5>)       \
     E(hmac_sha1, auth, Authentication::HMAC<Crypto::Hash::SHA1>)     \
     E(hmac_sha256, auth, Authentication::HMAC<Crypto::Hash::SHA256>) \
@@ -43,11 +49,15 @@
     E(ghash, auth, Authentication::GHash)                            \
     E(aes_128_cbc, cipher, Cipher::AESCipher::CBCMode, 128)          \
     E(aes_128_ctr, cipher, Cipher::AESCipher::CTRMode, 128)          \
-    E(aes_128_gcm, cipher, Cipher::AESCipher::GCMMode, 128)          \
+    E(aes_128_gcm, aead, Cipher::AESCipher::GCMMode, 128)            \
     E(aes_256_cbc, cipher, Cipher::AESCipher::CBCMode, 256)          \
     E(aes_256_ctr, cipher, Cipher::AESCipher::CTRMode, 256)          \
+    E(aes_256_gcm, aead, Cipher::AESCipher::GCMMode, 256)            \
     E(chacha20_128, cipher, Cipher::ChaCha20, 128, 96)               \
-    E(chacha20_256, cipher, Cipher::ChaCha20, 256, 96)
+    E(chacha20_256, cipher, Cipher::ChaCha20, 256, 96)               \
+    E(x25519, handshake, Curves::X25519)                             \
+    E(secp256r1, handshake, Curves::SECP256r1)                       \
+    E(secp384r1, handshake, Curves::SECP384r1)
 
 struct Timings {
     u64 total_us { 0 };
@@ -56,11 +66,27 @@ struct Timings {
     size_t count { 0 };
     size_t unit_bytes { 0 };
 };
-static HashMap<StringView, HashMap<size_t, Timings>> g_all_timings;
+static HashMap<ByteString, HashMap<size_t, Timings>> g_all_timings;
 static auto g_time_slice_per_size = Duration::from_seconds(3);
 
 constexpr size_t sizes_in_bytes[] = { 16, 1 * KiB, 16 * KiB, 256 * KiB, 1 * MiB, 16 * MiB };
 
+static Timings run_for_time_slice(Function<void()> const& func)
+{
+    Timings timing_result;
+    auto total_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    for (; total_timer.elapsed_time() < g_time_slice_per_size;) {
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        func();
+        auto elapsed = timer.elapsed_time();
+        timing_result.max_us = max(timing_result.max_us, elapsed.to_microseconds());
+        timing_result.min_us = min(timing_result.min_us, elapsed.to_microseconds());
+        timing_result.total_us += elapsed.to_microseconds();
+        timing_result.count++;
+    }
+    return timing_result;
+}
+
 static void run_benchmark_with_all_sizes(StringView name, Function<void(ByteBuffer&)> func)
 {
     for (auto size : sizes_in_bytes) {
@@ -72,23 +98,25 @@ static void run_benchmark_with_all_sizes(StringView name, Function<void(ByteBuff
         auto buffer = result.release_value();
         fill_with_random(buffer);
 
-        Timings timing_result { .unit_bytes = size };
         warn("Running benchmark for {} with size {} for ~{}ms...", name, size, g_time_slice_per_size.to_milliseconds());
         auto total_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
-        for (; total_timer.elapsed_time() < g_time_slice_per_size;) {
-            auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
-            func(buffer);
-            auto elapsed = timer.elapsed_time();
-            timing_result.max_us = max(timing_result.max_us, elapsed.to_microseconds());
-            timing_result.min_us = min(timing_result.min_us, elapsed.to_microseconds());
-            timing_result.total_us += elapsed.to_microseconds();
-            timing_result.count++;
-        }
+        auto timing_result = run_for_time_slice([&] { func(buffer); });
+        timing_result.unit_bytes = size;
         g_all_timings.ensure(name).set(size, timing_result);
         warnln("{}ms, {} ops, {}/s", total_timer.elapsed_milliseconds(), timing_result.count, human_readable_quantity(timing_result.unit_bytes * timing_result.count / timing_result.total_us * 1'000'000));
     }
 }
 
+// Operations that don't work on a buffer, like key exchanges, are recorded with a size of zero and reported in ops/s.
+static void run_benchmark_without_size(StringView name, Function<void()> func)
+{
+    warn("Running benchmark for {} for ~{}ms...", name, g_time_slice_per_size.to_milliseconds());
+    auto total_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    auto timing_result = run_for_time_slice(func);
+    g_all_timings.ensure(name).set(0, timing_result);
+    warnln("{}ms, {} ops, {} ops/s", total_timer.elapsed_milliseconds(), timing_result.count, timing_result.count * 1'000'000 / timing_result.total_us);
+}
+
 template<typename Algorithm>
 static ErrorOr<void> run_hash_benchmark(StringView name)
 {
@@ -99,6 +127,27 @@ static ErrorOr<void> run_hash_benchmark(StringView name)
     return {};
 }
 
+template<typename Algorithm>
+static ErrorOr<void> run_multihash_benchmark(StringView name)
+{
+    // Hash the buffer as lots of small, independent messages, like cache keys.
+    constexpr size_t message_size = 64;
+    Vector<ReadonlyBytes> messages;
+    Vector<typename Algorithm::DigestType> digests;
+    run_benchmark_with_all_sizes(name, [&](auto& buffer) {
+        // An empty buffer has no messages, so there is no first one to compare against.
+        if (messages.is_empty() || messages.size() != ceil_div(buffer.size(), message_size) || messages.first().data() != buffer.data()) {
+            messages.clear_with_capacity();
+            for (size_t offset = 0; offset < buffer.size(); offset += message_size)
+                messages.append(buffer.bytes().slice(offset, min(message_size, buffer.size() - offset)));
+            digests.resize(messages.size());
+        }
+        Algorithm::hash_many(messages, digests);
+        AK::taint_for_optimizer(digests);
+    });
+    return {};
+}
+
 template<typename Algorithm>
 static ErrorOr<void> run_checksum_benchmark(StringView name)
 {
@@ -169,6 +218,55 @@ static ErrorOr<void> run_cipher_benchmark(StringView name, size_t key_bits, Opti
     return {};
 }
 
+template<typename Algorithm>
+static ErrorOr<void> run_aead_benchmark(StringView name, size_t key_bits)
+{
+    auto key = TRY(ByteBuffer::create_uninitialized(key_bits / 8));
+    fill_with_random(key);
+    Algorithm cipher(key.bytes(), key_bits, Crypto::Cipher::Intent::Encryption);
+
+    // Use a nonce and additional data like the ones of a TLS record.
+    auto iv = TRY(ByteBuffer::create_zeroed(16));
+    fill_with_random(iv.bytes().trim(12));
+    auto aad = TRY(ByteBuffer::create_uninitialized(13));
+    fill_with_random(aad);
+
+    auto ciphertext = TRY(ByteBuffer::create_uninitialized(16 * MiB));
+    auto plaintext = TRY(ByteBuffer::create_uninitialized(16 * MiB));
+    auto tag = TRY(ByteBuffer::create_uninitialized(16));
+
+    run_benchmark_with_all_sizes(ByteString::formatted("{}_encrypt", name), [&](auto& buffer) {
+        cipher.encrypt(buffer, ciphertext.bytes().trim(buffer.size()), iv, aad, tag);
+        AK::taint_for_optimizer(ciphertext);
+    });
+
+    run_benchmark_with_all_sizes(ByteString::formatted("{}_decrypt", name), [&](auto& buffer) {
+        // The tag won't match, but that is only checked after decrypting everything.
+        auto result = cipher.decrypt(buffer, plaintext.bytes().trim(buffer.size()), iv, aad, tag);
+        AK::taint_for_optimizer(result);
+        AK::taint_for_optimizer(plaintext);
+    });
+    return {};
+}
+
+template<typename Curve>
+static ErrorOr<void> run_handshake_benchmark(StringView name)
+{
+    // The client's side of an ECDHE key exchange, as done for every TLS handshake: generate a key pair, and derive the
+    // shared secret from the server's public key.
+    Curve curve;
+    auto server_private_key = TRY(curve.generate_private_key());
+    auto server_public_key = TRY(curve.generate_public_key(server_private_key));
+    run_benchmark_without_size(name, [&] {
+        auto private_key = MUST(curve.generate_private_key());
+        auto public_key = MUST(curve.generate_public_key(private_key));
+        auto shared_point = MUST(curve.compute_coordinate(private_key, server_public_key));
+        AK::taint_for_optimizer(public_key);
+        AK::taint_for_optimizer(shared_point);
+    });
+    return {};
+}
+
 static ErrorOr<void> benchmark(StringView algorithm)
 {
 #define BENCH(name, type, algo, ...)                                                       \
@@ -189,6 +287,18 @@ static void print_benchmark_results()
     // algo, size, min, max, avg, throughput
     outln("{:<20} {:<10} {:<10} {:<10} {:<10} {:<10}", "Algorithm", "Size", "Min us/op", "Max us/op", "Avg us/op", "Throughput");
     for (auto& [algo, timings] : g_all_timings) {
+        if (auto t = timings.get(0); t.has_value()) {
+            auto& timing = t.value();
+            outln("{:<20} {:<10} {:<10} {:<10} {:<10} {:<10} ops/s",
+                algo,
+                "-",
+                timing.min_us,
+                timing.max_us,
+                timing.total_us / timing.count,
+                timing.count * 1'000'000 / timing.total_us);
+            continue;
+        }
+
         for (auto size : sizes_in_bytes) {
             auto t = timings.get(size);
             if (!t.has_value())
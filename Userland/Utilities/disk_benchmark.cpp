@@ -7,11 +7,15 @@
 
 #include <AK/ByteBuffer.h>
 #include <AK/ByteString.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <fcntl.h>
@@ -24,6 +28,32 @@ struct Result {
     u64 read_bps {};
 };
 
+struct CacheStatistics {
+    u64 hits {};
+    u64 misses {};
+    u64 evictions {};
+    u64 written_back {};
+};
+
+static ErrorOr<CacheStatistics> read_cache_statistics()
+{
+    auto file = TRY(Core::File::open("/sys/kernel/df"sv, Core::File::OpenMode::Read));
+    auto contents = TRY(file->read_until_eof());
+    auto json = TRY(JsonValue::from_string(contents));
+
+    CacheStatistics statistics;
+    json.as_array().for_each([&](JsonValue const& value) {
+        auto cache = value.as_object().get_object("cache"sv);
+        if (!cache.has_value())
+            return;
+        statistics.hits += cache->get_u64("hits"sv).value_or(0);
+        statistics.misses += cache->get_u64("misses"sv).value_or(0);
+        statistics.evictions += cache->get_u64("evictions"sv).value_or(0);
+        statistics.written_back += cache->get_u64("written_back"sv).value_or(0);
+    });
+    return statistics;
+}
+
 static Result average_result(Vector<Result> const& results)
 {
     Result average;
@@ -83,6 +113,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             Vector<Result> results;
 
             outln("Running: file_size={} block_size={}", file_size, block_size);
+            auto cache_statistics_before = read_cache_statistics();
             auto timer = Core::ElapsedTimer::start_new();
             while (timer.elapsed_time() < time_per_benchmark) {
                 out(".");
@@ -94,6 +125,17 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             auto average = average_result(results);
             outln("Finished: runs={} time={}ms write_bps={} read_bps={}", results.size(), timer.elapsed_milliseconds(), average.write_bps, average.read_bps);
 
+            auto cache_statistics_after = read_cache_statistics();
+            if (allow_cache && !cache_statistics_before.is_error() && !cache_statistics_after.is_error()) {
+                auto const& before = cache_statistics_before.value();
+                auto const& after = cache_statistics_after.value();
+                auto hits = after.hits - before.hits;
+                auto misses = after.misses - before.misses;
+                outln("Cache: hits={} misses={} hit_rate={}% evictions={} written_back={}",
+                    hits, misses, (hits + misses) ? (hits * 100 / (hits + misses)) : 0,
+                    after.evictions - before.evictions, after.written_back - before.written_back);
+            }
+
             sleep(1);
         }
     }
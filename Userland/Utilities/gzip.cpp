@@ -20,11 +20,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool keep_input_files { false };
     bool write_to_stdout { false };
     bool decompress { false };
+    size_t thread_count { 1 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
     args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(thread_count, "Compress using this many threads", "processes", 'p', "N");
     args_parser.add_positional_argument(filenames, "Files", "FILES", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -68,16 +70,19 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         NonnullOwnPtr<Core::File> input_file = TRY(Core::File::open_file_or_standard_stream(input_filename, Core::File::OpenMode::Read));
 
+        // Every write to the compressor is compressed on its own, so give each thread a few chunks to work on at a time.
+        auto buffer_size = max(1 * MiB, thread_count * 4 * Compress::GzipCompressor::parallel_chunk_size);
+
         // Buffer reads, which yields a significant performance improvement.
-        NonnullOwnPtr<Stream> input_stream = TRY(Core::InputBufferedFile::create(move(input_file), 1 * MiB));
+        NonnullOwnPtr<Stream> input_stream = TRY(Core::InputBufferedFile::create(move(input_file), buffer_size));
 
         if (decompress) {
             input_stream = TRY(try_make<Compress::GzipDecompressor>(move(input_stream)));
         } else {
-            output_stream = TRY(try_make<Compress::GzipCompressor>(output_stream.release_nonnull()));
+            output_stream = TRY(try_make<Compress::GzipCompressor>(output_stream.release_nonnull(), thread_count));
         }
 
-        auto buffer = TRY(ByteBuffer::create_uninitialized(1 * MiB));
+        auto buffer = TRY(ByteBuffer::create_uninitialized(buffer_size));
 
         while (!input_stream->is_eof()) {
             auto span = TRY(input_stream->read_some(buffer));
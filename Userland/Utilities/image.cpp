@@ -12,6 +12,7 @@
 #include <LibGfx/ImageFormats/BMPWriter.h>
 #include <LibGfx/ImageFormats/GIFWriter.h>
 #include <LibGfx/ImageFormats/ImageDecoder.h>
+#include <LibGfx/ImageFormats/JPEGLoader.h>
 #include <LibGfx/ImageFormats/JPEGWriter.h>
 #include <LibGfx/ImageFormats/PNGWriter.h>
 #include <LibGfx/ImageFormats/PortableFormatWriter.h>
@@ -27,23 +28,25 @@ struct LoadedImage {
     Optional<ReadonlyBytes> icc_data;
 };
 
-static ErrorOr<LoadedImage> load_image(RefPtr<Gfx::ImageDecoder> const& decoder, int frame_index)
+// Works with both Gfx::ImageDecoder and a Gfx::ImageDecoderPlugin that was created with format-specific options.
+template<typename Decoder>
+static ErrorOr<LoadedImage> load_image(Decoder& decoder, int frame_index)
 {
-    auto internal_format = decoder->natural_frame_format();
+    auto internal_format = decoder.natural_frame_format();
 
     auto bitmap = TRY([&]() -> ErrorOr<AnyBitmap> {
         switch (internal_format) {
         case Gfx::NaturalFrameFormat::RGB:
         case Gfx::NaturalFrameFormat::Grayscale:
         case Gfx::NaturalFrameFormat::Vector:
-            return TRY(decoder->frame(frame_index)).image;
+            return TRY(decoder.frame(frame_index)).image;
         case Gfx::NaturalFrameFormat::CMYK:
-            return RefPtr(TRY(decoder->cmyk_frame()));
+            return RefPtr(TRY(decoder.cmyk_frame()));
         }
         VERIFY_NOT_REACHED();
     }());
 
-    return LoadedImage { internal_format, move(bitmap), TRY(decoder->icc_data()) };
+    return LoadedImage { internal_format, move(bitmap), TRY(decoder.icc_data()) };
 }
 
 static ErrorOr<void> invert_cmyk(LoadedImage& image)
@@ -232,6 +235,7 @@ struct Options {
     u8 quality = 75;
     unsigned webp_color_cache_bits = 6;
     Optional<unsigned> webp_allowed_transforms;
+    size_t jpeg_decoder_threads = 1;
 };
 
 template<class T>
@@ -282,6 +286,7 @@ static ErrorOr<Options> parse_options(Main::Arguments arguments)
     args_parser.add_option(options.out_path, "Path to output image file", "output", 'o', "FILE");
     args_parser.add_option(options.no_output, "Do not write output (only useful for benchmarking image decoding)", "no-output", {});
     args_parser.add_option(options.frame_index, "Which frame of a multi-frame input image (0-based)", "frame-index", {}, "INDEX");
+    args_parser.add_option(options.jpeg_decoder_threads, "Number of threads used to decode the restart intervals of sequential JPEG images (default: 1)", "jpeg-decoder-threads", {}, "COUNT");
     args_parser.add_option(options.invert_cmyk, "Invert CMYK channels", "invert-cmyk", {});
     StringView crop_rect_string;
     args_parser.add_option(crop_rect_string, "Crop to a rectangle", "crop", {}, "x,y,w,h");
@@ -325,11 +330,17 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     auto file = TRY(Core::MappedFile::map(options.in_path));
     auto guessed_mime_type = Core::guess_mime_type_based_on_filename(options.in_path);
-    auto decoder = TRY(Gfx::ImageDecoder::try_create_for_raw_bytes(file->bytes(), guessed_mime_type));
-    if (!decoder)
-        return Error::from_string_literal("Could not find decoder for input file");
+    LoadedImage image = TRY([&]() -> ErrorOr<LoadedImage> {
+        if (options.jpeg_decoder_threads > 1 && Gfx::JPEGImageDecoderPlugin::sniff(file->bytes())) {
+            auto decoder = TRY(Gfx::JPEGImageDecoderPlugin::create_with_options(file->bytes(), { .thread_count = options.jpeg_decoder_threads }));
+            return load_image(*decoder, options.frame_index);
+        }
 
-    LoadedImage image = TRY(load_image(*decoder, options.frame_index));
+        auto decoder = TRY(Gfx::ImageDecoder::try_create_for_raw_bytes(file->bytes(), guessed_mime_type));
+        if (!decoder)
+            return Error::from_string_literal("Could not find decoder for input file");
+        return load_image(*decoder, options.frame_index);
+    }());
 
     if (options.invert_cmyk)
         TRY(invert_cmyk(image));
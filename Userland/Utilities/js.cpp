@@ -535,12 +535,15 @@ private:
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction map_fixed"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction map_fixed prot_exec"));
 
     bool gc_on_every_allocation = false;
+    bool generational_gc = false;
+    bool incremental_marking = false;
     bool disable_syntax_highlight = false;
     bool disable_debug_printing = false;
     bool use_test262_global = false;
+    bool dump_inline_cache_statistics = false;
     StringView evaluate_script;
     Vector<StringView> script_paths;
 
@@ -548,11 +551,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.set_general_help("This is a JavaScript interpreter.");
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(dump_inline_cache_statistics, "Dump property lookup cache hits and misses after running", "dump-inline-cache-stats");
+    args_parser.add_option(JS::Bytecode::g_jit_enabled, "Compile hot code with the JIT", "jit");
+    args_parser.add_option(JS::Bytecode::g_jit_compilation_threshold, "Number of runs before a function is JIT-compiled", "jit-threshold", 0, "count");
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
     args_parser.add_option(s_disable_source_location_hints, "Disable source location hints", "disable-source-location-hints", 'h');
     args_parser.add_option(gc_on_every_allocation, "GC on every allocation", "gc-on-every-allocation", 'g');
+    args_parser.add_option(generational_gc, "Use generational garbage collection", "generational-gc");
+    args_parser.add_option(incremental_marking, "Use incremental marking", "incremental-marking");
     args_parser.add_option(disable_syntax_highlight, "Disable live syntax highlighting", "no-syntax-highlight", 's');
     args_parser.add_option(disable_debug_printing, "Disable debug output", "disable-debug-output", {});
     args_parser.add_option(evaluate_script, "Evaluate argument as a script", "evaluate", 'c', "script");
@@ -560,6 +568,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_positional_argument(script_paths, "Path to script files", "scripts", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
+    // Only the JIT needs to map executable memory.
+    if (!JS::Bytecode::g_jit_enabled)
+        TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction map_fixed"));
+
     bool syntax_highlight = !disable_syntax_highlight;
 
     AK::set_debug_enabled(!disable_debug_printing);
@@ -600,6 +612,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         ReplConsoleClient console_client(console_object.console());
         console_object.console().set_client(console_client);
         g_vm->heap().set_should_collect_on_every_allocation(gc_on_every_allocation);
+        g_vm->heap().set_uses_generational_collection(generational_gc);
+        g_vm->heap().set_uses_incremental_marking(incremental_marking);
 
         auto& global_environment = realm.global_environment();
 
@@ -829,6 +843,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         ReplConsoleClient console_client(console_object.console());
         console_object.console().set_client(console_client);
         g_vm->heap().set_should_collect_on_every_allocation(gc_on_every_allocation);
+        g_vm->heap().set_uses_generational_collection(generational_gc);
+        g_vm->heap().set_uses_incremental_marking(incremental_marking);
 
         StringBuilder builder;
         StringView source_name;
@@ -861,7 +877,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         // We resolve modules as if it is the first file
 
-        if (!TRY(parse_and_run(realm, builder.string_view(), source_name)))
+        auto succeeded = TRY(parse_and_run(realm, builder.string_view(), source_name));
+        if (dump_inline_cache_statistics)
+            JS::Bytecode::Executable::dump_all_property_lookup_cache_statistics();
+        if (!succeeded)
             return 1;
     }
 
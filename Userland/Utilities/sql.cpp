@@ -7,15 +7,22 @@
 
 #include <AK/ByteString.h>
 #include <AK/Format.h>
+#include <AK/Random.h>
+#include <AK/ScopeGuard.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/StandardPaths.h>
 #include <LibFileSystem/FileSystem.h>
 #include <LibLine/Editor.h>
 #include <LibMain/Main.h>
 #include <LibSQL/AST/Lexer.h>
+#include <LibSQL/AST/Parser.h>
 #include <LibSQL/AST/Token.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/PageCache.h>
+#include <LibSQL/ResultSet.h>
 #include <LibSQL/SQLClient.h>
 #include <unistd.h>
 
@@ -85,12 +92,20 @@ public:
                 outln("{} row(s) created, {} updated, {} deleted", result.rows_created, result.rows_updated, result.rows_deleted);
             if (!result.has_results)
                 read_sql();
+            else
+                m_sql_client->async_fetch_results(result.statement_id, result.execution_id, fetch_row_count);
         };
 
-        m_sql_client->on_next_result = [](auto result) {
-            StringBuilder builder;
-            builder.join(", "sv, result.values);
-            outln("{}", builder.to_byte_string());
+        m_sql_client->on_next_results = [this](auto result) {
+            for (auto const& row : result.rows) {
+                StringBuilder builder;
+                builder.join(", "sv, row);
+                outln("{}", builder.to_byte_string());
+            }
+
+            // A partial batch means there are no rows left, and the server is about to tell us so.
+            if (result.rows.size() == fetch_row_count)
+                m_sql_client->async_fetch_results(result.statement_id, result.execution_id, fetch_row_count);
         };
 
         m_sql_client->on_results_exhausted = [this](auto result) {
@@ -148,6 +163,9 @@ public:
     }
 
 private:
+    // The number of result rows that are fetched from the server at once.
+    static constexpr u32 fetch_row_count = 100;
+
     ByteString m_history_path;
     RefPtr<Line::Editor> m_editor { nullptr };
     int m_repl_line_level { 0 };
@@ -277,7 +295,7 @@ private:
                     read_sql();
                 });
         } else if (auto statement_id = m_sql_client->prepare_statement(m_connection_id, piece); statement_id.has_value()) {
-            m_sql_client->async_execute_statement(*statement_id, {});
+            m_sql_client->async_open_cursor(*statement_id, {});
         } else {
             warnln("\033[33;1mError parsing SQL statement\033[0m: {}", piece);
             m_loop.deferred_invoke([this]() {
@@ -337,12 +355,167 @@ private:
     }
 };
 
+static constexpr size_t benchmark_synced_insert_count = 1000;
+static constexpr size_t benchmark_group_commit_size = 100;
+static constexpr size_t benchmark_point_lookup_count = 1000;
+
+static SQL::ResultOr<NonnullRefPtr<SQL::AST::Statement>> parse_statement(StringView sql)
+{
+    auto parser = SQL::AST::Parser(SQL::AST::Lexer(sql));
+    auto statement = parser.next_statement();
+    if (parser.has_errors())
+        return SQL::Result { SQL::SQLCommand::Unknown, SQL::SQLErrorCode::SyntaxError, parser.errors()[0].to_byte_string() };
+    return statement;
+}
+
+// Measures how fast rows are inserted into a table of the given size, and how long queries on it take when they scan
+// the table, and when they can use an index instead.
+static SQL::ResultOr<void> run_insert_and_query_benchmark(ByteString const& database_path, size_t row_count, u32 page_size)
+{
+    auto database = TRY(SQL::Database::create(database_path, page_size));
+    TRY(database->open());
+
+    auto execute = [&](StringView sql, ReadonlySpan<SQL::Value> placeholder_values = {}) -> SQL::ResultOr<SQL::ResultSet> {
+        auto statement = TRY(parse_statement(sql));
+        return statement->execute(database, placeholder_values);
+    };
+
+    TRY(execute("CREATE SCHEMA Benchmark;"sv));
+    TRY(execute("CREATE TABLE Benchmark.Entries ( Id integer, Name text );"sv));
+
+    auto insert_statement = TRY(parse_statement("INSERT INTO Benchmark.Entries VALUES ( ?, ? );"sv));
+
+    // Spread the ids over the table, so that they aren't stored in the order of the index.
+    auto insert_row = [&](size_t row) -> SQL::ResultOr<void> {
+        auto id = static_cast<i64>((row * 7919) % row_count);
+        Array<SQL::Value, 2> values { SQL::Value { id }, SQL::Value { ByteString::formatted("Row {}", id) } };
+        TRY(insert_statement->execute(database, values));
+        return {};
+    };
+
+    auto report_insert_throughput = [](size_t rows, StringView commit_mode, Core::ElapsedTimer const& timer) {
+        auto milliseconds = max<i64>(timer.elapsed_milliseconds(), 1);
+        outln("Inserted {} rows {} in {} ms, {} rows/s", rows, commit_mode, milliseconds, static_cast<i64>(rows) * 1000 / milliseconds);
+    };
+
+    // Every INSERT is a transaction of its own. A single client has to wait for each of them to be synced, while
+    // SQLServer syncs the transactions of concurrent clients together.
+    auto synced_rows = min(row_count, benchmark_synced_insert_count);
+    auto insert_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    for (size_t row = 0; row < synced_rows; ++row)
+        TRY(insert_row(row));
+    report_insert_throughput(synced_rows, "with a sync per transaction"sv, insert_timer);
+
+    if (synced_rows < row_count) {
+        database->set_uses_group_commit(true);
+        insert_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+
+        for (size_t row = synced_rows; row < row_count; ++row) {
+            TRY(insert_row(row));
+            if ((row - synced_rows + 1) % benchmark_group_commit_size == 0)
+                TRY(database->sync());
+        }
+        TRY(database->sync());
+
+        database->set_uses_group_commit(false);
+        report_insert_throughput(row_count - synced_rows, ByteString::formatted("with a sync per {} transactions", benchmark_group_commit_size), insert_timer);
+    }
+
+    struct Query {
+        StringView description;
+        StringView sql;
+        Vector<SQL::Value> placeholder_values;
+    };
+
+    auto range_start = static_cast<i64>(row_count / 2);
+    Array<Query, 3> queries {
+        Query { "Point lookup"sv, "SELECT * FROM Benchmark.Entries WHERE Id = ?;"sv, { SQL::Value { range_start } } },
+        Query { "Range of 1000 rows"sv, "SELECT * FROM Benchmark.Entries WHERE Id >= ? AND Id < ?;"sv, { SQL::Value { range_start }, SQL::Value { range_start + 1000 } } },
+        Query { "Ordered range of 1000 rows"sv, "SELECT * FROM Benchmark.Entries WHERE Id >= ? AND Id < ? ORDER BY Id;"sv, { SQL::Value { range_start }, SQL::Value { range_start + 1000 } } },
+    };
+
+    auto run_queries = [&](StringView access_path) -> SQL::ResultOr<void> {
+        for (auto const& query : queries) {
+            auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+            auto result = TRY(execute(query.sql, query.placeholder_values));
+            outln("{} ({}): {} row(s) in {} ms", query.description, access_path, result.size(), timer.elapsed_milliseconds());
+        }
+        return {};
+    };
+
+    TRY(run_queries("table scan"sv));
+
+    auto index_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    TRY(execute("CREATE INDEX Benchmark.EntriesById ON Entries ( Id );"sv));
+    outln("Created index in {} ms", index_timer.elapsed_milliseconds());
+
+    TRY(run_queries("index"sv));
+    return {};
+}
+
+// Measures how long full table scans and point lookups take on the table that was created by the insert benchmark.
+// The database is opened again, so that the first scan has to read every block from the heap file.
+static SQL::ResultOr<void> run_page_cache_benchmark(ByteString const& database_path, size_t row_count, bool uses_mapped_reads)
+{
+    auto database = TRY(SQL::Database::create(database_path));
+    TRY(database->heap().set_uses_mapped_reads(uses_mapped_reads));
+    TRY(database->open());
+
+    auto const& page_cache = database->heap().page_cache();
+    auto read_mode = uses_mapped_reads ? "mapped reads"sv : "file reads"sv;
+
+    auto report = [&](StringView description, size_t rows, size_t hits, size_t misses, Core::ElapsedTimer const& timer) {
+        auto lookups = max<size_t>(hits + misses, 1);
+        outln("{} ({}, {} byte pages): {} row(s) in {} ms, {}% page cache hits",
+            description, read_mode, database->heap().block_size(), rows, timer.elapsed_milliseconds(), hits * 100 / lookups);
+    };
+
+    auto scan_statement = TRY(parse_statement("SELECT * FROM Benchmark.Entries;"sv));
+    for (auto description : { "Cold table scan"sv, "Warm table scan"sv }) {
+        auto hits = page_cache.hits();
+        auto misses = page_cache.misses();
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        auto result = TRY(scan_statement->execute(database));
+        report(description, result.size(), page_cache.hits() - hits, page_cache.misses() - misses, timer);
+    }
+
+    auto lookup_statement = TRY(parse_statement("SELECT * FROM Benchmark.Entries WHERE Id = ?;"sv));
+    auto hits = page_cache.hits();
+    auto misses = page_cache.misses();
+    size_t rows = 0;
+    auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    for (size_t lookup = 0; lookup < benchmark_point_lookup_count; ++lookup) {
+        Array<SQL::Value, 1> values { SQL::Value { static_cast<i64>(get_random_uniform(static_cast<u32>(row_count))) } };
+        rows += TRY(lookup_statement->execute(database, values)).size();
+    }
+    report(ByteString::formatted("{} point lookups", benchmark_point_lookup_count), rows, page_cache.hits() - hits, page_cache.misses() - misses, timer);
+    return {};
+}
+
+// The statements are executed in-process on a temporary database, so that the timings don't include the IPC round
+// trips to SQLServer.
+static SQL::ResultOr<void> run_benchmark(size_t row_count, u32 page_size)
+{
+    auto database_path = ByteString::formatted("/tmp/sql-benchmark-{}.db", getpid());
+    ScopeGuard guard([&]() {
+        (void)FileSystem::remove(database_path, FileSystem::RecursionMode::Disallowed);
+        (void)FileSystem::remove(ByteString::formatted("{}-wal", database_path), FileSystem::RecursionMode::Disallowed);
+    });
+
+    TRY(run_insert_and_query_benchmark(database_path, row_count, page_size));
+    TRY(run_page_cache_benchmark(database_path, row_count, false));
+    TRY(run_page_cache_benchmark(database_path, row_count, true));
+    return {};
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     ByteString database_name(getlogin());
     ByteString file_to_source;
     ByteString file_to_read;
     bool suppress_sqlrc = false;
+    size_t benchmark_rows = 0;
+    u32 benchmark_page_size = SQL::Block::DEFAULT_SIZE;
     auto sqlrc_path = ByteString::formatted("{}/.sqlrc", Core::StandardPaths::home_directory());
 #if !defined(AK_OS_SERENITY)
     StringView sql_server_path;
@@ -354,11 +527,21 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(file_to_read, "File to read", "read", 'r', "file");
     args_parser.add_option(file_to_source, "File to source", "source", 's', "file");
     args_parser.add_option(suppress_sqlrc, "Don't read ~/.sqlrc", "no-sqlrc", 'n');
+    args_parser.add_option(benchmark_rows, "Benchmark inserts and queries on a temporary table with this many rows, then exit", "benchmark", 'b', "rows");
+    args_parser.add_option(benchmark_page_size, "Page size of the temporary database used by --benchmark", "page-size", 0, "bytes");
 #if !defined(AK_OS_SERENITY)
     args_parser.add_option(sql_server_path, "Path to SQLServer to launch if needed", "sql-server-path", 'p', "path");
 #endif
     args_parser.parse(arguments);
 
+    if (benchmark_rows > 0) {
+        if (auto result = run_benchmark(benchmark_rows, benchmark_page_size); result.is_error()) {
+            warnln("\033[33;1mBenchmark failed:\033[0m {}", result.error().error_string());
+            return 1;
+        }
+        return 0;
+    }
+
     Core::EventLoop loop;
 
 #if defined(AK_OS_SERENITY)
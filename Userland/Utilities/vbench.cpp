@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/System.h>
+#include <LibFileSystem/FileSystem.h>
+#include <LibMain/Main.h>
+#include <LibMedia/Containers/Matroska/MatroskaDemuxer.h>
+#include <LibMedia/Video/VP9/Decoder.h>
+
+struct DecodeStatistics {
+    size_t frame_count { 0 };
+    Duration decode_time;
+    Duration first_timestamp { Duration::max() };
+    Duration last_timestamp { Duration::min() };
+};
+
+static Media::DecoderErrorOr<void> receive_decoded_frames(Media::VideoDecoder& decoder, DecodeStatistics& statistics)
+{
+    while (true) {
+        auto frame_result = decoder.get_decoded_frame();
+        if (frame_result.is_error()) {
+            if (frame_result.error().category() == Media::DecoderErrorCategory::NeedsMoreInput)
+                return {};
+            return frame_result.release_error();
+        }
+
+        auto timestamp = frame_result.value()->timestamp();
+        statistics.first_timestamp = min(statistics.first_timestamp, timestamp);
+        statistics.last_timestamp = max(statistics.last_timestamp, timestamp);
+        statistics.frame_count++;
+    }
+}
+
+static Media::DecoderErrorOr<DecodeStatistics> decode_video(StringView path, size_t frame_limit, Media::Video::VP9::Decoder::FrameThreading frame_threading)
+{
+    auto demuxer = TRY(Media::Matroska::MatroskaDemuxer::from_file(path));
+    auto video_tracks = TRY(demuxer->get_tracks_for_type(Media::TrackType::Video));
+    if (video_tracks.is_empty())
+        return Media::DecoderError::with_description(Media::DecoderErrorCategory::Invalid, "No video track is present"sv);
+    auto track = video_tracks[0];
+
+    auto codec_id = TRY(demuxer->get_codec_id_for_track(track));
+    OwnPtr<Media::VideoDecoder> decoder;
+    switch (codec_id) {
+    case Media::CodecID::VP9:
+        decoder = make<Media::Video::VP9::Decoder>(frame_threading);
+        break;
+    default:
+        return Media::DecoderError::format(Media::DecoderErrorCategory::Invalid, "Unsupported codec: {}", codec_id);
+    }
+
+    DecodeStatistics statistics;
+
+    // With frame threading, frames keep decoding in the background between the calls into the decoder, so the whole
+    // loop is timed, including reading the samples and waiting for the last frames at the end.
+    auto decode_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+
+    while (statistics.frame_count < frame_limit) {
+        auto sample_result = demuxer->get_next_sample_for_track(track);
+        if (sample_result.is_error()) {
+            if (sample_result.error().category() == Media::DecoderErrorCategory::EndOfStream)
+                break;
+            return sample_result.release_error();
+        }
+        auto sample = sample_result.release_value();
+
+        TRY(decoder->receive_sample(sample.timestamp(), sample.data()));
+        TRY(receive_decoded_frames(*decoder, statistics));
+    }
+
+    TRY(decoder->signal_end_of_stream());
+    TRY(receive_decoded_frames(*decoder, statistics));
+
+    statistics.decode_time = decode_timer.elapsed_time();
+    return statistics;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    StringView path {};
+    int frame_count = -1;
+    bool no_frame_threading = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Benchmark video decoding");
+    args_parser.add_positional_argument(path, "Path to video file", "path");
+    args_parser.add_option(frame_count, "How many frames to decode at maximum", "frame-count", 'f', "frames");
+    args_parser.add_option(no_frame_threading, "Decode each frame before starting the next one", "no-frame-threading", 0);
+    args_parser.parse(arguments);
+
+    TRY(Core::System::unveil(TRY(FileSystem::absolute_path(path)), "r"sv));
+    TRY(Core::System::unveil(nullptr, nullptr));
+    TRY(Core::System::pledge("stdio rpath thread"));
+
+    auto frame_limit = frame_count > 0 ? static_cast<size_t>(frame_count) : NumericLimits<size_t>::max();
+    auto frame_threading = no_frame_threading ? Media::Video::VP9::Decoder::FrameThreading::No : Media::Video::VP9::Decoder::FrameThreading::Yes;
+    auto statistics_result = decode_video(path, frame_limit, frame_threading);
+    if (statistics_result.is_error()) {
+        warnln("Failed to decode video: {}", statistics_result.error().description());
+        return 1;
+    }
+    auto statistics = statistics_result.release_value();
+
+    if (statistics.frame_count == 0) {
+        warnln("No frames were decoded");
+        return 1;
+    }
+
+    auto decode_seconds = static_cast<double>(statistics.decode_time.to_microseconds()) / 1'000'000.;
+    auto frames_per_second = static_cast<double>(statistics.frame_count) / decode_seconds;
+    outln("Decoded {} frames in {:.3f} s, {:.1f} fps, {:.3f} ms/frame", statistics.frame_count, decode_seconds, frames_per_second, decode_seconds * 1000. / static_cast<double>(statistics.frame_count));
+
+    // The video's frame rate is estimated from the timestamps, since the container doesn't need to specify one.
+    if (statistics.frame_count > 1 && statistics.last_timestamp > statistics.first_timestamp) {
+        auto video_seconds = static_cast<double>((statistics.last_timestamp - statistics.first_timestamp).to_microseconds()) / 1'000'000.;
+        auto video_frames_per_second = static_cast<double>(statistics.frame_count - 1) / video_seconds;
+        outln("Video is {:.1f} fps, decoding at {:.1f}% of realtime speed", video_frames_per_second, frames_per_second / video_frames_per_second * 100.);
+    }
+
+    return 0;
+}